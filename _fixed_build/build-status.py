@@ -0,0 +1,8 @@
+#! /usr/bin/env python3
+
+# Programs that are runnable.
+ns3_runnable_programs = ['_fixed_build/scratch/ns3.30-obss-pd-test-debug', '_fixed_build/scratch/ns3.30-mesh-loc-jw-debug', '_fixed_build/scratch/ns3.30-obss-pd-0917-debug', '_fixed_build/scratch/subdir/ns3.30-subdir-debug', '_fixed_build/scratch/ns3.30-scratch-simulator-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = []
+
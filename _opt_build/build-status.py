@@ -0,0 +1,8 @@
+#! /usr/bin/env python3
+
+# Programs that are runnable.
+ns3_runnable_programs = ['_opt_build/scratch/ns3.30-obss-pd-test-optimized', '_opt_build/scratch/ns3.30-mesh-loc-jw-optimized', '_opt_build/scratch/ns3.30-obss-pd-0917-optimized', '_opt_build/scratch/subdir/ns3.30-subdir-optimized', '_opt_build/scratch/ns3.30-scratch-simulator-optimized']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = []
+
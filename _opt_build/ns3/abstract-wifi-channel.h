@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ABSTRACT_WIFI_CHANNEL_H
+#define ABSTRACT_WIFI_CHANNEL_H
+
+#include <vector>
+#include "ns3/channel.h"
+#include "ns3/nstime.h"
+#include "wifi-tx-vector.h"
+
+namespace ns3 {
+
+class NetDevice;
+class PropagationLossModel;
+class PropagationDelayModel;
+class MobilityModel;
+class AbstractWifiPhy;
+class Packet;
+
+/**
+ * \brief a channel to interconnect ns3::AbstractWifiPhy objects.
+ * \ingroup wifi
+ *
+ * This channel supports the same propagation models as ns3::YansWifiChannel,
+ * but it does not evaluate them for every transmission: the path loss and
+ * the propagation delay of every link are computed once and kept in a table,
+ * together with the list of receivers which are in range of each sender.
+ * A transmission is then only delivered to the receivers in range of its
+ * sender, at a power derived from the table.
+ *
+ * The table of a link is computed again when one of its ends moves.  It is
+ * therefore only exact for propagation loss models which are deterministic
+ * functions of the positions, such as ns3::LogDistancePropagationLossModel;
+ * random or time-varying loss models should be used with ns3::YansWifiChannel.
+ */
+class AbstractWifiChannel : public Channel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  AbstractWifiChannel ();
+  virtual ~AbstractWifiChannel ();
+
+  //inherited from Channel.
+  virtual std::size_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
+
+  /**
+   * Adds the given AbstractWifiPhy to the PHY list
+   *
+   * \param phy the AbstractWifiPhy to be added to the PHY list
+   *
+   * \return the index of the PHY in the PHY list
+   */
+  std::size_t Add (Ptr<AbstractWifiPhy> phy);
+
+  /**
+   * \param loss the new propagation loss model.
+   */
+  void SetPropagationLossModel (const Ptr<PropagationLossModel> loss);
+  /**
+   * \param delay the new propagation delay model.
+   */
+  void SetPropagationDelayModel (const Ptr<PropagationDelayModel> delay);
+
+  /**
+   * \param sender the index of the PHY from which the packet is originating.
+   * \param packet the packet to send, without its PHY headers
+   * \param txVector the TXVECTOR used to send the packet
+   * \param txPowerDbm the tx power associated to the packet, in dBm
+   * \param duration the transmission duration associated with the packet
+   * \param isFrameComplete false if the transmitter was switched off during the transmission
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from AbstractWifiPhy::StartTx.  The channel
+   * delivers the packet to the other AbstractWifiPhy objects on the same
+   * channel number which receive it above their sensitivity.
+   */
+  void Send (std::size_t sender, Ptr<const Packet> packet, WifiTxVector txVector,
+             double txPowerDbm, Time duration, bool isFrameComplete);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   *
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+
+private:
+  /**
+   * A vector of pointers to AbstractWifiPhy.
+   */
+  typedef std::vector<Ptr<AbstractWifiPhy> > PhyList;
+
+  /**
+   * The propagation of the transmissions of a sender to one of its receivers.
+   */
+  struct Link
+  {
+    std::size_t receiver; //!< the index of the receiver in the PHY list
+    double lossDb;        //!< the path loss between the antennas, in dB
+    Time delay;           //!< the propagation delay
+    uint32_t context;     //!< the id of the node of the receiver
+  };
+
+  /**
+   * A vector of links.
+   */
+  typedef std::vector<Link> Links;
+
+  /**
+   * Return the links from the given sender to the receivers which can be in
+   * range of its transmissions, computing them if they are not known yet.
+   *
+   * \param sender the index of the sender in the PHY list
+   *
+   * \return the links of the sender
+   */
+  const Links & GetLinks (std::size_t sender);
+  /**
+   * Forget the links of all the senders, so that they are computed again.
+   * This is connected to the CourseChange trace of the mobility models.
+   *
+   * \param mobility the mobility model which changed course
+   */
+  void InvalidateLinks (Ptr<const MobilityModel> mobility);
+
+  PhyList m_phyList;                   //!< List of AbstractWifiPhys connected to this AbstractWifiChannel
+  Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
+  Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  std::vector<Links> m_links;          //!< Links of each sender, indexed as the PHY list
+  std::vector<bool> m_linksValid;      //!< Whether the links of each sender are up to date
+  std::vector<Ptr<MobilityModel> > m_tracked; //!< Mobility models whose CourseChange is connected
+};
+
+} //namespace ns3
+
+#endif /* ABSTRACT_WIFI_CHANNEL_H */
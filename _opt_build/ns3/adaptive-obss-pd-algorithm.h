@@ -0,0 +1,181 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ADAPTIVE_OBSS_PD_ALGORITHM_H
+#define ADAPTIVE_OBSS_PD_ALGORITHM_H
+
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "mesh-obss-pd-algorithm.h"
+
+namespace ns3 {
+
+class Packet;
+class WifiMacHeader;
+
+/**
+ * \brief Multi-hop OBSS PD algorithm with an OBSS PD level per neighbor
+ * \ingroup wifi
+ *
+ * This OBSS_PD algorithm tells the OBSS frames apart as
+ * MeshObssPdAlgorithm does, but learns online, for each OBSS
+ * transmitter, the OBSS PD level under which the frames of the
+ * transmitter are ignored, instead of using one constant level.
+ *
+ * The first level of a transmitter is predicted from the path losses
+ * shared with ObssWifiManager, which this algorithm also feeds with the
+ * preambles it receives: it is the highest level whose TX power
+ * restriction still lets the frames to the next hop arrive SinrTarget dB
+ * above the frames of the transmitter. Until the next hop and the path
+ * losses are known, it is ObssPdLevel.
+ *
+ * The level is then corrected by the error rate of the frames sent while
+ * a frame of the transmitter is ignored, a frame being lost if no Ack or
+ * Block Ack is received before the next transmission. After every Window
+ * such frames, the level is lowered by the current step if their error
+ * rate is above PerTarget, raised otherwise, and the step is halved. The
+ * level of a transmitter hence settles after at most
+ * Window * (1 + log2 (InitialStep / MinStep)) frames.
+ */
+class AdaptiveObssPdAlgorithm : public MeshObssPdAlgorithm
+{
+public:
+  AdaptiveObssPdAlgorithm ();
+
+  static TypeId GetTypeId (void);
+
+  /**
+   * Connect the WifiNetDevice and setup eventual callbacks.
+   *
+   * \param device the WifiNetDevice
+   */
+  void ConnectWifiNetDevice (const Ptr<WifiNetDevice> device);
+
+  /**
+   * \param params the HE SIG parameters
+   *
+   * Evaluate the receipt of HE SIG.
+   */
+  void ReceiveHeSig (HePreambleParameters params);
+
+  /**
+   * Report the outcome of a frame sent while a frame of an OBSS
+   * transmitter was ignored.
+   *
+   * \param neighbor the node ID of the OBSS transmitter
+   * \param success whether the frame was acknowledged
+   */
+  void ReportTxOutcome (uint16_t neighbor, bool success);
+
+  /**
+   * \param neighbor the node ID of an OBSS transmitter
+   * \return the OBSS PD level (dBm) of the transmitter
+   */
+  double GetObssPdLevel (uint16_t neighbor) const;
+
+  /**
+   * \param neighbor the node ID of an OBSS transmitter
+   * \return true if the OBSS PD level of the transmitter has settled
+   */
+  bool IsSettled (uint16_t neighbor) const;
+
+  /**
+   * TracedCallback signature for the changes of the OBSS PD level of a
+   * neighbor.
+   *
+   * \param [in] neighbor The node ID of the OBSS transmitter
+   * \param [in] levelDbm The new OBSS PD level (dBm)
+   * \param [in] per The error rate of the frames of the last window
+   */
+  typedef void (* LevelTracedCallback)(uint16_t neighbor, double levelDbm, double per);
+
+private:
+  /// State of the OBSS PD level of an OBSS transmitter
+  struct Neighbor
+  {
+    bool known;         ///< whether a level was given to the transmitter
+    bool predicted;     ///< whether the level was predicted from the path losses
+    double level;       ///< OBSS PD level (dBm)
+    double step;        ///< next change of the level (dB)
+    uint32_t frames;    ///< frames sent in the current window
+    uint32_t failures;  ///< frames lost in the current window
+  };
+
+  /**
+   * \param neighbor the node ID of an OBSS transmitter
+   * \param level the first OBSS PD level of the transmitter, if it has none
+   * \return the state of the transmitter
+   */
+  Neighbor & GetNeighbor (uint16_t neighbor, double level);
+
+  /**
+   * Predict the OBSS PD level of a transmitter from the path losses
+   * between this node, its next hop and the transmitter.
+   *
+   * \param params the HE SIG parameters of a frame of the transmitter
+   * \param level the predicted OBSS PD level (dBm)
+   * \return false if there is no next hop or path loss yet
+   */
+  bool PredictObssPdLevel (HePreambleParameters params, double &level);
+
+  /**
+   * \param level an OBSS PD level (dBm)
+   * \return the level within ObssPdLevelMin and ObssPdLevelMax
+   */
+  double ClampObssPdLevel (double level) const;
+
+  /**
+   * Peek the MAC header of a frame of the PHY traces.
+   *
+   * \param packet the MPDU, with or without its A-MPDU subframe header
+   * \param hdr the MAC header
+   */
+  static void PeekMacHeader (Ptr<const Packet> packet, WifiMacHeader &hdr);
+
+  /**
+   * Resolve the previous frame and track the new one.
+   *
+   * \param packet the MPDU being transmitted
+   * \param txPowerW the TX power
+   */
+  void PhyTxBegin (Ptr<const Packet> packet, double txPowerW);
+
+  /**
+   * Acknowledge the previous frame.
+   *
+   * \param packet the MPDU received
+   */
+  void PhyRxEnd (Ptr<const Packet> packet);
+
+  double m_sinrTarget;    ///< SINR (dB) of the prediction of the first level
+  double m_perTarget;     ///< highest error rate for raising a level
+  uint32_t m_window;      ///< frames between two changes of a level
+  double m_initialStep;   ///< first change of a level (dB)
+  double m_minStep;       ///< smallest change of a level (dB)
+
+  std::vector<Neighbor> m_neighbors;  ///< state of the OBSS transmitters, indexed by node ID
+  uint16_t m_ignored;                 ///< node ID of the transmitter of the last ignored frame
+  Time m_ignoredEnd;                  ///< end of the last ignored frame
+  uint16_t m_pending;                 ///< node ID of the transmitter ignored by the unacknowledged frame
+  Time m_lastTx;                      ///< start of the last frame sent
+
+  TracedCallback<uint16_t, double, double> m_levelChange; ///< level change trace source
+};
+
+} //namespace ns3
+
+#endif /* ADAPTIVE_OBSS_PD_ALGORITHM_H */
@@ -0,0 +1,22 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_INTERNET_APPS
+    
+
+// Module headers:
+#include "dhcp-client.h"
+#include "dhcp-header.h"
+#include "dhcp-helper.h"
+#include "dhcp-server.h"
+#include "ping6-helper.h"
+#include "ping6.h"
+#include "radvd-helper.h"
+#include "radvd-interface.h"
+#include "radvd-prefix.h"
+#include "radvd.h"
+#include "v4ping-helper.h"
+#include "v4ping.h"
+#endif
@@ -0,0 +1,22 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_LR_WPAN
+    
+
+// Module headers:
+#include "lr-wpan-csmaca.h"
+#include "lr-wpan-error-model.h"
+#include "lr-wpan-helper.h"
+#include "lr-wpan-interference-helper.h"
+#include "lr-wpan-lqi-tag.h"
+#include "lr-wpan-mac-header.h"
+#include "lr-wpan-mac-trailer.h"
+#include "lr-wpan-mac.h"
+#include "lr-wpan-net-device.h"
+#include "lr-wpan-phy.h"
+#include "lr-wpan-spectrum-signal-parameters.h"
+#include "lr-wpan-spectrum-value-helper.h"
+#endif
@@ -0,0 +1,120 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2018 University of Washington
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Sébastien Deronne <sebastien.deronne@gmail.com>
+ */
+
+#ifndef MESH_OBSS_PD_ALGORITHM_H
+#define MESH_OBSS_PD_ALGORITHM_H
+
+#include "obss-pd-algorithm.h"
+#include "ns3/callback.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/mac48-address.h"
+
+namespace ns3 {
+
+/**
+ * \brief Multi-hop OBSS PD algorithm
+ * \ingroup wifi
+ *
+ * This OBSS_PD algorithm lets a mesh point ignore the frames of the
+ * other hops of a multi-hop network. Once a HE preamble and its header
+ * have been received by the PHY, the ReceiveHeSig method is triggered.
+ * The frame is intra-BSS if this device or its next hop towards the
+ * gateway sends or receives it, and OBSS otherwise. Without next hop,
+ * the algorithm falls back to comparing its own BSS color with the BSS
+ * color of the received preamble, so that the mesh neighborhoods colored
+ * by MeshHelper::AssignBssColors are each a BSS. If this is an OBSS
+ * frame, it compares the received RSSI with its configured OBSS_PD level
+ * value. The PHY then gets reset to IDLE state in case the received RSSI
+ * is lower than that constant OBSS PD level value, and is informed about
+ * TX power restrictions that might be applied to the next tranmission.
+ *
+ * The next hop is given by the routing protocol of the network through
+ * SetNextHopCallback, as the dot11s stack does with the HWMP path to
+ * the root. Otherwise, it is the next hop of the IPv4 route to the
+ * gateway, as found by AODV.
+ */
+class MeshObssPdAlgorithm : public ObssPdAlgorithm
+{
+public:
+  MeshObssPdAlgorithm ();
+
+  static TypeId GetTypeId (void);
+
+  /**
+   * Callback which returns, for the interface index of a device, the MAC
+   * address of the next hop of the device towards the gateway, a group
+   * address if there is none.
+   */
+  typedef Callback<Mac48Address, uint32_t> NextHopCallback;
+
+  /**
+   * Connect the WifiNetDevice and setup eventual callbacks.
+   *
+   * \param device the WifiNetDevice
+   */
+  void ConnectWifiNetDevice (const Ptr<WifiNetDevice> device);
+
+  /**
+   * \param params the HE SIG parameters
+   *
+   * Evaluate the receipt of HE SIG.
+   */
+  void ReceiveHeSig (HePreambleParameters params);
+
+  /**
+   * Set the callback which gives the next hop towards the gateway,
+   * instead of the IPv4 route to GatewayAddress.
+   *
+   * \param cb the callback
+   */
+  void SetNextHopCallback (NextHopCallback cb);
+
+  /**
+   * \param device the WifiNetDevice
+   * \param gateway the IPv4 address of the gateway
+   * \return the MAC address of the next hop of the IPv4 route of the
+   * device to the gateway, the broadcast address if there is no route
+   * or the MAC address of its next hop is not resolved yet
+   */
+  static Mac48Address GetIpv4NextHop (Ptr<WifiNetDevice> device, Ipv4Address gateway);
+
+protected:
+  /**
+   * \return the MAC address of the next hop of the device towards the
+   * gateway, a group address if there is none
+   */
+  Mac48Address GetNextHop (void) const;
+
+  /**
+   * \param params the HE SIG parameters
+   * \return true if the frame is OBSS: neither this device nor its next
+   * hop sends or receives it, or, without next hop, its BSS color is not
+   * the one of this device
+   */
+  bool IsObss (HePreambleParameters params);
+
+private:
+  Ipv4Address m_gateway;      ///< IPv4 address of the gateway
+  NextHopCallback m_nextHop;  ///< next hop given by the routing protocol
+};
+
+} //namespace ns3
+
+#endif /* MESH_OBSS_PD_ALGORITHM_H */
@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef OBSS_WIFI_MANAGER_H
+#define OBSS_WIFI_MANAGER_H
+
+#include "ns3/traced-value.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-net-device.h"
+#include "sta-wifi-mac.h"
+#include "wifi-remote-station-manager.h"
+#include "mesh-obss-pd-algorithm.h"
+#include "ns3/internet-module.h"
+#include "wifi-utils.h"
+
+class ObssWifiManagerTest;
+
+namespace ns3 {
+
+/**
+ * \brief Ideal rate control algorithm
+ * \ingroup wifi
+ *
+ * This class implements an 'ideal' rate control algorithm
+ * similar to RBAR in spirit (see <i>A rate-adaptive MAC
+ * protocol for multihop wireless networks</i> by G. Holland,
+ * N. Vaidya, and P. Bahl.): every station keeps track of the
+ * snr of every packet received and sends back this snr to the
+ * original transmitter by an out-of-band mechanism. Each
+ * transmitter keeps track of the last snr sent back by a receiver
+ * and uses it to pick a transmission mode based on a set
+ * of snr thresholds built from a target ber and transmission
+ * mode-specific snr/ber curves.
+ */
+class ObssWifiManager : public WifiRemoteStationManager
+{
+public:
+  /// Allow test cases to access private members
+  friend class ::ObssWifiManagerTest;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ObssWifiManager ();
+  virtual ~ObssWifiManager ();
+
+  void SetupPhy (const Ptr<WifiPhy> phy);
+
+  /**
+   * Set the callback which gives the next hop towards the gateway,
+   * instead of the IPv4 route to GatewayAddress.
+   *
+   * \param cb the callback
+   */
+  void SetNextHopCallback (MeshObssPdAlgorithm::NextHopCallback cb);
+
+  /// Selection of the TX power and MCS of the frames to the next hop
+  enum ObssPolicy
+  {
+    OBSS_POLICY_IDEAL, ///< the MCS of the last SNR, at the default TX power
+    OBSS_POLICY_JOINT  ///< the TX power and MCS of the best expected goodput of the active transmissions
+  };
+
+  /**
+   * Path losses (dB) towards a node, indexed by the node ID of the
+   * transmitter, UNKNOWN_PATH_LOSS if not heard yet
+   */
+  typedef std::vector<double> PathLosses;
+
+  static const double UNKNOWN_PATH_LOSS; ///< path loss of a pair of nodes not heard yet
+
+  /**
+   * Record the path loss between two nodes, learnt from the HE preamble
+   * of a frame, in the path losses shared by all the nodes, unless it is
+   * known already.
+   *
+   * \param dst the node ID of the receiver
+   * \param src the node ID of the transmitter
+   * \param loss the path loss (dB, negative)
+   * \return true if the path loss was recorded
+   */
+  static bool SetPathLoss (uint16_t dst, uint16_t src, double loss);
+
+  /**
+   * \param dst the node ID of the receiver
+   * \param src the node ID of the transmitter
+   * \return the path loss (dB, negative) between the two nodes,
+   * UNKNOWN_PATH_LOSS if the receiver has not heard the transmitter yet
+   */
+  static double GetPathLoss (uint16_t dst, uint16_t src);
+
+private:
+  //overridden from base class
+  void DoInitialize (void);
+  WifiRemoteStation* DoCreateStation (void) const;
+  void DoReportRxOk (WifiRemoteStation *station,
+                     double rxSnr, WifiMode txMode);
+  void DoReportRtsFailed (WifiRemoteStation *station);
+  void DoReportDataFailed (WifiRemoteStation *station);
+  void DoReportRtsOk (WifiRemoteStation *station,
+                      double ctsSnr, WifiMode ctsMode, double rtsSnr);
+  void DoReportDataOk (WifiRemoteStation *station,
+                       double ackSnr, WifiMode ackMode, double dataSnr);
+  void DoReportAmpduTxStatus (WifiRemoteStation *station,
+                              uint8_t nSuccessfulMpdus, uint8_t nFailedMpdus,
+                              double rxSnr, double dataSnr);
+  void DoReportFinalRtsFailed (WifiRemoteStation *station);
+  void DoReportFinalDataFailed (WifiRemoteStation *station);
+  WifiTxVector DoGetDataTxVector (WifiRemoteStation *station);
+  WifiTxVector DoGetRtsTxVector (WifiRemoteStation *station);
+  bool IsLowLatency (void) const;
+
+  /**
+   * Return the minimum SNR needed to successfully transmit
+   * data with this WifiTxVector at the specified BER.
+   *
+   * \param txVector WifiTxVector (containing valid mode, width, and nss)
+   *
+   * \return the minimum SNR for the given WifiTxVector
+   */
+  double GetSnrThreshold (WifiTxVector txVector) const;
+  /**
+   * Adds a pair of WifiTxVector and the minimum SNR for that given vector
+   * to the list.
+   *
+   * \param txVector the WifiTxVector storing mode, channel width, and nss
+   * \param snr the minimum SNR for the given txVector
+   */
+  void AddSnrThreshold (WifiTxVector txVector, double snr);
+
+  /**
+   * Convenience function for selecting a channel width for legacy mode
+   * \param mode legacy WifiMode
+   * \return the channel width (MHz) for the selected mode
+   */
+  uint16_t GetChannelWidthForMode (WifiMode mode) const;
+
+  void ReceiveHeSig (HePreambleParameters params);
+
+  void UpdatePathLoss(HePreambleParameters params);
+
+  void UpdateObssTransStatus(HePreambleParameters params);
+
+  void CheckObssStatus(HePreambleParameters params);
+
+  double GetSINR(uint16_t dst, double myTxpower);
+
+  double CalculateSnr (double signal, double noiseInterference, uint16_t channelWidth);
+
+  /**
+   * Build the tables of the success rate of each HE MCS and of the best
+   * HE MCS, against the SINR, for the channel width of the PHY.
+   */
+  void BuildGoodputTables (void);
+
+  /**
+   * \param sinrDb a SINR (dB)
+   * \return the index of the highest SINR of the goodput tables which
+   * does not exceed it
+   */
+  std::size_t GetSinrIndex (double sinrDb) const;
+
+  bool CheckRouting(HePreambleParameters params);
+
+  /**
+   * A vector of <snr, WifiTxVector> pair holding the minimum SNR for the
+   * WifiTxVector
+   */
+  typedef std::vector<std::pair<double, WifiTxVector> > Thresholds;
+
+  typedef std::tuple<uint16_t, uint16_t, Time, Time, double, uint8_t> ObssTran; //dst, src (node IDs), startTime, duration, txPower (dBm), mcs
+  typedef std::vector<ObssTran> ObssTrans;
+  typedef std::tuple<uint16_t, double, double, int> ReceiverInfo; // node ID (dst), interference(W), signal(W), Mcs
+  typedef std::vector<ReceiverInfo> ReceiverInfos;
+
+  /**
+   * Select the TX power level and HE MCS of the frames to the next hop
+   * which maximize the expected goodput of these frames and of the
+   * active transmissions, with a lookup in the goodput tables for each
+   * TX power level.  The TX power of a level is capped at the current
+   * TX power restriction of the PHY.
+   *
+   * \param recvinfos the next hop, then the receivers of the active
+   * transmissions
+   * \param until the end of the active transmissions
+   */
+  void SelectPowerAndMcs (const ReceiverInfos &recvinfos, Time until);
+
+  double m_ber;             //!< The maximum Bit Error Rate acceptable at any transmission mode
+  Thresholds m_thresholds;  //!< List of WifiTxVector and the minimum SNR pair
+
+  TracedValue<uint64_t> m_currentRate; //!< Trace rate changes
+
+  // #####
+  // obss pd
+  PathLosses m_pathLosses; // path losses towards this node
+  Ptr<WifiNetDevice> m_device;
+  bool m_obssRestricted;
+  ObssTrans m_obssTrans;
+  uint16_t m_nodeId;       ///< node ID of this node
+  uint16_t m_nextHopId;    ///< node ID of the next hop
+  Ipv4Address m_gateway;                          ///< IPv4 address of the gateway
+  MeshObssPdAlgorithm::NextHopCallback m_nextHop; ///< next hop given by the routing protocol
+
+  ObssPolicy m_policy;            ///< selection of the TX power and MCS
+  uint32_t m_frameSize;           ///< frame size (bytes) of the expected goodput
+  uint8_t m_obssPowerLimit;       ///< selected TX power level
+  uint8_t m_obssMcsLimit;         ///< selected HE MCS
+  Time m_obssRestrictedUntil;     ///< end of the transmissions of the selection
+  uint16_t m_goodputWidth;        ///< channel width (MHz) of the goodput tables
+  std::vector<WifiMode> m_heModes;   ///< HE modes, indexed by MCS
+  std::vector<uint64_t> m_heRates;   ///< data rates (b/s) of the HE modes, indexed by MCS
+  std::vector<std::vector<double> > m_successRates; ///< frame success rates, indexed by MCS and SINR
+  std::vector<uint8_t> m_bestMcs;    ///< MCS of the best expected goodput, indexed by SINR
+  std::vector<double> m_bestGoodput; ///< best expected goodput (b/s), indexed by SINR
+
+};
+
+} //namespace ns3
+
+#endif /* OBSS_WIFI_MANAGER_H */
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef REPLICATE_RUNNER_H
+#define REPLICATE_RUNNER_H
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ReplicateRunner declaration.
+ */
+
+#include <stdint.h>
+#include <cstddef>
+
+#include "callback.h"
+#include "non-copyable.h"
+#include "simulation-checkpoint.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ *
+ * Run several replications of a scenario built once.
+ *
+ * The scenario is built in the calling process, which is then forked
+ * once per replication.  Replication i sets the RngSeedManager run
+ * number to the first run plus i, restarts every existing random
+ * stream with it (RandomVariableStream::ResetAllStreams), then calls
+ * the replicate callback, which runs the simulation and records its
+ * results.  Read-only data of the scenario is shared between the
+ * processes by the operating system.
+ *
+ * Each replication records a fixed number of values in a table
+ * allocated in memory shared with the calling process, which can read
+ * them once Run returns:
+ *
+ * \code
+ *     void RunReplicate (ReplicateRunner *runner, uint32_t i)
+ *     {
+ *       Simulator::Stop (Seconds (totalTime));
+ *       Simulator::Run ();
+ *       runner->Record (0, sink->GetTotalRx ());
+ *       Simulator::Destroy ();
+ *     }
+ *
+ *     BuildScenario ();
+ *     ReplicateRunner runner (10, 1);
+ *     runner.Run (MakeBoundCallback (&RunReplicate, &runner));
+ *     for (uint32_t i = 0; i < 10; ++i)
+ *       {
+ *         if (runner.IsRecorded (i))
+ *           std::cout << runner.Get (i, 0) << std::endl;
+ *       }
+ *     Simulator::Destroy ();
+ * \endcode
+ *
+ * Values drawn while building the scenario, before Run, are the same
+ * in every replication; a replication is therefore not bit-identical
+ * to a separate run with the same run number when the construction
+ * itself draws random values.
+ */
+class ReplicateRunner : private NonCopyable
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] nReplicates The number of replications.
+   * \param [in] nValues The number of values recorded by each replication.
+   */
+  ReplicateRunner (uint32_t nReplicates, uint32_t nValues);
+  /** Destructor. */
+  ~ReplicateRunner ();
+
+  /**
+   * Set the maximum number of replications run at the same time.
+   * \param [in] maxParallel The number of replications, 0 for the
+   *             number of online processors.
+   */
+  void SetMaxParallel (uint32_t maxParallel);
+
+  /**
+   * Set the run number of the first replication.
+   * \param [in] run The run number, the current RngSeedManager run by default.
+   */
+  void SetFirstRun (uint64_t run);
+
+  /**
+   * \param [in] i The replication index.
+   * \return The run number of replication i.
+   */
+  uint64_t GetRun (uint32_t i) const;
+
+  /**
+   * Fork the replications and wait for them.
+   * \param [in] replicate The function run by each child with its index.
+   * \return The number of replications which exited successfully.
+   */
+  uint32_t Run (Callback<void, uint32_t> replicate);
+
+  /**
+   * Record a value of the replication of this process.
+   * \param [in] value The value index.
+   * \param [in] x The value.
+   */
+  void Record (uint32_t value, double x);
+
+  /**
+   * \param [in] i The replication index.
+   * \return True if replication i recorded at least one value.
+   */
+  bool IsRecorded (uint32_t i) const;
+
+  /**
+   * \param [in] i The replication index.
+   * \param [in] value The value index.
+   * \return The value recorded by replication i, 0 if none.
+   */
+  double Get (uint32_t i, uint32_t value) const;
+
+private:
+  /**
+   * Prepare the random streams of a replication and run it.
+   * \param [in] i The replication index.
+   */
+  void DoReplicate (uint32_t i);
+
+  uint32_t m_nReplicates;  //!< Number of replications.
+  uint32_t m_nValues;      //!< Number of values per replication.
+  uint64_t m_firstRun;     //!< Run number of the first replication.
+  SimulationCheckpoint m_checkpoint;  //!< Forks the replications.
+  Callback<void, uint32_t> m_replicate;  //!< Function run by each replication.
+  /**
+   * Shared table: one row per replication, holding a recorded flag
+   * followed by the values.
+   */
+  double *m_table;
+  std::size_t m_tableSize;  //!< Size of the table, in bytes.
+};
+
+} // namespace ns3
+
+#endif /* REPLICATE_RUNNER_H */
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+//  Copyright (C) 2001  Pierre L'Ecuyer (lecuyer@iro.umontreal.ca)
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+// Modified for ns-3 by: Rajib Bhattacharjea<raj.b@gatech.edu>
+
+#ifndef RNGSTREAM_H
+#define RNGSTREAM_H
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup rngimpl
+ * ns3::RngStream declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup randomvariable
+ * \defgroup rngimpl RNG Implementation
+ */
+  
+/**
+ * \ingroup rngimpl
+ *
+ * \brief Combined Multiple-Recursive Generator MRG32k3a
+ *
+ * This class is the combined multiple-recursive random number
+ * generator called MRG32k3a.  The ns3::RandomVariableBase class
+ * holds a static instance of this class.  The details of this
+ * class are explained in:
+ * http://www.iro.umontreal.ca/~lecuyer/myftp/papers/streams00.pdf
+ */
+class RngStream
+{
+public:
+  /**
+   * Construct from explicit seed, stream and substream values.
+   *
+   * \param [in] seed The starting seed.
+   * \param [in] stream The stream number.
+   * \param [in] substream The sub-stream number.
+   */
+  RngStream (uint32_t seed, uint64_t stream, uint64_t substream);
+  /**
+   * Copy constructor.
+   *
+   * \param [in] r The RngStream to copy.
+   */
+  RngStream (const RngStream & r);
+  /**
+   * Generate the next random number for this stream.
+   * Uniformly distributed between 0 and 1.
+   *
+   * The randoms are generated by blocks of BLOCK_SIZE, and buffered
+   * until they are consumed.  The sequence is the same as if they
+   * were generated one at a time.
+   *
+   * \returns The next random.
+   */
+  inline double RandU01 (void)
+  {
+    if (m_next == BLOCK_SIZE)
+      {
+        GenerateBlock (m_buffer);
+        m_next = 0;
+      }
+    return m_buffer[m_next++];
+  }
+  /**
+   * Generate the next \p count random numbers for this stream,
+   * as that many calls to RandU01 (void) would.
+   *
+   * \param [out] values The array to fill with the randoms.
+   * \param [in] count The number of randoms.
+   */
+  void RandU01 (double values[], std::size_t count);
+
+  /** The number of randoms generated at once. */
+  static const uint32_t BLOCK_SIZE = 16;
+
+private:
+  /**
+   * Generate the next BLOCK_SIZE randoms from the RNG state, and
+   * advance the state past them.
+   *
+   * \param [out] values The array to fill with the randoms.
+   */
+  void GenerateBlock (double values[BLOCK_SIZE]);
+  /**
+   * Advance \p state of the RNG by leaps and bounds.
+   *
+   * \param [in] nth The stream or substream index.
+   * \param [in] by The log2 base of \p nth.
+   * \param [in] state The state vector to advance.
+   */
+  void AdvanceNthBy (uint64_t nth, int by, double state[6]);
+
+  /** The RNG state vector. */
+  double m_currentState[6];
+  /** The randoms generated ahead of the RNG state. */
+  double m_buffer[BLOCK_SIZE];
+  /** The index of the next random to return in m_buffer. */
+  uint32_t m_next;
+};
+
+} // namespace ns3
+
+#endif
+ 
+
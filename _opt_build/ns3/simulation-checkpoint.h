@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATION_CHECKPOINT_H
+#define SIMULATION_CHECKPOINT_H
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::SimulationCheckpoint declaration.
+ */
+
+#include "callback.h"
+#include "nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ *
+ * Run a simulation up to a checkpoint, then continue it in several
+ * branches.
+ *
+ * The simulation is run up to the checkpoint time in the calling
+ * process, which is then forked once per branch.  Each child process
+ * starts from an exact copy of the simulator state at the checkpoint
+ * (nodes, devices, routing tables, pending events and random streams),
+ * calls the branch callback with its index and exits.  The callback is
+ * expected to apply the variation of its branch, run the simulation to
+ * its end and write its results.  The checkpoint itself lives in the
+ * memory of the calling process; it is not written to disk.
+ *
+ * Typical use is to share the warm-up of a scenario (route
+ * convergence, mesh peering) across the points of a parameter sweep:
+ *
+ * \code
+ *     void RunBranch (uint32_t i)
+ *     {
+ *       Config::Set ("/NodeList/ * /ApplicationList/ * /$ns3::OnOffApplication/DataRate",
+ *                    DataRateValue (rates[i]));
+ *       Simulator::Stop (Seconds (totalTime) - Simulator::Now ());
+ *       Simulator::Run ();
+ *       WriteResults (i);
+ *       Simulator::Destroy ();
+ *     }
+ *
+ *     SimulationCheckpoint checkpoint;
+ *     checkpoint.Branch (Seconds (startTime), rates.size (), MakeCallback (&RunBranch));
+ *     Simulator::Destroy ();
+ * \endcode
+ *
+ * Output streams are flushed before forking, so that buffered output
+ * is written once.  Branches writing to the same file must use
+ * distinct file names.  Only the default, single-threaded simulator
+ * implementation can be forked.
+ */
+class SimulationCheckpoint
+{
+public:
+  /** Constructor. */
+  SimulationCheckpoint ();
+
+  /**
+   * Set the maximum number of branches run at the same time.
+   * \param [in] maxParallel The number of branches, 0 for the number
+   *             of online processors.
+   */
+  void SetMaxParallel (uint32_t maxParallel);
+
+  /**
+   * Run the simulation up to the checkpoint, then fork the branches
+   * and wait for them.
+   *
+   * When this function returns, the simulator of the calling process
+   * is still at the checkpoint.
+   *
+   * \param [in] at The absolute checkpoint time, not earlier than now.
+   * \param [in] nBranches The number of branches.
+   * \param [in] branch The function run by each child with its index.
+   * \return The number of branches which exited successfully.
+   */
+  uint32_t Branch (Time at, uint32_t nBranches, Callback<void, uint32_t> branch);
+
+  /**
+   * \return The index of the branch run by this process, or -1 in the
+   *         process which took the checkpoint.
+   */
+  static int32_t GetBranchIndex (void);
+
+private:
+  uint32_t m_maxParallel;  //!< Maximum number of concurrent branches.
+  static int32_t m_branchIndex;  //!< Index of the branch of this process.
+};
+
+} // namespace ns3
+
+#endif /* SIMULATION_CHECKPOINT_H */
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLITE_SHARD_DATA_OUTPUT_H
+#define SQLITE_SHARD_DATA_OUTPUT_H
+
+#include <string>
+#include <vector>
+
+#include "data-collector.h"
+#include "sqlite-data-output.h"
+
+namespace ns3 {
+
+//------------------------------------------------------------
+//--------------------------------------------
+/**
+ * \ingroup dataoutput
+ * \class SqliteShardDataOutput
+ * \brief Outputs data to a per-run SQLite shard that is later merged
+ * into a single indexed database.
+ *
+ * Many simulation processes writing to the same SQLite file serialize
+ * on the database lock.  This class instead writes every run to its
+ * own file, named "<prefix>-shard-<id>.db", using the same tables as
+ * SqliteDataOutput (Experiments, Metadata and Singletons).  The shard
+ * id is the "ShardId" attribute if set, and the run label of the
+ * DataCollector otherwise, so concurrent replicates never share a
+ * file.
+ *
+ * Once the replicates are done, Compact merges every shard found next
+ * to the prefix into "<prefix>.db", replacing any rows previously
+ * merged for the same run labels, and indexes the run parameters
+ * stored as metadata.  FindRuns then selects runs by parameter value.
+ */
+class SqliteShardDataOutput : public SqliteDataOutput {
+public:
+  SqliteShardDataOutput();
+  virtual ~SqliteShardDataOutput();
+
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  virtual void Output (DataCollector &dc);
+
+  /**
+   * \param dc the DataCollector that would be output
+   * \return the name of the shard file dc would be written to
+   */
+  std::string GetShardFileName (const DataCollector &dc) const;
+
+  /**
+   * Merges every shard written with the current file prefix into
+   * "<prefix>.db".
+   *
+   * \param removeShards whether to delete the shards once merged
+   * \return the number of shards merged
+   */
+  uint32_t Compact (bool removeShards = true);
+
+  /**
+   * Finds the runs of the merged database whose metadata match all of
+   * the given key/value pairs.
+   *
+   * \param parameters the key/value pairs to match, as passed to
+   *        DataCollector::AddMetadata
+   * \return the matching run labels, sorted
+   */
+  std::vector<std::string> FindRuns (const MetadataList &parameters) const;
+
+private:
+  std::string m_shardId; //!< shard identifier, run label if empty
+
+  // end class SqliteShardDataOutput
+};
+
+// end namespace ns3
+};
+
+
+#endif /* SQLITE_SHARD_DATA_OUTPUT_H */
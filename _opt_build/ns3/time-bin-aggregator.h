@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIME_BIN_AGGREGATOR_H
+#define TIME_BIN_AGGREGATOR_H
+
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ns3/data-collection-object.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup aggregator
+ *
+ * \brief Sums values into fixed time windows and writes one
+ * tab-separated row per window, one column per data source.
+ *
+ * This aggregator is meant to replace the usual pattern of polling a
+ * set of counters (e.g. PacketSink::GetTotalRx) from an event that is
+ * rescheduled every monitoring interval.  Instead, every sample is
+ * accumulated into the window that contains the time it was produced
+ * at, and a window is closed only when the first sample of a later
+ * window arrives (or when Flush is called).  No simulator event is
+ * ever scheduled by this class.
+ *
+ * Each output row contains the end time of the window in seconds
+ * followed by the scaled sum of every column over that window.
+ * Windows in which no sample arrived are written with zero values,
+ * so the output is identical to that of a periodic poller stopped at
+ * the same time: Flush does not write the window ending at the current
+ * simulation time, which the last event of such a poller would not
+ * print either, unless "WriteLastWindow" is set.  Completed rows are
+ * kept in a memory buffer, and written synchronously to the output
+ * stream once "BufferRows" of them are pending, so that many columns
+ * can share a single stream without per-sample I/O.
+ *
+ * Samples can be fed either with Add, using a column index returned
+ * by AddColumn, or through Write2d, which has the signature of the
+ * TimeSeriesAdaptor "Output" trace source and uses the context
+ * string to select the column.
+ */
+class TimeBinAggregator : public DataCollectionObject
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \param outputFileName name of the file to write.
+   *
+   * Constructs an aggregator writing its rows to outputFileName.
+   */
+  TimeBinAggregator (const std::string &outputFileName);
+
+  /**
+   * \param os the stream to write to.
+   *
+   * Constructs an aggregator writing its rows to an existing stream,
+   * e.g. &std::cout.  The stream must outlive the aggregator.
+   */
+  TimeBinAggregator (std::ostream *os);
+
+  virtual ~TimeBinAggregator ();
+
+  /**
+   * \param heading the heading string.
+   *
+   * \brief Sets the heading string that will be printed before the
+   * first row.
+   *
+   * Only the first call has an effect.
+   */
+  void SetHeading (const std::string &heading);
+
+  /**
+   * \param context the name of the new column.
+   * \return the index of the new column.
+   *
+   * \brief Adds a column fed by Add or Write2d.
+   */
+  uint32_t AddColumn (const std::string &context);
+
+  /**
+   * \param context the name of the new column.
+   * \param value the value reported for every window.
+   * \return the index of the new column.
+   *
+   * \brief Adds a column that is not fed by any data source and
+   * reports the same value in every row, e.g. to keep column
+   * positions stable for sources that were not installed.
+   */
+  uint32_t AddConstantColumn (const std::string &context, double value);
+
+  /**
+   * \return the number of columns.
+   */
+  uint32_t GetNColumns (void) const;
+
+  /**
+   * \param column the column index returned by AddColumn.
+   * \param value the value to add to the current window.
+   *
+   * \brief Adds value to the window containing the current
+   * simulation time.
+   */
+  void Add (uint32_t column, double value);
+
+  /**
+   * \param context the name of the column.
+   * \param time the time of the sample, in seconds.
+   * \param value the value to add to the window containing time.
+   *
+   * \brief Trace sink for the TimeSeriesAdaptor "Output" trace source.
+   *
+   * A column is created on the fly for an unknown context.
+   */
+  void Write2d (std::string context, double time, double value);
+
+  /**
+   * \brief Closes every window that ended before the current simulation
+   * time, or at it if "WriteLastWindow" is set, and writes all pending
+   * rows to the stream.
+   *
+   * This is meant to be called once after Simulator::Run returns.
+   */
+  void Flush (void);
+
+private:
+  /**
+   * \param column the column index.
+   * \param time the time of the sample.
+   * \param value the value to add.
+   */
+  void DoAdd (uint32_t column, Time time, double value);
+
+  /**
+   * \param time a simulation time.
+   *
+   * \brief Closes every window that ends at or before time.
+   */
+  void AdvanceTo (Time time);
+
+  /// Appends the row of the current window to the buffer and resets it.
+  void CloseWindow (void);
+
+  /// Writes the buffered rows to the stream.
+  void WriteRows (void);
+
+  std::ofstream m_file;   //!< output file, if constructed from a file name
+  std::ostream *m_os;     //!< the stream rows are written to
+
+  Time m_interval;        //!< window length
+  Time m_startTime;       //!< start of the first window
+  double m_scale;         //!< factor applied to the window sums
+  uint32_t m_bufferRows;  //!< number of rows buffered before writing
+  bool m_writeLastWindow; //!< whether Flush writes the window ending at the current time
+
+  bool m_started;         //!< whether the first window has been opened
+  Time m_windowEnd;       //!< end of the current window
+
+  std::vector<double> m_sums;         //!< per-column sums of the current window
+  std::vector<bool> m_constant;       //!< whether a column has a constant value
+  std::map<std::string, uint32_t> m_columns; //!< column index by context
+
+  bool m_hasHeadingBeenSet; //!< whether the heading has been set
+  std::ostringstream m_buffer; //!< rows waiting to be written
+  uint32_t m_pendingRows; //!< number of rows in m_buffer
+};
+
+} // namespace ns3
+
+#endif // TIME_BIN_AGGREGATOR_H
@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# Validate the abstracted PHY against YansWifiPhy: run the same mesh grids
+# with both PHY models and print, for each grid, the mean aggregate
+# throughput (Mbps) over the seeds and the mean wall time of a run.
+
+./waf
+
+dirout="my-simulations/2_throughput/output/abstract-phy/"
+rrstart=1
+rrend=6
+
+mkdir -p "${dirout}"
+
+for gg in 2 3 4
+do
+  aa=$((gg*gg))
+  appl=$(seq -s+ 1 $((aa-1)))
+  for phy in yans abstract
+  do
+    for ((rr=${rrstart}; rr<=${rrend}; rr=rr+1))
+    do
+      out="${dirout}grid_${aa}_${phy}_${rr}.txt"
+      if [ ! -f "${out}" ]; then
+        start=$(date +%s%N)
+        ./waf --run "mesh-loc-jw --phy=${phy} --RngRun=${rr} --gridSize=${gg} --apNum=${aa} --apXStep=10 --apYStep=10 --gateways=0 --appl=${appl} --app=udp --datarate=5e5 --rateControl=ideal --totalTime=30" &> "${out}"
+        end=$(date +%s%N)
+        echo "wall $(( (end-start)/1000000 ))" >> "${out}"
+      fi
+    done
+    # Aggregate throughput of each second, then mean over the seconds and seeds
+    cat ${dirout}grid_${aa}_${phy}_*.txt | awk -F'\t' -v grid=${aa} -v phy=${phy} '
+      /^[0-9]+\.00\t/ { s=0; for (i=2; i<=NF; i++) if ($i>=0) s+=$i; tot+=s; n++ }
+      /^wall / { split($0, w, " "); wall+=w[2]; runs++ }
+      END { printf "grid %d %-8s throughput %.3f Mbps wall %d ms\n", grid, phy, tot/n, wall/runs }'
+  done
+done
@@ -0,0 +1,44 @@
+#!/bin/bash
+
+# Compare on-demand HWMP with the gateway as root of the HWMP proactive
+# tree, announced by proactive PREQs or by RANNs, on the 400-client
+# layouts: print, for each number of APs, the mean aggregate throughput
+# (Mbps) over the layouts and seeds and the mean wall time of a run.
+# The layouts are scaled down so that the 802.11ax mesh of mesh-loc-jw
+# connects their APs.
+
+./waf
+
+dirin="my-simulations/2_throughput/input/"
+dirout="my-simulations/2_throughput/output/mesh-root/"
+scale=20
+rrstart=1
+rrend=4
+
+mkdir -p "${dirout}"
+
+for ((aa=10; aa<=25; aa=aa+5))
+do
+  appl=$(seq -s+ 1 $((aa-1)))
+  for root in none preq rann
+  do
+    for ((dd=1; dd<=10; dd=dd+1))
+    do
+      for ((rr=${rrstart}; rr<=${rrend}; rr=rr+1))
+      do
+        out="${dirout}mesh_400_0_${aa}_${dd}_${root}_${rr}.txt"
+        if [ ! -f "${out}" ]; then
+          start=$(date +%s%N)
+          ./waf --run "mesh-loc-jw --meshRoot=${root} --RngRun=${rr} --apNum=${aa} --locationFile=${dirin}location_400_0_${aa}_${dd}.txt --scale=${scale} --gateways=0 --appl=${appl} --app=udp --datarate=2e5 --rateControl=ideal --totalTime=60" &> "${out}"
+          end=$(date +%s%N)
+          echo "wall $(( (end-start)/1000000 ))" >> "${out}"
+        fi
+      done
+    done
+    # Aggregate throughput of each second, then mean over the seconds, layouts and seeds
+    cat ${dirout}mesh_400_0_${aa}_*_${root}_*.txt | awk -F'\t' -v aps=${aa} -v root=${root} '
+      /^[0-9]+\.00\t/ { s=0; for (i=2; i<=NF; i++) if ($i>=0) s+=$i; tot+=s; n++ }
+      /^wall / { split($0, w, " "); wall+=w[2]; runs++ }
+      END { printf "aps %d %-5s throughput %.3f Mbps wall %d ms\n", aps, root, tot/n, wall/runs }'
+  done
+done
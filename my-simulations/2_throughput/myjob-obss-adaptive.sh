@@ -0,0 +1,45 @@
+#!/bin/bash
+
+# Compare the OBSS PD levels swept by hand with the level learnt for each
+# neighbor by the adaptive OBSS PD algorithm, on the 802.11ax mesh of the
+# 400-client layouts: print, for each number of APs and each constant
+# level, then for the adaptive algorithm, the mean aggregate throughput
+# (Mbps) over the layouts and seeds.  The layouts are scaled down so that
+# the OBSS frames of the mesh are heard.
+
+./waf
+
+dirin="my-simulations/2_throughput/input/"
+dirout="my-simulations/2_throughput/output/obss-adaptive/"
+scale=10
+rrstart=1
+rrend=4
+
+mkdir -p "${dirout}"
+
+for ((aa=10; aa<=25; aa=aa+5))
+do
+  appl=$(seq -s+ 1 $((aa-1)))
+  for level in -82 -77 -72 -67 -62 adaptive
+  do
+    if [ "${level}" = adaptive ]; then
+      obss="--obssLevel=-72 --obssAdaptive=1"
+    else
+      obss="--obssLevel=${level}"
+    fi
+    for ((dd=1; dd<=10; dd=dd+1))
+    do
+      for ((rr=${rrstart}; rr<=${rrend}; rr=rr+1))
+      do
+        out="${dirout}mesh_400_0_${aa}_${dd}_${level}_${rr}.txt"
+        if [ ! -f "${out}" ]; then
+          ./waf --run "mesh-loc-jw --mac=mesh --meshRoot=preq --isObss=1 ${obss} --RngRun=${rr} --apNum=${aa} --locationFile=${dirin}location_400_0_${aa}_${dd}.txt --scale=${scale} --gateways=0 --appl=${appl} --app=udp --datarate=2e6 --rateControl=ideal --totalTime=40" &> "${out}"
+        fi
+      done
+    done
+    # Aggregate throughput of each second, then mean over the seconds, layouts and seeds
+    cat ${dirout}mesh_400_0_${aa}_*_${level}_*.txt | awk -F'\t' -v aps=${aa} -v level=${level} '
+      /^[0-9]+\.00\t/ { s=0; for (i=2; i<=NF; i++) if ($i>=0) s+=$i; tot+=s; n++ }
+      END { printf "aps %d %-8s throughput %.3f Mbps\n", aps, level, tot/n }'
+  done
+done
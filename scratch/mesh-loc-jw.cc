@@ -6,6 +6,7 @@
  * Flow monitor - delay
  */
 
+#include <cstdio>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
@@ -23,6 +24,8 @@
 #include "ns3/netanim-module.h"
 #include "ns3/olsr-module.h"
 #include "ns3/point-to-point-module.h"
+#include "ns3/stats-module.h"
+#include "ns3/topology-read-module.h"
 #include "ns3/wifi-module.h"
 #include "ns3/mesh-module.h"
 #include "ns3/v4ping-helper.h"
@@ -32,32 +35,12 @@
 using namespace ns3;
 
 /// throughput monitor
-std::vector<uint64_t> lastTotalRx;
-std::vector<double> throughput;
 std::vector<Ptr<PacketSink>> packetSink;
 
-double
-CalculateSingleStreamThroughput (Ptr<PacketSink> sink, uint64_t &lastTotalRx, double monitorInterval)
-{
-  double thr = (sink->GetTotalRx () - lastTotalRx) * (double) 8/1e6 / monitorInterval;
-  lastTotalRx = sink->GetTotalRx ();
-  return thr;
-}
-
 void
-CalculateThroughput (double monitorInterval)
+SinkRx (Ptr<TimeBinAggregator> monitor, uint32_t column, Ptr<const Packet> packet, const Address &from)
 {
-  std::cout << Simulator::Now ().GetSeconds ();
-  for (uint32_t i = 0; i < packetSink.size (); ++i)
-    {
-      if (packetSink[i] == NULL)
-        throughput[i] = -1;
-      else
-        throughput[i] = CalculateSingleStreamThroughput (packetSink[i], lastTotalRx[i], monitorInterval);
-      std::cout << '\t' << throughput[i];
-    }
-  std::cout << std::endl;
-  Simulator::Schedule (Seconds (monitorInterval), &CalculateThroughput, monitorInterval);
+  monitor->Add (column, packet->GetSize ());
 }
 
 void
@@ -96,6 +79,7 @@ private:
   double monitorInterval;
   bool anim;
   std::string flowout;
+  std::string resultsPrefix;
   bool pcap;
   // Layout parameters
   std::string locationFile;
@@ -106,9 +90,14 @@ private:
   double apYStep;
   double clStep;
   std::string gateways;
+  // PHY parameters
+  std::string phy;
   // MAC parameters
   bool linkFail;
   std::string mac;
+  std::string meshRoot;
+  uint32_t meshRadios;
+  bool multiChannel;
   // Rate adaptation parameters
   std::string rateControl;
   std::string constantRate;
@@ -122,9 +111,14 @@ private:
   double startTime;
   double datarate;
   bool datarateUp;
+  std::string sweepDatarates;
+  uint32_t replicates;
   // obss pd
   bool isObss;
   double obssLevel;
+  bool obssAdaptive;
+  std::string obssPolicy;
+  double bssColorRange;
   // network
   /// nodes used in the example
   NodeContainer apNodes;
@@ -141,10 +135,16 @@ private:
   ApplicationContainer serverApps;
   ApplicationContainer clientApps;
   /// specified real implementation
-  std::vector<std::vector<double>> locations;
+  Ptr<BinaryTopologyReader> locations;
   NodeContainer csmaNodes;
   NetDeviceContainer csmaDevices;
   Ipv4InterfaceContainer csmaInterfaces;
+  /// monitoring
+  Ptr<TimeBinAggregator> throughputMonitor;
+  FlowMonitorHelper flowmon;
+  Ptr<FlowMonitor> monitor;
+  std::vector<double> sweep;
+  ReplicateRunner *replicateRunner;
 
 private:
   void CreateVariables ();
@@ -164,6 +164,14 @@ private:
   void CreateCsmaDevices ();
   void ReadLocations ();
   void PreSetStationManager ();
+  /// Send the output of a forked run to files named after suffix
+  void RedirectOutput (std::string suffix);
+  /// Run one sweep point from the warm-up checkpoint
+  void RunSweepPoint (uint32_t i);
+  /// Run one replication of the scenario
+  void RunReplicate (uint32_t i);
+  /// Write the results of the run
+  void WriteResults ();
 };
 
 int main (int argc, char **argv)
@@ -186,6 +194,7 @@ AodvExample::AodvExample () :
   monitorInterval (1),
   anim (false),
   flowout ("out-flow.xml"),
+  resultsPrefix (""),
   pcap (false),
   // Layout parameters
   locationFile (""),
@@ -196,9 +205,14 @@ AodvExample::AodvExample () :
   apYStep (30),
   clStep (10),
   gateways ("0"),
+  // PHY parameters
+  phy ("yans"),
   // MAC parameters
   linkFail (false),
   mac ("mesh"),
+  meshRoot ("none"),
+  meshRadios (1),
+  multiChannel (false),
   // Rate adaptation parameters
   rateControl ("constant"),
   constantRate ("VhtMcs0"),
@@ -212,8 +226,14 @@ AodvExample::AodvExample () :
   startTime (10),
   datarate (1e6),
   datarateUp (false),
+  sweepDatarates (""),
+  replicates (0),
   isObss(false),
-  obssLevel(-62)
+  obssLevel(-62),
+  obssAdaptive(false),
+  obssPolicy("Ideal"),
+  bssColorRange(100),
+  replicateRunner (0)
 {
 }
 
@@ -232,6 +252,7 @@ AodvExample::Configure (int argc, char **argv)
   cmd.AddValue ("monitorInterval", "Monitor interval, s.", monitorInterval);
   cmd.AddValue ("anim", "Output netanim .xml file or not.", anim);
   cmd.AddValue ("flowout", "Result output directory", flowout);
+  cmd.AddValue ("resultsPrefix", "Prefix of the sqlite result shards, disabled if empty.", resultsPrefix);
   cmd.AddValue ("pcap", "Write PCAP traces.", pcap);
 
   cmd.AddValue ("locationFile", "Location file name.", locationFile);
@@ -243,8 +264,12 @@ AodvExample::Configure (int argc, char **argv)
   cmd.AddValue ("clStep", "CL range around AP.", clStep);
   cmd.AddValue ("gateways", "Index of gateway AP.", gateways);
 
+  cmd.AddValue ("phy", "PHY model--yans/abstract.", phy);
   cmd.AddValue ("linkFail", "Enable link failure model or not.", linkFail);
   cmd.AddValue ("mac", "MAC type", mac);
+  cmd.AddValue ("meshRoot", "HWMP gateway tree--none/preq/rann.", meshRoot);
+  cmd.AddValue ("meshRadios", "Number of mesh interfaces of each AP, on non-overlapping channels.", meshRadios);
+  cmd.AddValue ("multiChannel", "Split the frames to a next hop between its channels or not.", multiChannel);
 
   cmd.AddValue ("rateControl", "Rate control--constant/ideal/minstrel.", rateControl);
   cmd.AddValue ("constantRate", "Rate used for ConstantRateManager.", constantRate);
@@ -258,11 +283,41 @@ AodvExample::Configure (int argc, char **argv)
   cmd.AddValue ("startTime", "Application start time, s.", startTime);
   cmd.AddValue ("datarate", "Tested application datarate.", datarate);
   cmd.AddValue ("datarateUp", "Increase datarate or not.", datarateUp);
+  cmd.AddValue ("sweepDatarates", "Comma-separated datarates run from one warm-up, "
+                "each writing to its own flowout and results shard.", sweepDatarates);
+  cmd.AddValue ("replicates", "Number of runs forked from one scenario build, "
+                "starting at RngRun, each writing to its own flowout and results shard.", replicates);
   cmd.AddValue ("isObss", "Use obss pd or not", isObss);
   cmd.AddValue ("obssLevel", "Obss pd thershold level", obssLevel);
+  cmd.AddValue ("obssPolicy", "TX power and MCS selection of rateControl=obss--Ideal/Joint", obssPolicy);
+  cmd.AddValue ("obssAdaptive", "Learn the obss pd level of each neighbor, starting from obssLevel (mesh only)", obssAdaptive);
+  cmd.AddValue ("bssColorRange", "Radius (m) of the mesh neighborhoods of a HE BSS color", bssColorRange);
 
   cmd.Parse (argc, argv);
 
+  std::replace (sweepDatarates.begin (), sweepDatarates.end (), ',', ' ');
+  std::istringstream sweepStream (sweepDatarates);
+  double rate;
+  while (sweepStream >> rate)
+    sweep.push_back (rate);
+  if (!sweep.empty () && datarateUp)
+    {
+      std::cerr << "sweepDatarates and datarateUp cannot be combined\n";
+      return false;
+    }
+  if (!sweep.empty () && replicates > 0)
+    {
+      std::cerr << "sweepDatarates and replicates cannot be combined\n";
+      return false;
+    }
+#ifndef STATS_HAS_SQLITE3
+  if (!resultsPrefix.empty ())
+    {
+      std::cerr << "resultsPrefix needs the sqlite support of the stats module\n";
+      return false;
+    }
+#endif
+
   return true;
 }
 
@@ -283,14 +338,120 @@ AodvExample::Run ()
   if (!anim)
     netanim.SetStopTime (Seconds (0));
 
-  FlowMonitorHelper flowmon;
-  Ptr<FlowMonitor> monitor = flowmon.InstallAll ();
+  monitor = flowmon.InstallAll ();
+
+  throughputMonitor = CreateObject<TimeBinAggregator> (&std::cout);
+  throughputMonitor->SetAttribute ("Interval", TimeValue (Seconds (monitorInterval)));
+  throughputMonitor->SetAttribute ("StartTime", TimeValue (Seconds (startTime)));
+  throughputMonitor->SetAttribute ("Scale", DoubleValue ((double) 8/1e6 / monitorInterval));
+  //Rows are written as soon as they are complete, among the other output of the run
+  throughputMonitor->SetAttribute ("BufferRows", UintegerValue (1));
+  for (uint32_t i = 0; i < packetSink.size (); ++i)
+    {
+      std::ostringstream name;
+      name << "cl-" << i;
+      if (packetSink[i] == NULL)
+        throughputMonitor->AddConstantColumn (name.str (), -1);
+      else
+        packetSink[i]->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&SinkRx, throughputMonitor,
+                                                                            throughputMonitor->AddColumn (name.str ())));
+    }
+
+  if (!sweep.empty ())
+    {
+      // The warm-up before startTime does not depend on the datarate;
+      // run it once and continue each sweep point from there.
+      SimulationCheckpoint checkpoint;
+      uint32_t succeeded = checkpoint.Branch (Seconds (startTime), sweep.size (),
+                                              MakeCallback (&AodvExample::RunSweepPoint, this));
+      std::cout << succeeded << " of " << sweep.size () << " sweep points done\n";
+      Simulator::Destroy ();
+      return;
+    }
 
   Simulator::Schedule (Seconds (startTime), &PrintThroughputTitle, apNum);
-  Simulator::Schedule (Seconds (startTime+monitorInterval), &CalculateThroughput, monitorInterval);
+  if (replicates > 0)
+    {
+      // The scenario is built once; each replication only changes the
+      // run number of the random streams.
+      ReplicateRunner runner (replicates, apNum);
+      replicateRunner = &runner;
+      uint32_t succeeded = runner.Run (MakeCallback (&AodvExample::RunReplicate, this));
+      std::cout << succeeded << " of " << replicates << " replications done\n";
+      std::cout << "Run";
+      for (uint32_t j = 0; j < apNum; ++j)
+        std::cout << "\tcl-" << j;
+      std::cout << '\n';
+      for (uint32_t i = 0; i < replicates; ++i)
+        {
+          if (!runner.IsRecorded (i))
+            continue;
+          std::cout << runner.GetRun (i);
+          for (uint32_t j = 0; j < apNum; ++j)
+            std::cout << '\t' << (packetSink[j] == NULL ? -1 : runner.Get (i, j));
+          std::cout << '\n';
+        }
+      replicateRunner = 0;
+      Simulator::Destroy ();
+      return;
+    }
+  Simulator::Stop (Seconds (totalTime));
+  Simulator::Run ();
+  WriteResults ();
+  Simulator::Destroy ();
+}
+
+void
+AodvExample::RedirectOutput (std::string suffix)
+{
+  std::string::size_type dot = flowout.rfind ('.');
+  if (dot == std::string::npos || flowout.find ('/', dot) != std::string::npos)
+    dot = flowout.size ();
+  std::string base = flowout.substr (0, dot) + suffix;
+  flowout = base + flowout.substr (dot);
+  if (std::freopen ((base + ".txt").c_str (), "w", stdout) == NULL)
+    NS_FATAL_ERROR ("Cannot redirect the output to " << base << ".txt");
+}
+
+void
+AodvExample::RunReplicate (uint32_t i)
+{
+  std::ostringstream suffix;
+  suffix << "-run" << RngSeedManager::GetRun ();
+  RedirectOutput (suffix.str ());
 
   Simulator::Stop (Seconds (totalTime));
   Simulator::Run ();
+  WriteResults ();
+  for (uint32_t j = 0; j < apNum; ++j)
+    {
+      if (packetSink[j] != NULL)
+        replicateRunner->Record (j, (double) packetSink[j]->GetTotalRx () * 8/1e6 / (totalTime - startTime));
+    }
+  Simulator::Destroy ();
+}
+
+void
+AodvExample::RunSweepPoint (uint32_t i)
+{
+  datarate = sweep[i];
+  std::ostringstream suffix;
+  suffix << "-" << datarate;
+  RedirectOutput (suffix.str ());
+
+  Config::Set ("/NodeList/*/ApplicationList/*/$ns3::OnOffApplication/DataRate",
+               DataRateValue (DataRate ((uint64_t) (datarate))));
+  PrintThroughputTitle (apNum);
+  Simulator::Stop (Seconds (totalTime) - Simulator::Now ());
+  Simulator::Run ();
+  WriteResults ();
+  Simulator::Destroy ();
+}
+
+void
+AodvExample::WriteResults ()
+{
+  throughputMonitor->Flush ();
 
   monitor->CheckForLostPackets ();
   Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (flowmon.GetClassifier ());
@@ -319,7 +480,43 @@ AodvExample::Run ()
 
   monitor->SerializeToXmlFile(flowout, false, false);
 
-  Simulator::Destroy ();
+  if (!resultsPrefix.empty ())
+    {
+      std::ostringstream run;
+      run << locationFile << "-" << gateways << "-" << datarate << "-" << RngSeedManager::GetRun ();
+      DataCollector data;
+      data.DescribeRun ("mesh-loc-jw", route + "-" + app, locationFile, run.str ());
+      data.AddMetadata ("locationFile", locationFile);
+      data.AddMetadata ("apNum", apNum);
+      data.AddMetadata ("gateways", gateways);
+      data.AddMetadata ("mac", mac);
+      data.AddMetadata ("route", route);
+      data.AddMetadata ("app", app);
+      data.AddMetadata ("rateControl", rateControl);
+      data.AddMetadata ("obssPolicy", obssPolicy);
+      data.AddMetadata ("datarate", datarate);
+      data.AddMetadata ("obssLevel", isObss ? obssLevel : 0);
+      data.AddMetadata ("obssAdaptive", (uint32_t) (isObss && obssAdaptive));
+      data.AddMetadata ("seed", RngSeedManager::GetSeed ());
+      data.AddMetadata ("run", (uint32_t) RngSeedManager::GetRun ());
+      for (uint32_t i = 0; i < packetSink.size (); ++i)
+        {
+          if (packetSink[i] == NULL)
+            continue;
+          std::ostringstream key;
+          key << "cl-" << i;
+          Ptr<MinMaxAvgTotalCalculator<double> > thr = CreateObject<MinMaxAvgTotalCalculator<double> > ();
+          thr->SetKey ("throughput");
+          thr->SetContext (key.str ());
+          thr->Update ((double) packetSink[i]->GetTotalRx () * 8/1e6 / (totalTime - startTime));
+          data.AddDataCalculator (thr);
+        }
+#ifdef STATS_HAS_SQLITE3
+      Ptr<SqliteShardDataOutput> output = CreateObject<SqliteShardDataOutput> ();
+      output->SetFilePrefix (resultsPrefix);
+      output->Output (data);
+#endif
+    }
 }
 
 void
@@ -330,15 +527,10 @@ AodvExample::Report (std::ostream &)
 void
 AodvExample::CreateVariables ()
 {  
-  lastTotalRx.reserve (apNum);
-  throughput.reserve (apNum);
   packetSink.reserve (apNum);
 
   for (uint32_t i = 0; i < apNum; ++i)
     {
-      locations.push_back (std::vector<double> (4, 0));
-      lastTotalRx.push_back (0);
-      throughput.push_back (0);
       packetSink.push_back (NULL);
     }
 
@@ -370,9 +562,9 @@ AodvExample::CreateApNodes ()
     }
 
   // Create static grid
-  MobilityHelper mobility;
   if (locationFile.empty ())
     {
+      MobilityHelper mobility;
       mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
                                      "MinX", DoubleValue (0.0),
                                      "MinY", DoubleValue (0.0),
@@ -380,21 +572,18 @@ AodvExample::CreateApNodes ()
                                      "DeltaY", DoubleValue (apYStep),
                                      "GridWidth", UintegerValue (gridSize),
                                      "LayoutType", StringValue ("RowFirst"));
+      mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+      mobility.Install (apNodes);
     }
   else
     {
-      if (locations.size () < apNum)
+      if (locations == 0 || locations->GetNNodes () < apNum)
         {
           std::cout << "Number of locations is not enough !!!\n";
           std::exit (0);
         }
-      Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
-      for (uint32_t i = 0; i < apNum; i++)
-        positionAlloc->Add (Vector (locations[i][0] * scale/100, locations[i][1] * scale/100, locations[i][2]));
-      mobility.SetPositionAllocator (positionAlloc);
+      locations->InstallPositions (apNodes, Vector (scale/100, scale/100, 1));
     }
-  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
-  mobility.Install (apNodes);
 
   std::cout << "CreateApNodes () DONE !!!\n";
 }
@@ -461,8 +650,23 @@ AodvExample::CreateMeshDevices ()
                                       "Period", StringValue ("ns3::ConstantRandomVariable[Constant=5.0]"));
     }
 
-  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
-  wifiPhy.SetChannel (wifiChannel.Create ());
+  YansWifiPhyHelper yansPhy = YansWifiPhyHelper::Default ();
+  AbstractWifiPhyHelper abstractPhy = AbstractWifiPhyHelper::Default ();
+  WifiPhyHelper *phyHelper;
+  if (phy == std::string ("abstract"))
+    {
+      // The abstracted channel keeps a table of the link losses, the link
+      // failure models would change them under it
+      NS_ABORT_MSG_IF (linkFail, "The abstracted PHY does not support link failures");
+      abstractPhy.SetChannel (AbstractWifiChannelHelper::Default ().Create ());
+      phyHelper = &abstractPhy;
+    }
+  else
+    {
+      yansPhy.SetChannel (wifiChannel.Create ());
+      phyHelper = &yansPhy;
+    }
+  WifiPhyHelper &wifiPhy = *phyHelper;
   wifiPhy.Set ("ChannelNumber", UintegerValue (38));
   wifiPhy.Set ("Antennas", UintegerValue (4));
   wifiPhy.Set ("MaxSupportedTxSpatialStreams", UintegerValue (4));
@@ -497,11 +701,19 @@ AodvExample::CreateMeshDevices ()
       Config::SetDefault ("ns3::dot11s::HwmpProtocol::RfFlag", BooleanValue (true));
       Config::SetDefault ("ns3::dot11s::HwmpProtocol::MaxTtl", UintegerValue (2));
 
-      mesh.SetSpreadInterfaceChannels (MeshHelper::ZERO_CHANNEL);
+      Config::SetDefault ("ns3::dot11s::HwmpProtocol::MultiChannelForwarding", BooleanValue (multiChannel));
+
+      mesh.SetSpreadInterfaceChannels (meshRadios > 1 ? MeshHelper::SPREAD_CHANNELS : MeshHelper::ZERO_CHANNEL);
+      mesh.SetNumberOfInterfaces (meshRadios);
       mesh.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
       if (rateControl == std::string ("ideal"))
         mesh.SetRemoteStationManager ("ns3::IdealWifiManager",
                                       "RtsCtsThreshold", UintegerValue (99999));
+      else if (rateControl == std::string ("obss"))
+        mesh.SetRemoteStationManager ("ns3::ObssWifiManager",
+                                      "RtsCtsThreshold", UintegerValue (99999),
+                                      "DefaultTxPowerLevel", UintegerValue(9),
+                                      "ObssPolicy", StringValue (obssPolicy));
       else if (rateControl == std::string ("minstrel"))
         mesh.SetRemoteStationManager ("ns3::MinstrelHtWifiManager",
                                       "RtsCtsThreshold", UintegerValue (99999));
@@ -516,7 +728,30 @@ AodvExample::CreateMeshDevices ()
                                       "ControlMode", StringValue ("HtMcs0"),
                                       "DataMode", StringValue (constantRate),
                                       "RtsCtsThreshold", UintegerValue (99999));
+      // The next hop of the spatial reuse is the one of the HWMP path to
+      // the root, see meshRoot
+      if (isObss)
+        mesh.SetObssPdAlgorithm (obssAdaptive ? "ns3::AdaptiveObssPdAlgorithm" : "ns3::MeshObssPdAlgorithm",
+                                 "ObssPdLevel", DoubleValue (obssLevel));
+      if (meshRoot == std::string ("rann"))
+        Config::SetDefault ("ns3::dot11s::HwmpProtocol::RootMode", StringValue ("Rann"));
+      if (meshRoot != std::string ("none"))
+        {
+          Config::SetDefault ("ns3::dot11s::HwmpProtocol::Dot11MeshHWMPrannInterval", TimeValue (MicroSeconds (1024*2000)));
+          Config::SetDefault ("ns3::dot11s::HwmpProtocol::RootPathRepair", BooleanValue (true));
+        }
       meshDevices = mesh.Install (wifiPhy, apNodes);
+
+      // The gateways are the roots of the HWMP proactive tree
+      if (meshRoot != std::string ("none"))
+        {
+          std::string roots (gateways);
+          std::replace (roots.begin (), roots.end (), '+', ' ');
+          std::istringstream rootStream (roots);
+          uint32_t root;
+          while (rootStream >> root)
+            meshDevices.Get (root)->GetObject<dot11s::HwmpProtocol> ()->SetRoot ();
+        }
     }
   else
     {
@@ -531,7 +766,8 @@ AodvExample::CreateMeshDevices ()
       else if (rateControl == std::string ("obss"))
         wifi.SetRemoteStationManager ("ns3::ObssWifiManager",
                                       "RtsCtsThreshold", UintegerValue (99999),
-                                      "DefaultTxPowerLevel", UintegerValue(9));
+                                      "DefaultTxPowerLevel", UintegerValue(9),
+                                      "ObssPolicy", StringValue (obssPolicy));
       else if (rateControl == std::string ("minstrel"))
         wifi.SetRemoteStationManager ("ns3::MinstrelHtWifiManager",
                                       "RtsCtsThreshold", UintegerValue (99999));
@@ -555,7 +791,12 @@ AodvExample::CreateMeshDevices ()
       meshDevices = wifi.Install (wifiPhy, wifiMac, apNodes);
     }
 
-    if(isObss)
+    if(isObss && mac == std::string ("mesh"))
+    {
+      // one HE BSS color per mesh neighborhood
+      MeshHelper::AssignBssColors (meshDevices, bssColorRange);
+    }
+    else if(isObss)
     {
       // set HE BSS color
       for (uint32_t i = 0; i < meshDevices.GetN (); i++)
@@ -785,11 +1026,11 @@ AodvExample::ReadLocations ()
   if (locationFile.empty ())
     return;
 
-  std::ifstream fin (locationFile);
-  if (fin.is_open ())
+  // The binary cache next to the location file is shared by replicates.
+  locations = CreateObject<BinaryTopologyReader> ();
+  locations->SetSourceFile (locationFile, "Location");
+  if (!locations->Load ())
     {
-      for (uint32_t i = 0; i < apNum; ++i)
-        fin >> locations[i][0] >> locations[i][1] >> locations[i][2];
-      fin.close ();
+      locations = 0;
     }
 }
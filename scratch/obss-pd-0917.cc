@@ -30,6 +30,7 @@
 #include "ns3/netanim-module.h"
 #include "ns3/olsr-module.h"
 #include "ns3/point-to-point-module.h"
+#include "ns3/topology-read-module.h"
 #include "ns3/wifi-module.h"
 #include "ns3/mesh-module.h"
 #include "ns3/v4ping-helper.h"
@@ -170,7 +171,7 @@ private:
 
   /// specified real implementation
   std::string locationFile;
-  std::vector<std::vector<double>> locations;
+  Ptr<BinaryTopologyReader> locations;
   uint32_t gateways;
   double scale;
   NodeContainer csmaNodes;
@@ -409,7 +410,6 @@ AodvExample::CreateVariables ()
       clDevices.push_back (NetDeviceContainer ());
       apInterfaces.push_back (Ipv4InterfaceContainer ());
       clInterfaces.push_back (Ipv4InterfaceContainer ());
-      locations.push_back (std::vector<double> (4, 0));
     }
   for (uint32_t i = 0; i < txNum; ++i)
     {
@@ -453,9 +453,9 @@ AodvExample::CreateApNodes ()
     }
 
   // Create static grid
-  MobilityHelper mobility;
   if (locationFile.empty ())
     {
+        MobilityHelper mobility;
         Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
         positionAlloc->Add (Vector (0.0, 0.0, 0.0));  // Node 1
         positionAlloc->Add (Vector (lengthStep, 0.0, 0.0));  // 2
@@ -464,21 +464,18 @@ AodvExample::CreateApNodes ()
         positionAlloc->Add (Vector (lengthStep, widthStep, 0.0));  // 5
         positionAlloc->Add (Vector (0.0, widthStep, 0.0));  // 6
         mobility.SetPositionAllocator (positionAlloc);
+        mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+        mobility.Install (apNodes);
     }
   else
     {
-      if (locations.size () < apNum)
+      if (locations == 0 || locations->GetNNodes () < apNum)
         {
           std::cout << "Number of locations is not enough !!!\n";
           std::exit (0);
         }
-      Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
-      for (uint32_t i = 0; i < apNum; i++)
-        positionAlloc->Add (Vector (locations[i][0] * scale/100, locations[i][1] * scale/100, locations[i][2]));
-      mobility.SetPositionAllocator (positionAlloc);
+      locations->InstallPositions (apNodes, Vector (scale/100, scale/100, 1));
     }
-  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
-  mobility.Install (apNodes);
 
   std::cout << "CreateApNodes () DONE !!!\n";
 }
@@ -1260,12 +1257,12 @@ AodvExample::ReadLocations ()
   if (locationFile.empty ())
     return;
 
-  std::ifstream fin (locationFile);
-  if (fin.is_open ())
+  // The binary cache next to the location file is shared by replicates.
+  locations = CreateObject<BinaryTopologyReader> ();
+  locations->SetSourceFile (locationFile, "Location");
+  if (!locations->Load ())
     {
-      for (uint32_t i = 0; i < apNum; ++i)
-        fin >> locations[i][0] >> locations[i][1] >> locations[i][2];
-      fin.close ();
+      locations = 0;
     }
 }
 
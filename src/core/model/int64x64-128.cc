@@ -17,6 +17,7 @@
  *
  */
 
+#include <algorithm>  // min
 #include "int64x64-128.h"
 #include "abort.h"
 #include "assert.h"
@@ -60,6 +61,46 @@ output_sign (const int128_t sa,
   return (negA && !negB) || (!negA && negB);
 }
 
+/**
+ * \ingroup highprec
+ * Count the trailing zero bits of a 128-bit value.
+ *
+ * \param [in] v The value.
+ * \returns The number of trailing zero bits, 128 if \pname{v} is zero.
+ */
+static inline
+uint64_t
+CountTrailingZeros (const uint128_t v)
+{
+  const uint64_t lo = v;
+  const uint64_t hi = v >> 64;
+  if (lo != 0)
+    {
+      return __builtin_ctzll (lo);
+    }
+  return hi != 0 ? 64 + __builtin_ctzll (hi) : 128;
+}
+
+/**
+ * \ingroup highprec
+ * Count the leading zero bits of a 128-bit value.
+ *
+ * \param [in] v The value.
+ * \returns The number of leading zero bits, 128 if \pname{v} is zero.
+ */
+static inline
+uint64_t
+CountLeadingZeros (const uint128_t v)
+{
+  const uint64_t lo = v;
+  const uint64_t hi = v >> 64;
+  if (hi != 0)
+    {
+      return __builtin_clzll (hi);
+    }
+  return lo != 0 ? 64 + __builtin_clzll (lo) : 128;
+}
+
 void
 int64x64_t::Mul (const int64x64_t & o)
 {
@@ -139,20 +180,17 @@ int64x64_t::Udiv (const uint128_t a, const uint128_t b)
   uint64_t shift = 0;          // Number we are going to get this round
   
     // Skip trailing zeros in divisor
-  while ( (shift < DIGITS) && !(den & 0x1))
-    {
-      ++shift;
-      den >>= 1;
-    }
+  shift = std::min (CountTrailingZeros (den), DIGITS);
+  den >>= shift;
   
   while ( (digis < DIGITS) && (rem != ZERO) )
     {
       // Skip leading zeros in remainder
-      while ( (digis + shift < DIGITS) &&
-              !(rem & HP128_MASK_HI_BIT))
-        {      
-          ++shift;
-          rem <<= 1;
+      if (digis + shift < DIGITS)
+        {
+          uint64_t zeros = std::min (CountLeadingZeros (rem), DIGITS - digis - shift);
+          shift += zeros;
+          rem <<= zeros;
         }
 
       // Cast off denominator bits if:
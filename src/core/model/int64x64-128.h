@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include <cmath>  // pow
+#include <cstring>  // memcpy
 
 #if defined(HAVE___UINT128_T) && !defined(HAVE_UINT128_T)
 typedef __uint128_t uint128_t;
@@ -93,6 +94,20 @@ public:
   /**@{*/
   inline int64x64_t (const double value)
   {
+    // Fast path: when the least significant bit of the double weighs
+    // at least 2^-64, and the double is below 2^63, its value is
+    // represented exactly.  The long double conversion gives the same
+    // result, the rounding it adds is a no-op for these values.
+    uint64_t bits;
+    std::memcpy (&bits, &value, sizeof (bits));
+    const int exponent = static_cast<int> ((bits >> 52) & 0x7ff);
+    if (exponent >= 1011 && exponent < 1086)
+      {
+        const int128_t significand = (bits & 0xfffffffffffffULL) | (1ULL << 52);
+        _v = significand << (exponent - 1011);
+        _v = (bits >> 63) ? -_v : _v;
+        return;
+      }
     const int64x64_t tmp ((long double)value);
     _v = tmp._v;
   }
@@ -204,8 +219,10 @@ public:
   {
     const bool negative = _v < 0;
     const uint128_t value = negative ? -_v : _v;
-    const long double fhi = value >> 64;
-    const long double flo = (value & HP_MASK_LO) / HP_MAX_64;
+    // Both halves fit in 64 bits: converting them as such is exact,
+    // and avoids the much slower 128-bit conversion
+    const long double fhi = static_cast<uint64_t> (value >> 64);
+    const long double flo = static_cast<uint64_t> (value & HP_MASK_LO) / HP_MAX_64;
     long double retval = fhi;
     retval += flo;
     retval = negative ? -retval : retval;
@@ -98,6 +98,11 @@ class TimeWithUnit;
  * resolution.  Therefore the maximum duration of your simulation,
  * if you use picoseconds, is 2^64 ps = 2^24 s = 7 months, whereas,
  * had you used nanoseconds, you could have run for 584 years.
+ *
+ * The resolution can also be fixed at compile time, with the
+ * \c --time-resolution option of \c waf \c configure.  The conversions
+ * between units then use constant factors, and the Time objects are
+ * never tracked, but SetResolution() aborts if asked for another unit.
  */
 class Time
 {
@@ -442,6 +447,16 @@ public:
    */
   inline static Time FromInteger (uint64_t value, enum Unit unit)
   {
+#ifdef NS3_TIME_RESOLUTION
+    if (unit <= FIXED_RESOLUTION)
+      {
+        value *= GetFixedFactor (unit);
+      }
+    else
+      {
+        value /= GetFixedFactor (unit);
+      }
+#else
     struct Information *info = PeekInformation (unit);
     if (info->fromMul)
       {
@@ -451,6 +466,7 @@ public:
       {
         value /= info->factor;
       }
+#endif
     return Time (value);
   }
   inline static Time FromDouble (double value, enum Unit unit)
@@ -463,7 +479,11 @@ public:
     // DO NOT REMOVE this temporary variable. It's here
     // to work around a compiler bug in gcc 3.4
     int64x64_t retval = value;
-    if (info->fromMul)
+    if (IsResolution (unit, info))
+      {
+        // no conversion
+      }
+    else if (IsFromMul (unit, info))
       {
         retval *= info->timeFrom;
       }
@@ -490,8 +510,18 @@ public:
    */
   inline int64_t ToInteger (enum Unit unit) const
   {
-    struct Information *info = PeekInformation (unit);
     int64_t v = m_data;
+#ifdef NS3_TIME_RESOLUTION
+    if (unit >= FIXED_RESOLUTION)
+      {
+        v *= GetFixedFactor (unit);
+      }
+    else
+      {
+        v /= GetFixedFactor (unit);
+      }
+#else
+    struct Information *info = PeekInformation (unit);
     if (info->toMul)
       {
         v *= info->factor;
@@ -500,6 +530,7 @@ public:
       {
         v /= info->factor;
       }
+#endif
     return v;
   }
   inline double ToDouble (enum Unit unit) const
@@ -510,7 +541,7 @@ public:
   {
     struct Information *info = PeekInformation (unit);
     int64x64_t retval = int64x64_t (m_data);
-    if (info->toMul)
+    if (IsToMul (unit, info))
       {
         retval *= info->timeTo;
       }
@@ -590,6 +621,96 @@ private:
     return & (PeekResolution ()->info[timeUnit]);
   }
 
+  /**
+   *  Whether \p unit is the current resolution, in which case there
+   *  is nothing to convert.
+   *
+   *  \param [in] unit The Unit to convert from or to
+   *  \param [in] info The Information for \p unit
+   *  \return \c true if \p unit is the current resolution
+   */
+  static inline bool IsResolution (enum Unit unit, const struct Information *info)
+  {
+#ifdef NS3_TIME_RESOLUTION
+    return unit == FIXED_RESOLUTION;
+#else
+    return info->factor == 1;
+#endif
+  }
+  /**
+   *  \param [in] unit The Unit to convert to
+   *  \param [in] info The Information for \p unit
+   *  \return \c true if converting to \p unit is a multiplication
+   */
+  static inline bool IsToMul (enum Unit unit, const struct Information *info)
+  {
+#ifdef NS3_TIME_RESOLUTION
+    return unit >= FIXED_RESOLUTION;
+#else
+    return info->toMul;
+#endif
+  }
+  /**
+   *  \param [in] unit The Unit to convert from
+   *  \param [in] info The Information for \p unit
+   *  \return \c true if converting from \p unit is a multiplication
+   */
+  static inline bool IsFromMul (enum Unit unit, const struct Information *info)
+  {
+#ifdef NS3_TIME_RESOLUTION
+    return unit <= FIXED_RESOLUTION;
+#else
+    return info->fromMul;
+#endif
+  }
+
+#ifdef NS3_TIME_RESOLUTION
+  /** The resolution fixed at compile time. */
+  static constexpr enum Unit FIXED_RESOLUTION = static_cast<enum Unit> (NS3_TIME_RESOLUTION);
+  /**
+   *  \param [in] n The exponent
+   *  \return 10 to the power \p n
+   */
+  static constexpr int64_t Pow10 (int n)
+  {
+    return n <= 0 ? 1 : 10 * Pow10 (n - 1);
+  }
+  /**
+   *  \param [in] unit The Unit
+   *  \return The power of ten of \p unit, as in SetResolution()
+   */
+  static constexpr int GetUnitPower (enum Unit unit)
+  {
+    return unit <= H ? 17 : unit == MIN ? 16 : unit == S ? 15 : unit == MS ? 12
+           : unit == US ? 9 : unit == NS ? 6 : unit == PS ? 3 : 0;
+  }
+  /**
+   *  \param [in] unit The Unit
+   *  \return The coefficient of \p unit, as in SetResolution()
+   */
+  static constexpr int64_t GetUnitCoefficient (enum Unit unit)
+  {
+    return unit == Y ? 315360 : unit == D ? 864 : unit == H ? 36 : unit == MIN ? 6 : 1;
+  }
+  /**
+   *  The Information::factor of \p unit for the fixed resolution,
+   *  computed at compile time.
+   *
+   *  \param [in] unit The Unit
+   *  \return The ratio of \p unit and the fixed resolution, the
+   *  greatest of the two over the smallest
+   */
+  static constexpr int64_t GetFixedFactor (enum Unit unit)
+  {
+    return Pow10 (GetUnitPower (unit) > GetUnitPower (FIXED_RESOLUTION)
+                  ? GetUnitPower (unit) - GetUnitPower (FIXED_RESOLUTION)
+                  : GetUnitPower (FIXED_RESOLUTION) - GetUnitPower (unit))
+           * (GetUnitCoefficient (unit) > GetUnitCoefficient (FIXED_RESOLUTION)
+              ? GetUnitCoefficient (unit) / GetUnitCoefficient (FIXED_RESOLUTION)
+              : GetUnitCoefficient (FIXED_RESOLUTION) / GetUnitCoefficient (unit));
+  }
+#endif /* NS3_TIME_RESOLUTION */
+
   /**
    *  Set the default resolution
    *
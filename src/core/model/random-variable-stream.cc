@@ -36,6 +36,7 @@
 #include "unused.h"
 #include <cmath>
 #include <iostream>
+#include <set>
 
 /**
  * \file
@@ -72,17 +73,56 @@ RandomVariableStream::GetTypeId (void)
   return tid;
 }
 
+/**
+ * \ingroup randomvariable
+ * \returns The set of existing streams.
+ *
+ * The set is never freed, so that streams destroyed at exit can still
+ * remove themselves.
+ */
+static std::set<RandomVariableStream *> &
+GetAllStreams (void)
+{
+  static std::set<RandomVariableStream *> *streams = new std::set<RandomVariableStream *> ();
+  return *streams;
+}
+
 RandomVariableStream::RandomVariableStream()
-  : m_rng (0)
+  : m_rng (0),
+    m_rngStreamIndex (0)
 {
   NS_LOG_FUNCTION (this);
+  GetAllStreams ().insert (this);
 }
 RandomVariableStream::~RandomVariableStream()
 {
   NS_LOG_FUNCTION (this);
+  GetAllStreams ().erase (this);
   delete m_rng;
 }
 
+uint32_t
+RandomVariableStream::ResetAllStreams (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  uint32_t n = 0;
+  std::set<RandomVariableStream *> &streams = GetAllStreams ();
+  for (std::set<RandomVariableStream *>::iterator i = streams.begin (); i != streams.end (); ++i)
+    {
+      RandomVariableStream *stream = *i;
+      if (stream->m_rng == 0)
+        {
+          continue;
+        }
+      delete stream->m_rng;
+      stream->m_rng = new RngStream (RngSeedManager::GetSeed (),
+                                     stream->m_rngStreamIndex,
+                                     RngSeedManager::GetRun ());
+      ++n;
+    }
+  return n;
+}
+
 void
 RandomVariableStream::SetAntithetic(bool isAntithetic)
 {
@@ -111,6 +151,7 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
                              RngSeedManager::GetRun ());
+      m_rngStreamIndex = nextStream;
     }
   else
     {
@@ -121,6 +162,7 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
                              RngSeedManager::GetRun ());
+      m_rngStreamIndex = target;
     }
   m_stream = stream;
 }
@@ -149,6 +149,18 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Restart every existing stream from the current seed and run.
+   *
+   * Each stream keeps its stream number, but gets the generator it
+   * would have had if it had been created with the current
+   * RngSeedManager seed and run.  This lets a process forked after
+   * building a scenario run it as another replication.
+   *
+   * \return The number of streams restarted.
+   */
+  static uint32_t ResetAllStreams (void);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
@@ -187,6 +199,9 @@ private:
   /** The stream number for the RngStream. */
   int64_t m_stream;
 
+  /** The stream index passed to the RngStream, once allocated. */
+  uint64_t m_rngStreamIndex;
+
 };  // class RandomVariableStream
 
   
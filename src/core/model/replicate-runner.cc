@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sys/mman.h>
+
+#include "replicate-runner.h"
+#include "random-variable-stream.h"
+#include "rng-seed-manager.h"
+#include "simulator.h"
+#include "abort.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ReplicateRunner implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReplicateRunner");
+
+ReplicateRunner::ReplicateRunner (uint32_t nReplicates, uint32_t nValues)
+  : m_nReplicates (nReplicates),
+    m_nValues (nValues),
+    m_firstRun (RngSeedManager::GetRun ()),
+    m_table (0),
+    m_tableSize (std::size_t (nReplicates) * (nValues + 1) * sizeof (double))
+{
+  NS_LOG_FUNCTION (this << nReplicates << nValues);
+  if (m_tableSize > 0)
+    {
+      // Anonymous shared pages are zeroed and survive fork ().
+      void *table = mmap (0, m_tableSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+      NS_ABORT_MSG_IF (table == MAP_FAILED, "Could not allocate the shared result table");
+      m_table = static_cast<double *> (table);
+    }
+}
+
+ReplicateRunner::~ReplicateRunner ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_table)
+    {
+      munmap (m_table, m_tableSize);
+    }
+}
+
+void
+ReplicateRunner::SetMaxParallel (uint32_t maxParallel)
+{
+  NS_LOG_FUNCTION (this << maxParallel);
+  m_checkpoint.SetMaxParallel (maxParallel);
+}
+
+void
+ReplicateRunner::SetFirstRun (uint64_t run)
+{
+  NS_LOG_FUNCTION (this << run);
+  m_firstRun = run;
+}
+
+uint64_t
+ReplicateRunner::GetRun (uint32_t i) const
+{
+  return m_firstRun + i;
+}
+
+uint32_t
+ReplicateRunner::Run (Callback<void, uint32_t> replicate)
+{
+  NS_LOG_FUNCTION (this << m_nReplicates);
+  m_replicate = replicate;
+  return m_checkpoint.Branch (Simulator::Now (), m_nReplicates,
+                              MakeCallback (&ReplicateRunner::DoReplicate, this));
+}
+
+void
+ReplicateRunner::DoReplicate (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  RngSeedManager::SetRun (GetRun (i));
+  uint32_t n = RandomVariableStream::ResetAllStreams ();
+  NS_LOG_INFO ("Replication " << i << " restarted " << n << " streams with run " << GetRun (i));
+  m_replicate (i);
+}
+
+void
+ReplicateRunner::Record (uint32_t value, double x)
+{
+  NS_LOG_FUNCTION (this << value << x);
+  int32_t i = SimulationCheckpoint::GetBranchIndex ();
+  NS_ABORT_MSG_IF (i < 0, "Values can only be recorded by a replication");
+  NS_ABORT_MSG_IF (value >= m_nValues, "Value index " << value << " out of range");
+  double *row = m_table + i * (m_nValues + 1);
+  row[1 + value] = x;
+  row[0] = 1;
+}
+
+bool
+ReplicateRunner::IsRecorded (uint32_t i) const
+{
+  NS_ASSERT (i < m_nReplicates);
+  return m_table[i * (m_nValues + 1)] != 0;
+}
+
+double
+ReplicateRunner::Get (uint32_t i, uint32_t value) const
+{
+  NS_ASSERT (i < m_nReplicates && value < m_nValues);
+  return m_table[i * (m_nValues + 1) + 1 + value];
+}
+
+} // namespace ns3
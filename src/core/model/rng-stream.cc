@@ -322,6 +322,65 @@ void PowerOfTwoMatrix (int n, Matrix a1p, Matrix a2p)
     }
 }
 
+/** First component modulus, as an integer. */
+const uint64_t m1Int = 4294967087ULL;
+
+/** Second component modulus, as an integer. */
+const uint64_t m2Int = 4294944443ULL;
+
+/**
+ * The last rows of the transition matrices of the two MRG components
+ * raised to all powers from 1 to ns3::RngStream::BLOCK_SIZE: the
+ * coefficients which give, from a state, the value of each component
+ * that many steps ahead.
+ */
+struct BlockCoefficients
+{
+  uint64_t a1[ns3::RngStream::BLOCK_SIZE][3];  //!< First component coefficients.
+  uint64_t a2[ns3::RngStream::BLOCK_SIZE][3];  //!< Second component coefficients.
+};
+
+/**
+ * Compute the coefficients of the values of the two MRG components
+ * from 1 to ns3::RngStream::BLOCK_SIZE steps ahead.
+ *
+ * \returns The coefficients.
+ */
+struct BlockCoefficients BlockConstants (void)
+{
+  struct BlockCoefficients coefficients;
+  Matrix a1p, a2p;
+  for (uint32_t i = 0; i < ns3::RngStream::BLOCK_SIZE; i++)
+    {
+      MatPowModM (A1p0, a1p, m1, i + 1);
+      MatPowModM (A2p0, a2p, m2, i + 1);
+      for (int j = 0; j < 3; j++)
+        {
+          coefficients.a1[i][j] = static_cast<uint64_t> (a1p[2][j]);
+          coefficients.a2[i][j] = static_cast<uint64_t> (a2p[2][j]);
+        }
+    }
+  return coefficients;
+}
+
+/**
+ * Return (a[0]*s[0] + a[1]*s[1] + a[2]*s[2]) MOD m; a, s and m must
+ * be < 2^32 - 208.
+ *
+ * This computes the result exactly in 64-bit integers: each product
+ * is below 2^64 - 2^40, so adding a remainder to it cannot overflow.
+ *
+ * \tparam m Modulus.
+ * \param [in] a Coefficients.
+ * \param [in] s State of the component.
+ * \returns The dot product of \pname{a} and \pname{s}, MOD \pname{m}.
+ */
+template <uint64_t m>
+inline uint64_t DotModM (const uint64_t a[3], const uint64_t s[3])
+{
+  return ((a[0] * s[0] + a[1] * s[1] % m) % m + a[2] * s[2]) % m;
+}
+
 } // namespace MRG32k3a
 
 
@@ -329,35 +388,67 @@ namespace ns3 {
 
 using namespace MRG32k3a;
   
-double RngStream::RandU01 ()
+const uint32_t RngStream::BLOCK_SIZE;
+
+void
+RngStream::GenerateBlock (double values[BLOCK_SIZE])
 {
-  int32_t k;
-  double p1, p2, u;
-
-  /* Component 1 */
-  p1 = a12 * m_currentState[1] - a13n * m_currentState[0];
-  k = static_cast<int32_t> (p1 / m1);
-  p1 -= k * m1;
-  if (p1 < 0.0)
+  static const struct BlockCoefficients coefficients = BlockConstants ();
+
+  // The values of a component at each step of the block only depend on
+  // the state at its start, so they are computed independently of each
+  // other rather than one step after the other.  The arithmetic is
+  // exact, so they are the same.
+  const uint64_t s1[3] = {
+    static_cast<uint64_t> (m_currentState[0]),
+    static_cast<uint64_t> (m_currentState[1]),
+    static_cast<uint64_t> (m_currentState[2])
+  };
+  const uint64_t s2[3] = {
+    static_cast<uint64_t> (m_currentState[3]),
+    static_cast<uint64_t> (m_currentState[4]),
+    static_cast<uint64_t> (m_currentState[5])
+  };
+  uint64_t p1[BLOCK_SIZE];
+  uint64_t p2[BLOCK_SIZE];
+  for (uint32_t i = 0; i < BLOCK_SIZE; ++i)
     {
-      p1 += m1;
+      p1[i] = DotModM<m1Int> (coefficients.a1[i], s1);
+      p2[i] = DotModM<m2Int> (coefficients.a2[i], s2);
+
+      /* Combination, with a mask rather than a branch on random values:
+         u - 1 is negative, and its sign bit set, iff u <= 0 */
+      int64_t u = static_cast<int64_t> (p1[i]) - static_cast<int64_t> (p2[i]);
+      u += ((u - 1) >> 63) & m1Int;
+      values[i] = u * norm;
     }
-  m_currentState[0] = m_currentState[1]; m_currentState[1] = m_currentState[2]; m_currentState[2] = p1;
 
-  /* Component 2 */
-  p2 = a21 * m_currentState[5] - a23n * m_currentState[3];
-  k = static_cast<int32_t> (p2 / m2);
-  p2 -= k * m2;
-  if (p2 < 0.0)
+  for (int i = 0; i < 3; ++i)
     {
-      p2 += m2;
+      m_currentState[i] = p1[BLOCK_SIZE - 3 + i];
+      m_currentState[3 + i] = p2[BLOCK_SIZE - 3 + i];
     }
-  m_currentState[3] = m_currentState[4]; m_currentState[4] = m_currentState[5]; m_currentState[5] = p2;
-
-  /* Combination */
-  u = ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
+}
 
-  return u;
+void
+RngStream::RandU01 (double values[], std::size_t count)
+{
+  std::size_t i = 0;
+  // The randoms already generated come first
+  for (; i < count && m_next < BLOCK_SIZE; ++i)
+    {
+      values[i] = m_buffer[m_next++];
+    }
+  // then whole blocks, generated in place,
+  for (; i + BLOCK_SIZE <= count; i += BLOCK_SIZE)
+    {
+      GenerateBlock (&values[i]);
+    }
+  // and the rest through the buffer
+  for (; i < count; ++i)
+    {
+      values[i] = RandU01 ();
+    }
 }
 
 RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
@@ -372,6 +463,7 @@ RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
     }
   AdvanceNthBy (stream, 127, m_currentState);
   AdvanceNthBy (substream, 76, m_currentState);
+  m_next = BLOCK_SIZE;
 }
 
 RngStream::RngStream(const RngStream& r)
@@ -380,6 +472,11 @@ RngStream::RngStream(const RngStream& r)
     {
       m_currentState[i] = r.m_currentState[i];
     }
+  for (uint32_t i = r.m_next; i < BLOCK_SIZE; ++i)
+    {
+      m_buffer[i] = r.m_buffer[i];
+    }
+  m_next = r.m_next;
 }
 
 void 
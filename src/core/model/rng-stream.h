@@ -20,6 +20,7 @@
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
 #include <string>
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -67,11 +68,41 @@ public:
    * Generate the next random number for this stream.
    * Uniformly distributed between 0 and 1.
    *
+   * The randoms are generated by blocks of BLOCK_SIZE, and buffered
+   * until they are consumed.  The sequence is the same as if they
+   * were generated one at a time.
+   *
    * \returns The next random.
    */
-  double RandU01 (void);
+  inline double RandU01 (void)
+  {
+    if (m_next == BLOCK_SIZE)
+      {
+        GenerateBlock (m_buffer);
+        m_next = 0;
+      }
+    return m_buffer[m_next++];
+  }
+  /**
+   * Generate the next \p count random numbers for this stream,
+   * as that many calls to RandU01 (void) would.
+   *
+   * \param [out] values The array to fill with the randoms.
+   * \param [in] count The number of randoms.
+   */
+  void RandU01 (double values[], std::size_t count);
+
+  /** The number of randoms generated at once. */
+  static const uint32_t BLOCK_SIZE = 16;
 
 private:
+  /**
+   * Generate the next BLOCK_SIZE randoms from the RNG state, and
+   * advance the state past them.
+   *
+   * \param [out] values The array to fill with the randoms.
+   */
+  void GenerateBlock (double values[BLOCK_SIZE]);
   /**
    * Advance \p state of the RNG by leaps and bounds.
    *
@@ -83,6 +114,10 @@ private:
 
   /** The RNG state vector. */
   double m_currentState[6];
+  /** The randoms generated ahead of the RNG state. */
+  double m_buffer[BLOCK_SIZE];
+  /** The index of the next random to return in m_buffer. */
+  uint32_t m_next;
 };
 
 } // namespace ns3
@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "simulation-checkpoint.h"
+#include "simulator.h"
+#include "abort.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::SimulationCheckpoint implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SimulationCheckpoint");
+
+int32_t SimulationCheckpoint::m_branchIndex = -1;
+
+SimulationCheckpoint::SimulationCheckpoint ()
+  : m_maxParallel (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SimulationCheckpoint::SetMaxParallel (uint32_t maxParallel)
+{
+  NS_LOG_FUNCTION (this << maxParallel);
+  m_maxParallel = maxParallel;
+}
+
+int32_t
+SimulationCheckpoint::GetBranchIndex (void)
+{
+  return m_branchIndex;
+}
+
+uint32_t
+SimulationCheckpoint::Branch (Time at, uint32_t nBranches, Callback<void, uint32_t> branch)
+{
+  NS_LOG_FUNCTION (this << at << nBranches);
+  NS_ABORT_MSG_IF (at < Simulator::Now (), "Checkpoint time " << at << " is in the past");
+
+  if (at > Simulator::Now ())
+    {
+      Simulator::Stop (at - Simulator::Now ());
+      Simulator::Run ();
+    }
+  NS_LOG_INFO ("Checkpoint taken at " << Simulator::Now ().GetSeconds () << " s");
+
+  uint32_t maxParallel = m_maxParallel;
+  if (maxParallel == 0)
+    {
+      long online = sysconf (_SC_NPROCESSORS_ONLN);
+      maxParallel = online > 0 ? online : 1;
+    }
+
+  std::map<pid_t, uint32_t> running;
+  uint32_t succeeded = 0;
+  uint32_t next = 0;
+  while (next < nBranches || !running.empty ())
+    {
+      if (next < nBranches && running.size () < maxParallel)
+        {
+          // Do not let the children write what is still buffered.
+          std::cout.flush ();
+          std::cerr.flush ();
+          std::fflush (NULL);
+
+          pid_t pid = fork ();
+          NS_ABORT_MSG_IF (pid < 0, "Could not fork branch " << next);
+          if (pid == 0)
+            {
+              m_branchIndex = next;
+              branch (next);
+              std::cout.flush ();
+              std::cerr.flush ();
+              std::fflush (NULL);
+              // Skip the destructors of the static objects of the
+              // parent, which the parent will run itself.
+              _exit (0);
+            }
+          NS_LOG_INFO ("Branch " << next << " forked as process " << pid);
+          running[pid] = next++;
+          continue;
+        }
+
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          NS_LOG_ERROR ("Lost track of " << running.size () << " branches");
+          break;
+        }
+      std::map<pid_t, uint32_t>::iterator it = running.find (pid);
+      if (it == running.end ())
+        {
+          continue;
+        }
+      if (WIFEXITED (status) && WEXITSTATUS (status) == 0)
+        {
+          ++succeeded;
+        }
+      else
+        {
+          NS_LOG_WARN ("Branch " << it->second << " failed with status " << status);
+        }
+      running.erase (it);
+    }
+  return succeeded;
+}
+
+} // namespace ns3
@@ -68,6 +68,9 @@ bool Time::StaticInit ()
 
   if (firstTime)
     {
+      // When the resolution is fixed at compile time, there is no Time
+      // to convert, and so none to record
+#ifndef NS3_TIME_RESOLUTION
       if (! g_markingTimes)
         {
           static MarkedTimes markingTimes;
@@ -77,6 +80,7 @@ bool Time::StaticInit ()
         {
           NS_LOG_ERROR ("firstTime but g_markingTimes != 0");
         }
+#endif
 
       // Schedule the cleanup.
       // We'd really like:
@@ -171,7 +175,11 @@ Time::SetDefaultNsResolution (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   struct Resolution resolution;
+#ifdef NS3_TIME_RESOLUTION
+  SetResolution (FIXED_RESOLUTION, &resolution, false);
+#else
   SetResolution (Time::NS, &resolution, false);
+#endif
   return resolution;
 }
 
@@ -180,7 +188,13 @@ void
 Time::SetResolution (enum Unit resolution)
 {
   NS_LOG_FUNCTION (resolution);
+#ifdef NS3_TIME_RESOLUTION
+  // Already the resolution, with no Time to convert
+  NS_ABORT_MSG_IF (resolution != FIXED_RESOLUTION,
+                   "The resolution of Time is fixed at compile time to unit " << FIXED_RESOLUTION);
+#else
   SetResolution (resolution, PeekResolution ());
+#endif
 }
 
 
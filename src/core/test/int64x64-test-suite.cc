@@ -1182,6 +1182,54 @@ Int64x64DoubleTestCase::DoRun (void)
 }
 
 
+class Int64x64DoubleFastPathTestCase : public TestCase
+{
+public:
+  Int64x64DoubleFastPathTestCase ();
+  virtual void DoRun (void);
+  void Check (const double value);
+};
+
+Int64x64DoubleFastPathTestCase::Int64x64DoubleFastPathTestCase ()
+  : TestCase ("Construct from double, same as from long double")
+{
+}
+
+void
+Int64x64DoubleFastPathTestCase::Check (const double value)
+{
+  const int64x64_t result = int64x64_t (value);
+  const int64x64_t expect = int64x64_t (static_cast<long double> (value));
+  NS_TEST_ASSERT_MSG_EQ ((result == expect), true,
+			 "int64x64_t (double) differs from int64x64_t (long double) for "
+			 << std::setprecision (17) << value);
+}
+
+void
+Int64x64DoubleFastPathTestCase::DoRun (void)
+{
+  // The fast path of the double constructor covers the doubles whose
+  // least significant bit weighs at least 2^-64, below 2^63.  Check
+  // around its bounds, with all bits set or a single one.
+  const double mantissas[] = { 1.0, 1.5, 1.0000000000000002, 1.9999999999999998, 1.2345678901234567 };
+  for (int exponent = -80; exponent <= 62; ++exponent)
+    {
+      for (unsigned int i = 0; i < sizeof (mantissas) / sizeof (mantissas[0]); ++i)
+	{
+	  const double value = std::ldexp (mantissas[i], exponent);
+	  Check (value);
+	  Check (-value);
+	}
+    }
+  Check (0.0);
+  Check (-0.0);
+  Check (1e-9);
+  Check (0.5e-6);
+  Check (123.456789);
+  Check (-987654.321);
+}
+
+
 class Int64x64ImplTestCase : public TestCase
 {
 public:
@@ -1241,6 +1289,7 @@ public:
     AddTestCase (new Int64x64Bug1786TestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64InvertTestCase (), TestCase::QUICK);
     AddTestCase (new Int64x64DoubleTestCase (), TestCase::QUICK);
+    AddTestCase (new Int64x64DoubleFastPathTestCase (), TestCase::QUICK);
   }
 }  g_int64x64TestSuite;
 
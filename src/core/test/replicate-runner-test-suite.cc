@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/replicate-runner.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+
+/**
+ * \file
+ * \ingroup core-tests
+ * ReplicateRunner test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+/**
+ * \ingroup core-tests
+ *
+ * Each replication draws from its own run and records its values.
+ */
+class ReplicateRunnerTestCase : public TestCase
+{
+public:
+  ReplicateRunnerTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Run one replication.
+   * \param [in] i The replication index.
+   */
+  void RunReplicate (uint32_t i);
+
+  ReplicateRunner *m_runner;           //!< The runner.
+  Ptr<UniformRandomVariable> m_fixed;  //!< Stream with a fixed number.
+  Ptr<UniformRandomVariable> m_auto;   //!< Stream with an automatic number.
+};
+
+ReplicateRunnerTestCase::ReplicateRunnerTestCase ()
+  : TestCase ("Check the runs and the shared results of the replications"),
+    m_runner (0)
+{
+}
+
+void
+ReplicateRunnerTestCase::RunReplicate (uint32_t i)
+{
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  m_runner->Record (0, m_fixed->GetValue ());
+  m_runner->Record (1, m_auto->GetValue ());
+  m_runner->Record (2, Simulator::Now ().GetSeconds ());
+  Simulator::Destroy ();
+}
+
+void
+ReplicateRunnerTestCase::DoRun (void)
+{
+  uint64_t run = RngSeedManager::GetRun ();
+  m_fixed = CreateObject<UniformRandomVariable> ();
+  m_fixed->SetStream (7);
+  m_auto = CreateObject<UniformRandomVariable> ();
+
+  ReplicateRunner runner (3, 3);
+  runner.SetFirstRun (11);
+  m_runner = &runner;
+  uint32_t succeeded = runner.Run (MakeCallback (&ReplicateRunnerTestCase::RunReplicate, this));
+  NS_TEST_ASSERT_MSG_EQ (succeeded, 3, "All replications should have succeeded");
+  NS_TEST_ASSERT_MSG_EQ (RngSeedManager::GetRun (), run, "The run of the parent should not change");
+
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (runner.IsRecorded (i), true, "Replication " << i << " recorded nothing");
+      NS_TEST_EXPECT_MSG_EQ (runner.Get (i, 2), 1, "Replication " << i << " did not run");
+
+      // The stream with a fixed number draws what a new stream of
+      // the same run would.
+      RngSeedManager::SetRun (runner.GetRun (i));
+      Ptr<UniformRandomVariable> expected = CreateObject<UniformRandomVariable> ();
+      expected->SetStream (7);
+      NS_TEST_EXPECT_MSG_EQ (runner.Get (i, 0), expected->GetValue (), "Wrong value of replication " << i);
+      for (uint32_t j = 0; j < i; ++j)
+        {
+          NS_TEST_EXPECT_MSG_NE (runner.Get (i, 1), runner.Get (j, 1), "Replications " << j << " and " << i << " drew the same value");
+        }
+    }
+  RngSeedManager::SetRun (run);
+  m_fixed = 0;
+  m_auto = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * ReplicateRunner test suite.
+ */
+class ReplicateRunnerTestSuite : public TestSuite
+{
+public:
+  ReplicateRunnerTestSuite ();
+};
+
+ReplicateRunnerTestSuite::ReplicateRunnerTestSuite ()
+  : TestSuite ("replicate-runner", UNIT)
+{
+  AddTestCase (new ReplicateRunnerTestCase, TestCase::QUICK);
+}
+
+/** Static variable for test initialization. */
+static ReplicateRunnerTestSuite g_replicateRunnerTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simulation-checkpoint.h"
+
+/**
+ * \file
+ * \ingroup core-tests
+ * SimulationCheckpoint test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+/**
+ * \ingroup core-tests
+ *
+ * Every branch continues from the state of the checkpoint.
+ */
+class SimulationCheckpointTestCase : public TestCase
+{
+public:
+  SimulationCheckpointTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /** Count one tick and schedule the next one. */
+  void Tick (void);
+  /**
+   * Run one branch and write its counter.
+   * \param [in] i The branch index.
+   */
+  void RunBranch (uint32_t i);
+  /**
+   * \param [in] i The branch index.
+   * \return The file of branch i.
+   */
+  std::string GetFileName (uint32_t i);
+
+  uint32_t m_ticks;      //!< Number of ticks so far.
+  uint32_t m_increment;  //!< Value of one tick.
+};
+
+SimulationCheckpointTestCase::SimulationCheckpointTestCase ()
+  : TestCase ("Check that branches continue from the checkpoint"),
+    m_ticks (0),
+    m_increment (1)
+{
+}
+
+void
+SimulationCheckpointTestCase::Tick (void)
+{
+  m_ticks += m_increment;
+  Simulator::Schedule (Seconds (1), &SimulationCheckpointTestCase::Tick, this);
+}
+
+std::string
+SimulationCheckpointTestCase::GetFileName (uint32_t i)
+{
+  std::ostringstream name;
+  name << "branch-" << i;
+  return CreateTempDirFilename (name.str ());
+}
+
+void
+SimulationCheckpointTestCase::RunBranch (uint32_t i)
+{
+  // The branches differ in what happens after the checkpoint only.
+  m_increment = 10 * (i + 1);
+  Simulator::Stop (Seconds (10) - Simulator::Now ());
+  Simulator::Run ();
+  std::ofstream out (GetFileName (i).c_str ());
+  out << SimulationCheckpoint::GetBranchIndex () << ' ' << m_ticks << std::endl;
+  Simulator::Destroy ();
+}
+
+void
+SimulationCheckpointTestCase::DoRun (void)
+{
+  Simulator::Schedule (Seconds (0.5), &SimulationCheckpointTestCase::Tick, this);
+
+  SimulationCheckpoint checkpoint;
+  checkpoint.SetMaxParallel (2);
+  uint32_t succeeded = checkpoint.Branch (Seconds (5), 3,
+                                          MakeCallback (&SimulationCheckpointTestCase::RunBranch, this));
+  NS_TEST_ASSERT_MSG_EQ (succeeded, 3, "All branches should have succeeded");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (5), "The simulator should still be at the checkpoint");
+  NS_TEST_ASSERT_MSG_EQ (m_ticks, 5, "Wrong number of ticks before the checkpoint");
+  NS_TEST_ASSERT_MSG_EQ (SimulationCheckpoint::GetBranchIndex (), -1, "Wrong branch index of the parent");
+
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      std::ifstream in (GetFileName (i).c_str ());
+      int32_t index = -1;
+      uint32_t ticks = 0;
+      in >> index >> ticks;
+      NS_TEST_ASSERT_MSG_EQ (index, (int32_t) i, "Wrong branch index");
+      // 5 ticks before the checkpoint, 5 after it (5.5 s to 9.5 s).
+      NS_TEST_EXPECT_MSG_EQ (ticks, 5 + 5 * 10 * (i + 1), "Wrong number of ticks of branch " << i);
+    }
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * SimulationCheckpoint test suite.
+ */
+class SimulationCheckpointTestSuite : public TestSuite
+{
+public:
+  SimulationCheckpointTestSuite ();
+};
+
+SimulationCheckpointTestSuite::SimulationCheckpointTestSuite ()
+  : TestSuite ("simulation-checkpoint", UNIT)
+{
+  AddTestCase (new SimulationCheckpointTestCase, TestCase::QUICK);
+}
+
+/** Static variable for test initialization. */
+static SimulationCheckpointTestSuite g_simulationCheckpointTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
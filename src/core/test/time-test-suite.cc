@@ -89,12 +89,15 @@ TimeSimpleTestCase::DoRun (void)
                          "is 1fs really 1fs ?");
 #endif
 
+  // The resolution cannot change when it is fixed at compile time
+#ifndef NS3_TIME_RESOLUTION
   Time ten = NanoSeconds (10);
   int64_t tenValue = ten.GetInteger ();
   Time::SetResolution (Time::PS);
   int64_t tenKValue = ten.GetInteger ();
   NS_TEST_ASSERT_MSG_EQ (tenValue * 1000, tenKValue,
                          "change resolution to PS");
+#endif
 }
 
 void 
@@ -22,6 +22,10 @@
 #include "ns3/hwmp-protocol.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/mesh-wifi-interface-mac.h"
+#include "ns3/mesh-obss-pd-algorithm.h"
+#include "ns3/obss-wifi-manager.h"
+#include "ns3/string.h"
+#include <sstream>
 
 namespace ns3 {
 using namespace dot11s;
@@ -38,7 +42,13 @@ Dot11sStack::GetTypeId ()
                    "The MAC address of root mesh point.",
                    Mac48AddressValue (Mac48Address ("ff:ff:ff:ff:ff:ff")),
                    MakeMac48AddressAccessor (&Dot11sStack::m_root),
-                   MakeMac48AddressChecker ());
+                   MakeMac48AddressChecker ())
+    .AddAttribute ("Roots",
+                   "The space separated MAC addresses of the root mesh points, in addition to Root, "
+                   "typically the gateways of the mesh.",
+                   StringValue (""),
+                   MakeStringAccessor (&Dot11sStack::m_roots),
+                   MakeStringChecker ());
   return tid;
 }
 Dot11sStack::Dot11sStack () :
@@ -70,7 +80,14 @@ Dot11sStack::InstallStack (Ptr<MeshPointDevice> mp)
     {
       return false;
     }
-  if (mp->GetAddress () == m_root)
+  bool isRoot = (mp->GetAddress () == m_root);
+  std::istringstream roots (m_roots);
+  std::string root;
+  while (roots >> root)
+    {
+      isRoot |= (mp->GetAddress () == Mac48Address (root.c_str ()));
+    }
+  if (isRoot)
     {
       hwmp->SetRoot ();
     }
@@ -78,6 +95,22 @@ Dot11sStack::InstallStack (Ptr<MeshPointDevice> mp)
   //PeekPointer()'s to avoid circular Ptr references
   pmp->SetPeerLinkStatusCallback (MakeCallback (&HwmpProtocol::PeerLinkStatus, PeekPointer (hwmp)));
   hwmp->SetNeighboursCallback (MakeCallback (&PeerManagementProtocol::GetPeers, PeekPointer (pmp)));
+  //The spatial reuse of the interfaces follows the HWMP path to the root
+  std::vector<Ptr<NetDevice> > ifaces = mp->GetInterfaces ();
+  for (std::vector<Ptr<NetDevice> >::const_iterator i = ifaces.begin (); i != ifaces.end (); ++i)
+    {
+      Ptr<WifiNetDevice> device = (*i)->GetObject<WifiNetDevice> ();
+      Ptr<MeshObssPdAlgorithm> obssPd = device->GetObject<MeshObssPdAlgorithm> ();
+      if (obssPd != 0)
+        {
+          obssPd->SetNextHopCallback (MakeCallback (&HwmpProtocol::GetNextHopToRoot, PeekPointer (hwmp)));
+        }
+      Ptr<ObssWifiManager> manager = DynamicCast<ObssWifiManager> (device->GetRemoteStationManager ());
+      if (manager != 0)
+        {
+          manager->SetNextHopCallback (MakeCallback (&HwmpProtocol::GetNextHopToRoot, PeekPointer (hwmp)));
+        }
+    }
   return true;
 }
 void
@@ -77,6 +77,7 @@ public:
   void ResetStats (const Ptr<MeshPointDevice> mp);
 private:
   Mac48Address m_root; ///< root
+  std::string m_roots; ///< space separated addresses of the other roots
 };
 
 } // namespace ns3
@@ -34,9 +34,69 @@
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/wifi-mac-queue.h"
 #include "ns3/qos-utils.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/obss-pd-algorithm.h"
+#include "ns3/mobility-model.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
 
 namespace ns3
 {
+/**
+ * Get the channel of a mesh point interface, so that the interfaces use
+ * non-overlapping channels of the width of the PHY, starting with the
+ * channel the PHY is on.  The channels are reused when there are more
+ * interfaces than channels.
+ *
+ * \param phy the PHY of the interface, configured with its standard
+ * \param index the index of the interface
+ * \return the channel number, or the one of the PHY if it is on none of
+ *         the non-overlapping channels
+ */
+static uint8_t
+GetSpreadChannelNumber (Ptr<WifiPhy> phy, uint32_t index)
+{
+  static const uint8_t channels24[] = {1, 6, 11};
+  static const uint8_t channels20[] = {36, 40, 44, 48, 52, 56, 60, 64, 100, 104, 108, 112, 116, 120, 124, 128,
+                                       132, 136, 140, 144, 149, 153, 157, 161, 165};
+  static const uint8_t channels40[] = {38, 46, 54, 62, 102, 110, 118, 126, 134, 142, 151, 159};
+  static const uint8_t channels80[] = {42, 58, 106, 122, 138, 155};
+  static const uint8_t channels160[] = {50, 114};
+  const uint8_t *channels = 0;
+  uint32_t nChannels = 0;
+  if (phy->GetFrequency () < 5000)
+    {
+      channels = channels24;
+      nChannels = sizeof (channels24);
+    }
+  else if (phy->GetChannelWidth () == 20)
+    {
+      channels = channels20;
+      nChannels = sizeof (channels20);
+    }
+  else if (phy->GetChannelWidth () == 40)
+    {
+      channels = channels40;
+      nChannels = sizeof (channels40);
+    }
+  else if (phy->GetChannelWidth () == 80)
+    {
+      channels = channels80;
+      nChannels = sizeof (channels80);
+    }
+  else if (phy->GetChannelWidth () == 160)
+    {
+      channels = channels160;
+      nChannels = sizeof (channels160);
+    }
+  const uint8_t *first = std::find (channels, channels + nChannels, phy->GetChannelNumber ());
+  if (first == channels + nChannels)
+    {
+      return phy->GetChannelNumber ();
+    }
+  return channels[(first - channels + index) % nChannels];
+}
+
 MeshHelper::MeshHelper () :
   m_nInterfaces (1),
   m_spreadChannelPolicy (ZERO_CHANNEL),
@@ -109,7 +169,7 @@ MeshHelper::Install (const WifiPhyHelper &phyHelper, NodeContainer c) const
             }
           if (m_spreadChannelPolicy == SPREAD_CHANNELS)
             {
-              channel = i * 5;
+              channel = i;
             }
           Ptr<WifiNetDevice> iface = CreateInterface (phyHelper, node, channel);
           mp->AddInterface (iface);
@@ -174,6 +234,28 @@ MeshHelper::SetRemoteStationManager (std::string type,
   m_stationManager.Set (n6, v6);
   m_stationManager.Set (n7, v7);
 }
+void
+MeshHelper::SetObssPdAlgorithm (std::string type,
+                                std::string n0, const AttributeValue &v0,
+                                std::string n1, const AttributeValue &v1,
+                                std::string n2, const AttributeValue &v2,
+                                std::string n3, const AttributeValue &v3,
+                                std::string n4, const AttributeValue &v4,
+                                std::string n5, const AttributeValue &v5,
+                                std::string n6, const AttributeValue &v6,
+                                std::string n7, const AttributeValue &v7)
+{
+  m_obssPdAlgorithm = ObjectFactory ();
+  m_obssPdAlgorithm.SetTypeId (type);
+  m_obssPdAlgorithm.Set (n0, v0);
+  m_obssPdAlgorithm.Set (n1, v1);
+  m_obssPdAlgorithm.Set (n2, v2);
+  m_obssPdAlgorithm.Set (n3, v3);
+  m_obssPdAlgorithm.Set (n4, v4);
+  m_obssPdAlgorithm.Set (n5, v5);
+  m_obssPdAlgorithm.Set (n6, v6);
+  m_obssPdAlgorithm.Set (n7, v7);
+}
 void 
 MeshHelper::SetStandard (enum WifiPhyStandard standard)
 {
@@ -210,10 +292,20 @@ MeshHelper::CreateInterface (const WifiPhyHelper &phyHelper, Ptr<Node> node, uin
   mac->SetAddress (Mac48Address::Allocate ());
   mac->ConfigureStandard (m_standard);
   phy->ConfigureStandard (m_standard);
+  if (channelId > 0)
+    {
+      phy->SetChannelNumber (GetSpreadChannelNumber (phy, channelId));
+    }
   device->SetMac (mac);
   device->SetPhy (phy);
   device->SetRemoteStationManager (manager);
   node->AddDevice (device);
+  if ((m_standard >= WIFI_PHY_STANDARD_80211ax_2_4GHZ) && (m_obssPdAlgorithm.IsTypeIdSet ()))
+    {
+      Ptr<ObssPdAlgorithm> obssPdAlgorithm = m_obssPdAlgorithm.Create<ObssPdAlgorithm> ();
+      device->AggregateObject (obssPdAlgorithm);
+      obssPdAlgorithm->ConnectWifiNetDevice (device);
+    }
   // mac->SwitchFrequencyChannel (channelId);
   // Aggregate a NetDeviceQueueInterface object if a RegularWifiMac is installed
   Ptr<RegularWifiMac> rmac = DynamicCast<RegularWifiMac> (mac);
@@ -351,6 +443,67 @@ MeshHelper::AssignStreams (NetDeviceContainer c, int64_t stream)
   return (currentStream - stream);
 }
 
+uint8_t
+MeshHelper::AssignBssColors (NetDeviceContainer c, double range)
+{
+  //BSS colors are 6-bit, and 0 disables the BSS coloring
+  const uint8_t maxColor = 63;
+  std::vector<uint8_t> colors (c.GetN (), 0);
+  std::vector<Vector> positions;
+  for (uint32_t i = 0; i < c.GetN (); ++i)
+    {
+      Ptr<MobilityModel> mobility = c.Get (i)->GetNode ()->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "Mesh point without mobility model");
+      positions.push_back (mobility->GetPosition ());
+    }
+  std::vector<bool> used (maxColor + 1, false);
+  for (uint32_t head = 0; head < c.GetN (); ++head)
+    {
+      if (colors[head] != 0)
+        {
+          continue;
+        }
+      //The least used color among the mesh points within twice the range
+      std::vector<uint32_t> nearby (maxColor + 1, 0);
+      for (uint32_t i = 0; i < c.GetN (); ++i)
+        {
+          if (colors[i] != 0 && CalculateDistance (positions[head], positions[i]) <= 2 * range)
+            {
+              nearby[colors[i]]++;
+            }
+        }
+      uint8_t color = 1;
+      for (uint8_t k = 2; k <= maxColor; ++k)
+        {
+          if (nearby[k] < nearby[color])
+            {
+              color = k;
+            }
+        }
+      used[color] = true;
+      for (uint32_t i = head; i < c.GetN (); ++i)
+        {
+          if (colors[i] == 0 && CalculateDistance (positions[head], positions[i]) <= range)
+            {
+              colors[i] = color;
+            }
+        }
+    }
+  for (uint32_t i = 0; i < c.GetN (); ++i)
+    {
+      Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (c.Get (i));
+      NS_ASSERT (mp != 0);
+      std::vector<Ptr<NetDevice> > ifaces = mp->GetInterfaces ();
+      for (std::vector<Ptr<NetDevice> >::const_iterator j = ifaces.begin (); j != ifaces.end (); ++j)
+        {
+          Ptr<HeConfiguration> heConfiguration = DynamicCast<WifiNetDevice> (*j)->GetHeConfiguration ();
+          NS_ASSERT_MSG (heConfiguration != 0, "Mesh interface without HE configuration");
+          heConfiguration->SetAttribute ("BssColor", UintegerValue (colors[i]));
+        }
+    }
+  return std::count (used.begin (), used.end (), true);
+}
+
 void
 MeshHelper::SetSelectQueueCallback (SelectQueueCallback f)
 {
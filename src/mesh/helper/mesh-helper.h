@@ -122,6 +122,38 @@ public:
                            std::string n5 = "", const AttributeValue &v5 = EmptyAttributeValue (),
                            std::string n6 = "", const AttributeValue &v6 = EmptyAttributeValue (),
                            std::string n7 = "", const AttributeValue &v7 = EmptyAttributeValue ());
+  /**
+   * \param type the type of ns3::ObssPdAlgorithm to create.
+   * \param n0 the name of the attribute to set
+   * \param v0 the value of the attribute to set
+   * \param n1 the name of the attribute to set
+   * \param v1 the value of the attribute to set
+   * \param n2 the name of the attribute to set
+   * \param v2 the value of the attribute to set
+   * \param n3 the name of the attribute to set
+   * \param v3 the value of the attribute to set
+   * \param n4 the name of the attribute to set
+   * \param v4 the value of the attribute to set
+   * \param n5 the name of the attribute to set
+   * \param v5 the value of the attribute to set
+   * \param n6 the name of the attribute to set
+   * \param v6 the value of the attribute to set
+   * \param n7 the name of the attribute to set
+   * \param v7 the value of the attribute to set
+   *
+   * All the attributes specified in this method should exist
+   * in the requested algorithm. The algorithm is installed on the
+   * interfaces of an 802.11ax standard only.
+   */
+  void SetObssPdAlgorithm (std::string type,
+                           std::string n0 = "", const AttributeValue &v0 = EmptyAttributeValue (),
+                           std::string n1 = "", const AttributeValue &v1 = EmptyAttributeValue (),
+                           std::string n2 = "", const AttributeValue &v2 = EmptyAttributeValue (),
+                           std::string n3 = "", const AttributeValue &v3 = EmptyAttributeValue (),
+                           std::string n4 = "", const AttributeValue &v4 = EmptyAttributeValue (),
+                           std::string n5 = "", const AttributeValue &v5 = EmptyAttributeValue (),
+                           std::string n6 = "", const AttributeValue &v6 = EmptyAttributeValue (),
+                           std::string n7 = "", const AttributeValue &v7 = EmptyAttributeValue ());
   /**
    * Set PHY standard
    * \param standard the wifi phy standard
@@ -132,8 +164,10 @@ public:
   /** 
    *  \brief Spread/not spread frequency channels of MP interfaces. 
    * 
-   *  If set to true different non-overlapping 20MHz frequency 
-   *  channels will be assigned to different mesh point interfaces.
+   *  If set to SPREAD_CHANNELS, different non-overlapping frequency
+   *  channels of the channel width of the standard will be assigned
+   *  to different mesh point interfaces, starting with the channel
+   *  the PHY helper configures.
    */
   enum ChannelPolicy
   {
@@ -217,6 +251,24 @@ public:
    */
   int64_t AssignStreams (NetDeviceContainer c, int64_t stream);
 
+  /**
+   * \brief Color the interfaces of mesh points with HE BSS colors, one per
+   * mesh neighborhood.
+   *
+   * The mesh points are taken in order: each one which is not colored yet
+   * heads a neighborhood made of itself and of the mesh points within
+   * range of it which are not colored yet. The neighborhood takes the
+   * lowest color which no mesh point within twice the range of its head
+   * has, so that the neighborhoods which can hear each other have
+   * different colors as long as there are enough of them. The mesh points
+   * must have a mobility model, and their interfaces an HE configuration.
+   *
+   * \param c the mesh point devices, as returned by Install
+   * \param range the radius (m) of a neighborhood
+   * \return the number of colors used
+   */
+  static uint8_t AssignBssColors (NetDeviceContainer c, double range);
+
 
   typedef std::function<std::size_t (Ptr<QueueItem>)> SelectQueueCallback;
   void SetSelectQueueCallback (SelectQueueCallback f);
@@ -225,7 +277,8 @@ private:
   /**
    * \param phyHelper
    * \param node
-   * \param channelId
+   * \param channelId the index of the interface among the non-overlapping
+   *        channels, zero for the channel the PHY helper configures
    * \returns a WifiNetDevice with ready-to-use interface
    */
   Ptr<WifiNetDevice> CreateInterface (const WifiPhyHelper &phyHelper, Ptr<Node> node, uint16_t channelId) const;
@@ -237,6 +290,7 @@ private:
   // Interface factory
   ObjectFactory m_mac; ///< the MAC
   ObjectFactory m_stationManager; ///< the station manager
+  ObjectFactory m_obssPdAlgorithm; ///< the OBSS PD algorithm
   enum WifiPhyStandard m_standard; ///< phy standard
   SelectQueueCallback m_selectQueueCallback; ///< select queue callback
 
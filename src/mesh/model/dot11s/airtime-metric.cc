@@ -79,8 +79,6 @@ AirtimeLinkMetricCalculator::CalculateMetric (Mac48Address peerAddress, Ptr<Mesh
    * Final result is expressed in units of 0.01 Time Unit = 10.24 us (as required by 802.11s draft)
    */
   NS_ASSERT (!peerAddress.IsGroup ());
-  //obtain current rate:
-  WifiMode mode = mac->GetWifiRemoteStationManager ()->GetDataTxVector (peerAddress, &m_testHeader, m_testFrame).GetMode ();
   //obtain frame error rate:
   double failAvg = mac->GetWifiRemoteStationManager ()->GetInfo (peerAddress).GetFrameErrorRate ();
   if (failAvg == 1)
@@ -89,10 +87,8 @@ AirtimeLinkMetricCalculator::CalculateMetric (Mac48Address peerAddress, Ptr<Mesh
       return (uint32_t) 0xffffffff;
     }
   NS_ASSERT (failAvg < 1.0);
-  WifiTxVector txVector;
-  txVector.SetMode (mode);
-  txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
-  txVector = mac->GetWifiRemoteStationManager ()->GetDataTxVector (peerAddress, &m_testHeader, m_testFrame);
+  //obtain current rate:
+  WifiTxVector txVector = mac->GetWifiRemoteStationManager ()->GetDataTxVector (peerAddress, &m_testHeader, m_testFrame);
   //calculate metric
   uint32_t metric = (uint32_t)((double)( /*Overhead + payload*/
                                  mac->GetPifs () + mac->GetSlot () + mac->GetEifsNoDifs () + //DIFS + SIFS + AckTxTime = PIFS + SLOT + EifsNoDifs
@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 #include "ns3/nstime.h"
 #include "ns3/log.h"
+#include "ns3/abort.h"
 #include "dot11s-mac-header.h"
 #include "hwmp-protocol-mac.h"
 #include "hwmp-tag.h"
@@ -115,7 +116,20 @@ HwmpProtocolMac::ReceiveAction (Ptr<Packet> packet, const WifiMacHeader & header
     {
       if ((*i)->ElementId () == IE_RANN)
         {
-          NS_LOG_WARN ("RANN is not supported!");
+          Ptr<IeRann> rann = DynamicCast<IeRann> (*i);
+          NS_ASSERT (rann != 0);
+          m_stats.rxRann++;
+          if (rann->GetOriginatorAddress () == m_protocol->GetAddress ())
+            {
+              continue;
+            }
+          if (rann->GetTtl () == 0)
+            {
+              continue;
+            }
+          rann->DecrementTtl ();
+          m_protocol->ReceiveRann (*rann, header.GetAddr2 (), m_ifIndex, header.GetAddr3 (),
+                                   m_parent->GetLinkMetric (header.GetAddr2 ()));
         }
       if ((*i)->ElementId () == IE_PREQ)
         {
@@ -234,36 +248,23 @@ void
 HwmpProtocolMac::SendPreq (std::vector<IePreq> preq)
 {
   NS_LOG_FUNCTION (this);
-  Ptr<Packet> packet = Create<Packet> ();
-  MeshInformationElementVector elements;
+  std::vector<Ptr<WifiInformationElement> > elements;
   for (std::vector<IePreq>::iterator i = preq.begin (); i != preq.end (); i++)
     {
-      elements.AddInformationElement (Ptr<IePreq> (&(*i)));
-    }
-  packet->AddHeader (elements);
-  packet->AddHeader (GetWifiActionHeader ());
-  //create 802.11 header:
-  WifiMacHeader hdr;
-  hdr.SetType (WIFI_MAC_MGT_ACTION);
-  hdr.SetDsNotFrom ();
-  hdr.SetDsNotTo ();
-  hdr.SetAddr2 (m_parent->GetAddress ());
-  hdr.SetAddr3 (m_protocol->GetAddress ());
-  //Send Management frame
-  std::vector<Mac48Address> receivers = m_protocol->GetPreqReceivers (m_ifIndex);
-  for (std::vector<Mac48Address>::const_iterator i = receivers.begin (); i != receivers.end (); i++)
-    {
-      hdr.SetAddr1 (*i);
-      m_stats.txPreq++;
-      m_stats.txMgt++;
-      m_stats.txMgtBytes += packet->GetSize ();
-      m_parent->SendManagementFrame (packet, hdr);
+      elements.push_back (Create<IePreq> (*i));
     }
+  Send (elements, m_protocol->GetPreqReceivers (m_ifIndex));
 }
 void
-HwmpProtocolMac::RequestDestination (Mac48Address dst, uint32_t originator_seqno, uint32_t dst_seqno)
+HwmpProtocolMac::RequestDestination (Mac48Address dst, uint32_t originator_seqno, uint32_t dst_seqno, bool doFlag, bool rfFlag)
 {
-  NS_LOG_FUNCTION (this << dst << originator_seqno << dst_seqno);
+  NS_LOG_FUNCTION (this << dst << originator_seqno << dst_seqno << doFlag << rfFlag);
+  if (m_batchedPreq != 0 && !m_batchedPreq->IsFull ())
+    {
+      //My PREQ is still waiting for the end of the batch window
+      m_batchedPreq->AddDestinationAddressElement (doFlag, rfFlag, dst, dst_seqno);
+      return;
+    }
   for (std::vector<IePreq>::iterator i = m_myPreq.begin (); i != m_myPreq.end (); i++)
     {
       if (i->IsFull ())
@@ -271,7 +272,7 @@ HwmpProtocolMac::RequestDestination (Mac48Address dst, uint32_t originator_seqno
           continue;
         }
       NS_ASSERT (i->GetDestCount () > 0);
-      i->AddDestinationAddressElement (m_protocol->GetDoFlag (), m_protocol->GetRfFlag (), dst, dst_seqno);
+      i->AddDestinationAddressElement (doFlag, rfFlag, dst, dst_seqno);
     }
   IePreq preq;
   preq.SetHopcount (0);
@@ -280,7 +281,7 @@ HwmpProtocolMac::RequestDestination (Mac48Address dst, uint32_t originator_seqno
   preq.SetOriginatorAddress (m_protocol->GetAddress ());
   preq.SetOriginatorSeqNumber (originator_seqno);
   preq.SetLifetime (m_protocol->GetActivePathLifetime ());
-  preq.AddDestinationAddressElement (m_protocol->GetDoFlag (), m_protocol->GetRfFlag (), dst, dst_seqno);
+  preq.AddDestinationAddressElement (doFlag, rfFlag, dst, dst_seqno);
   m_myPreq.push_back (preq);
   SendMyPreq ();
 }
@@ -299,82 +300,140 @@ HwmpProtocolMac::SendMyPreq ()
   //reschedule sending PREQ
   NS_ASSERT (!m_preqTimer.IsRunning ());
   m_preqTimer = Simulator::Schedule (m_protocol->GetPreqMinInterval (), &HwmpProtocolMac::SendMyPreq, this);
-  SendPreq (m_myPreq);
+  std::vector<Ptr<WifiInformationElement> > elements;
+  Ptr<IePreq> preq;
+  for (std::vector<IePreq>::iterator i = m_myPreq.begin (); i != m_myPreq.end (); i++)
+    {
+      preq = Create<IePreq> (*i);
+      elements.push_back (preq);
+    }
   m_myPreq.clear ();
+  Send (elements, m_protocol->GetPreqReceivers (m_ifIndex));
+  if (m_batchTimer.IsRunning ())
+    {
+      m_batchedPreq = preq;
+    }
 }
 void
 HwmpProtocolMac::SendPrep (IePrep prep, Mac48Address receiver)
 {
   NS_LOG_FUNCTION (this << receiver);
-  //Create packet
-  Ptr<Packet> packet = Create<Packet> ();
-  MeshInformationElementVector elements;
-  elements.AddInformationElement (Ptr<IePrep> (&prep));
-  packet->AddHeader (elements);
-  packet->AddHeader (GetWifiActionHeader ());
-  //create 802.11 header:
-  WifiMacHeader hdr;
-  hdr.SetType (WIFI_MAC_MGT_ACTION);
-  hdr.SetDsNotFrom ();
-  hdr.SetDsNotTo ();
-  hdr.SetAddr1 (receiver);
-  hdr.SetAddr2 (m_parent->GetAddress ());
-  hdr.SetAddr3 (m_protocol->GetAddress ());
-  //Send Management frame
-  m_stats.txPrep++;
-  m_stats.txMgt++;
-  m_stats.txMgtBytes += packet->GetSize ();
-  m_parent->SendManagementFrame (packet, hdr);
+  std::vector<Ptr<WifiInformationElement> > elements;
+  elements.push_back (Create<IePrep> (prep));
+  std::vector<Mac48Address> receivers;
+  receivers.push_back (receiver);
+  Send (elements, receivers);
+}
+void
+HwmpProtocolMac::SendRann (IeRann rann)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Ptr<WifiInformationElement> > elements;
+  elements.push_back (Create<IeRann> (rann));
+  Send (elements, m_protocol->GetPreqReceivers (m_ifIndex));
 }
 void
 HwmpProtocolMac::ForwardPerr (std::vector<HwmpProtocol::FailedDestination> failedDestinations, std::vector<
                                 Mac48Address> receivers)
 {
   NS_LOG_FUNCTION (this);
-  Ptr<Packet> packet = Create<Packet> ();
+  std::vector<Ptr<WifiInformationElement> > elements;
   Ptr<IePerr> perr = Create <IePerr> ();
-  MeshInformationElementVector elements;
   for (std::vector<HwmpProtocol::FailedDestination>::const_iterator i = failedDestinations.begin (); i
        != failedDestinations.end (); i++)
     {
-      if (!perr->IsFull ())
+      if (perr->IsFull ())
         {
-          perr->AddAddressUnit (*i);
+          elements.push_back (perr);
+          perr = Create <IePerr> ();
         }
-      else
+      perr->AddAddressUnit (*i);
+    }
+  if (perr->GetNumOfDest () > 0)
+    {
+      elements.push_back (perr);
+    }
+  if (receivers.size () >= m_protocol->GetUnicastPerrThreshold ())
+    {
+      receivers.clear ();
+      receivers.push_back (Mac48Address::GetBroadcast ());
+    }
+  Send (elements, receivers);
+}
+void
+HwmpProtocolMac::Send (std::vector<Ptr<WifiInformationElement> > elements, const std::vector<Mac48Address> & receivers)
+{
+  NS_LOG_FUNCTION (this);
+  if (elements.empty ())
+    {
+      return;
+    }
+  Time window = m_protocol->GetPathSelectionBatchWindow ();
+  for (std::vector<Mac48Address>::const_iterator i = receivers.begin (); i != receivers.end (); i++)
+    {
+      if (window.IsZero ())
         {
-          elements.AddInformationElement (perr);
-          perr->ResetPerr ();
+          SendElements (elements, *i);
+          continue;
         }
+      std::vector<Ptr<WifiInformationElement> > & batch = m_batch[*i];
+      batch.insert (batch.end (), elements.begin (), elements.end ());
     }
-  if (perr->GetNumOfDest () > 0)
+  if (!window.IsZero () && !m_batchTimer.IsRunning ())
     {
-      elements.AddInformationElement (perr);
+      m_batchTimer = Simulator::Schedule (window, &HwmpProtocolMac::SendBatch, this);
     }
-  packet->AddHeader (elements);
-  packet->AddHeader (GetWifiActionHeader ());
+}
+void
+HwmpProtocolMac::SendBatch ()
+{
+  NS_LOG_FUNCTION (this);
+  m_batchedPreq = 0;
+  std::map<Mac48Address, std::vector<Ptr<WifiInformationElement> > > batch;
+  batch.swap (m_batch);
+  for (std::map<Mac48Address, std::vector<Ptr<WifiInformationElement> > >::const_iterator i = batch.begin ();
+       i != batch.end (); i++)
+    {
+      SendElements (i->second, i->first);
+    }
+}
+void
+HwmpProtocolMac::SendElements (const std::vector<Ptr<WifiInformationElement> > & elements, Mac48Address receiver)
+{
+  NS_LOG_FUNCTION (this << receiver << elements.size ());
   //create 802.11 header:
   WifiMacHeader hdr;
   hdr.SetType (WIFI_MAC_MGT_ACTION);
   hdr.SetDsNotFrom ();
   hdr.SetDsNotTo ();
+  hdr.SetAddr1 (receiver);
   hdr.SetAddr2 (m_parent->GetAddress ());
   hdr.SetAddr3 (m_protocol->GetAddress ());
-  if (receivers.size () >= m_protocol->GetUnicastPerrThreshold ())
+  std::vector<Ptr<WifiInformationElement> >::const_iterator i = elements.begin ();
+  while (i != elements.end ())
     {
-      receivers.clear ();
-      receivers.push_back (Mac48Address::GetBroadcast ());
-    }
-  //Send Management frame
-  for (std::vector<Mac48Address>::const_iterator i = receivers.begin (); i != receivers.end (); i++)
-    {
-      //
-      // 64-bit Intel valgrind complains about hdr.SetAddr1 (*i).  It likes this
-      // just fine.
-      //
-      Mac48Address address = *i;
-      hdr.SetAddr1 (address);
-      m_stats.txPerr++;
+      //Fill a frame with as many elements as it holds
+      MeshInformationElementVector frameElements;
+      bool preq = false;
+      bool prep = false;
+      bool perr = false;
+      bool rann = false;
+      for (; i != elements.end () && frameElements.AddInformationElement (*i); i++)
+        {
+          preq |= ((*i)->ElementId () == IE_PREQ);
+          prep |= ((*i)->ElementId () == IE_PREP);
+          perr |= ((*i)->ElementId () == IE_PERR);
+          rann |= ((*i)->ElementId () == IE_RANN);
+        }
+      NS_ABORT_MSG_IF (frameElements.Begin () == frameElements.End (), "Information element does not fit in a frame");
+      Ptr<Packet> packet = Create<Packet> ();
+      packet->AddHeader (frameElements);
+      packet->AddHeader (GetWifiActionHeader ());
+      //Send Management frame
+      m_stats.txPreq += preq;
+      m_stats.txPrep += prep;
+      m_stats.txPerr += perr;
+      m_stats.txRann += rann;
       m_stats.txMgt++;
       m_stats.txMgtBytes += packet->GetSize ();
       m_parent->SendManagementFrame (packet, hdr);
@@ -447,13 +506,18 @@ HwmpProtocolMac::GetLinkMetric (Mac48Address peerAddress) const
 {
   return m_parent->GetLinkMetric (peerAddress);
 }
+uint32_t
+HwmpProtocolMac::GetQueueSize () const
+{
+  return m_parent->GetQueueSize ();
+}
 uint16_t
 HwmpProtocolMac::GetChannelId () const
 {
   return m_parent->GetFrequencyChannel ();
 }
 HwmpProtocolMac::Statistics::Statistics () :
-  txPreq (0), rxPreq (0), txPrep (0), rxPrep (0), txPerr (0), rxPerr (0), txMgt (0), txMgtBytes (0),
+  txPreq (0), rxPreq (0), txPrep (0), rxPrep (0), txPerr (0), rxPerr (0), txRann (0), rxRann (0), txMgt (0), txMgtBytes (0),
   rxMgt (0), rxMgtBytes (0), txData (0), txDataBytes (0), rxData (0), rxDataBytes (0)
 {
 }
@@ -464,9 +528,11 @@ HwmpProtocolMac::Statistics::Print (std::ostream & os) const
   "txPreq= \"" << txPreq << "\"" << std::endl <<
   "txPrep=\"" << txPrep << "\"" << std::endl <<
   "txPerr=\"" << txPerr << "\"" << std::endl <<
+  "txRann=\"" << txRann << "\"" << std::endl <<
   "rxPreq=\"" << rxPreq << "\"" << std::endl <<
   "rxPrep=\"" << rxPrep << "\"" << std::endl <<
   "rxPerr=\"" << rxPerr << "\"" << std::endl <<
+  "rxRann=\"" << rxRann << "\"" << std::endl <<
   "txMgt=\"" << txMgt << "\"" << std::endl <<
   "txMgtBytes=\"" << txMgtBytes << "\"" << std::endl <<
   "rxMgt=\"" << rxMgt << "\"" << std::endl <<
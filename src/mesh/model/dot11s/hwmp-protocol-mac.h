@@ -23,11 +23,13 @@
 
 #include "ns3/mesh-wifi-interface-mac-plugin.h"
 #include "ns3/hwmp-protocol.h"
+#include <map>
 
 namespace ns3 {
 
 class MeshWifiInterfaceMac;
 class WifiActionHeader;
+class WifiInformationElement;
 
 namespace dot11s {
 
@@ -35,11 +37,18 @@ class HwmpProtocol;
 class IePreq;
 class IePrep;
 class IePerr;
+class IeRann;
 
 /**
  * \ingroup dot11s
  *
  * \brief Interface MAC plugin for HWMP -- 802.11s routing protocol
+ *
+ * When the PathSelectionBatchWindow attribute of HWMP is not zero, the
+ * PREQ, PREP and PERR elements are not sent at once, but queued by
+ * receiver for the duration of the window, then sent in as few frames
+ * as possible.  The destinations requested during the window are added
+ * to my PREQ which waits in the queue, if it is not full.
  */
 class HwmpProtocolMac : public MeshWifiInterfaceMacPlugin
 {
@@ -87,6 +96,11 @@ private:
    * \param receiver the MAC address of the receiver
    */
   void SendPrep (IePrep prep, Mac48Address receiver);
+  /**
+   * Send RANN function
+   * \param rann the RANN information element
+   */
+  void SendRann (IeRann rann);
   /**
    * Forward a path error
    * \param destinations vector of failed destinations
@@ -105,19 +119,41 @@ private:
    * \param dest is the destination to be resolved
    * \param originator_seqno is a sequence number that shall be preq originator sequenece number
    * \param dst_seqno is a sequence number taken from routing table
+   * \param doFlag the destination only flag of the destination
+   * \param rfFlag the reply and forward flag of the destination
    */
-  void RequestDestination (Mac48Address dest, uint32_t originator_seqno, uint32_t dst_seqno);
+  void RequestDestination (Mac48Address dest, uint32_t originator_seqno, uint32_t dst_seqno, bool doFlag, bool rfFlag);
   //\}
 
   /// Sends one PREQ when PreqMinInterval after last PREQ expires (if any PREQ exists in rhe queue)
   void SendMyPreq ();
   /// Send PERR function
   void SendMyPerr ();
+  /**
+   * Send path selection information elements to each receiver, either
+   * at once or at the end of the batch window.
+   *
+   * \param elements the information elements
+   * \param receivers the MAC addresses of the receivers
+   */
+  void Send (std::vector<Ptr<WifiInformationElement> > elements, const std::vector<Mac48Address> & receivers);
+  /// Send the information elements queued during the batch window
+  void SendBatch ();
+  /**
+   * Send path selection information elements to a receiver, in as few
+   * frames as possible.
+   *
+   * \param elements the information elements
+   * \param receiver the MAC address of the receiver
+   */
+  void SendElements (const std::vector<Ptr<WifiInformationElement> > & elements, Mac48Address receiver);
   /**
    * \param peerAddress peer address
    * \return metric to HWMP protocol, needed only by metrics to add peer as routing entry
    */
   uint32_t GetLinkMetric (Mac48Address peerAddress) const;
+  /// \return the number of frames waiting in the queues of the interface
+  uint32_t GetQueueSize () const;
   /**
    * Get the channel ID 
    * \returns the channel ID
@@ -149,6 +185,13 @@ private:
     std::vector<Mac48Address> receivers; ///< receivers
   };
   MyPerr m_myPerr; ///< PERR
+  //\}
+  ///\name Information elements queued during the batch window
+  //\{
+  EventId m_batchTimer; ///< end of the batch window
+  std::map<Mac48Address, std::vector<Ptr<WifiInformationElement> > > m_batch; ///< queued elements, by receiver
+  Ptr<IePreq> m_batchedPreq; ///< my last queued PREQ
+  //\}
   ///\name Statistics:
   //\{
   /// Statistics structure
@@ -160,6 +203,8 @@ private:
     uint16_t rxPrep; ///< receive PREP
     uint16_t txPerr; ///< transmit PERR
     uint16_t rxPerr; ///< receive PERR
+    uint16_t txRann; ///< transmit RANN
+    uint16_t rxRann; ///< receive RANN
     uint16_t txMgt; ///< transmit management
     uint32_t txMgtBytes; ///< transmit management bytes
     uint16_t rxMgt; ///< receive management
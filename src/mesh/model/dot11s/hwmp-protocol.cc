@@ -32,8 +32,12 @@
 #include "airtime-metric.h"
 #include "ie-dot11s-preq.h"
 #include "ie-dot11s-prep.h"
+#include "ie-dot11s-rann.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/enum.h"
 #include "ie-dot11s-perr.h"
+#include <algorithm>
+#include <limits>
 
 namespace ns3 {
 
@@ -64,6 +68,14 @@ HwmpProtocol::GetTypeId ()
                       &HwmpProtocol::m_maxQueueSize),
                     MakeUintegerChecker<uint16_t> (1)
                     )
+    .AddAttribute ( "QueueDropPolicy",
+                    "Upon queuing with a full queue, drop the oldest (DropOldest) or the newest (DropNewest) packet",
+                    EnumValue (DROP_NEWEST),
+                    MakeEnumAccessor (
+                      &HwmpProtocol::m_queueDropPolicy),
+                    MakeEnumChecker (DROP_OLDEST, "DropOldest",
+                                     DROP_NEWEST, "DropNewest")
+                    )
     .AddAttribute ( "Dot11MeshHWMPmaxPREQretries",
                     "Maximum number of retries before we suppose the destination to be unreachable",
                     UintegerValue (3),
@@ -113,12 +125,52 @@ HwmpProtocol::GetTypeId ()
                     MakeTimeChecker ()
                     )
     .AddAttribute ( "Dot11MeshHWMPrannInterval",
-                    "Lifetime of poractive routing information",
+                    "Interval between two successive RANNs",
                     TimeValue (MicroSeconds (1024*5000)),
                     MakeTimeAccessor (
                       &HwmpProtocol::m_dot11MeshHWMPrannInterval),
                     MakeTimeChecker ()
                     )
+    .AddAttribute ( "PathSelectionBatchWindow",
+                    "Time during which the PREQ, PREP and PERR elements sent by an interface are queued, "
+                    "to be sent in as few frames as possible. Zero sends each of them at once.",
+                    TimeValue (Seconds (0)),
+                    MakeTimeAccessor (
+                      &HwmpProtocol::m_pathSelectionBatchWindow),
+                    MakeTimeChecker (Seconds (0))
+                    )
+    .AddAttribute ( "RootMode",
+                    "How a root announces itself: with proactive PREQs, answered by a PREP of each mesh point (ProactivePreq), "
+                    "or with RANNs, answered by a PREP only when the path back to the mesh point broke or is about to expire (Rann)",
+                    EnumValue (PROACTIVE_PREQ),
+                    MakeEnumAccessor (
+                      &HwmpProtocol::m_rootMode),
+                    MakeEnumChecker (PROACTIVE_PREQ, "ProactivePreq",
+                                     RANN, "Rann")
+                    )
+    .AddAttribute ( "RootLoadMetric",
+                    "Metric added by a root to its announcements for each Mbps it received since the previous one, "
+                    "so that the mesh points favor the least loaded roots. Zero announces the path metric only.",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (
+                      &HwmpProtocol::m_rootLoadMetric),
+                    MakeUintegerChecker<uint32_t> ()
+                    )
+    .AddAttribute ( "RootPathRepair",
+                    "Request a broken path to a root at once from the neighbours, rather than wait for the next announcement",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (
+                      &HwmpProtocol::m_rootPathRepair),
+                    MakeBooleanChecker ()
+                    )
+    .AddAttribute ( "MultiChannelForwarding",
+                    "Split the unicast frames to a next hop between the peer links to it on the different interfaces, "
+                    "choosing for each frame the link of least airtime metric times one plus the frames waiting on its interface",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (
+                      &HwmpProtocol::m_multiChannelForwarding),
+                    MakeBooleanChecker ()
+                    )
     .AddAttribute ( "MaxTtl",
                     "Initial value of Time To Live field",
                     UintegerValue (32),
@@ -172,6 +224,11 @@ HwmpProtocol::GetTypeId ()
                      MakeTraceSourceAccessor (&HwmpProtocol::m_routeChangeTraceSource),
                      "ns3::HwmpProtocol::RouteChangeTracedCallback"
                      )
+    .AddTraceSource ("QueueingDelay",
+                     "The time spent in the queue by a packet sent once its path is resolved",
+                     MakeTraceSourceAccessor (&HwmpProtocol::m_queueingDelayTrace),
+                     "ns3::Time::TracedCallback"
+                     )
   ;
   return tid;
 }
@@ -181,8 +238,10 @@ HwmpProtocol::HwmpProtocol () :
   m_hwmpSeqno (1),
   m_preqId (0),
   m_rtable (CreateObject<HwmpRtable> ()),
+  m_rootRxBytes (0),
   m_randomStart (Seconds (0.1)),
   m_maxQueueSize (255),
+  m_queueDropPolicy (DROP_NEWEST),
   m_dot11MeshHWMPmaxPREQretries (3),
   m_dot11MeshHWMPnetDiameterTraversalTime (MicroSeconds (1024*100)),
   m_dot11MeshHWMPpreqMinInterval (MicroSeconds (1024*100)),
@@ -191,7 +250,12 @@ HwmpProtocol::HwmpProtocol () :
   m_dot11MeshHWMPactivePathTimeout (MicroSeconds (1024*5000)),
   m_dot11MeshHWMPpathToRootInterval (MicroSeconds (1024*2000)),
   m_dot11MeshHWMPrannInterval (MicroSeconds (1024*5000)),
+  m_pathSelectionBatchWindow (Seconds (0)),
   m_isRoot (false),
+  m_rootMode (PROACTIVE_PREQ),
+  m_rootLoadMetric (0),
+  m_rootPathRepair (false),
+  m_multiChannelForwarding (false),
   m_maxTtl (32),
   m_unicastPerrThreshold (32),
   m_unicastPreqThreshold (1),
@@ -216,7 +280,14 @@ HwmpProtocol::DoInitialize ()
   if (m_isRoot)
     {
       Time randomStart = Seconds (m_coefficient->GetValue ());
-      m_proactivePreqTimer = Simulator::Schedule (randomStart, &HwmpProtocol::SendProactivePreq, this);
+      if (m_rootMode == RANN)
+        {
+          m_proactivePreqTimer = Simulator::Schedule (randomStart, &HwmpProtocol::SendRann, this);
+        }
+      else
+        {
+          m_proactivePreqTimer = Simulator::Schedule (randomStart, &HwmpProtocol::SendProactivePreq, this);
+        }
     }
 }
 
@@ -228,12 +299,22 @@ HwmpProtocol::DoDispose ()
     {
       i->second.preqTimeout.Cancel ();
     }
+  for (std::map<Mac48Address, RootRegistration>::iterator i = m_rootRegistrations.begin (); i != m_rootRegistrations.end (); i++)
+    {
+      i->second.event.Cancel ();
+    }
   m_proactivePreqTimer.Cancel ();
   m_preqTimeouts.clear ();
+  m_rootRegistrations.clear ();
+  m_rootRepairs.clear ();
+  m_receivers.clear ();
+  m_peerMeshPoints.clear ();
+  m_peerLinks.clear ();
   m_lastDataSeqno.clear ();
   m_hwmpSeqnoMetricDatabase.clear ();
   m_interfaces.clear ();
   m_rqueue.clear ();
+  m_rqueueByDst.clear ();
   m_rtable = 0;
   m_mp = 0;
 }
@@ -299,7 +380,7 @@ HwmpProtocol::RequestRoute (
               continue;
             }
           channels.push_back (plugin->second->GetChannelId ());
-          std::vector<Mac48Address> receivers = GetBroadcastReceivers (plugin->first);
+          const std::vector<Mac48Address> & receivers = GetBroadcastReceivers (plugin->first);
           for (std::vector<Mac48Address>::const_iterator i = receivers.begin (); i != receivers.end (); i++)
             {
               Ptr<Packet> packetCopy = packet->Copy ();
@@ -329,6 +410,10 @@ HwmpProtocol::RemoveRoutingStuff (uint32_t fromIface, const Mac48Address source,
     {
       NS_FATAL_ERROR ("HWMP tag must exist when packet received from the network");
     }
+  if (m_isRoot && destination == GetAddress ())
+    {
+      m_rootRxBytes += packet->GetSize ();
+    }
   return true;
 }
 bool
@@ -339,10 +424,18 @@ HwmpProtocol::ForwardUnicast (uint32_t  sourceIface, const Mac48Address source,
   NS_ASSERT (destination != Mac48Address::GetBroadcast ());
   HwmpRtable::LookupResult result = m_rtable->LookupReactive (destination);
   NS_LOG_DEBUG ("Requested src = "<<source<<", dst = "<<destination<<", I am "<<GetAddress ()<<", RA = "<<result.retransmitter);
+  if (result.retransmitter == Mac48Address::GetBroadcast ())
+    {
+      result = m_rtable->LookupProactive (destination);
+    }
   if (result.retransmitter == Mac48Address::GetBroadcast ())
     {
       result = m_rtable->LookupProactive ();
     }
+  if (result.retransmitter != Mac48Address::GetBroadcast ())
+    {
+      SelectPeerLink (result.ifIndex, result.retransmitter);
+    }
   HwmpTag tag;
   tag.SetAddress (result.retransmitter);
   tag.SetTtl (ttl);
@@ -394,7 +487,7 @@ HwmpProtocol::ForwardUnicast (uint32_t  sourceIface, const Mac48Address source,
       m_stats.initiatedPreq++;
       for (HwmpProtocolMacMap::const_iterator i = m_interfaces.begin (); i != m_interfaces.end (); i++)
         {
-          i->second->RequestDestination (destination, originator_seqno, dst_seqno);
+          i->second->RequestDestination (destination, originator_seqno, dst_seqno, m_doFlag, m_rfFlag);
         }
     }
   QueuedPacket pkt;
@@ -508,11 +601,11 @@ HwmpProtocol::ReceivePreq (IePreq preq, Mac48Address from, uint32_t interface, M
           //per destination flags DO and RF
           NS_ASSERT (preq.GetDestCount () == 1);
           NS_ASSERT (((*i)->IsDo ()) && ((*i)->IsRf ()));
-          //Add proactive path only if it is the better then existed
-          //before
+          //Add proactive path to this root only if it is the better
+          //then existed before
           if (
-            ((m_rtable->LookupProactive ()).retransmitter == Mac48Address::GetBroadcast ()) ||
-            ((m_rtable->LookupProactive ()).metric > preq.GetMetric ())
+            ((m_rtable->LookupProactive (preq.GetOriginatorAddress ())).retransmitter == Mac48Address::GetBroadcast ()) ||
+            ((m_rtable->LookupProactive (preq.GetOriginatorAddress ())).metric > preq.GetMetric ())
             )
             {
               m_rtable->AddProactivePath (
@@ -533,6 +626,7 @@ HwmpProtocol::ReceivePreq (IePreq preq, Mac48Address from, uint32_t interface, M
               rChange.lifetime = MicroSeconds (preq.GetLifetime () * 1024);
               rChange.seqnum = preq.GetOriginatorSeqNumber ();
               m_routeChangeTraceSource (rChange);
+              m_rootRepairs.erase (preq.GetOriginatorAddress ());
               ProactivePathResolved ();
             }
           if (!preq.IsNeedNotPrep ())
@@ -671,6 +765,30 @@ HwmpProtocol::ReceivePrep (IePrep prep, Mac48Address from, uint32_t interface, M
                                   result.lifetime);
         }
       ReactivePathResolved (prep.GetOriginatorAddress ());
+      if (m_rootRepairs.erase (prep.GetOriginatorAddress ()) > 0)
+        {
+          //The path to a root is repaired: it is proactive again, and
+          //the root needs the new path back
+          m_rtable->AddProactivePath (
+            prep.GetMetric (),
+            prep.GetOriginatorAddress (),
+            from,
+            interface,
+            m_dot11MeshHWMPactiveRootTimeout,
+            sequence);
+          // Notify trace source of routing change
+          struct RouteChange rChange;
+          rChange.type = "Add Proactive";
+          rChange.destination = prep.GetOriginatorAddress ();
+          rChange.retransmitter = from;
+          rChange.interface = interface;
+          rChange.metric = prep.GetMetric ();
+          rChange.lifetime = m_dot11MeshHWMPactiveRootTimeout;
+          rChange.seqnum = sequence;
+          m_routeChangeTraceSource (rChange);
+          RegisterWithRoot (prep.GetOriginatorAddress (), sequence);
+          ProactivePathResolved ();
+        }
     }
   if (
     ((m_rtable->LookupReactive (fromMp)).retransmitter == Mac48Address::GetBroadcast ()) ||
@@ -737,6 +855,61 @@ HwmpProtocol::ReceivePerr (std::vector<FailedDestination> destinations, Mac48Add
   ForwardPathError (MakePathError (retval));
 }
 void
+HwmpProtocol::ReceiveRann (IeRann rann, Mac48Address from, uint32_t interface, Mac48Address fromMp, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << from << interface << fromMp << metric);
+  rann.IncrementMetric (metric);
+  Mac48Address root = rann.GetOriginatorAddress ();
+  uint32_t seqno = rann.GetDestSeqNumber ();
+  //acceptance cretirea, as for a PREQ:
+  std::map<Mac48Address, std::pair<uint32_t, uint32_t> >::const_iterator i = m_hwmpSeqnoMetricDatabase.find (root);
+  if (i != m_hwmpSeqnoMetricDatabase.end ())
+    {
+      if ((int32_t)(i->second.first - seqno) > 0)
+        {
+          return;
+        }
+      if ((i->second.first == seqno) && (i->second.second <= rann.GetMetric ()))
+        {
+          return;
+        }
+    }
+  m_hwmpSeqnoMetricDatabase[root] = std::make_pair (seqno, rann.GetMetric ());
+  NS_LOG_DEBUG ("I am " << GetAddress () << ", Accepted rann from address" << from << ", rann:" << rann);
+  m_rtable->AddProactivePath (rann.GetMetric (), root, from, interface, m_dot11MeshHWMPactiveRootTimeout, seqno);
+  // Notify trace source of routing change
+  struct RouteChange rChange;
+  rChange.type = "Add Proactive";
+  rChange.destination = root;
+  rChange.retransmitter = from;
+  rChange.interface = interface;
+  rChange.metric = rann.GetMetric ();
+  rChange.lifetime = m_dot11MeshHWMPactiveRootTimeout;
+  rChange.seqnum = seqno;
+  m_routeChangeTraceSource (rChange);
+  //The reactive path lets the PREPs to the root be forwarded
+  m_rtable->AddReactivePath (root, from, interface, rann.GetMetric (), m_dot11MeshHWMPactiveRootTimeout, seqno);
+  rChange.type = "Add Reactive";
+  m_routeChangeTraceSource (rChange);
+  //The RANNs of the root along better paths arrive within the network
+  //diameter traversal time: register along the best one
+  RootRegistration & registration = m_rootRegistrations[root];
+  if (!registration.event.IsRunning ())
+    {
+      registration.event = Simulator::Schedule (m_dot11MeshHWMPnetDiameterTraversalTime,
+                                                &HwmpProtocol::RegisterWithRoot, this, root, seqno);
+    }
+  m_rootRepairs.erase (root);
+  ReactivePathResolved (root);
+  ProactivePathResolved ();
+  //Forward RANN to all interfaces:
+  NS_LOG_DEBUG ("I am " << GetAddress () << "retransmitting RANN:" << rann);
+  for (HwmpProtocolMacMap::const_iterator j = m_interfaces.begin (); j != m_interfaces.end (); j++)
+    {
+      j->second->SendRann (rann);
+    }
+}
+void
 HwmpProtocol::SendPrep (
   Mac48Address src,
   Mac48Address dst,
@@ -798,18 +971,38 @@ void
 HwmpProtocol::PeerLinkStatus (Mac48Address meshPointAddress, Mac48Address peerAddress, uint32_t interface, bool status)
 {
   NS_LOG_FUNCTION (this << meshPointAddress << peerAddress << interface << status);
+  //The peers of the interface changed
+  m_receivers.erase (interface);
+  std::vector<std::pair<uint32_t, Mac48Address> > & links = m_peerLinks[meshPointAddress];
+  std::vector<std::pair<uint32_t, Mac48Address> >::iterator link = std::find (links.begin (), links.end (),
+                                                                              std::make_pair (interface, peerAddress));
   if (status)
     {
+      if (link == links.end ())
+        {
+          links.push_back (std::make_pair (interface, peerAddress));
+        }
+      m_peerMeshPoints[peerAddress] = meshPointAddress;
       return;
     }
+  if (link != links.end ())
+    {
+      links.erase (link);
+    }
+  if (links.empty ())
+    {
+      m_peerLinks.erase (meshPointAddress);
+    }
+  m_peerMeshPoints.erase (peerAddress);
   std::vector<FailedDestination> destinations = m_rtable->GetUnreachableDestinations (peerAddress);
   NS_LOG_DEBUG (destinations.size () << " failed destinations for peer address " << peerAddress);
   InitiatePathError (MakePathError (destinations));
 }
 void
-HwmpProtocol::SetNeighboursCallback (Callback<std::vector<Mac48Address>, uint32_t> cb)
+HwmpProtocol::SetNeighboursCallback (Callback<const std::vector<Mac48Address> &, uint32_t> cb)
 {
   m_neighboursCallback = cb;
+  m_receivers.clear ();
 }
 bool
 HwmpProtocol::DropDataFrame (uint32_t seqno, Mac48Address source)
@@ -909,6 +1102,7 @@ HwmpProtocol::GetPerrReceivers (std::vector<FailedDestination> failedDest)
       rChange.destination = failedDest[i].destination;
       rChange.seqnum = failedDest[i].seqnum;
       m_routeChangeTraceSource (rChange);
+      HwmpRtable::LookupResult root = m_rtable->LookupProactiveExpired (failedDest[i].destination);
       m_rtable->DeleteProactivePath (failedDest[i].destination);
       // Notify trace source of routing change
       struct RouteChange rChangePro;
@@ -916,6 +1110,16 @@ HwmpProtocol::GetPerrReceivers (std::vector<FailedDestination> failedDest)
       rChangePro.destination = failedDest[i].destination;
       rChangePro.seqnum = failedDest[i].seqnum;
       m_routeChangeTraceSource (rChangePro);
+      if (root.retransmitter != Mac48Address::GetBroadcast ())
+        {
+          std::map<Mac48Address, RootRegistration>::iterator registration = m_rootRegistrations.find (failedDest[i].destination);
+          if (registration != m_rootRegistrations.end ())
+            {
+              registration->second.whenSent = Seconds (0);
+            }
+          //After the PERR is sent, so that the precursors do not answer
+          Simulator::ScheduleNow (&HwmpProtocol::RepairRootPath, this, failedDest[i].destination, root.seqnum);
+        }
       for (unsigned int j = 0; j < precursors.size (); j++)
         {
           retval.push_back (precursors[j]);
@@ -934,37 +1138,49 @@ HwmpProtocol::GetPerrReceivers (std::vector<FailedDestination> failedDest)
     }
   return retval;
 }
-std::vector<Mac48Address>
+const std::vector<Mac48Address> &
 HwmpProtocol::GetPreqReceivers (uint32_t interface)
 {
   NS_LOG_FUNCTION (this << interface);
-  std::vector<Mac48Address> retval;
-  if (!m_neighboursCallback.IsNull ())
-    {
-      retval = m_neighboursCallback (interface);
-    }
-  if ((retval.size () >= m_unicastPreqThreshold) || (retval.size () == 0))
+  //The receivers are chosen again only when a peer link of the interface
+  //is established or closed, or when the threshold changed
+  Receivers & receivers = m_receivers[interface];
+  if (receivers.preq.empty () || (receivers.unicastPreqThreshold != m_unicastPreqThreshold))
     {
-      retval.clear ();
-      retval.push_back (Mac48Address::GetBroadcast ());
+      receivers.unicastPreqThreshold = m_unicastPreqThreshold;
+      receivers.preq.clear ();
+      if (!m_neighboursCallback.IsNull ())
+        {
+          receivers.preq = m_neighboursCallback (interface);
+        }
+      if ((receivers.preq.size () >= m_unicastPreqThreshold) || (receivers.preq.size () == 0))
+        {
+          receivers.preq.clear ();
+          receivers.preq.push_back (Mac48Address::GetBroadcast ());
+        }
     }
-  return retval;
+  return receivers.preq;
 }
-std::vector<Mac48Address>
+const std::vector<Mac48Address> &
 HwmpProtocol::GetBroadcastReceivers (uint32_t interface)
 {
   NS_LOG_FUNCTION (this << interface);
-  std::vector<Mac48Address> retval;
-  if (!m_neighboursCallback.IsNull ())
-    {
-      retval = m_neighboursCallback (interface);
-    }
-  if ((retval.size () >= m_unicastDataThreshold) || (retval.size () == 0))
+  Receivers & receivers = m_receivers[interface];
+  if (receivers.broadcast.empty () || (receivers.unicastDataThreshold != m_unicastDataThreshold))
     {
-      retval.clear ();
-      retval.push_back (Mac48Address::GetBroadcast ());
+      receivers.unicastDataThreshold = m_unicastDataThreshold;
+      receivers.broadcast.clear ();
+      if (!m_neighboursCallback.IsNull ())
+        {
+          receivers.broadcast = m_neighboursCallback (interface);
+        }
+      if ((receivers.broadcast.size () >= m_unicastDataThreshold) || (receivers.broadcast.size () == 0))
+        {
+          receivers.broadcast.clear ();
+          receivers.broadcast.push_back (Mac48Address::GetBroadcast ());
+        }
     }
-  return retval;
+  return receivers.broadcast;
 }
 
 bool
@@ -973,9 +1189,17 @@ HwmpProtocol::QueuePacket (QueuedPacket packet)
   NS_LOG_FUNCTION (this);
   if (m_rqueue.size () > m_maxQueueSize)
     {
-      return false;
+      if (m_queueDropPolicy == DROP_NEWEST)
+        {
+          return false;
+        }
+      QueuedPacket oldest = DequeueFirstPacket ();
+      NS_LOG_DEBUG ("Dropping packet from " << oldest.src << " to " << oldest.dst << " due to queue overflow");
+      m_stats.totalDropped++;
+      oldest.reply (false, oldest.pkt, oldest.src, oldest.dst, oldest.protocol, HwmpRtable::MAX_METRIC);
     }
-  m_rqueue.push_back (packet);
+  packet.whenQueued = Simulator::Now ();
+  m_rqueueByDst[packet.dst].push_back (m_rqueue.insert (m_rqueue.end (), packet));
   return true;
 }
 
@@ -985,13 +1209,15 @@ HwmpProtocol::DequeueFirstPacketByDst (Mac48Address dst)
   NS_LOG_FUNCTION (this << dst);
   QueuedPacket retval;
   retval.pkt = 0;
-  for (std::vector<QueuedPacket>::iterator i = m_rqueue.begin (); i != m_rqueue.end (); i++)
+  std::map<Mac48Address, std::deque<std::list<QueuedPacket>::iterator> >::iterator i = m_rqueueByDst.find (dst);
+  if (i != m_rqueueByDst.end ())
     {
-      if ((*i).dst == dst)
+      retval = *i->second.front ();
+      m_rqueue.erase (i->second.front ());
+      i->second.pop_front ();
+      if (i->second.empty ())
         {
-          retval = (*i);
-          m_rqueue.erase (i);
-          break;
+          m_rqueueByDst.erase (i);
         }
     }
   return retval;
@@ -1005,8 +1231,16 @@ HwmpProtocol::DequeueFirstPacket ()
   retval.pkt = 0;
   if (m_rqueue.size () != 0)
     {
-      retval = m_rqueue[0];
-      m_rqueue.erase (m_rqueue.begin ());
+      retval = m_rqueue.front ();
+      // The first packet of the queue is also the first one to its destination
+      std::map<Mac48Address, std::deque<std::list<QueuedPacket>::iterator> >::iterator i = m_rqueueByDst.find (retval.dst);
+      NS_ASSERT (i != m_rqueueByDst.end () && i->second.front () == m_rqueue.begin ());
+      i->second.pop_front ();
+      if (i->second.empty ())
+        {
+          m_rqueueByDst.erase (i);
+        }
+      m_rqueue.pop_front ();
     }
   return retval;
 }
@@ -1027,14 +1261,18 @@ HwmpProtocol::ReactivePathResolved (Mac48Address dst)
   QueuedPacket packet = DequeueFirstPacketByDst (dst);
   while (packet.pkt != 0)
     {
+      uint32_t ifIndex = result.ifIndex;
+      Mac48Address retransmitter = result.retransmitter;
+      SelectPeerLink (ifIndex, retransmitter);
       //set RA tag for retransmitter:
       HwmpTag tag;
       packet.pkt->RemovePacketTag (tag);
-      tag.SetAddress (result.retransmitter);
+      tag.SetAddress (retransmitter);
       packet.pkt->AddPacketTag (tag);
       m_stats.txUnicast++;
       m_stats.txBytes += packet.pkt->GetSize ();
-      packet.reply (true, packet.pkt, packet.src, packet.dst, packet.protocol, result.ifIndex);
+      m_queueingDelayTrace (Simulator::Now () - packet.whenQueued);
+      packet.reply (true, packet.pkt, packet.src, packet.dst, packet.protocol, ifIndex);
 
       packet = DequeueFirstPacketByDst (dst);
     }
@@ -1043,12 +1281,18 @@ void
 HwmpProtocol::ProactivePathResolved ()
 {
   NS_LOG_FUNCTION (this);
-  //send all packets to root
-  HwmpRtable::LookupResult result = m_rtable->LookupProactive ();
-  NS_ASSERT (result.retransmitter != Mac48Address::GetBroadcast ());
+  //send all packets to roots
+  HwmpRtable::LookupResult best = m_rtable->LookupProactive ();
+  NS_ASSERT (best.retransmitter != Mac48Address::GetBroadcast ());
   QueuedPacket packet = DequeueFirstPacket ();
   while (packet.pkt != 0)
     {
+      HwmpRtable::LookupResult result = m_rtable->LookupProactive (packet.dst);
+      if (result.retransmitter == Mac48Address::GetBroadcast ())
+        {
+          result = best;
+        }
+      SelectPeerLink (result.ifIndex, result.retransmitter);
       //set RA tag for retransmitter:
       HwmpTag tag;
       if (!packet.pkt->RemovePacketTag (tag))
@@ -1059,12 +1303,49 @@ HwmpProtocol::ProactivePathResolved ()
       packet.pkt->AddPacketTag (tag);
       m_stats.txUnicast++;
       m_stats.txBytes += packet.pkt->GetSize ();
+      m_queueingDelayTrace (Simulator::Now () - packet.whenQueued);
       packet.reply (true, packet.pkt, packet.src, packet.dst, packet.protocol, result.ifIndex);
 
       packet = DequeueFirstPacket ();
     }
 }
 
+void
+HwmpProtocol::SelectPeerLink (uint32_t & interface, Mac48Address & retransmitter)
+{
+  NS_LOG_FUNCTION (this << interface << retransmitter);
+  if (!m_multiChannelForwarding)
+    {
+      return;
+    }
+  std::map<Mac48Address, Mac48Address>::const_iterator peer = m_peerMeshPoints.find (retransmitter);
+  if (peer == m_peerMeshPoints.end ())
+    {
+      return;
+    }
+  std::map<Mac48Address, std::vector<std::pair<uint32_t, Mac48Address> > >::const_iterator links =
+    m_peerLinks.find (peer->second);
+  if ((links == m_peerLinks.end ()) || (links->second.size () < 2))
+    {
+      return;
+    }
+  uint64_t bestCost = std::numeric_limits<uint64_t>::max ();
+  for (std::vector<std::pair<uint32_t, Mac48Address> >::const_iterator i = links->second.begin ();
+       i != links->second.end (); ++i)
+    {
+      HwmpProtocolMacMap::const_iterator plugin = m_interfaces.find (i->first);
+      NS_ASSERT (plugin != m_interfaces.end ());
+      uint64_t cost = static_cast<uint64_t> (plugin->second->GetLinkMetric (i->second))
+        * (1 + plugin->second->GetQueueSize ());
+      if (cost < bestCost)
+        {
+          bestCost = cost;
+          interface = i->first;
+          retransmitter = i->second;
+        }
+    }
+}
+
 bool
 HwmpProtocol::ShouldSendPreq (Mac48Address dst)
 {
@@ -1085,8 +1366,9 @@ HwmpProtocol::RetryPathDiscovery (Mac48Address dst, uint8_t numOfRetry)
 {
   NS_LOG_FUNCTION (this << dst << (uint16_t) numOfRetry);
   HwmpRtable::LookupResult result = m_rtable->LookupReactive (dst);
-  if (result.retransmitter == Mac48Address::GetBroadcast ())
+  if (result.retransmitter == Mac48Address::GetBroadcast () && m_rootRepairs.count (dst) == 0)
     {
+      //The path to a root being repaired is not resolved by the other roots
       result = m_rtable->LookupProactive ();
     }
   if (result.retransmitter != Mac48Address::GetBroadcast ())
@@ -1110,6 +1392,7 @@ HwmpProtocol::RetryPathDiscovery (Mac48Address dst, uint8_t numOfRetry)
       NS_ASSERT (i != m_preqTimeouts.end ());
       m_routeDiscoveryTimeCallback (Simulator::Now () - i->second.whenScheduled);
       m_preqTimeouts.erase (i);
+      m_rootRepairs.erase (dst);
       return;
     }
   numOfRetry++;
@@ -1117,7 +1400,7 @@ HwmpProtocol::RetryPathDiscovery (Mac48Address dst, uint8_t numOfRetry)
   uint32_t dst_seqno = m_rtable->LookupReactiveExpired (dst).seqnum;
   for (HwmpProtocolMacMap::const_iterator i = m_interfaces.begin (); i != m_interfaces.end (); i++)
     {
-      i->second->RequestDestination (dst, originator_seqno, dst_seqno);
+      i->second->RequestDestination (dst, originator_seqno, dst_seqno, m_doFlag, m_rfFlag);
     }
   m_preqTimeouts[dst].preqTimeout = Simulator::Schedule (
       Time ((2 * (numOfRetry + 1)) *  m_dot11MeshHWMPnetDiameterTraversalTime),
@@ -1135,8 +1418,24 @@ void
 HwmpProtocol::UnsetRoot ()
 {
   NS_LOG_FUNCTION (this);
+  m_isRoot = false;
   m_proactivePreqTimer.Cancel ();
 }
+Mac48Address
+HwmpProtocol::GetRoot ()
+{
+  return m_rtable->GetProactiveRoot ();
+}
+Mac48Address
+HwmpProtocol::GetNextHopToRoot (uint32_t interface)
+{
+  HwmpRtable::LookupResult result = m_rtable->LookupProactive ();
+  if (!result.IsValid () || result.ifIndex != interface)
+    {
+      return Mac48Address::GetBroadcast ();
+    }
+  return result.retransmitter;
+}
 void
 HwmpProtocol::SendProactivePreq ()
 {
@@ -1152,12 +1451,94 @@ HwmpProtocol::SendProactivePreq ()
   preq.SetOriginatorAddress (GetAddress ());
   preq.SetPreqID (GetNextPreqId ());
   preq.SetOriginatorSeqNumber (GetNextHwmpSeqno ());
+  preq.SetMetric (GetRootInitialMetric ());
   for (HwmpProtocolMacMap::const_iterator i = m_interfaces.begin (); i != m_interfaces.end (); i++)
     {
       i->second->SendPreq (preq);
     }
   m_proactivePreqTimer = Simulator::Schedule (m_dot11MeshHWMPpathToRootInterval, &HwmpProtocol::SendProactivePreq, this);
 }
+void
+HwmpProtocol::SendRann ()
+{
+  NS_LOG_FUNCTION (this);
+  IeRann rann;
+  rann.SetHopcount (0);
+  rann.SetTTL (m_maxTtl);
+  rann.SetOriginatorAddress (GetAddress ());
+  rann.SetDestSeqNumber (GetNextHwmpSeqno ());
+  rann.SetMetric (GetRootInitialMetric ());
+  for (HwmpProtocolMacMap::const_iterator i = m_interfaces.begin (); i != m_interfaces.end (); i++)
+    {
+      i->second->SendRann (rann);
+    }
+  m_proactivePreqTimer = Simulator::Schedule (m_dot11MeshHWMPrannInterval, &HwmpProtocol::SendRann, this);
+}
+uint32_t
+HwmpProtocol::GetRootInitialMetric ()
+{
+  NS_LOG_FUNCTION (this);
+  Time interval = (m_rootMode == RANN) ? m_dot11MeshHWMPrannInterval : m_dot11MeshHWMPpathToRootInterval;
+  double mbps = m_rootRxBytes * 8 / 1e6 / interval.GetSeconds ();
+  m_rootRxBytes = 0;
+  return static_cast<uint32_t> (std::min (m_rootLoadMetric * mbps, HwmpRtable::MAX_METRIC / 2.0));
+}
+void
+HwmpProtocol::RegisterWithRoot (Mac48Address root, uint32_t rootSeqno)
+{
+  NS_LOG_FUNCTION (this << root << rootSeqno);
+  HwmpRtable::LookupResult result = m_rtable->LookupProactive (root);
+  if (result.retransmitter == Mac48Address::GetBroadcast ())
+    {
+      return;
+    }
+  //The path back of the last PREP stays valid when the path to the root
+  //changes to a better one: register again only when it broke, or before
+  //the root forgets it
+  RootRegistration & registration = m_rootRegistrations[root];
+  if (!registration.whenSent.IsZero () &&
+      (registration.whenSent + m_dot11MeshHWMPactiveRootTimeout / 2 > Simulator::Now ()))
+    {
+      return;
+    }
+  registration.whenSent = Simulator::Now ();
+  SendPrep (
+    GetAddress (),
+    root,
+    result.retransmitter,
+    (uint32_t)0,
+    rootSeqno,
+    GetNextHwmpSeqno (),
+    m_dot11MeshHWMPactiveRootTimeout.GetMicroSeconds () / 1024,
+    result.ifIndex
+    );
+}
+void
+HwmpProtocol::RepairRootPath (Mac48Address root, uint32_t seqno)
+{
+  NS_LOG_FUNCTION (this << root << seqno);
+  if (!m_rootPathRepair || root == GetAddress ())
+    {
+      return;
+    }
+  if (m_rtable->LookupReactive (root).retransmitter != Mac48Address::GetBroadcast ())
+    {
+      return;
+    }
+  if (!ShouldSendPreq (root))
+    {
+      return;
+    }
+  //Neither DO nor RF: the first mesh point with a path to the root as
+  //fresh as the broken one answers, and does not forward the PREQ
+  m_rootRepairs.insert (root);
+  m_stats.initiatedPreq++;
+  uint32_t originator_seqno = GetNextHwmpSeqno ();
+  for (HwmpProtocolMacMap::const_iterator i = m_interfaces.begin (); i != m_interfaces.end (); i++)
+    {
+      i->second->RequestDestination (root, originator_seqno, seqno, false, false);
+    }
+}
 bool
 HwmpProtocol::GetDoFlag ()
 {
@@ -1178,6 +1559,11 @@ HwmpProtocol::GetPerrMinInterval ()
 {
   return m_dot11MeshHWMPperrMinInterval;
 }
+Time
+HwmpProtocol::GetPathSelectionBatchWindow ()
+{
+  return m_pathSelectionBatchWindow;
+}
 uint8_t
 HwmpProtocol::GetMaxTtl ()
 {
@@ -1250,7 +1636,11 @@ HwmpProtocol::Report (std::ostream & os) const
   "Dot11MeshHWMPactivePathTimeout=\"" << m_dot11MeshHWMPactivePathTimeout.GetSeconds () << "\"" << std::endl <<
   "Dot11MeshHWMPpathToRootInterval=\"" << m_dot11MeshHWMPpathToRootInterval.GetSeconds () << "\"" << std::endl <<
   "Dot11MeshHWMPrannInterval=\"" << m_dot11MeshHWMPrannInterval.GetSeconds () << "\"" << std::endl <<
+  "pathSelectionBatchWindow=\"" << m_pathSelectionBatchWindow.GetSeconds () << "\"" << std::endl <<
   "isRoot=\"" << m_isRoot << "\"" << std::endl <<
+  "rootMode=\"" << (m_rootMode == RANN ? "Rann" : "ProactivePreq") << "\"" << std::endl <<
+  "rootLoadMetric=\"" << m_rootLoadMetric << "\"" << std::endl <<
+  "rootPathRepair=\"" << m_rootPathRepair << "\"" << std::endl <<
   "maxTtl=\"" << (uint16_t)m_maxTtl << "\"" << std::endl <<
   "unicastPerrThreshold=\"" << (uint16_t)m_unicastPerrThreshold << "\"" << std::endl <<
   "unicastPreqThreshold=\"" << (uint16_t)m_unicastPreqThreshold << "\"" << std::endl <<
@@ -27,6 +27,9 @@
 #include "ns3/traced-value.h"
 #include <vector>
 #include <map>
+#include <list>
+#include <deque>
+#include <set>
 
 namespace ns3 {
 class MeshPointDevice;
@@ -39,6 +42,7 @@ class HwmpRtable;
 class IePerr;
 class IePreq;
 class IePrep;
+class IeRann;
 
 /**
  * Structure to encapsulate route change information
@@ -58,6 +62,21 @@ struct RouteChange
  *
  * \brief Hybrid wireless mesh protocol -- a mesh routing protocol defined
  * in IEEE 802.11-2012 standard.
+ *
+ * Root mesh points, typically the gateways of the mesh, periodically
+ * announce themselves with proactive PREQs or with RANNs, as per the
+ * RootMode attribute, so that every mesh point keeps a path to each of
+ * them.  A destination which is a root is reached by its own path, and
+ * a destination without any path through the root of lowest metric;
+ * with the RootLoadMetric attribute, a root adds to the metric of its
+ * announcements the traffic it receives, so that the mesh points favor
+ * the least loaded of the roots at a similar distance.  In RANN mode a
+ * mesh point sends a PREP to a root along its best path to it when the
+ * path back of its previous PREP broke or is about to expire, instead of
+ * answering each announcement.
+ * When the path to a root is broken, the mesh point requests it at once
+ * from its neighbours, which answer it if their own path to the root is
+ * still valid, rather than wait for the next announcement.
  */
 class HwmpProtocol : public MeshL2RoutingProtocol
 {
@@ -70,6 +89,19 @@ public:
   HwmpProtocol ();
   ~HwmpProtocol ();
   void DoDispose ();
+
+  /// Drop policy of the queue of the packets waiting for a path
+  enum QueueDropPolicy
+  {
+    DROP_NEWEST,
+    DROP_OLDEST
+  };
+  /// How a root announces itself
+  enum RootMode
+  {
+    PROACTIVE_PREQ,
+    RANN
+  };
   /**
    * \brief structure of unreachable destination - address and sequence number
    */
@@ -127,11 +159,23 @@ public:
    * \brief This callback is used to obtain active neighbours on a given interface
    * \param cb is a callback, which returns a list of addresses on given interface (uint32_t)
    */
-  void SetNeighboursCallback (Callback<std::vector<Mac48Address>, uint32_t> cb);
+  void SetNeighboursCallback (Callback<const std::vector<Mac48Address> &, uint32_t> cb);
   ///\name Proactive PREQ mechanism:
   ///\{
   void SetRoot ();
   void UnsetRoot ();
+  /**
+   * \return the root of lowest metric to which this mesh point has a
+   * path, the broadcast address if there is none
+   */
+  Mac48Address GetRoot ();
+  /**
+   * \param interface the interface index
+   * \return the next hop of the path to the root of lowest metric,
+   * typically the gateway of this mesh point, the broadcast address if
+   * there is no such path through the interface
+   */
+  Mac48Address GetNextHopToRoot (uint32_t interface);
   ///\}
   ///\brief Statistics:
   void Report (std::ostream &) const;
@@ -189,6 +233,7 @@ private:
     uint16_t protocol; ///< protocol number
     uint32_t inInterface; ///< incoming device interface ID. (if packet has come from upper layers, this is Mesh point ID)
     RouteReplyCallback reply; ///< how to reply
+    Time whenQueued; ///< time at which the packet was queued
 
     QueuedPacket ();
   };
@@ -239,6 +284,16 @@ private:
    * \param fromMp the from MP address
    */
   void ReceivePerr (std::vector<FailedDestination> destinations, Mac48Address from, uint32_t interface, Mac48Address fromMp);
+  /**
+   * \brief Handler for receiving Root Announcement
+   *
+   * \param rann the IE rann
+   * \param from the from address
+   * \param interface the interface
+   * \param fromMp the 'from MP' address
+   * \param metric the metric
+   */
+  void ReceiveRann (IeRann rann, Mac48Address from, uint32_t interface, Mac48Address fromMp, uint32_t metric);
    /**
     * \brief Send Path Reply
     * \param src the source address
@@ -291,14 +346,14 @@ private:
    * \param interface
    * \return list of addresses where a PREQ should be sent to
    */
-  std::vector<Mac48Address> GetPreqReceivers (uint32_t interface);
+  const std::vector<Mac48Address> & GetPreqReceivers (uint32_t interface);
   /**
    * Get broadcast receivers
    *
    * \param interface
    * \return list of addresses where a broadcast should be retransmitted
    */
-  std::vector<Mac48Address> GetBroadcastReceivers (uint32_t interface);
+  const std::vector<Mac48Address> & GetBroadcastReceivers (uint32_t interface);
   /**
    * \brief MAC-plugin asks whether the frame can be dropped. Protocol automatically updates seqno.
    *
@@ -314,13 +369,43 @@ private:
   typedef TracedCallback <struct RouteChange> RouteChangeTracedCallback;
   /// Route change trace source
   TracedCallback<struct RouteChange> m_routeChangeTraceSource;
+  /// Time spent in the queue by the packets sent once their path is resolved
+  TracedCallback<Time> m_queueingDelayTrace;
   ///\name Methods related to Queue/Dequeue procedures
   ///\{
+  /**
+   * \brief Queue a packet until its path is resolved; when the queue is
+   * full, the newest or the oldest packet is dropped, as per the drop policy.
+   *
+   * \param packet the packet
+   * \return false if the packet is dropped
+   */
   bool QueuePacket (QueuedPacket packet);
+  /**
+   * \param dst the destination address
+   * \return the first queued packet to \p dst, with a null pkt if there is none
+   */
   QueuedPacket  DequeueFirstPacketByDst (Mac48Address dst);
+  /**
+   * \return the first queued packet, with a null pkt if there is none
+   */
   QueuedPacket  DequeueFirstPacket ();
   void ReactivePathResolved (Mac48Address dst);
+  /// Send the queued packets to the roots: to a root through its own path, to the others through the root of lowest metric
   void ProactivePathResolved ();
+  /**
+   * \brief With multi-channel forwarding, choose the peer link to the
+   * next hop of a path through which a frame is sent.
+   *
+   * The candidates are the peer links to the mesh point of the next hop,
+   * one on each interface which has one, and the link of least airtime
+   * metric times one plus the number of frames waiting on its interface
+   * is chosen, the first one on a tie.
+   *
+   * \param interface the interface of the path, updated with the one of the link
+   * \param retransmitter the next hop of the path, updated with its address on the link
+   */
+  void SelectPeerLink (uint32_t & interface, Mac48Address & retransmitter);
   ///\}
   ///\name Methods responsible for path discovery retry procedure:
   ///\{
@@ -343,6 +428,30 @@ private:
   void  RetryPathDiscovery (Mac48Address dst, uint8_t numOfRetry);
   /// Proactive Preq routines:
   void SendProactivePreq ();
+  /// Send a root announcement
+  void SendRann ();
+  /**
+   * \return the initial metric of the announcements of this root, which
+   * grows with the traffic it received since its last announcement
+   */
+  uint32_t GetRootInitialMetric ();
+  /**
+   * \brief Send a PREP to a root along the proactive path to it, so that
+   * the root has a path back to this mesh point, unless the path back
+   * of the last PREP did not break and does not expire soon
+   *
+   * \param root the address of the root
+   * \param rootSeqno the sequence number of the root
+   */
+  void RegisterWithRoot (Mac48Address root, uint32_t rootSeqno);
+  /**
+   * \brief Request the path to a root after the proactive path to it
+   * broke: the neighbours which still have a valid path answer it.
+   *
+   * \param root the address of the root
+   * \param seqno the sequence number of the broken path
+   */
+  void RepairRootPath (Mac48Address root, uint32_t seqno);
   ///\}
   ///\return address of MeshPointDevice
   Mac48Address GetAddress ();
@@ -367,6 +476,12 @@ private:
    * \returns the PERR minimum interval
    */
   Time GetPerrMinInterval ();
+  /**
+   * Get the window during which the path selection elements sent by an
+   * interface are queued, to be sent in as few frames as possible
+   * \returns the batch window, zero if the elements are sent at once
+   */
+  Time GetPathSelectionBatchWindow ();
   /**
    * Get maximum TTL function
    * \returns the maximum TTL
@@ -439,16 +554,27 @@ private:
   };
 
   std::map<Mac48Address, PreqEvent> m_preqTimeouts; ///< PREQ timeouts
-  EventId m_proactivePreqTimer; ///< proactive PREQ timer
+  EventId m_proactivePreqTimer; ///< proactive PREQ or RANN timer
+  /// RootRegistration structure
+  struct RootRegistration {
+    Time whenSent; ///< time of the last PREP sent to the root, zero if its path broke
+    EventId event; ///< PREP waiting for the best RANN of the root
+  };
+  std::map<Mac48Address, RootRegistration> m_rootRegistrations; ///< registrations with each root
+  std::set<Mac48Address> m_rootRepairs; ///< roots whose broken path is requested
+  uint64_t m_rootRxBytes; ///< bytes received by this root since its last announcement
   /// Random start in Proactive PREQ propagation
   Time m_randomStart;
-  /// Packet Queue
-  std::vector<QueuedPacket> m_rqueue;
+  /// Packet Queue, in the order of arrival
+  std::list<QueuedPacket> m_rqueue;
+  /// The packets of m_rqueue by destination, in the order of arrival
+  std::map<Mac48Address, std::deque<std::list<QueuedPacket>::iterator> > m_rqueueByDst;
   
   /// \name HWMP-protocol parameters
   /// These are all Attributes
   /// \{
   uint16_t m_maxQueueSize;
+  QueueDropPolicy m_queueDropPolicy;
   uint8_t m_dot11MeshHWMPmaxPREQretries;
   Time m_dot11MeshHWMPnetDiameterTraversalTime;
   Time m_dot11MeshHWMPpreqMinInterval;
@@ -457,7 +583,12 @@ private:
   Time m_dot11MeshHWMPactivePathTimeout;
   Time m_dot11MeshHWMPpathToRootInterval;
   Time m_dot11MeshHWMPrannInterval;
+  Time m_pathSelectionBatchWindow;
   bool m_isRoot;
+  RootMode m_rootMode;
+  uint32_t m_rootLoadMetric;
+  bool m_rootPathRepair;
+  bool m_multiChannelForwarding;
   uint8_t m_maxTtl;
   uint8_t m_unicastPerrThreshold;
   uint8_t m_unicastPreqThreshold;
@@ -468,7 +599,21 @@ private:
   
   /// Random variable for random start time
   Ptr<UniformRandomVariable> m_coefficient; ///< coefficient
-  Callback <std::vector<Mac48Address>, uint32_t> m_neighboursCallback; ///< neighbors callback
+  Callback <const std::vector<Mac48Address> &, uint32_t> m_neighboursCallback; ///< neighbors callback
+  /// Receivers structure
+  struct Receivers
+  {
+    std::vector<Mac48Address> preq; ///< PREQ receivers
+    std::vector<Mac48Address> broadcast; ///< broadcast receivers
+    uint8_t unicastPreqThreshold; ///< UnicastPreqThreshold the PREQ receivers were chosen with
+    uint8_t unicastDataThreshold; ///< UnicastDataThreshold the broadcast receivers were chosen with
+  };
+  /// Receivers of each interface, until a peer link is established or closed
+  std::map<uint32_t, Receivers> m_receivers;
+  /// Mesh point address of each peer interface address
+  std::map<Mac48Address, Mac48Address> m_peerMeshPoints;
+  /// Established peer links to each peer mesh point: {interface, peer interface address}, in the order of establishment
+  std::map<Mac48Address, std::vector<std::pair<uint32_t, Mac48Address> > > m_peerLinks;
 };
 } // namespace dot11s
 } // namespace ns3
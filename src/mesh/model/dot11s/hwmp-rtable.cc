@@ -45,7 +45,6 @@ HwmpRtable::GetTypeId ()
 }
 HwmpRtable::HwmpRtable ()
 {
-  DeleteProactivePath ();
 }
 HwmpRtable::~HwmpRtable ()
 {
@@ -54,6 +53,7 @@ void
 HwmpRtable::DoDispose ()
 {
   m_routes.clear ();
+  m_roots.clear ();
 }
 void
 HwmpRtable::AddReactivePath (Mac48Address destination, Mac48Address retransmitter, uint32_t interface,
@@ -79,12 +79,13 @@ HwmpRtable::AddProactivePath (uint32_t metric, Mac48Address root, Mac48Address r
                               uint32_t interface, Time lifetime, uint32_t seqnum)
 {
   NS_LOG_FUNCTION (this << metric << root << retransmitter << interface << lifetime << seqnum); 
-  m_root.root = root;
-  m_root.retransmitter = retransmitter;
-  m_root.metric = metric;
-  m_root.whenExpire = Simulator::Now () + lifetime;
-  m_root.seqnum = seqnum;
-  m_root.interface = interface;
+  ProactiveRoute &route = m_roots[root];
+  route.root = root;
+  route.retransmitter = retransmitter;
+  route.metric = metric;
+  route.whenExpire = Simulator::Now () + lifetime;
+  route.seqnum = seqnum;
+  route.interface = interface;
 }
 void
 HwmpRtable::AddPrecursor (Mac48Address destination, uint32_t precursorInterface,
@@ -120,21 +121,13 @@ void
 HwmpRtable::DeleteProactivePath ()
 {
   NS_LOG_FUNCTION (this);
-  m_root.precursors.clear ();
-  m_root.interface = INTERFACE_ANY;
-  m_root.metric = MAX_METRIC;
-  m_root.retransmitter = Mac48Address::GetBroadcast ();
-  m_root.seqnum = 0;
-  m_root.whenExpire = Simulator::Now ();
+  m_roots.clear ();
 }
 void
 HwmpRtable::DeleteProactivePath (Mac48Address root)
 {
   NS_LOG_FUNCTION (this << root);
-  if (m_root.root == root)
-    {
-      DeleteProactivePath ();
-    }
+  m_roots.erase (root);
 }
 void
 HwmpRtable::DeleteReactivePath (Mac48Address destination)
@@ -179,20 +172,83 @@ HwmpRtable::LookupResult
 HwmpRtable::LookupProactive ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_root.whenExpire < Simulator::Now ())
+  for (std::map<Mac48Address, ProactiveRoute>::iterator i = m_roots.begin (); i != m_roots.end (); )
     {
-      NS_LOG_DEBUG ("Proactive route has expired and will be deleted, sorry.");
-      DeleteProactivePath ();
+      if (i->second.whenExpire < Simulator::Now ())
+        {
+          NS_LOG_DEBUG ("Proactive route to " << i->first << " has expired and will be deleted, sorry.");
+          m_roots.erase (i++);
+        }
+      else
+        {
+          i++;
+        }
     }
   return LookupProactiveExpired ();
 }
 HwmpRtable::LookupResult
+HwmpRtable::LookupProactive (Mac48Address root)
+{
+  NS_LOG_FUNCTION (this << root);
+  std::map<Mac48Address, ProactiveRoute>::iterator i = m_roots.find (root);
+  if (i == m_roots.end ())
+    {
+      return LookupResult ();
+    }
+  if (i->second.whenExpire < Simulator::Now ())
+    {
+      NS_LOG_DEBUG ("Proactive route to " << root << " has expired and will be deleted, sorry.");
+      m_roots.erase (i);
+      return LookupResult ();
+    }
+  return LookupProactiveExpired (root);
+}
+HwmpRtable::LookupResult
 HwmpRtable::LookupProactiveExpired ()
 {
   NS_LOG_FUNCTION (this);
-  NS_LOG_DEBUG ("Returning proactive route to root");
-  return LookupResult (m_root.retransmitter, m_root.interface, m_root.metric, m_root.seqnum,
-                       m_root.whenExpire - Simulator::Now ());
+  std::map<Mac48Address, ProactiveRoute>::const_iterator best = m_roots.end ();
+  for (std::map<Mac48Address, ProactiveRoute>::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
+    {
+      if (best == m_roots.end () || i->second.metric < best->second.metric)
+        {
+          best = i;
+        }
+    }
+  if (best == m_roots.end ())
+    {
+      return LookupResult ();
+    }
+  NS_LOG_DEBUG ("Returning proactive route to root " << best->first);
+  return LookupResult (best->second.retransmitter, best->second.interface, best->second.metric, best->second.seqnum,
+                       best->second.whenExpire - Simulator::Now ());
+}
+HwmpRtable::LookupResult
+HwmpRtable::LookupProactiveExpired (Mac48Address root)
+{
+  NS_LOG_FUNCTION (this << root);
+  std::map<Mac48Address, ProactiveRoute>::const_iterator i = m_roots.find (root);
+  if (i == m_roots.end ())
+    {
+      return LookupResult ();
+    }
+  NS_LOG_DEBUG ("Returning proactive route to root " << root);
+  return LookupResult (i->second.retransmitter, i->second.interface, i->second.metric, i->second.seqnum,
+                       i->second.whenExpire - Simulator::Now ());
+}
+Mac48Address
+HwmpRtable::GetProactiveRoot ()
+{
+  NS_LOG_FUNCTION (this);
+  LookupResult best = LookupProactive ();
+  for (std::map<Mac48Address, ProactiveRoute>::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
+    {
+      if (i->second.metric == best.metric)
+        {
+          return i->first;
+        }
+    }
+  return Mac48Address::GetBroadcast ();
 }
 std::vector<HwmpProtocol::FailedDestination>
 HwmpRtable::GetUnreachableDestinations (Mac48Address peerAddress)
@@ -210,12 +266,18 @@ HwmpRtable::GetUnreachableDestinations (Mac48Address peerAddress)
           retval.push_back (dst);
         }
     }
-  //Lookup a path to root
-  if (m_root.retransmitter == peerAddress)
+  //Lookup the paths to roots, which are not already reported by their
+  //reactive path
+  for (std::map<Mac48Address, ProactiveRoute>::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
-      dst.destination = m_root.root;
-      dst.seqnum = m_root.seqnum;
-      retval.push_back (dst);
+      std::map<Mac48Address, ReactiveRoute>::const_iterator reactive = m_routes.find (i->first);
+      if (i->second.retransmitter == peerAddress
+          && (reactive == m_routes.end () || reactive->second.retransmitter != peerAddress))
+        {
+          dst.destination = i->first;
+          dst.seqnum = i->second.seqnum;
+          retval.push_back (dst);
+        }
     }
   return retval;
 }
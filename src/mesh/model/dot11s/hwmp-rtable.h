@@ -106,6 +106,7 @@ public:
     );
   void AddPrecursor (Mac48Address destination, uint32_t precursorInterface, Mac48Address precursorAddress, Time lifetime);
   PrecursorList GetPrecursors (Mac48Address destination);
+  /// Delete the paths to all the roots
   void DeleteProactivePath ();
   void DeleteProactivePath (Mac48Address root);
   void DeleteReactivePath (Mac48Address destination);
@@ -117,10 +118,16 @@ public:
   LookupResult LookupReactive (Mac48Address destination);
   /// Return all reactive paths, including expired
   LookupResult LookupReactiveExpired (Mac48Address destination);
-  /// Find proactive path to tree root. Note that calling this method has side effect of deleting expired proactive path
+  /// Find proactive path to the tree root of lowest metric. Note that calling this method has side effect of deleting expired proactive paths
   LookupResult LookupProactive ();
-  /// Return all proactive paths, including expired
+  /// Find proactive path to a given tree root
+  LookupResult LookupProactive (Mac48Address root);
+  /// Return the proactive path of lowest metric, including expired
   LookupResult LookupProactiveExpired ();
+  /// Return the proactive path to a given tree root, including expired
+  LookupResult LookupProactiveExpired (Mac48Address root);
+  /// Find the tree root of lowest metric, the broadcast address if there is none
+  Mac48Address GetProactiveRoot ();
   //\}
 
   /**
@@ -162,8 +169,8 @@ private:
 
   /// List of routes
   std::map<Mac48Address, ReactiveRoute>  m_routes;
-  /// Path to proactive tree root MP
-  ProactiveRoute  m_root;
+  /// Paths to proactive tree root MPs
+  std::map<Mac48Address, ProactiveRoute> m_roots;
 };
 } // namespace dot11s
 } // namespace ns3
@@ -32,6 +32,7 @@
 #include "ns3/mesh-wifi-interface-mac-plugin.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/trace-source-accessor.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -104,11 +105,9 @@ PeerManagementProtocol::DoDispose ()
   //deleting each
   for (PeerLinksMap::iterator j = m_peerLinks.begin (); j != m_peerLinks.end (); j++)
     {
-      for (PeerLinksOnInterface::iterator i = j->second.begin (); i != j->second.end (); i++)
-        {
-          (*i) = 0;
-        }
-      j->second.clear ();
+      j->second.links.clear ();
+      j->second.index.clear ();
+      j->second.peers.clear ();
     }
   m_peerLinks.clear ();
   m_plugins.clear ();
@@ -133,8 +132,7 @@ PeerManagementProtocol::Install (Ptr<MeshPointDevice> mp)
       Ptr<PeerManagementProtocolMac> plugin = Create<PeerManagementProtocolMac> ((*i)->GetIfIndex (), this);
       mac->InstallPlugin (plugin);
       m_plugins[(*i)->GetIfIndex ()] = plugin;
-      PeerLinksOnInterface newmap;
-      m_peerLinks[(*i)->GetIfIndex ()] = newmap;
+      m_peerLinks[(*i)->GetIfIndex ()] = PeerLinksOnInterface ();
     }
   // Mesh point aggregates all installed protocols
   m_address = Mac48Address::ConvertFrom (mp->GetAddress ());
@@ -152,7 +150,7 @@ PeerManagementProtocol::GetBeaconTimingElement (uint32_t interface)
   Ptr<IeBeaconTiming> retval = Create<IeBeaconTiming> ();
   PeerLinksMap::iterator iface = m_peerLinks.find (interface);
   NS_ASSERT (iface != m_peerLinks.end ());
-  for (PeerLinksOnInterface::iterator i = iface->second.begin (); i != iface->second.end (); i++)
+  for (std::vector<Ptr<PeerLink> >::iterator i = iface->second.links.begin (); i != iface->second.links.end (); i++)
     {
       //If we do not know peer Assoc Id, we shall not add any info
       //to a beacon timing element
@@ -288,7 +286,11 @@ PeerManagementProtocol::InitiateLink (uint32_t interface, Mac48Address peerAddre
   new_link->SetPeerMeshPointAddress (peerMeshPointAddress);
   new_link->SetMacPlugin (plugin->second);
   new_link->MLMESetSignalStatusCallback (MakeCallback (&PeerManagementProtocol::PeerLinkStatus, this));
-  iface->second.push_back (new_link);
+  iface->second.links.push_back (new_link);
+  PeerLinkEntry entry;
+  entry.link = new_link;
+  entry.active = false;
+  iface->second.index[peerAddress] = entry;
   return new_link;
 }
 
@@ -297,23 +299,19 @@ PeerManagementProtocol::FindPeerLink (uint32_t interface, Mac48Address peerAddre
 {
   PeerLinksMap::iterator iface = m_peerLinks.find (interface);
   NS_ASSERT (iface != m_peerLinks.end ());
-  for (PeerLinksOnInterface::iterator i = iface->second.begin (); i != iface->second.end (); i++)
+  std::map<Mac48Address, PeerLinkEntry>::iterator i = iface->second.index.find (peerAddress);
+  if (i == iface->second.index.end ())
     {
-      if ((*i)->GetPeerAddress () == peerAddress)
-        {
-          if ((*i)->LinkIsIdle ())
-            {
-              (*i) = 0;
-              (iface->second).erase (i);
-              return 0;
-            }
-          else
-            {
-              return (*i);
-            }
-        }
+      return 0;
+    }
+  Ptr<PeerLink> link = i->second.link;
+  if (link->LinkIsIdle ())
+    {
+      iface->second.index.erase (i);
+      iface->second.links.erase (std::find (iface->second.links.begin (), iface->second.links.end (), link));
+      return 0;
     }
-  return 0;
+  return link;
 }
 void
 PeerManagementProtocol::SetPeerLinkStatusCallback (
@@ -322,20 +320,12 @@ PeerManagementProtocol::SetPeerLinkStatusCallback (
   m_peerStatusCallback = cb;
 }
 
-std::vector<Mac48Address>
+const std::vector<Mac48Address> &
 PeerManagementProtocol::GetPeers (uint32_t interface) const
 {
-  std::vector<Mac48Address> retval;
   PeerLinksMap::const_iterator iface = m_peerLinks.find (interface);
   NS_ASSERT (iface != m_peerLinks.end ());
-  for (PeerLinksOnInterface::const_iterator i = iface->second.begin (); i != iface->second.end (); i++)
-    {
-      if ((*i)->LinkIsEstab ())
-        {
-          retval.push_back ((*i)->GetPeerAddress ());
-        }
-    }
-  return retval;
+  return iface->second.peers;
 }
 
 std::vector< Ptr<PeerLink> >
@@ -345,22 +335,20 @@ PeerManagementProtocol::GetPeerLinks () const
 
   for (PeerLinksMap::const_iterator iface = m_peerLinks.begin (); iface != m_peerLinks.end (); ++iface)
     {
-      for (PeerLinksOnInterface::const_iterator i = iface->second.begin ();
-           i != iface->second.end (); i++)
+      for (std::vector<Ptr<PeerLink> >::const_iterator i = iface->second.links.begin ();
+           i != iface->second.links.end (); i++)
         if ((*i)->LinkIsEstab ())
           links.push_back (*i);
     }
   return links;
 }
 bool
-PeerManagementProtocol::IsActiveLink (uint32_t interface, Mac48Address peerAddress)
+PeerManagementProtocol::IsActiveLink (uint32_t interface, Mac48Address peerAddress) const
 {
-  Ptr<PeerLink> peerLink = FindPeerLink (interface, peerAddress);
-  if (peerLink != 0)
-    {
-      return (peerLink->LinkIsEstab ());
-    }
-  return false;
+  PeerLinksMap::const_iterator iface = m_peerLinks.find (interface);
+  NS_ASSERT (iface != m_peerLinks.end ());
+  std::map<Mac48Address, PeerLinkEntry>::const_iterator i = iface->second.index.find (peerAddress);
+  return (i != iface->second.index.end ()) && i->second.active;
 }
 bool
 PeerManagementProtocol::ShouldSendOpen (uint32_t interface, Mac48Address peerAddress)
@@ -402,7 +390,7 @@ PeerManagementProtocol::CheckBeaconCollisions (uint32_t interface)
 
   NS_ASSERT_MSG (TuToTime (m_maxBeaconShift) <= m_beaconInterval[interface], "Wrong beacon shift parameters");
 
-  if (iface->second.size () == 0)
+  if (iface->second.links.size () == 0)
     {
       //I have no peers - may be our beacons are in collision
       ShiftOwnBeacon (interface);
@@ -410,7 +398,7 @@ PeerManagementProtocol::CheckBeaconCollisions (uint32_t interface)
     }
   //check whether all my peers receive my beacon and I'am not in collision with other beacons
 
-  for (PeerLinksOnInterface::iterator i = iface->second.begin (); i != iface->second.end (); i++)
+  for (std::vector<Ptr<PeerLink> >::iterator i = iface->second.links.begin (); i != iface->second.links.end (); i++)
     {
       bool myBeaconExists = false;
       IeBeaconTiming::NeighboursTimingUnitsList neighbors = (*i)->GetBeaconTimingElement ().GetNeighboursTimingElementsList ();
@@ -503,6 +491,23 @@ PeerManagementProtocol::PeerLinkStatus (uint32_t interface, Mac48Address peerAdd
                     << " and peer mesh point:" << peerMeshPointAddress << " and its interface:" << peerAddress
                     << ", at my interface ID:" << interface << ". State movement:" << PeerLink::PeerStateNames[ostate] 
                     << " -> " << PeerLink::PeerStateNames[nstate]);
+  if ((nstate == PeerLink::ESTAB) != (ostate == PeerLink::ESTAB))
+    {
+      //The established peers change before anyone is notified
+      PeerLinksMap::iterator iface = m_peerLinks.find (interface);
+      NS_ASSERT (iface != m_peerLinks.end ());
+      std::map<Mac48Address, PeerLinkEntry>::iterator entry = iface->second.index.find (peerAddress);
+      NS_ASSERT (entry != iface->second.index.end ());
+      entry->second.active = (nstate == PeerLink::ESTAB);
+      iface->second.peers.clear ();
+      for (std::vector<Ptr<PeerLink> >::const_iterator i = iface->second.links.begin (); i != iface->second.links.end (); i++)
+        {
+          if ((*i)->LinkIsEstab ())
+            {
+              iface->second.peers.push_back ((*i)->GetPeerAddress ());
+            }
+        }
+    }
   if ((nstate == PeerLink::ESTAB) && (ostate != PeerLink::ESTAB))
     {
       NotifyLinkOpen (peerMeshPointAddress, peerAddress, plugin->second->GetAddress (), interface);
@@ -569,7 +574,7 @@ PeerManagementProtocol::Report (std::ostream & os) const
       //Print all active peer links:
       PeerLinksMap::const_iterator iface = m_peerLinks.find (plugins->second->m_ifIndex);
       NS_ASSERT (iface != m_peerLinks.end ());
-      for (PeerLinksOnInterface::const_iterator i = iface->second.begin (); i != iface->second.end (); i++)
+      for (std::vector<Ptr<PeerLink> >::const_iterator i = iface->second.links.begin (); i != iface->second.links.end (); i++)
         {
           (*i)->Report (os);
         }
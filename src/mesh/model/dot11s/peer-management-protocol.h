@@ -32,6 +32,7 @@
 #include "peer-link.h"
 
 #include <map>
+#include <vector>
 namespace ns3 {
 class MeshPointDevice;
 class UniformRandomVariable;
@@ -129,7 +130,7 @@ public:
   /**
    * \brief Checks if there is established link
    */
-  bool IsActiveLink (uint32_t interface, Mac48Address peerAddress);
+  bool IsActiveLink (uint32_t interface, Mac48Address peerAddress) const;
   // \}
   ///\name Interface to other protocols (MLME)
   // \{
@@ -140,7 +141,7 @@ public:
   /// Get list of all active peer links
   std::vector < Ptr<PeerLink> > GetPeerLinks () const;
   /// Get list of active peers of my given interface
-  std::vector<Mac48Address> GetPeers (uint32_t interface) const;
+  const std::vector<Mac48Address> & GetPeers (uint32_t interface) const;
   /**
    * Get mesh point address. \todo this used by plugins only. Now MAC plugins can ask MP address directly from main MAC
    *
@@ -218,9 +219,21 @@ private:
     Time referenceTbtt; ///< When one of my station's beacons was put into a beacon queue;
     Time beaconInterval; ///< Beacon interval of my station;
   };
-  /// We keep a vector of pointers to PeerLink class. This vector
-  /// keeps all peer links at a given interface.
-  typedef std::vector<Ptr<PeerLink> > PeerLinksOnInterface;
+  /// A peer link and whether it is established
+  struct PeerLinkEntry
+  {
+    Ptr<PeerLink> link; ///< the peer link
+    bool active; ///< whether the peer link is established
+  };
+  /// The peer links at a given interface, in the order of their creation
+  /// and by peer address, and the addresses of the established ones,
+  /// which are only updated when a peer link is established or closed.
+  struct PeerLinksOnInterface
+  {
+    std::vector<Ptr<PeerLink> > links; ///< peer links, in the order of their creation
+    std::map<Mac48Address, PeerLinkEntry> index; ///< peer links by peer address
+    std::vector<Mac48Address> peers; ///< addresses of the established peer links, in the order of their creation
+  };
   /// This map keeps all peer links.
   typedef std::map<uint32_t, PeerLinksOnInterface>  PeerLinksMap;
   /// This map keeps relationship between peer address and its beacon information
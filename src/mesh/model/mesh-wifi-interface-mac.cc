@@ -32,6 +32,10 @@
 #include "ns3/double.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/socket.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/qos-txop.h"
+#include "ns3/wifi-mac-queue.h"
+#include <cmath>
 
 namespace ns3 {
 
@@ -68,12 +72,35 @@ MeshWifiInterfaceMac::GetTypeId ()
                       &MeshWifiInterfaceMac::SetBeaconGeneration, &MeshWifiInterfaceMac::GetBeaconGeneration),
                     MakeBooleanChecker ()
                     )
+    .AddAttribute ( "AbstractBeacons",
+                    "If true, beacons are not transmitted by the PHY: their airtime is reserved "
+                    "on the channel and they are delivered to the neighbors that would decode them, "
+                    "according to the error rate of each link without interference. "
+                    "Peer links are kept alive by these beacons; the peer link management "
+                    "frames are still transmitted. "
+                    "Requires a PHY which evaluates the RX power of a single link, as YansWifiPhy does.",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (
+                      &MeshWifiInterfaceMac::m_abstractBeacons),
+                    MakeBooleanChecker ()
+                    )
+    .AddAttribute ( "MetricFerThreshold",
+                    "Change of the frame error rate average of a peer above which its cached "
+                    "link metric is recomputed. The metric is always recomputed when the data "
+                    "mode selected for the peer, or its data rate, changes.",
+                    DoubleValue (0.05),
+                    MakeDoubleAccessor (
+                      &MeshWifiInterfaceMac::m_metricFerThreshold),
+                    MakeDoubleChecker<double> (0, 1)
+                    )
   ;
   return tid;
 }
 
 MeshWifiInterfaceMac::MeshWifiInterfaceMac ()
-  : m_standard (WIFI_PHY_STANDARD_80211a)
+  : m_abstractBeacons (false),
+    m_metricFerThreshold (0.05),
+    m_standard (WIFI_PHY_STANDARD_80211a)
 {
   NS_LOG_FUNCTION (this);
 
@@ -122,11 +149,31 @@ MeshWifiInterfaceMac::SetLinkUpCallback (Callback<void> linkUp)
   linkUp ();
 }
 
+void
+MeshWifiInterfaceMac::SetWifiRemoteStationManager (const Ptr<WifiRemoteStationManager> stationManager)
+{
+  NS_LOG_FUNCTION (this << stationManager);
+  if (m_stationManager != 0)
+    {
+      m_stationManager->TraceDisconnectWithoutContext ("DataModeChange",
+                                                       MakeCallback (&MeshWifiInterfaceMac::DataModeChanged, this));
+      m_stationManager->TraceDisconnectWithoutContext ("FrameErrorRate",
+                                                       MakeCallback (&MeshWifiInterfaceMac::FrameErrorRateUpdated, this));
+    }
+  RegularWifiMac::SetWifiRemoteStationManager (stationManager);
+  m_linkMetricCache.clear ();
+  stationManager->TraceConnectWithoutContext ("DataModeChange",
+                                              MakeCallback (&MeshWifiInterfaceMac::DataModeChanged, this));
+  stationManager->TraceConnectWithoutContext ("FrameErrorRate",
+                                              MakeCallback (&MeshWifiInterfaceMac::FrameErrorRateUpdated, this));
+}
+
 void
 MeshWifiInterfaceMac::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_plugins.clear ();
+  m_linkMetricCache.clear ();
   m_beaconSendEvent.Cancel ();
 
   RegularWifiMac::DoDispose ();
@@ -164,6 +211,10 @@ MeshWifiInterfaceMac::AssignStreams (int64_t stream)
     {
       currentStream += (*i)->AssignStreams (currentStream);
     }
+  if (m_abstractBeacons)
+    {
+      currentStream += AssignAbstractedStreams (currentStream);
+    }
   return (currentStream - stream);
 }
 
@@ -217,6 +268,8 @@ MeshWifiInterfaceMac::SwitchFrequencyChannel (uint16_t new_id)
    */
   Ptr<YansWifiPhy> phy = m_phy->GetObject<YansWifiPhy> ();
   phy->SetChannelNumber (new_id);
+  // The TX durations which the link metrics depend on may change
+  m_linkMetricCache.clear ();
   // Don't know NAV on new channel
   m_channelAccessManager->NotifyNavResetNow (Seconds (0));
 }
@@ -472,7 +525,14 @@ MeshWifiInterfaceMac::SendBeacon ()
     {
       (*i)->UpdateBeacon (beacon);
     }
-  m_txop->Queue (beacon.CreatePacket (), beacon.CreateHeader (GetAddress (), GetMeshPointAddress ()));
+  if (m_abstractBeacons)
+    {
+      SendAbstracted (beacon.CreatePacket (), beacon.CreateHeader (GetAddress (), GetMeshPointAddress ()));
+    }
+  else
+    {
+      m_txop->Queue (beacon.CreatePacket (), beacon.CreateHeader (GetAddress (), GetMeshPointAddress ()));
+    }
 
   ScheduleNextBeacon ();
 }
@@ -675,21 +735,68 @@ MeshWifiInterfaceMac::ReceiveBlockAck (Ptr<Packet> const_packet, WifiMacHeader c
     }
 }
 
+uint32_t
+MeshWifiInterfaceMac::GetQueueSize ()
+{
+  uint32_t size = m_txop->GetWifiMacQueue ()->GetNPackets ();
+  for (EdcaQueues::const_iterator i = m_edca.begin (); i != m_edca.end (); ++i)
+    {
+      size += i->second->GetWifiMacQueue ()->GetNPackets ();
+    }
+  return size;
+}
+
 uint32_t
 MeshWifiInterfaceMac::GetLinkMetric (Mac48Address peerAddress)
 {
-  uint32_t metric = 1;
-  if (!m_linkMetricCallback.IsNull ())
+  if (m_linkMetricCallback.IsNull ())
+    {
+      return 1;
+    }
+  std::map<Mac48Address, LinkMetricCacheEntry>::const_iterator i = m_linkMetricCache.find (peerAddress);
+  if (i != m_linkMetricCache.end ())
     {
-      metric = m_linkMetricCallback (peerAddress, this);
+      return i->second.metric;
     }
-  return metric;
+  // The metric callback may report the data mode of the peer, which must
+  // not invalidate the entry being computed: it is inserted afterwards
+  LinkMetricCacheEntry entry;
+  entry.metric = m_linkMetricCallback (peerAddress, this);
+  entry.frameErrorRate = m_stationManager->GetInfo (peerAddress).GetFrameErrorRate ();
+  m_linkMetricCache[peerAddress] = entry;
+  return entry.metric;
 }
 
 void
 MeshWifiInterfaceMac::SetLinkMetricCallback (Callback<uint32_t, Mac48Address, Ptr<MeshWifiInterfaceMac> > cb)
 {
   m_linkMetricCallback = cb;
+  m_linkMetricCache.clear ();
+}
+
+void
+MeshWifiInterfaceMac::DataModeChanged (WifiMode oldMode, WifiMode newMode, Mac48Address peerAddress)
+{
+  NS_LOG_FUNCTION (this << oldMode << newMode << peerAddress);
+  m_linkMetricCache.erase (peerAddress);
+}
+
+void
+MeshWifiInterfaceMac::FrameErrorRateUpdated (double frameErrorRate, Mac48Address peerAddress)
+{
+  std::map<Mac48Address, LinkMetricCacheEntry>::iterator i = m_linkMetricCache.find (peerAddress);
+  if (i == m_linkMetricCache.end ())
+    {
+      return;
+    }
+  // A frame error rate of 1 gives the maximum metric, whatever the threshold
+  if (std::abs (frameErrorRate - i->second.frameErrorRate) > m_metricFerThreshold
+      || (frameErrorRate == 1) != (i->second.frameErrorRate == 1))
+    {
+      NS_LOG_DEBUG ("Frame error rate of " << peerAddress << " moved from "
+                    << i->second.frameErrorRate << " to " << frameErrorRate);
+      m_linkMetricCache.erase (i);
+    }
 }
 
 void
@@ -748,6 +855,8 @@ MeshWifiInterfaceMac::FinishConfigureStandard (enum WifiPhyStandard standard)
 {
   RegularWifiMac::FinishConfigureStandard (standard);
   m_standard = standard;
+  // The interframe spaces which the link metrics depend on may change
+  m_linkMetricCache.clear ();
 
   // We use the single DCF provided by WifiMac for the purpose of
   // Beacon transmission. For this we need to reconfigure the channel
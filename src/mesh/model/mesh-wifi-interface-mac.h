@@ -32,6 +32,7 @@
 #include "ns3/regular-wifi-mac.h"
 #include "ns3/mesh-wifi-interface-mac-plugin.h"
 #include "ns3/event-id.h"
+#include <map>
 
 namespace ns3 {
 
@@ -65,6 +66,7 @@ public:
   virtual void  Enqueue (Ptr<const Packet> packet, Mac48Address to);
   virtual bool  SupportsSendFrom () const;
   virtual void  SetLinkUpCallback (Callback<void> linkUp);
+  virtual void  SetWifiRemoteStationManager (const Ptr<WifiRemoteStationManager> stationManager);
   ///\name Each mesh point interface must know the mesh point address
   // \{
   void SetMeshPointAddress (Mac48Address);
@@ -143,8 +145,23 @@ public:
   ///\name Metric Calculation routines:
   // \{
   void SetLinkMetricCallback (Callback<uint32_t, Mac48Address, Ptr<MeshWifiInterfaceMac> > cb);
+  /**
+   * Get the metric of the link to a peer.  The metric is cached per peer,
+   * and only recomputed when the data mode selected for the peer by the
+   * remote station manager, or its data rate, changes, or when its frame
+   * error rate average moves by more than the MetricFerThreshold attribute.
+   *
+   * \param peerAddress the peer address
+   * \return the link metric
+   */
   uint32_t GetLinkMetric (Mac48Address peerAddress);
   // \}
+  /**
+   * \return the number of frames waiting on the interface: the beacons
+   *         and other non-QoS frames, and the frames of the access
+   *         categories
+   */
+  uint32_t GetQueueSize ();
   ///\brief Statistics:
   void Report (std::ostream &) const;
   /// Reset statistics
@@ -194,6 +211,23 @@ private:
    * \param to the to address
    */
   void ForwardDown (Ptr<const Packet> packet, Mac48Address from, Mac48Address to);
+  /**
+   * Invalidate the cached link metric of a peer whose data mode or data
+   * rate changed.
+   *
+   * \param oldMode the previous data mode
+   * \param newMode the new data mode
+   * \param peerAddress the peer address
+   */
+  void DataModeChanged (WifiMode oldMode, WifiMode newMode, Mac48Address peerAddress);
+  /**
+   * Invalidate the cached link metric of a peer whose frame error rate
+   * average moved by more than the threshold since the metric was computed.
+   *
+   * \param frameErrorRate the new frame error rate average
+   * \param peerAddress the peer address
+   */
+  void FrameErrorRateUpdated (double frameErrorRate, Mac48Address peerAddress);
   /// Send beacon
   void SendBeacon ();
   /// Schedule next beacon
@@ -223,6 +257,8 @@ private:
   Time m_randomStart;
   /// Time for the next frame
   Time m_tbtt;
+  /// whether beacons are abstracted rather than transmitted
+  bool m_abstractBeacons;
   // \}
 
   /// Mesh point address
@@ -233,6 +269,16 @@ private:
   /// List of all installed plugins
   PluginList m_plugins;
   Callback<uint32_t, Mac48Address, Ptr<MeshWifiInterfaceMac> > m_linkMetricCallback; ///< linkMetricCallback
+  /// Cached link metric of a peer
+  struct LinkMetricCacheEntry
+  {
+    uint32_t metric; ///< link metric
+    double frameErrorRate; ///< frame error rate average the metric was computed with
+  };
+  /// Cached link metrics, by peer address
+  std::map<Mac48Address, LinkMetricCacheEntry> m_linkMetricCache;
+  /// Change of the frame error rate average above which a cached link metric is recomputed
+  double m_metricFerThreshold;
   /// Statistics:
   struct Statistics
   {
@@ -17,6 +17,8 @@
  *
  * Author: Pavel Boyko <boyko@iitp.ru>
  */
+#include <algorithm>
+#include <sstream>
 #include "ns3/test.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
@@ -25,6 +27,26 @@
 #include "ns3/hwmp-rtable.h"
 #include "ns3/peer-link-frame.h"
 #include "ns3/ie-dot11s-peer-management.h"
+#include "ns3/hwmp-protocol.h"
+#include "ns3/mesh-helper.h"
+#include "ns3/mesh-point-device.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/config.h"
+#include "ns3/airtime-metric.h"
+#include "ns3/mesh-wifi-interface-mac.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/ht-capabilities.h"
+#include "ns3/he-configuration.h"
+#include "ns3/mesh-obss-pd-algorithm.h"
+#include "ns3/adaptive-obss-pd-algorithm.h"
+#include "ns3/wifi-utils.h"
 
 using namespace ns3;
 using namespace dot11s;
@@ -269,6 +291,983 @@ PeerLinkFrameStartTest::DoRun ()
     NS_TEST_EXPECT_MSG_EQ (a, b, "PEER_LINK_CLOSE works");
   }
 }
+/**
+ * \ingroup mesh-test
+ * \ingroup tests
+ *
+ * \brief Test the queue of the packets waiting for a path in HWMP: with
+ * both drop policies, each packet is dropped once, either when the queue
+ * overflows or when the discovery of the path to its destination fails.
+ */
+class HwmpQueueTest : public TestCase
+{
+public:
+  HwmpQueueTest ();
+  virtual void DoRun ();
+
+private:
+  /**
+   * Queue packets to two unreachable destinations in a full queue.
+   *
+   * \param policy the drop policy of the queue
+   */
+  void RunPolicy (HwmpProtocol::QueueDropPolicy policy);
+  /**
+   * Record a packet dropped by HWMP.
+   *
+   * \param success whether a path was found
+   * \param packet the packet
+   * \param src the source address
+   * \param dst the destination address
+   * \param protocol the protocol number
+   * \param index the interface index
+   */
+  void Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t index);
+
+  std::vector<uint64_t> m_dropped; ///< UIDs of the dropped packets, in order
+};
+
+HwmpQueueTest::HwmpQueueTest ()
+  : TestCase ("HWMP queue drop policies")
+{
+}
+
+void
+HwmpQueueTest::Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t index)
+{
+  NS_TEST_EXPECT_MSG_EQ (success, false, "No path can be found");
+  m_dropped.push_back (packet->GetUid ());
+}
+
+void
+HwmpQueueTest::RunPolicy (HwmpProtocol::QueueDropPolicy policy)
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  MobilityHelper mobility;
+  mobility.Install (nodes);
+
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  Ptr<HwmpProtocol> hwmp = DynamicCast<HwmpProtocol> (mp->GetRoutingProtocol ());
+  //The queue holds MaxQueueSize + 1 packets
+  hwmp->SetAttribute ("MaxQueueSize", UintegerValue (2));
+  hwmp->SetAttribute ("QueueDropPolicy", EnumValue (policy));
+
+  Mac48Address src = Mac48Address::ConvertFrom (mp->GetAddress ());
+  Mac48Address dst[2] = {Mac48Address ("02:00:00:00:00:01"), Mac48Address ("02:00:00:00:00:02")};
+  std::vector<uint64_t> uids;
+  m_dropped.clear ();
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<Packet> packet = Create<Packet> (100);
+      bool queued = hwmp->RequestRoute (mp->GetIfIndex (), src, dst[i % 2], packet, 0x0800,
+                                        MakeCallback (&HwmpQueueTest::Reply, this));
+      NS_TEST_EXPECT_MSG_EQ (queued, (i < 3 || policy == HwmpProtocol::DROP_OLDEST), "Packet " << i << " queued");
+      //HWMP queues a copy of the packet
+      uids.push_back (packet->GetUid ());
+    }
+  if (policy == HwmpProtocol::DROP_OLDEST)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_dropped.size (), 1, "The oldest packet is dropped on overflow");
+      NS_TEST_EXPECT_MSG_EQ (m_dropped[0], uids[0], "The oldest packet is dropped on overflow");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_dropped.size (), 0, "The newest packet is not queued");
+    }
+
+  //The path discoveries fail, and the remaining packets are dropped
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_dropped.size (), (policy == HwmpProtocol::DROP_OLDEST ? 4 : 3), "Packets dropped");
+  std::sort (m_dropped.begin (), m_dropped.end ());
+  NS_TEST_EXPECT_MSG_EQ ((std::unique (m_dropped.begin (), m_dropped.end ()) == m_dropped.end ()), true,
+                         "Each packet is dropped once");
+}
+
+void
+HwmpQueueTest::DoRun ()
+{
+  RunPolicy (HwmpProtocol::DROP_NEWEST);
+  RunPolicy (HwmpProtocol::DROP_OLDEST);
+}
+
+/**
+ * \ingroup mesh-test
+ * \ingroup tests
+ *
+ * \brief Test the cache of the airtime link metrics of a mesh interface:
+ * the metric of a peer is only recomputed when its data mode changes, or
+ * when its frame error rate average moves by more than the threshold.
+ */
+class AirtimeMetricCacheTest : public TestCase
+{
+public:
+  AirtimeMetricCacheTest ();
+  virtual void DoRun ();
+
+private:
+  /**
+   * Compute the airtime metric, and count the computations.
+   *
+   * \param peerAddress the peer address
+   * \param mac the mesh interface
+   * \return the link metric
+   */
+  uint32_t CalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac);
+  /// Change the data mode, then the frame error rate of the peer
+  void ChangeModeAndFrameErrorRate ();
+  /// Move the frame error rate of the peer by less than the threshold
+  void MoveFrameErrorRate ();
+
+  Ptr<AirtimeLinkMetricCalculator> m_calculator; ///< metric calculator
+  Ptr<MeshWifiInterfaceMac> m_mac; ///< mesh interface
+  Ptr<WifiRemoteStationManager> m_manager; ///< station manager of the mesh interface
+  Mac48Address m_peer; ///< peer address
+  WifiMacHeader m_header; ///< header of the data frames to the peer
+  uint32_t m_computed; ///< number of metric computations
+  uint32_t m_metric; ///< last metric
+};
+
+AirtimeMetricCacheTest::AirtimeMetricCacheTest ()
+  : TestCase ("Airtime link metric cache"),
+    m_peer ("02:00:00:00:00:01"),
+    m_computed (0),
+    m_metric (0)
+{
+}
+
+uint32_t
+AirtimeMetricCacheTest::CalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac)
+{
+  m_computed++;
+  return m_calculator->CalculateMetric (peerAddress, mac);
+}
+
+void
+AirtimeMetricCacheTest::ChangeModeAndFrameErrorRate ()
+{
+  m_metric = m_mac->GetLinkMetric (m_peer);
+  NS_TEST_EXPECT_MSG_EQ (m_mac->GetLinkMetric (m_peer), m_metric, "Cached metric");
+  NS_TEST_EXPECT_MSG_EQ (m_computed, 1, "The metric is computed once");
+
+  //The new mode is only seen by the cache once it is selected for a frame
+  m_manager->SetAttribute ("DataMode", StringValue ("OfdmRate6Mbps"));
+  NS_TEST_EXPECT_MSG_EQ (m_mac->GetLinkMetric (m_peer), m_metric, "Cached metric");
+  m_manager->GetDataTxVector (m_peer, &m_header, Create<Packet> (1000));
+  uint32_t metric = m_mac->GetLinkMetric (m_peer);
+  NS_TEST_EXPECT_MSG_EQ (m_computed, 2, "The metric is recomputed on a mode change");
+  NS_TEST_EXPECT_MSG_GT (metric, m_metric, "A lower rate gives a higher metric");
+  m_metric = metric;
+
+  //A failure a second after the start moves the frame error rate to 1 - 1/e
+  m_manager->ReportFinalDataFailed (m_peer, &m_header, 1000);
+  metric = m_mac->GetLinkMetric (m_peer);
+  NS_TEST_EXPECT_MSG_EQ (m_computed, 3, "The metric is recomputed on a frame error rate change");
+  NS_TEST_EXPECT_MSG_GT (metric, m_metric, "A higher frame error rate gives a higher metric");
+  m_metric = metric;
+}
+
+void
+AirtimeMetricCacheTest::MoveFrameErrorRate ()
+{
+  m_manager->ReportDataOk (m_peer, &m_header, 0, WifiPhy::GetOfdmRate6Mbps (), 0, 1000);
+  NS_TEST_EXPECT_MSG_EQ (m_mac->GetLinkMetric (m_peer), m_metric, "Cached metric");
+  NS_TEST_EXPECT_MSG_EQ (m_computed, 3, "The metric is not recomputed on a small frame error rate change");
+}
+
+void
+AirtimeMetricCacheTest::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate54Mbps"));
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  MobilityHelper mobility;
+  mobility.Install (nodes);
+
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (mp->GetInterfaces ()[0]);
+  m_mac = DynamicCast<MeshWifiInterfaceMac> (device->GetMac ());
+  m_manager = device->GetRemoteStationManager ();
+  m_calculator = CreateObject<AirtimeLinkMetricCalculator> ();
+  m_mac->SetLinkMetricCallback (MakeCallback (&AirtimeMetricCacheTest::CalculateMetric, this));
+  m_header.SetType (WIFI_MAC_QOSDATA);
+  m_header.SetQosTid (0);
+
+  Simulator::Schedule (Seconds (1), &AirtimeMetricCacheTest::ChangeModeAndFrameErrorRate, this);
+  Simulator::Schedule (Seconds (1) + MicroSeconds (1), &AirtimeMetricCacheTest::MoveFrameErrorRate, this);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_mac = 0;
+  m_manager = 0;
+  m_calculator = 0;
+}
+
+/**
+ * \ingroup mesh-test
+ * \ingroup tests
+ *
+ * \brief Test that the cached airtime metric of a peer is recomputed when
+ * the data rate changes under the same data mode: the HT capabilities of
+ * the peer enable the short guard interval.
+ */
+class AirtimeMetricRateChangeTest : public TestCase
+{
+public:
+  AirtimeMetricRateChangeTest ();
+  virtual void DoRun ();
+
+private:
+  /**
+   * Compute the airtime metric, and count the computations.
+   *
+   * \param peerAddress the peer address
+   * \param mac the mesh interface
+   * \return the link metric
+   */
+  uint32_t CalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac);
+  /// Enable the short guard interval of the peer
+  void ChangeGuardInterval ();
+
+  Ptr<AirtimeLinkMetricCalculator> m_calculator; ///< metric calculator
+  Ptr<MeshWifiInterfaceMac> m_mac; ///< mesh interface
+  Ptr<WifiRemoteStationManager> m_manager; ///< station manager of the mesh interface
+  Mac48Address m_peer; ///< peer address
+  WifiMacHeader m_header; ///< header of the data frames to the peer
+  uint32_t m_computed; ///< number of metric computations
+};
+
+AirtimeMetricRateChangeTest::AirtimeMetricRateChangeTest ()
+  : TestCase ("Airtime link metric cache on a data rate change"),
+    m_peer ("02:00:00:00:00:01"),
+    m_computed (0)
+{
+}
+
+uint32_t
+AirtimeMetricRateChangeTest::CalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac)
+{
+  m_computed++;
+  return m_calculator->CalculateMetric (peerAddress, mac);
+}
+
+void
+AirtimeMetricRateChangeTest::ChangeGuardInterval ()
+{
+  HtCapabilities htCapabilities;
+  htCapabilities.SetHtSupported (1);
+  htCapabilities.SetRxMcsBitmask (7);
+  m_manager->AddStationHtCapabilities (m_peer, htCapabilities);
+  uint32_t metric = m_mac->GetLinkMetric (m_peer);
+  NS_TEST_EXPECT_MSG_EQ (m_computed, 1, "The metric is computed once");
+
+  //Same mode, but a shorter guard interval, hence a higher data rate
+  htCapabilities.SetShortGuardInterval20 (1);
+  m_manager->AddStationHtCapabilities (m_peer, htCapabilities);
+  WifiTxVector txVector = m_manager->GetDataTxVector (m_peer, &m_header, Create<Packet> (1000));
+  NS_TEST_EXPECT_MSG_EQ (txVector.GetGuardInterval (), 400, "Short guard interval");
+  NS_TEST_EXPECT_MSG_LT (m_mac->GetLinkMetric (m_peer), metric, "A higher rate gives a lower metric");
+  NS_TEST_EXPECT_MSG_EQ (m_computed, 2, "The metric is recomputed on a data rate change");
+}
+
+void
+AirtimeMetricRateChangeTest::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("HtMcs7"));
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  MobilityHelper mobility;
+  mobility.Install (nodes);
+
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (mp->GetInterfaces ()[0]);
+  m_mac = DynamicCast<MeshWifiInterfaceMac> (device->GetMac ());
+  m_manager = device->GetRemoteStationManager ();
+  m_calculator = CreateObject<AirtimeLinkMetricCalculator> ();
+  m_mac->SetLinkMetricCallback (MakeCallback (&AirtimeMetricRateChangeTest::CalculateMetric, this));
+  m_header.SetType (WIFI_MAC_QOSDATA);
+  m_header.SetQosTid (0);
+
+  Simulator::Schedule (Seconds (1), &AirtimeMetricRateChangeTest::ChangeGuardInterval, this);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_mac = 0;
+  m_manager = 0;
+  m_calculator = 0;
+}
+
+/**
+ * \ingroup mesh-test
+ * \ingroup tests
+ *
+ * \brief Test the batching of the path selection elements: a mesh point
+ * requests the paths to its two neighbors at once.  Without batching,
+ * the second destination waits for the PREQ minimum interval in a second
+ * PREQ, while with batching, it is added to the first PREQ, which waits
+ * for the end of the batch window.
+ */
+class HwmpBatchTest : public TestCase
+{
+public:
+  HwmpBatchTest ();
+  virtual void DoRun ();
+
+private:
+  /**
+   * Request the paths to the two neighbors.
+   *
+   * \param window the batch window
+   */
+  void RunWindow (Time window);
+  /**
+   * Count the path selection frames transmitted by the first mesh point.
+   *
+   * \param packet the frame
+   * \param txPowerW the TX power
+   */
+  void PhyTxBegin (Ptr<const Packet> packet, double txPowerW);
+  /**
+   * Count the paths found.
+   *
+   * \param success whether a path was found
+   * \param packet the packet
+   * \param src the source address
+   * \param dst the destination address
+   * \param protocol the protocol number
+   * \param index the interface index
+   */
+  void Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t index);
+
+  uint32_t m_frames; ///< number of path selection frames transmitted by the first mesh point
+  uint32_t m_found; ///< number of paths found
+};
+
+HwmpBatchTest::HwmpBatchTest ()
+  : TestCase ("HWMP path selection batching"),
+    m_frames (0),
+    m_found (0)
+{
+}
+
+void
+HwmpBatchTest::PhyTxBegin (Ptr<const Packet> packet, double txPowerW)
+{
+  Ptr<Packet> copy = packet->Copy ();
+  WifiMacHeader hdr;
+  copy->RemoveHeader (hdr);
+  if (!hdr.IsAction ())
+    {
+      return;
+    }
+  WifiActionHeader actionHdr;
+  copy->RemoveHeader (actionHdr);
+  if (actionHdr.GetCategory () == WifiActionHeader::MESH
+      && actionHdr.GetAction ().meshAction == WifiActionHeader::PATH_SELECTION)
+    {
+      m_frames++;
+    }
+}
+
+void
+HwmpBatchTest::Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t index)
+{
+  m_found += success;
+}
+
+void
+HwmpBatchTest::RunWindow (Time window)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  //Management action frames are only received by QoS mesh points
+  mesh.SetMacType ("QosSupported", BooleanValue (true));
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  mesh.AssignStreams (devices, 0);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (50),
+                                 "GridWidth", UintegerValue (3));
+  mobility.Install (nodes);
+  Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/PathSelectionBatchWindow",
+               TimeValue (window));
+
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (mp->GetInterfaces ()[0]);
+  device->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&HwmpBatchTest::PhyTxBegin, this));
+  Mac48Address src = Mac48Address::ConvertFrom (mp->GetAddress ());
+  Ptr<Packet> packet = Create<Packet> (100);
+  m_frames = 0;
+  m_found = 0;
+  //Peer links are up after a few beacons
+  for (uint32_t i = 1; i < 3; i++)
+    {
+      Mac48Address dst = Mac48Address::ConvertFrom (devices.Get (i)->GetAddress ());
+      Simulator::Schedule (Seconds (5), &MeshL2RoutingProtocol::RequestRoute, mp->GetRoutingProtocol (),
+                           mp->GetIfIndex (), src, dst, packet, 0x0800, MakeCallback (&HwmpBatchTest::Reply, this));
+    }
+  Simulator::Stop (Seconds (6));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_found, 2, "Both paths are found");
+  NS_TEST_EXPECT_MSG_EQ (m_frames, (window.IsZero () ? 2 : 1), "PREQs of the first mesh point");
+}
+
+void
+HwmpBatchTest::DoRun ()
+{
+  RunWindow (Seconds (0));
+  RunWindow (MilliSeconds (10));
+}
+
+/**
+ * \ingroup mesh-test
+ * \ingroup tests
+ *
+ * \brief Test the proactive tree of two roots announced by RANNs, on a
+ * line of five mesh points whose ends are the roots: each mesh point
+ * keeps a path to both roots, selects the closest one, and the roots
+ * have a path back to each mesh point.  Then the middle mesh point of
+ * the line is told that its peer link towards the first root failed: with
+ * path repair, it requests the path to the first root again at once,
+ * while without it, it waits for the next RANN.
+ */
+class HwmpRootTest : public TestCase
+{
+public:
+  HwmpRootTest ();
+  virtual void DoRun ();
+
+private:
+  /**
+   * Build the line and run it.
+   *
+   * \param repair whether the broken paths to the roots are repaired
+   */
+  void RunRepair (bool repair);
+  /// Check the paths to and from the roots
+  void CheckTree ();
+  /// Break the path of the middle mesh point to the first root
+  void BreakLink ();
+  /**
+   * Check the path of the middle mesh point to the first root
+   *
+   * \param repair whether the broken paths to the roots are repaired
+   */
+  void CheckRepair (bool repair);
+  /**
+   * Count the paths found.
+   *
+   * \param success whether a path was found
+   * \param packet the packet
+   * \param src the source address
+   * \param dst the destination address
+   * \param protocol the protocol number
+   * \param index the interface index
+   */
+  void Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t index);
+
+  NetDeviceContainer m_devices; ///< the mesh points
+  uint32_t m_found; ///< number of paths found
+};
+
+HwmpRootTest::HwmpRootTest ()
+  : TestCase ("HWMP proactive tree of several roots"),
+    m_found (0)
+{
+}
+
+void
+HwmpRootTest::Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t index)
+{
+  m_found += success;
+}
+
+void
+HwmpRootTest::CheckTree ()
+{
+  Mac48Address first = Mac48Address::ConvertFrom (m_devices.Get (0)->GetAddress ());
+  Mac48Address last = Mac48Address::ConvertFrom (m_devices.Get (4)->GetAddress ());
+  for (uint32_t i = 1; i < 4; i++)
+    {
+      Ptr<HwmpProtocol> hwmp = m_devices.Get (i)->GetObject<HwmpProtocol> ();
+      NS_TEST_EXPECT_MSG_EQ (hwmp->GetRoutingTable ()->LookupProactive (first).IsValid (), true, "Path to the first root");
+      NS_TEST_EXPECT_MSG_EQ (hwmp->GetRoutingTable ()->LookupProactive (last).IsValid (), true, "Path to the last root");
+      Mac48Address address = Mac48Address::ConvertFrom (m_devices.Get (i)->GetAddress ());
+      Ptr<HwmpRtable> firstRoot = m_devices.Get (0)->GetObject<HwmpProtocol> ()->GetRoutingTable ();
+      NS_TEST_EXPECT_MSG_EQ (firstRoot->LookupReactive (address).IsValid (), true, "Path of the first root back");
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_devices.Get (1)->GetObject<HwmpProtocol> ()->GetRoot (), first, "Closest root");
+  NS_TEST_EXPECT_MSG_EQ (m_devices.Get (3)->GetObject<HwmpProtocol> ()->GetRoot (), last, "Closest root");
+  Ptr<NetDevice> iface = DynamicCast<MeshPointDevice> (m_devices.Get (1))->GetInterfaces ()[0];
+  Ptr<NetDevice> rootIface = DynamicCast<MeshPointDevice> (m_devices.Get (0))->GetInterfaces ()[0];
+  Ptr<HwmpProtocol> hwmp = m_devices.Get (1)->GetObject<HwmpProtocol> ();
+  NS_TEST_EXPECT_MSG_EQ (hwmp->GetNextHopToRoot (iface->GetIfIndex ()), Mac48Address::ConvertFrom (rootIface->GetAddress ()),
+                         "Next hop to the closest root");
+  NS_TEST_EXPECT_MSG_EQ (hwmp->GetNextHopToRoot (iface->GetIfIndex () + 1), Mac48Address::GetBroadcast (),
+                         "No next hop to the closest root through another interface");
+
+  //The path to a root is known at once
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (m_devices.Get (1));
+  mp->GetRoutingProtocol ()->RequestRoute (mp->GetIfIndex (), Mac48Address::ConvertFrom (mp->GetAddress ()), last,
+                                           Create<Packet> (100), 0x0800, MakeCallback (&HwmpRootTest::Reply, this));
+  NS_TEST_EXPECT_MSG_EQ (m_found, 1, "Path to the last root without discovery");
+}
+
+void
+HwmpRootTest::BreakLink ()
+{
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (m_devices.Get (2));
+  Mac48Address first = Mac48Address::ConvertFrom (m_devices.Get (0)->GetAddress ());
+  Ptr<HwmpProtocol> hwmp = mp->GetObject<HwmpProtocol> ();
+  Mac48Address peer = hwmp->GetRoutingTable ()->LookupProactive (first).retransmitter;
+  hwmp->PeerLinkStatus (Mac48Address::ConvertFrom (mp->GetAddress ()), peer, mp->GetInterfaces ()[0]->GetIfIndex (), false);
+  NS_TEST_EXPECT_MSG_EQ (hwmp->GetRoutingTable ()->LookupProactive (first).IsValid (), false, "Broken path to the first root");
+}
+
+void
+HwmpRootTest::CheckRepair (bool repair)
+{
+  Mac48Address first = Mac48Address::ConvertFrom (m_devices.Get (0)->GetAddress ());
+  Ptr<HwmpProtocol> hwmp = m_devices.Get (2)->GetObject<HwmpProtocol> ();
+  NS_TEST_EXPECT_MSG_EQ (hwmp->GetRoutingTable ()->LookupProactive (first).IsValid (), repair, "Repaired path to the first root");
+}
+
+void
+HwmpRootTest::RunRepair (bool repair)
+{
+  //The mesh points get the addresses which follow the last allocated one
+  uint8_t buffer[6];
+  Mac48Address::Allocate ().CopyTo (buffer);
+  uint64_t address = 0;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      address = (address << 8) | buffer[i];
+    }
+  std::ostringstream roots;
+  for (uint64_t root = address + 1; root <= address + 5; root += 4)
+    {
+      for (int32_t i = 5; i >= 0; i--)
+        {
+          buffer[i] = (root >> (8 * (5 - i))) & 0xff;
+        }
+      Mac48Address mac;
+      mac.CopyFrom (buffer);
+      roots << mac << " ";
+    }
+
+  NodeContainer nodes;
+  nodes.Create (5);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack", "Roots", StringValue (roots.str ()));
+  //Management action frames are only received by QoS mesh points
+  mesh.SetMacType ("QosSupported", BooleanValue (true));
+  m_devices = mesh.Install (phy, nodes);
+  mesh.AssignStreams (m_devices, 0);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (50),
+                                 "GridWidth", UintegerValue (5));
+  mobility.Install (nodes);
+  Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/RootMode",
+               EnumValue (HwmpProtocol::RANN));
+  Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/Dot11MeshHWMPrannInterval",
+               TimeValue (Seconds (4)));
+  Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/RootPathRepair",
+               BooleanValue (repair));
+  m_found = 0;
+
+  //Peer links are up after a few beacons, and the second RANNs are sent
+  //after 4 s
+  Simulator::Schedule (Seconds (4.5), &HwmpRootTest::CheckTree, this);
+  Simulator::Schedule (Seconds (5), &HwmpRootTest::BreakLink, this);
+  Simulator::Schedule (Seconds (6), &HwmpRootTest::CheckRepair, this, repair);
+  Simulator::Stop (Seconds (6.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+HwmpRootTest::DoRun ()
+{
+  RunRepair (true);
+  RunRepair (false);
+}
+
+/**
+ * \ingroup dot11s-test
+ * \ingroup tests
+ *
+ * \brief Test the multi-channel forwarding: two mesh points of two
+ * interfaces each, spread over two channels, peer on both channels.
+ * Then the first one sends a burst of frames to the second one: without
+ * multi-channel forwarding, they are all sent on the interface of the
+ * path, while with it, they are split between both interfaces.
+ */
+class HwmpMultiChannelTest : public TestCase
+{
+public:
+  HwmpMultiChannelTest ();
+  virtual void DoRun ();
+
+private:
+  /**
+   * Send the burst of frames.
+   *
+   * \param multiChannel whether multi-channel forwarding is enabled
+   */
+  void RunBurst (bool multiChannel);
+  /**
+   * Count the data frames transmitted by an interface of the first mesh
+   * point.
+   *
+   * \param context the index of the interface
+   * \param packet the frame
+   * \param txPowerW the TX power
+   */
+  void PhyTxBegin (std::string context, Ptr<const Packet> packet, double txPowerW);
+
+  uint32_t m_frames[2]; ///< number of data frames transmitted by each interface of the first mesh point
+};
+
+HwmpMultiChannelTest::HwmpMultiChannelTest ()
+  : TestCase ("HWMP multi-channel forwarding")
+{
+}
+
+void
+HwmpMultiChannelTest::PhyTxBegin (std::string context, Ptr<const Packet> packet, double txPowerW)
+{
+  WifiMacHeader hdr;
+  packet->PeekHeader (hdr);
+  if (hdr.IsData () && !hdr.GetAddr1 ().IsGroup ())
+    {
+      m_frames[context == "1"]++;
+    }
+}
+
+void
+HwmpMultiChannelTest::RunBurst (bool multiChannel)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetMacType ("QosSupported", BooleanValue (true));
+  mesh.SetNumberOfInterfaces (2);
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  mesh.AssignStreams (devices, 0);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (50),
+                                 "GridWidth", UintegerValue (2));
+  mobility.Install (nodes);
+  Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/MultiChannelForwarding",
+               BooleanValue (multiChannel));
+
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  std::vector<Ptr<NetDevice> > interfaces = mp->GetInterfaces ();
+  NS_TEST_ASSERT_MSG_EQ (interfaces.size (), 2, "Interfaces of the mesh point");
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<WifiPhy> wifiPhy = DynamicCast<WifiNetDevice> (interfaces[i])->GetPhy ();
+      NS_TEST_EXPECT_MSG_EQ (+wifiPhy->GetChannelNumber (), (i == 0 ? 36 : 40), "Channel of the interface");
+      std::ostringstream context;
+      context << i;
+      wifiPhy->TraceConnect ("PhyTxBegin", context.str (), MakeCallback (&HwmpMultiChannelTest::PhyTxBegin, this));
+      m_frames[i] = 0;
+    }
+  //Peer links are up on both channels after a few beacons
+  Mac48Address dst = Mac48Address::ConvertFrom (devices.Get (1)->GetAddress ());
+  const uint32_t burst = 100;
+  for (uint32_t i = 0; i < burst; i++)
+    {
+      Simulator::Schedule (Seconds (5), &NetDevice::Send, mp, Create<Packet> (1000), dst, 0x0800);
+    }
+  Simulator::Stop (Seconds (7));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (m_frames[0] + m_frames[1], burst, "The whole burst is transmitted");
+  if (multiChannel)
+    {
+      NS_TEST_EXPECT_MSG_GT (m_frames[0], burst / 4, "Frames of the first interface");
+      NS_TEST_EXPECT_MSG_GT (m_frames[1], burst / 4, "Frames of the second interface");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (std::min (m_frames[0], m_frames[1]), 0, "Frames of the interface which is not on the path");
+    }
+}
+
+void
+HwmpMultiChannelTest::DoRun ()
+{
+  RunBurst (false);
+  RunBurst (true);
+}
+
+/**
+ * \ingroup mesh-test
+ * \ingroup tests
+ *
+ * \brief Test the HE spatial reuse of a line of four 802.11ax mesh
+ * points: each interface gets the OBSS PD algorithm of the helper, and
+ * the mesh points are colored two by two, one BSS color per
+ * neighborhood, and the node IDs carried by their preambles are found
+ * from their addresses.
+ */
+class MeshBssColorTest : public TestCase
+{
+public:
+  MeshBssColorTest ();
+  virtual void DoRun ();
+};
+
+MeshBssColorTest::MeshBssColorTest ()
+  : TestCase ("HE BSS colors of the mesh neighborhoods")
+{
+}
+
+void
+MeshBssColorTest::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  mesh.SetMacType ("QosSupported", BooleanValue (true));
+  mesh.SetObssPdAlgorithm ("ns3::MeshObssPdAlgorithm");
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (30),
+                                 "GridWidth", UintegerValue (4));
+  mobility.Install (nodes);
+
+  NS_TEST_EXPECT_MSG_EQ (+MeshHelper::AssignBssColors (devices, 40), 2, "Colors of the neighborhoods");
+  const uint8_t colors[4] = {1, 1, 2, 2};
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<WifiNetDevice> iface = DynamicCast<WifiNetDevice> (DynamicCast<MeshPointDevice> (devices.Get (i))->GetInterfaces ()[0]);
+      NS_TEST_EXPECT_MSG_NE (iface->GetObject<MeshObssPdAlgorithm> (), 0, "OBSS PD algorithm of the interface");
+      UintegerValue bssColor;
+      iface->GetHeConfiguration ()->GetAttribute ("BssColor", bssColor);
+      NS_TEST_EXPECT_MSG_EQ (bssColor.Get (), colors[i], "BSS color of the mesh point");
+      NS_TEST_EXPECT_MSG_EQ (GetNodeIdOfAddress (iface->GetMac ()->GetAddress ()), nodes.Get (i)->GetId (),
+                             "Node ID of the interface address");
+    }
+  NS_TEST_EXPECT_MSG_EQ (GetNodeIdOfAddress (Mac48Address::GetBroadcast ()), NO_NODE_ID, "Node ID of a group address");
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mesh-test
+ * \ingroup tests
+ *
+ * \brief Test the learning of the OBSS PD level of a neighbor by the
+ * adaptive OBSS PD algorithm of the mesh points: the level is lowered
+ * after a window of lost frames, raised after a window of acknowledged
+ * ones, with a step halved each time, and settles after
+ * 1 + log2 (InitialStep / MinStep) windows.
+ */
+class AdaptiveObssPdTest : public TestCase
+{
+public:
+  AdaptiveObssPdTest ();
+  virtual void DoRun ();
+
+private:
+  /**
+   * Count the changes of the level.
+   *
+   * \param neighbor the node ID of the neighbor
+   * \param levelDbm the new level
+   * \param per the error rate of the last window
+   */
+  void LevelChange (uint16_t neighbor, double levelDbm, double per);
+
+  uint32_t m_changes; ///< number of changes of the level
+};
+
+AdaptiveObssPdTest::AdaptiveObssPdTest ()
+  : TestCase ("Adaptive OBSS PD level of a neighbor"),
+    m_changes (0)
+{
+}
+
+void
+AdaptiveObssPdTest::LevelChange (uint16_t neighbor, double levelDbm, double per)
+{
+  m_changes++;
+}
+
+void
+AdaptiveObssPdTest::DoRun ()
+{
+  Ptr<AdaptiveObssPdAlgorithm> algorithm = CreateObject<AdaptiveObssPdAlgorithm> ();
+  algorithm->SetAttribute ("ObssPdLevel", DoubleValue (-72));
+  algorithm->SetAttribute ("Window", UintegerValue (10));
+  algorithm->SetAttribute ("InitialStep", DoubleValue (4));
+  algorithm->SetAttribute ("MinStep", DoubleValue (0.5));
+  algorithm->TraceConnectWithoutContext ("LevelChange", MakeCallback (&AdaptiveObssPdTest::LevelChange, this));
+
+  //Lost, acknowledged, lost then acknowledged windows: -76, -74, -75, -74.5
+  const bool outcomes[4] = {false, true, false, true};
+  const double levels[4] = {-76, -74, -75, -74.5};
+  for (uint32_t window = 0; window < 4; window++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (algorithm->IsSettled (3), false, "Level settled too early");
+      for (uint32_t i = 0; i < 10; i++)
+        {
+          algorithm->ReportTxOutcome (3, outcomes[window]);
+        }
+      NS_TEST_EXPECT_MSG_EQ_TOL (algorithm->GetObssPdLevel (3), levels[window], 1e-9, "Level after window " << window);
+    }
+  NS_TEST_EXPECT_MSG_EQ (algorithm->IsSettled (3), true, "Level not settled");
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      algorithm->ReportTxOutcome (3, false);
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (algorithm->GetObssPdLevel (3), -74.5, 1e-9, "Settled level changed");
+  NS_TEST_EXPECT_MSG_EQ (m_changes, 4, "Changes of the level");
+  NS_TEST_EXPECT_MSG_EQ_TOL (algorithm->GetObssPdLevel (5), -72, 1e-9, "Level of an unknown neighbor");
+  NS_TEST_EXPECT_MSG_EQ (algorithm->IsSettled (5), false, "Unknown neighbor settled");
+}
+
+/**
+ * \ingroup mesh-test
+ * \ingroup tests
+ *
+ * \brief Test the adaptive OBSS PD algorithm on real HE links: a line of
+ * four 802.11ax mesh points, in two neighborhoods of different BSS colors.
+ * The second one sends to the first one while the third one sends to the
+ * fourth one.  The second mesh point ignores the frames of the third one,
+ * and learns its level from the outcome of the frames it sends meanwhile,
+ * read from the S-MPDUs and A-MPDUs of the PHY traces.
+ */
+class AdaptiveObssPdLinkTest : public TestCase
+{
+public:
+  AdaptiveObssPdLinkTest ();
+  virtual void DoRun ();
+
+private:
+  /**
+   * Count the changes of the level of the second mesh point.
+   *
+   * \param neighbor the node ID of the neighbor
+   * \param levelDbm the new level
+   * \param per the error rate of the last window
+   */
+  void LevelChange (uint16_t neighbor, double levelDbm, double per);
+
+  uint16_t m_neighbor; ///< node ID of the third mesh point
+  uint32_t m_changes; ///< number of changes of the level of the third mesh point
+  double m_per; ///< lowest error rate of the windows
+};
+
+AdaptiveObssPdLinkTest::AdaptiveObssPdLinkTest ()
+  : TestCase ("Adaptive OBSS PD level of a neighbor on HE mesh links"),
+    m_neighbor (NO_NODE_ID),
+    m_changes (0),
+    m_per (1)
+{
+}
+
+void
+AdaptiveObssPdLinkTest::LevelChange (uint16_t neighbor, double levelDbm, double per)
+{
+  if (neighbor == m_neighbor)
+    {
+      m_changes++;
+      m_per = std::min (m_per, per);
+    }
+}
+
+void
+AdaptiveObssPdLinkTest::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  mesh.SetMacType ("QosSupported", BooleanValue (true));
+  mesh.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("HeMcs2"));
+  mesh.SetObssPdAlgorithm ("ns3::AdaptiveObssPdAlgorithm",
+                           "ObssPdLevel", DoubleValue (-72),
+                           "Window", UintegerValue (1));
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  mesh.AssignStreams (devices, 0);
+  //The receivers are far from the transmitter of the other link
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0, 0, 0));
+  positions->Add (Vector (20, 0, 0));
+  positions->Add (Vector (70, 0, 0));
+  positions->Add (Vector (90, 0, 0));
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (nodes);
+  NS_TEST_ASSERT_MSG_EQ (+MeshHelper::AssignBssColors (devices, 40), 2, "Colors of the neighborhoods");
+
+  Ptr<WifiNetDevice> iface = DynamicCast<WifiNetDevice> (DynamicCast<MeshPointDevice> (devices.Get (1))->GetInterfaces ()[0]);
+  Ptr<AdaptiveObssPdAlgorithm> algorithm = DynamicCast<AdaptiveObssPdAlgorithm> (iface->GetObject<MeshObssPdAlgorithm> ());
+  NS_TEST_ASSERT_MSG_NE (algorithm, 0, "Adaptive OBSS PD algorithm of the interface");
+  algorithm->TraceConnectWithoutContext ("LevelChange", MakeCallback (&AdaptiveObssPdLinkTest::LevelChange, this));
+  m_neighbor = nodes.Get (2)->GetId ();
+
+  //Peer links are up after a few beacons, and the paths are discovered
+  //one after the other.  Then both links are saturated, so that their
+  //frames overlap
+  const uint32_t links[2][2] = {{1, 0}, {2, 3}};
+  for (uint32_t link = 0; link < 2; link++)
+    {
+      Ptr<NetDevice> mp = devices.Get (links[link][0]);
+      Mac48Address dst = Mac48Address::ConvertFrom (devices.Get (links[link][1])->GetAddress ());
+      Simulator::Schedule (Seconds (5) + MilliSeconds (100 * link), &NetDevice::Send, mp, Create<Packet> (1000), dst, 0x0800);
+      for (uint32_t i = 0; i < 2000; i++)
+        {
+          Simulator::Schedule (Seconds (5.5) + MicroSeconds (250 * i), &NetDevice::Send, mp, Create<Packet> (1000), dst, 0x0800);
+        }
+    }
+  Simulator::Stop (Seconds (7));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_GT (m_changes, 0, "Level of the third mesh point learnt from the frames sent");
+  NS_TEST_EXPECT_MSG_LT (m_per, 1, "Frames acknowledged while the third mesh point is ignored");
+}
+
 /**
  * \ingroup mesh-test
  * \ingroup tests
@@ -287,6 +1286,15 @@ Dot11sTestSuite::Dot11sTestSuite ()
   AddTestCase (new MeshHeaderTest, TestCase::QUICK);
   AddTestCase (new HwmpRtableTest, TestCase::QUICK);
   AddTestCase (new PeerLinkFrameStartTest, TestCase::QUICK);
+  AddTestCase (new HwmpQueueTest, TestCase::QUICK);
+  AddTestCase (new AirtimeMetricCacheTest, TestCase::QUICK);
+  AddTestCase (new AirtimeMetricRateChangeTest, TestCase::QUICK);
+  AddTestCase (new HwmpBatchTest, TestCase::QUICK);
+  AddTestCase (new HwmpRootTest, TestCase::QUICK);
+  AddTestCase (new HwmpMultiChannelTest, TestCase::QUICK);
+  AddTestCase (new MeshBssColorTest, TestCase::QUICK);
+  AddTestCase (new AdaptiveObssPdTest, TestCase::QUICK);
+  AddTestCase (new AdaptiveObssPdLinkTest, TestCase::QUICK);
 }
 
 static Dot11sTestSuite g_dot11sTestSuite; ///< the test suite
@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Merges the shards written by SqliteShardDataOutput for a prefix into
+// "<prefix>.db", then lists the runs matching a set of parameters.
+//
+// Sample usage, after replicates were run with --resultsPrefix=out/mesh:
+//   ./waf --run 'sqlite-shard-compact --prefix=out/mesh --query=apNum=20,gateways=1'
+
+#include <iostream>
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/stats-module.h"
+#include "ns3/sqlite-shard-data-output.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string prefix = "data";
+  std::string query = "";
+  bool keepShards = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("prefix", "File prefix the shards were written with", prefix);
+  cmd.AddValue ("query", "Comma-separated key=value parameters to look up", query);
+  cmd.AddValue ("keepShards", "Do not delete the shards once merged", keepShards);
+  cmd.Parse (argc, argv);
+
+  Ptr<SqliteShardDataOutput> output = CreateObject<SqliteShardDataOutput> ();
+  output->SetFilePrefix (prefix);
+  uint32_t merged = output->Compact (!keepShards);
+  std::cout << "Merged " << merged << " shards into " << prefix << ".db" << std::endl;
+
+  MetadataList parameters;
+  std::istringstream iss (query);
+  std::string item;
+  while (std::getline (iss, item, ','))
+    {
+      std::string::size_type eq = item.find ('=');
+      if (eq == std::string::npos)
+        {
+          NS_FATAL_ERROR ("Malformed query item " << item);
+        }
+      parameters.push_back (std::make_pair (item.substr (0, eq), item.substr (eq + 1)));
+    }
+
+  std::vector<std::string> runs = output->FindRuns (parameters);
+  for (std::vector<std::string>::const_iterator i = runs.begin (); i != runs.end (); ++i)
+    {
+      std::cout << *i << std::endl;
+    }
+
+  return 0;
+}
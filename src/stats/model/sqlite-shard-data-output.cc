@@ -0,0 +1,255 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <list>
+
+#include <sqlite3.h>
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/system-path.h"
+
+#include "sqlite-shard-data-output.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SqliteShardDataOutput");
+
+/// Infix between the file prefix and the shard id
+static const std::string SHARD_INFIX = "-shard-";
+
+/**
+ * Execute a statement without result rows.
+ * \param db the database
+ * \param exe the statement
+ * \return sqlite return code.
+ */
+static int
+ExecStatement (sqlite3 *db, std::string exe)
+{
+  NS_LOG_INFO ("executing '" << exe << "'");
+  char *errMsg = 0;
+  int res = sqlite3_exec (db, exe.c_str (), NULL, NULL, &errMsg);
+  if (res != SQLITE_OK)
+    {
+      NS_LOG_ERROR ("sqlite3 error: \"" << errMsg << "\"");
+      sqlite3_free (errMsg);
+    }
+  return res;
+}
+
+//--------------------------------------------------------------
+//----------------------------------------------
+SqliteShardDataOutput::SqliteShardDataOutput()
+{
+  NS_LOG_FUNCTION (this);
+}
+SqliteShardDataOutput::~SqliteShardDataOutput()
+{
+  NS_LOG_FUNCTION (this);
+}
+/* static */
+TypeId
+SqliteShardDataOutput::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SqliteShardDataOutput")
+    .SetParent<SqliteDataOutput> ()
+    .SetGroupName ("Stats")
+    .AddConstructor<SqliteShardDataOutput> ()
+    .AddAttribute ("ShardId",
+                   "Identifier of the shard written by this process. "
+                   "The run label of the DataCollector is used if empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&SqliteShardDataOutput::m_shardId),
+                   MakeStringChecker ());
+  return tid;
+}
+
+std::string
+SqliteShardDataOutput::GetShardFileName (const DataCollector &dc) const
+{
+  std::string id = m_shardId.empty () ? dc.GetRunLabel () : m_shardId;
+  std::replace (id.begin (), id.end (), '/', '_');
+  return m_filePrefix + SHARD_INFIX + id + ".db";
+}
+
+//----------------------------------------------
+void
+SqliteShardDataOutput::Output (DataCollector &dc)
+{
+  NS_LOG_FUNCTION (this << &dc);
+
+  // SqliteDataOutput writes to "<prefix>.db"; point it at the shard.
+  std::string prefix = m_filePrefix;
+  std::string shard = GetShardFileName (dc);
+  m_filePrefix = shard.substr (0, shard.size () - 3);
+  SqliteDataOutput::Output (dc);
+  m_filePrefix = prefix;
+
+  // end SqliteShardDataOutput::Output
+}
+
+uint32_t
+SqliteShardDataOutput::Compact (bool removeShards)
+{
+  NS_LOG_FUNCTION (this << removeShards);
+
+  std::list<std::string> elements = SystemPath::Split (m_filePrefix);
+  std::string base = elements.back ();
+  elements.pop_back ();
+  std::string dir = elements.empty () ? "." : SystemPath::Join (elements.begin (), elements.end ());
+  if (dir.empty ())
+    {
+      dir = "/";
+    }
+
+  std::vector<std::string> shards;
+  std::list<std::string> files = SystemPath::ReadFiles (dir);
+  for (std::list<std::string>::const_iterator i = files.begin (); i != files.end (); ++i)
+    {
+      std::string name = *i;
+      if (name.size () > base.size () + SHARD_INFIX.size () + 3
+          && name.compare (0, base.size () + SHARD_INFIX.size (), base + SHARD_INFIX) == 0
+          && name.compare (name.size () - 3, 3, ".db") == 0)
+        {
+          shards.push_back (SystemPath::Append (dir, name));
+        }
+    }
+  std::sort (shards.begin (), shards.end ());
+
+  sqlite3 *db;
+  std::string dbFile = m_filePrefix + ".db";
+  if (sqlite3_open (dbFile.c_str (), &db))
+    {
+      NS_LOG_ERROR ("Could not open sqlite3 database \"" << dbFile << "\"");
+      NS_LOG_ERROR ("sqlite3 error \"" << sqlite3_errmsg (db) << "\"");
+      sqlite3_close (db);
+      return 0;
+    }
+
+  ExecStatement (db, "create table if not exists Experiments (run, experiment, strategy, input, description text)");
+  ExecStatement (db, "create table if not exists Metadata ( run text, key text, value)");
+  ExecStatement (db, "create table if not exists Singletons ( run text, name text, variable text, value )");
+  ExecStatement (db, "create index if not exists ExperimentsByRun on Experiments (run)");
+  ExecStatement (db, "create index if not exists MetadataByKey on Metadata (key, value, run)");
+  ExecStatement (db, "create index if not exists MetadataByRun on Metadata (run)");
+  ExecStatement (db, "create index if not exists SingletonsByRun on Singletons (run, name, variable)");
+
+  static const char *tables[] = { "Experiments", "Metadata", "Singletons" };
+  uint32_t merged = 0;
+  for (std::vector<std::string>::const_iterator i = shards.begin (); i != shards.end (); ++i)
+    {
+      sqlite3_stmt *stmt;
+      sqlite3_prepare_v2 (db, "attach database ? as shard", -1, &stmt, NULL);
+      sqlite3_bind_text (stmt, 1, i->c_str (), i->length (), SQLITE_TRANSIENT);
+      int res = sqlite3_step (stmt);
+      sqlite3_finalize (stmt);
+      if (res != SQLITE_DONE)
+        {
+          NS_LOG_ERROR ("Could not attach shard \"" << *i << "\": " << sqlite3_errmsg (db));
+          continue;
+        }
+
+      // A run written again replaces what was merged for it before.
+      bool ok = ExecStatement (db, "BEGIN") == SQLITE_OK;
+      for (uint32_t t = 0; ok && t < 3; ++t)
+        {
+          std::string table = tables[t];
+          sqlite3_prepare_v2 (db, "select count(*) from shard.sqlite_master where type = 'table' and name = ?",
+                              -1, &stmt, NULL);
+          sqlite3_bind_text (stmt, 1, table.c_str (), table.length (), SQLITE_TRANSIENT);
+          bool exists = sqlite3_step (stmt) == SQLITE_ROW && sqlite3_column_int (stmt, 0) > 0;
+          sqlite3_finalize (stmt);
+          if (!exists)
+            {
+              continue;
+            }
+          ok = ExecStatement (db, "delete from main." + table
+                              + " where run in (select run from shard." + table + ")") == SQLITE_OK
+            && ExecStatement (db, "insert into main." + table
+                              + " select * from shard." + table) == SQLITE_OK;
+        }
+      ok = ok && ExecStatement (db, "COMMIT") == SQLITE_OK;
+      if (!ok)
+        {
+          ExecStatement (db, "ROLLBACK");
+        }
+      ExecStatement (db, "detach database shard");
+
+      if (ok)
+        {
+          ++merged;
+          if (removeShards && std::remove (i->c_str ()) != 0)
+            {
+              NS_LOG_ERROR ("Could not remove shard \"" << *i << "\"");
+            }
+        }
+    }
+
+  sqlite3_close (db);
+  NS_LOG_INFO ("merged " << merged << " of " << shards.size () << " shards into " << dbFile);
+  return merged;
+
+  // end SqliteShardDataOutput::Compact
+}
+
+std::vector<std::string>
+SqliteShardDataOutput::FindRuns (const MetadataList &parameters) const
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<std::string> runs;
+  sqlite3 *db;
+  std::string dbFile = m_filePrefix + ".db";
+  if (sqlite3_open_v2 (dbFile.c_str (), &db, SQLITE_OPEN_READONLY, NULL))
+    {
+      NS_LOG_ERROR ("Could not open sqlite3 database \"" << dbFile << "\"");
+      sqlite3_close (db);
+      return runs;
+    }
+
+  std::string query = "select distinct run from Experiments";
+  for (uint32_t i = 0; i < parameters.size (); ++i)
+    {
+      query += " intersect select run from Metadata where key = ? and value = ?";
+    }
+  query += " order by run";
+
+  sqlite3_stmt *stmt;
+  if (sqlite3_prepare_v2 (db, query.c_str (), -1, &stmt, NULL) != SQLITE_OK)
+    {
+      NS_LOG_ERROR ("sqlite3 error \"" << sqlite3_errmsg (db) << "\"");
+      sqlite3_close (db);
+      return runs;
+    }
+  int index = 1;
+  for (MetadataList::const_iterator i = parameters.begin (); i != parameters.end (); ++i)
+    {
+      sqlite3_bind_text (stmt, index++, i->first.c_str (), i->first.length (), SQLITE_TRANSIENT);
+      sqlite3_bind_text (stmt, index++, i->second.c_str (), i->second.length (), SQLITE_TRANSIENT);
+    }
+  while (sqlite3_step (stmt) == SQLITE_ROW)
+    {
+      runs.push_back (reinterpret_cast<const char *> (sqlite3_column_text (stmt, 0)));
+    }
+  sqlite3_finalize (stmt);
+  sqlite3_close (db);
+  return runs;
+
+  // end SqliteShardDataOutput::FindRuns
+}
@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "time-bin-aggregator.h"
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimeBinAggregator");
+
+NS_OBJECT_ENSURE_REGISTERED (TimeBinAggregator);
+
+TypeId
+TimeBinAggregator::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::TimeBinAggregator")
+    .SetParent<DataCollectionObject> ()
+    .SetGroupName ("Stats")
+    .AddAttribute ("Interval",
+                   "The length of a window. Must not be changed once samples "
+                   "have been added.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&TimeBinAggregator::m_interval),
+                   MakeTimeChecker (TimeStep (1)))
+    .AddAttribute ("StartTime",
+                   "The start of the first window. Earlier samples are ignored.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&TimeBinAggregator::m_startTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("Scale",
+                   "The factor applied to the window sums when they are written, "
+                   "e.g. 8e-6 / Interval to convert bytes to Mbit/s.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&TimeBinAggregator::m_scale),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("BufferRows",
+                   "The number of completed rows kept in memory before they "
+                   "are written to the output stream.",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&TimeBinAggregator::m_bufferRows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("WriteLastWindow",
+                   "Whether Flush also writes the window ending at the current "
+                   "simulation time, which a periodic poller stopped at that "
+                   "time does not print.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TimeBinAggregator::m_writeLastWindow),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+TimeBinAggregator::TimeBinAggregator (const std::string &outputFileName)
+  : m_os (&m_file),
+    m_started (false),
+    m_hasHeadingBeenSet (false),
+    m_pendingRows (0)
+{
+  NS_LOG_FUNCTION (this << outputFileName);
+  m_file.open (outputFileName.c_str ());
+}
+
+TimeBinAggregator::TimeBinAggregator (std::ostream *os)
+  : m_os (os),
+    m_started (false),
+    m_hasHeadingBeenSet (false),
+    m_pendingRows (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TimeBinAggregator::~TimeBinAggregator ()
+{
+  NS_LOG_FUNCTION (this);
+  WriteRows ();
+  m_os->flush ();
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+}
+
+void
+TimeBinAggregator::SetHeading (const std::string &heading)
+{
+  NS_LOG_FUNCTION (this << heading);
+  if (!m_hasHeadingBeenSet)
+    {
+      m_hasHeadingBeenSet = true;
+      m_buffer << heading << '\n';
+    }
+}
+
+uint32_t
+TimeBinAggregator::AddColumn (const std::string &context)
+{
+  NS_LOG_FUNCTION (this << context);
+  NS_ABORT_MSG_IF (m_columns.find (context) != m_columns.end (),
+                   "Column " << context << " already exists");
+  uint32_t column = m_sums.size ();
+  m_columns[context] = column;
+  m_sums.push_back (0.0);
+  m_constant.push_back (false);
+  return column;
+}
+
+uint32_t
+TimeBinAggregator::AddConstantColumn (const std::string &context, double value)
+{
+  NS_LOG_FUNCTION (this << context << value);
+  uint32_t column = AddColumn (context);
+  m_sums[column] = value;
+  m_constant[column] = true;
+  return column;
+}
+
+uint32_t
+TimeBinAggregator::GetNColumns (void) const
+{
+  return m_sums.size ();
+}
+
+void
+TimeBinAggregator::Add (uint32_t column, double value)
+{
+  NS_LOG_FUNCTION (this << column << value);
+  DoAdd (column, Simulator::Now (), value);
+}
+
+void
+TimeBinAggregator::Write2d (std::string context, double time, double value)
+{
+  NS_LOG_FUNCTION (this << context << time << value);
+  std::map<std::string, uint32_t>::const_iterator it = m_columns.find (context);
+  uint32_t column = (it == m_columns.end ()) ? AddColumn (context) : it->second;
+  DoAdd (column, Seconds (time), value);
+}
+
+void
+TimeBinAggregator::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_enabled)
+    {
+      Time now = Simulator::Now ();
+      AdvanceTo (m_writeLastWindow ? now : now - TimeStep (1));
+    }
+  WriteRows ();
+  m_os->flush ();
+}
+
+void
+TimeBinAggregator::DoAdd (uint32_t column, Time time, double value)
+{
+  NS_ASSERT (column < m_sums.size ());
+  NS_ASSERT_MSG (!m_constant[column], "Cannot add samples to a constant column");
+  if (!m_enabled || time < m_startTime)
+    {
+      return;
+    }
+  if (!m_started || time >= m_windowEnd)
+    {
+      AdvanceTo (time);
+    }
+  m_sums[column] += value;
+}
+
+void
+TimeBinAggregator::AdvanceTo (Time time)
+{
+  if (!m_started)
+    {
+      if (time < m_startTime)
+        {
+          return;
+        }
+      m_started = true;
+      m_windowEnd = m_startTime + m_interval;
+    }
+  while (m_windowEnd <= time)
+    {
+      CloseWindow ();
+    }
+}
+
+void
+TimeBinAggregator::CloseWindow (void)
+{
+  NS_LOG_FUNCTION (this << m_windowEnd);
+  m_buffer.flags (m_os->flags ());
+  m_buffer.precision (m_os->precision ());
+  m_buffer << m_windowEnd.GetSeconds ();
+  for (uint32_t i = 0; i < m_sums.size (); ++i)
+    {
+      if (m_constant[i])
+        {
+          m_buffer << '\t' << m_sums[i];
+        }
+      else
+        {
+          m_buffer << '\t' << m_sums[i] * m_scale;
+          m_sums[i] = 0.0;
+        }
+    }
+  m_buffer << '\n';
+  m_windowEnd += m_interval;
+  if (++m_pendingRows >= m_bufferRows)
+    {
+      WriteRows ();
+    }
+}
+
+void
+TimeBinAggregator::WriteRows (void)
+{
+  *m_os << m_buffer.str ();
+  m_buffer.str ("");
+  m_pendingRows = 0;
+}
+
+} // namespace ns3
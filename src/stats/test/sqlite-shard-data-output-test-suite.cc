@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/basic-data-calculators.h"
+#include "ns3/data-collector.h"
+#include "ns3/sqlite-shard-data-output.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Runs written to separate shards are merged into one database and can
+// be selected by their metadata.
+// ===========================================================================
+
+class SqliteShardDataOutputTestCase : public TestCase
+{
+public:
+  SqliteShardDataOutputTestCase ();
+  virtual ~SqliteShardDataOutputTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write one run to its shard.
+   * \param prefix the file prefix
+   * \param run the run label
+   * \param apNum the value of the apNum parameter
+   * \param seed the value of the seed parameter
+   */
+  void WriteRun (std::string prefix, std::string run, uint32_t apNum, uint32_t seed);
+};
+
+SqliteShardDataOutputTestCase::SqliteShardDataOutputTestCase ()
+  : TestCase ("Check shard compaction and run lookup of SqliteShardDataOutput")
+{
+}
+
+SqliteShardDataOutputTestCase::~SqliteShardDataOutputTestCase ()
+{
+}
+
+void
+SqliteShardDataOutputTestCase::WriteRun (std::string prefix, std::string run, uint32_t apNum, uint32_t seed)
+{
+  DataCollector data;
+  data.DescribeRun ("mesh", "udp", "location_400_0", run);
+  data.AddMetadata ("apNum", apNum);
+  data.AddMetadata ("seed", seed);
+
+  Ptr<CounterCalculator<> > rx = CreateObject<CounterCalculator<> > ();
+  rx->SetKey ("cl-0");
+  rx->SetContext ("rx-packets");
+  rx->Update (seed);
+  data.AddDataCalculator (rx);
+
+  Ptr<SqliteShardDataOutput> output = CreateObject<SqliteShardDataOutput> ();
+  output->SetFilePrefix (prefix);
+  output->Output (data);
+  std::ifstream shard (output->GetShardFileName (data).c_str ());
+  NS_TEST_ASSERT_MSG_EQ (shard.good (), true, "Shard " << output->GetShardFileName (data) << " not written");
+  data.Dispose ();
+}
+
+void
+SqliteShardDataOutputTestCase::DoRun (void)
+{
+  std::string prefix = CreateTempDirFilename ("results");
+
+  WriteRun (prefix, "run-1", 10, 1);
+  WriteRun (prefix, "run-2", 10, 2);
+  WriteRun (prefix, "run-3", 20, 1);
+
+  Ptr<SqliteShardDataOutput> output = CreateObject<SqliteShardDataOutput> ();
+  output->SetFilePrefix (prefix);
+  NS_TEST_ASSERT_MSG_EQ (output->Compact (), 3, "All shards should have been merged");
+  NS_TEST_ASSERT_MSG_EQ (output->Compact (), 0, "Merged shards should have been removed");
+
+  MetadataList parameters;
+  NS_TEST_ASSERT_MSG_EQ (output->FindRuns (parameters).size (), 3, "Wrong number of runs");
+
+  parameters.push_back (std::make_pair ("apNum", "10"));
+  std::vector<std::string> runs = output->FindRuns (parameters);
+  NS_TEST_ASSERT_MSG_EQ (runs.size (), 2, "Wrong number of runs with apNum=10");
+  NS_TEST_ASSERT_MSG_EQ (runs[0], "run-1", "Wrong run with apNum=10");
+  NS_TEST_ASSERT_MSG_EQ (runs[1], "run-2", "Wrong run with apNum=10");
+
+  parameters.push_back (std::make_pair ("seed", "2"));
+  runs = output->FindRuns (parameters);
+  NS_TEST_ASSERT_MSG_EQ (runs.size (), 1, "Wrong number of runs with apNum=10 and seed=2");
+  NS_TEST_ASSERT_MSG_EQ (runs[0], "run-2", "Wrong run with apNum=10 and seed=2");
+
+  // Writing a run again replaces it instead of duplicating it.
+  WriteRun (prefix, "run-2", 20, 2);
+  NS_TEST_ASSERT_MSG_EQ (output->Compact (), 1, "The new shard should have been merged");
+  NS_TEST_ASSERT_MSG_EQ (output->FindRuns (parameters).size (), 0, "run-2 should have been replaced");
+  parameters.pop_front ();
+  parameters.push_front (std::make_pair ("apNum", "20"));
+  NS_TEST_ASSERT_MSG_EQ (output->FindRuns (parameters).size (), 1, "run-2 should have apNum=20");
+}
+
+
+class SqliteShardDataOutputTestSuite : public TestSuite
+{
+public:
+  SqliteShardDataOutputTestSuite ();
+};
+
+SqliteShardDataOutputTestSuite::SqliteShardDataOutputTestSuite ()
+  : TestSuite ("sqlite-shard-data-output", UNIT)
+{
+  AddTestCase (new SqliteShardDataOutputTestCase, TestCase::QUICK);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static SqliteShardDataOutputTestSuite sqliteShardDataOutputTestSuite;
@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/time-bin-aggregator.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Samples fed with Add are summed per window and written as one row
+// per window, empty windows included.
+// ===========================================================================
+
+class TimeBinAggregatorTestCase : public TestCase
+{
+public:
+  TimeBinAggregatorTestCase ();
+  virtual ~TimeBinAggregatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TimeBinAggregatorTestCase::TimeBinAggregatorTestCase ()
+  : TestCase ("Check windowed sums written by TimeBinAggregator")
+{
+}
+
+TimeBinAggregatorTestCase::~TimeBinAggregatorTestCase ()
+{
+}
+
+void
+TimeBinAggregatorTestCase::DoRun (void)
+{
+  std::ostringstream os;
+  Ptr<TimeBinAggregator> aggregator = CreateObject<TimeBinAggregator> (&os);
+  aggregator->SetAttribute ("Interval", TimeValue (Seconds (1)));
+  aggregator->SetAttribute ("StartTime", TimeValue (Seconds (1)));
+  aggregator->SetAttribute ("Scale", DoubleValue (2));
+  aggregator->SetHeading ("Time[s]\ta\tb\tc");
+  uint32_t a = aggregator->AddColumn ("a");
+  uint32_t b = aggregator->AddColumn ("b");
+  aggregator->AddConstantColumn ("c", -1);
+  NS_TEST_ASSERT_MSG_EQ (aggregator->GetNColumns (), 3, "Unexpected number of columns");
+
+  // Before the start time: ignored.
+  Simulator::Schedule (Seconds (0.5), &TimeBinAggregator::Add, aggregator, a, 100.0);
+  // First window [1, 2).
+  Simulator::Schedule (Seconds (1.0), &TimeBinAggregator::Add, aggregator, a, 1.0);
+  Simulator::Schedule (Seconds (1.5), &TimeBinAggregator::Add, aggregator, a, 2.0);
+  Simulator::Schedule (Seconds (1.7), &TimeBinAggregator::Add, aggregator, b, 3.0);
+  // Window [2, 3) stays empty, window [3, 4) gets one sample.
+  Simulator::Schedule (Seconds (3.2), &TimeBinAggregator::Add, aggregator, b, 4.0);
+  // Window [4, 5) is still open when the simulation stops.
+  Simulator::Schedule (Seconds (4.9), &TimeBinAggregator::Add, aggregator, a, 5.0);
+  Simulator::Stop (Seconds (4.5));
+  Simulator::Run ();
+
+  aggregator->Flush ();
+  NS_TEST_ASSERT_MSG_EQ (os.str (),
+                         "Time[s]\ta\tb\tc\n"
+                         "2\t6\t6\t-1\n"
+                         "3\t0\t0\t-1\n"
+                         "4\t0\t8\t-1\n",
+                         "Unexpected aggregator output");
+
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// Write2d creates columns from the context and uses the sample time
+// rather than the current simulation time.
+// ===========================================================================
+
+class TimeBinAggregatorWrite2dTestCase : public TestCase
+{
+public:
+  TimeBinAggregatorWrite2dTestCase ();
+  virtual ~TimeBinAggregatorWrite2dTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TimeBinAggregatorWrite2dTestCase::TimeBinAggregatorWrite2dTestCase ()
+  : TestCase ("Check TimeBinAggregator fed through Write2d")
+{
+}
+
+TimeBinAggregatorWrite2dTestCase::~TimeBinAggregatorWrite2dTestCase ()
+{
+}
+
+void
+TimeBinAggregatorWrite2dTestCase::DoRun (void)
+{
+  std::ostringstream os;
+  Ptr<TimeBinAggregator> aggregator = CreateObject<TimeBinAggregator> (&os);
+  aggregator->SetAttribute ("Interval", TimeValue (MilliSeconds (500)));
+  aggregator->SetAttribute ("BufferRows", UintegerValue (1));
+
+  aggregator->Write2d ("x", 0.1, 1);
+  aggregator->Write2d ("y", 0.2, 2);
+  aggregator->Write2d ("x", 0.4, 3);
+  NS_TEST_ASSERT_MSG_EQ (os.str (), "", "No window should be complete yet");
+
+  aggregator->Write2d ("y", 0.6, 4);
+  NS_TEST_ASSERT_MSG_EQ (os.str (), "0.5\t4\t2\n",
+                         "First window should be written as soon as it is complete");
+
+  aggregator->Disable ();
+  aggregator->Write2d ("y", 0.7, 100);
+  aggregator->Enable ();
+  aggregator->Write2d ("x", 1.2, 5);
+  NS_TEST_ASSERT_MSG_EQ (os.str (), "0.5\t4\t2\n1\t0\t4\n",
+                         "Samples received while disabled should be ignored");
+
+  Simulator::Destroy ();
+}
+
+// ===========================================================================
+// Flush does not write the window ending at the stop time, as a
+// periodic poller stopped at that time would not, unless
+// WriteLastWindow is set.
+// ===========================================================================
+
+class TimeBinAggregatorLastWindowTestCase : public TestCase
+{
+public:
+  TimeBinAggregatorLastWindowTestCase ();
+  virtual ~TimeBinAggregatorLastWindowTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TimeBinAggregatorLastWindowTestCase::TimeBinAggregatorLastWindowTestCase ()
+  : TestCase ("Check the last window written by TimeBinAggregator::Flush")
+{
+}
+
+TimeBinAggregatorLastWindowTestCase::~TimeBinAggregatorLastWindowTestCase ()
+{
+}
+
+void
+TimeBinAggregatorLastWindowTestCase::DoRun (void)
+{
+  std::ostringstream os;
+  Ptr<TimeBinAggregator> aggregator = CreateObject<TimeBinAggregator> (&os);
+  aggregator->SetAttribute ("Interval", TimeValue (Seconds (1)));
+  uint32_t a = aggregator->AddColumn ("a");
+
+  Simulator::Schedule (Seconds (0.5), &TimeBinAggregator::Add, aggregator, a, 1.0);
+  Simulator::Schedule (Seconds (1.5), &TimeBinAggregator::Add, aggregator, a, 2.0);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+
+  aggregator->Flush ();
+  NS_TEST_ASSERT_MSG_EQ (os.str (), "1\t1\n", "The window ending at the stop time should not be written");
+
+  aggregator->SetAttribute ("WriteLastWindow", BooleanValue (true));
+  aggregator->Flush ();
+  NS_TEST_ASSERT_MSG_EQ (os.str (), "1\t1\n2\t2\n", "The window ending at the stop time should be written");
+
+  Simulator::Destroy ();
+}
+
+
+class TimeBinAggregatorTestSuite : public TestSuite
+{
+public:
+  TimeBinAggregatorTestSuite ();
+};
+
+TimeBinAggregatorTestSuite::TimeBinAggregatorTestSuite ()
+  : TestSuite ("time-bin-aggregator", UNIT)
+{
+  AddTestCase (new TimeBinAggregatorTestCase, TestCase::QUICK);
+  AddTestCase (new TimeBinAggregatorWrite2dTestCase, TestCase::QUICK);
+  AddTestCase (new TimeBinAggregatorLastWindowTestCase, TestCase::QUICK);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static TimeBinAggregatorTestSuite timeBinAggregatorTestSuite;
@@ -24,6 +24,7 @@
 #include "ns3/inet-topology-reader.h"
 #include "ns3/orbis-topology-reader.h"
 #include "ns3/rocketfuel-topology-reader.h"
+#include "ns3/binary-topology-reader.h"
 #include "ns3/log.h"
 
 namespace ns3 {
@@ -71,6 +72,11 @@ TopologyReaderHelper::GetTopologyReader ()
           NS_LOG_INFO ("Creating Rocketfuel formatted data input.");
           m_inputModel = CreateObject<RocketfuelTopologyReader> ();
         }
+      else if (m_fileType == "Binary")
+        {
+          NS_LOG_INFO ("Creating Binary formatted data input.");
+          m_inputModel = CreateObject<BinaryTopologyReader> ();
+        }
       else
         {
           NS_ASSERT_MSG (false, "Wrong (unknown) File Type");
@@ -0,0 +1,526 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ns3/log.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/mobility-model.h"
+
+#include "binary-topology-reader.h"
+#include "inet-topology-reader.h"
+#include "orbis-topology-reader.h"
+#include "rocketfuel-topology-reader.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTopologyReader");
+
+NS_OBJECT_ENSURE_REGISTERED (BinaryTopologyReader);
+
+namespace {
+
+/// Magic string at the start of the files
+const char MAGIC[8] = "NS3TOPO";
+/// Version of the file format
+const uint32_t VERSION = 1;
+/// The file has node positions
+const uint32_t HAS_POSITIONS = 1;
+/// The file has link weights
+const uint32_t HAS_WEIGHTS = 2;
+
+/// Header of the files
+struct FileHeader
+{
+  char magic[8];      //!< MAGIC
+  uint32_t version;   //!< VERSION
+  uint32_t flags;     //!< HAS_POSITIONS and HAS_WEIGHTS
+  uint32_t nNodes;    //!< Number of nodes
+  uint32_t nLinks;    //!< Number of links
+  uint64_t sourceSize; //!< Size of the text file the file caches, or zero
+};
+
+/**
+ * \param a The status of a file.
+ * \param b The status of another file.
+ * \return True if the first file was not modified before the second one,
+ * with the nanosecond resolution of the file system.
+ */
+bool
+IsNotOlder (const struct stat &a, const struct stat &b)
+{
+  if (a.st_mtim.tv_sec != b.st_mtim.tv_sec)
+    {
+      return a.st_mtim.tv_sec > b.st_mtim.tv_sec;
+    }
+  return a.st_mtim.tv_nsec >= b.st_mtim.tv_nsec;
+}
+
+} // unnamed namespace
+
+TypeId BinaryTopologyReader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BinaryTopologyReader")
+    .SetParent<TopologyReader> ()
+    .SetGroupName ("TopologyReader")
+    .AddConstructor<BinaryTopologyReader> ()
+  ;
+  return tid;
+}
+
+BinaryTopologyReader::BinaryTopologyReader ()
+  : m_map (0),
+    m_mapSize (0),
+    m_mapDevice (0),
+    m_mapInode (0),
+    m_nNodes (0),
+    m_nLinks (0),
+    m_positions (0),
+    m_links (0),
+    m_weights (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTopologyReader::~BinaryTopologyReader ()
+{
+  NS_LOG_FUNCTION (this);
+  Unmap ();
+}
+
+void
+BinaryTopologyReader::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Unmap ();
+  TopologyReader::DoDispose ();
+}
+
+void
+BinaryTopologyReader::SetSourceFile (const std::string &fileName, const std::string &fileType)
+{
+  NS_LOG_FUNCTION (this << fileName << fileType);
+  NS_ASSERT_MSG (fileType == "Location" || fileType == "Inet"
+                 || fileType == "Orbis" || fileType == "Rocketfuel",
+                 "Wrong (unknown) source file type " << fileType);
+  m_sourceFileName = fileName;
+  m_sourceFileType = fileType;
+  if (GetFileName ().empty ())
+    {
+      SetFileName (fileName + ".bin");
+    }
+}
+
+bool
+BinaryTopologyReader::IsCacheValid (void) const
+{
+  struct stat cache;
+  if (stat (GetFileName ().c_str (), &cache) != 0)
+    {
+      return false;
+    }
+  if (m_sourceFileName.empty ())
+    {
+      return true;
+    }
+  struct stat source;
+  if (stat (m_sourceFileName.c_str (), &source) != 0)
+    {
+      // Only the cache is left; use it.
+      return true;
+    }
+  if (!IsNotOlder (cache, source))
+    {
+      return false;
+    }
+  // A text file rewritten within the timestamp resolution of the file
+  // system still differs in size most of the time.
+  FileHeader header;
+  std::ifstream in (GetFileName ().c_str (), std::ios::binary);
+  if (!in.read (reinterpret_cast<char *> (&header), sizeof (header)))
+    {
+      return false;
+    }
+  return header.sourceSize == uint64_t (source.st_size);
+}
+
+uint64_t
+BinaryTopologyReader::GetSourceSize (void) const
+{
+  struct stat source;
+  if (stat (m_sourceFileName.c_str (), &source) != 0)
+    {
+      return 0;
+    }
+  return source.st_size;
+}
+
+bool
+BinaryTopologyReader::ConvertLocations (void) const
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t sourceSize = GetSourceSize ();
+  std::ifstream fin (m_sourceFileName.c_str ());
+  if (!fin.is_open ())
+    {
+      NS_LOG_WARN ("Location file " << m_sourceFileName << " cannot be opened");
+      return false;
+    }
+
+  // One node per line; extra columns are ignored.
+  std::vector<Vector> positions;
+  std::string line;
+  while (std::getline (fin, line))
+    {
+      std::istringstream lineBuffer (line);
+      Vector position;
+      if (lineBuffer >> position.x >> position.y >> position.z)
+        {
+          positions.push_back (position);
+        }
+      else if (line.find_first_not_of (" \t\r") != std::string::npos)
+        {
+          NS_LOG_WARN ("Skipping malformed line \"" << line << "\" of " << m_sourceFileName);
+        }
+    }
+  NS_LOG_INFO ("Converted " << positions.size () << " locations of " << m_sourceFileName);
+  return WriteFile (GetFileName (), positions.size (), positions,
+                    std::vector<std::pair<uint32_t, uint32_t> > (), std::vector<double> (), sourceSize);
+}
+
+NodeContainer
+BinaryTopologyReader::ConvertGraph (void)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<TopologyReader> reader;
+  if (m_sourceFileType == "Inet")
+    {
+      reader = CreateObject<InetTopologyReader> ();
+    }
+  else if (m_sourceFileType == "Orbis")
+    {
+      reader = CreateObject<OrbisTopologyReader> ();
+    }
+  else
+    {
+      reader = CreateObject<RocketfuelTopologyReader> ();
+    }
+  reader->SetFileName (m_sourceFileName);
+  uint64_t sourceSize = GetSourceSize ();
+  NodeContainer nodes = reader->Read ();
+  if (nodes.GetN () == 0)
+    {
+      return nodes;
+    }
+
+  std::map<Ptr<Node>, uint32_t> index;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      index[nodes.Get (i)] = i;
+    }
+  std::vector<std::pair<uint32_t, uint32_t> > links;
+  std::vector<double> weights;
+  bool hasWeights = true;
+  for (ConstLinksIterator i = reader->LinksBegin (); i != reader->LinksEnd (); ++i)
+    {
+      links.push_back (std::make_pair (index[i->GetFromNode ()], index[i->GetToNode ()]));
+      AddLink (*i);
+      std::string weight;
+      if (hasWeights && i->GetAttributeFailSafe ("Weight", weight))
+        {
+          weights.push_back (std::atof (weight.c_str ()));
+        }
+      else
+        {
+          hasWeights = false;
+        }
+    }
+  if (!hasWeights)
+    {
+      weights.clear ();
+    }
+  WriteFile (GetFileName (), nodes.GetN (), std::vector<Vector> (), links, weights, sourceSize);
+  return nodes;
+}
+
+bool
+BinaryTopologyReader::Map (void)
+{
+  NS_LOG_FUNCTION (this);
+  Unmap ();
+  int fd = open (GetFileName ().c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Binary topology file " << GetFileName () << " cannot be opened");
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || st.st_size < (off_t) sizeof (FileHeader))
+    {
+      NS_LOG_WARN ("Binary topology file " << GetFileName () << " is truncated");
+      close (fd);
+      return false;
+    }
+  void *map = mmap (0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Binary topology file " << GetFileName () << " cannot be mapped");
+      return false;
+    }
+  m_map = static_cast<uint8_t *> (map);
+  m_mapSize = st.st_size;
+  m_mapDevice = st.st_dev;
+  m_mapInode = st.st_ino;
+
+  FileHeader header;
+  std::memcpy (&header, m_map, sizeof (header));
+  uint64_t size = sizeof (FileHeader) + uint64_t (header.nLinks) * 2 * sizeof (uint32_t);
+  if (header.flags & HAS_POSITIONS)
+    {
+      size += uint64_t (header.nNodes) * 3 * sizeof (double);
+    }
+  if (header.flags & HAS_WEIGHTS)
+    {
+      size += uint64_t (header.nLinks) * sizeof (double);
+    }
+  if (std::memcmp (header.magic, MAGIC, sizeof (MAGIC)) != 0
+      || header.version != VERSION || size > m_mapSize)
+    {
+      NS_LOG_WARN ("Binary topology file " << GetFileName () << " is not valid");
+      Unmap ();
+      return false;
+    }
+
+  // Positions come first so that the doubles stay aligned.
+  const uint8_t *p = m_map + sizeof (FileHeader);
+  m_nNodes = header.nNodes;
+  m_nLinks = header.nLinks;
+  if (header.flags & HAS_POSITIONS)
+    {
+      m_positions = reinterpret_cast<const double *> (p);
+      p += m_nNodes * 3 * sizeof (double);
+    }
+  if (header.flags & HAS_WEIGHTS)
+    {
+      m_weights = reinterpret_cast<const double *> (p);
+      p += m_nLinks * sizeof (double);
+    }
+  m_links = reinterpret_cast<const uint32_t *> (p);
+  NS_LOG_INFO ("Mapped " << m_nNodes << " nodes and " << m_nLinks << " links of " << GetFileName ());
+  return true;
+}
+
+void
+BinaryTopologyReader::Unmap (void)
+{
+  if (m_map)
+    {
+      munmap (m_map, m_mapSize);
+    }
+  m_map = 0;
+  m_mapSize = 0;
+  m_mapDevice = 0;
+  m_mapInode = 0;
+  m_nNodes = 0;
+  m_nLinks = 0;
+  m_positions = 0;
+  m_links = 0;
+  m_weights = 0;
+}
+
+bool
+BinaryTopologyReader::Load (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsCacheValid ())
+    {
+      if (m_sourceFileType != "Location")
+        {
+          NS_LOG_WARN ("Graph topologies are converted by Read");
+          return false;
+        }
+      if (!ConvertLocations ())
+        {
+          Unmap ();
+          return false;
+        }
+    }
+  // Keep the mapping only if the cache was not replaced since.
+  struct stat st;
+  if (m_map && stat (GetFileName ().c_str (), &st) == 0
+      && st.st_dev == m_mapDevice && st.st_ino == m_mapInode)
+    {
+      return true;
+    }
+  return Map ();
+}
+
+NodeContainer
+BinaryTopologyReader::Read (void)
+{
+  NS_LOG_FUNCTION (this);
+  NodeContainer nodes;
+  if (!m_sourceFileName.empty () && m_sourceFileType != "Location" && !IsCacheValid ())
+    {
+      Unmap ();
+      nodes = ConvertGraph ();
+      if (IsCacheValid ())
+        {
+          Map ();
+        }
+      return nodes;
+    }
+  if (!Load ())
+    {
+      return nodes;
+    }
+
+  nodes.Create (m_nNodes);
+  for (uint32_t i = 0; i < m_nLinks; ++i)
+    {
+      uint32_t from = m_links[2 * i];
+      uint32_t to = m_links[2 * i + 1];
+      if (from >= m_nNodes || to >= m_nNodes)
+        {
+          NS_LOG_WARN ("Skipping link " << i << " to a missing node");
+          continue;
+        }
+      std::ostringstream fromName;
+      std::ostringstream toName;
+      fromName << from;
+      toName << to;
+      Link link (nodes.Get (from), fromName.str (), nodes.Get (to), toName.str ());
+      if (m_weights)
+        {
+          std::ostringstream weight;
+          weight << m_weights[i];
+          link.SetAttribute ("Weight", weight.str ());
+        }
+      AddLink (link);
+    }
+  NS_LOG_INFO ("Binary topology created with " << m_nNodes << " nodes and " << LinksSize () << " links");
+  return nodes;
+}
+
+uint32_t
+BinaryTopologyReader::GetNNodes (void) const
+{
+  return m_nNodes;
+}
+
+bool
+BinaryTopologyReader::HasPositions (void) const
+{
+  return m_positions != 0;
+}
+
+Vector
+BinaryTopologyReader::GetPosition (uint32_t i) const
+{
+  NS_ASSERT_MSG (m_positions != 0, "The topology has no positions");
+  NS_ASSERT (i < m_nNodes);
+  return Vector (m_positions[3 * i], m_positions[3 * i + 1], m_positions[3 * i + 2]);
+}
+
+void
+BinaryTopologyReader::InstallPositions (NodeContainer nodes, Vector scale) const
+{
+  NS_LOG_FUNCTION (this << nodes.GetN () << scale);
+  NS_ASSERT_MSG (nodes.GetN () <= m_nNodes, "Not enough positions for " << nodes.GetN () << " nodes");
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Vector position = GetPosition (i);
+      position.x *= scale.x;
+      position.y *= scale.y;
+      position.z *= scale.z;
+      Ptr<Node> node = nodes.Get (i);
+      Ptr<MobilityModel> mobility = node->GetObject<MobilityModel> ();
+      if (mobility == 0)
+        {
+          mobility = CreateObject<ConstantPositionMobilityModel> ();
+          node->AggregateObject (mobility);
+        }
+      mobility->SetPosition (position);
+    }
+}
+
+bool
+BinaryTopologyReader::WriteFile (const std::string &fileName, uint32_t nNodes,
+                                 const std::vector<Vector> &positions,
+                                 const std::vector<std::pair<uint32_t, uint32_t> > &links,
+                                 const std::vector<double> &weights,
+                                 uint64_t sourceSize)
+{
+  NS_LOG_FUNCTION (fileName << nNodes << links.size ());
+  NS_ASSERT (positions.empty () || positions.size () == nNodes);
+  NS_ASSERT (weights.empty () || weights.size () == links.size ());
+
+  FileHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.magic, MAGIC, sizeof (MAGIC));
+  header.version = VERSION;
+  header.flags = (positions.empty () ? 0 : HAS_POSITIONS) | (weights.empty () ? 0 : HAS_WEIGHTS);
+  header.nNodes = nNodes;
+  header.nLinks = links.size ();
+  header.sourceSize = sourceSize;
+
+  // Write to a temporary file first, so that processes started
+  // concurrently never map a partial file.
+  std::ostringstream tmpName;
+  tmpName << fileName << ".tmp." << getpid ();
+  std::ofstream out (tmpName.str ().c_str (), std::ios::binary | std::ios::trunc);
+  if (!out.is_open ())
+    {
+      NS_LOG_WARN ("Binary topology file " << tmpName.str () << " cannot be written");
+      return false;
+    }
+  out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  for (std::vector<Vector>::const_iterator i = positions.begin (); i != positions.end (); ++i)
+    {
+      double xyz[3] = { i->x, i->y, i->z };
+      out.write (reinterpret_cast<const char *> (xyz), sizeof (xyz));
+    }
+  if (!weights.empty ())
+    {
+      out.write (reinterpret_cast<const char *> (&weights[0]), weights.size () * sizeof (double));
+    }
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i = links.begin (); i != links.end (); ++i)
+    {
+      uint32_t ends[2] = { i->first, i->second };
+      out.write (reinterpret_cast<const char *> (ends), sizeof (ends));
+    }
+  out.close ();
+  if (!out || std::rename (tmpName.str ().c_str (), fileName.c_str ()) != 0)
+    {
+      NS_LOG_WARN ("Binary topology file " << fileName << " cannot be written");
+      std::remove (tmpName.str ().c_str ());
+      return false;
+    }
+  return true;
+}
+
+} /* namespace ns3 */
@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TOPOLOGY_READER_H
+#define BINARY_TOPOLOGY_READER_H
+
+#include <vector>
+
+#include <sys/types.h>
+
+#include "ns3/node-container.h"
+#include "ns3/vector.h"
+#include "topology-reader.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup topology
+ *
+ * \brief Topology reader for a compact, memory-mapped binary format.
+ *
+ * The binary file holds a fixed 32-byte header, followed by an
+ * optional array of node positions (three doubles per node), by an
+ * optional array of link weights (one double per link) and by the
+ * links as pairs of 32-bit node indices.  All values are in host byte
+ * order.  The file is mapped read-only, so replicate processes
+ * loading the same topology share its pages.
+ *
+ * The binary file can be used directly (SetFileName) or as a cache
+ * of a text file (SetSourceFile).  In the latter case, the text file
+ * is parsed and the cache written only if the cache is missing, older
+ * than the text file, or made from a text file of another size.  The supported text formats are the
+ * location files of our scenarios ("Location": one node per line,
+ * the first three columns being x, y and z) and the formats of the
+ * other topology readers ("Inet", "Orbis" and "Rocketfuel").
+ *
+ * Nodes are named after their index in the file, and links carry a
+ * "Weight" attribute if the source had one.  When a graph cache is
+ * (re)built, the nodes and links are those of the text reader.
+ */
+class BinaryTopologyReader : public TopologyReader
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  BinaryTopologyReader ();
+  virtual ~BinaryTopologyReader ();
+
+  /**
+   * \brief Uses the binary file as a cache of a text file.
+   *
+   * The cache is named after the text file with a ".bin" suffix,
+   * unless a file name was set with SetFileName.
+   *
+   * \param [in] fileName The text file name.
+   * \param [in] fileType The text file type ("Location", "Inet",
+   *             "Orbis" or "Rocketfuel").
+   */
+  void SetSourceFile (const std::string &fileName, const std::string &fileType);
+
+  /**
+   * \brief Maps the binary file, converting the source file first if
+   * needed, without creating any node.
+   *
+   * Graph formats need their nodes to be created to be converted, so
+   * Read must be used instead if their cache is stale.
+   *
+   * \return True if the topology is available.
+   */
+  bool Load (void);
+
+  /**
+   * \brief Creates one node per entry of the file and adds the links.
+   *
+   * \return The container of the nodes created (empty on error).
+   */
+  virtual NodeContainer Read (void);
+
+  /**
+   * \return The number of nodes in the loaded topology.
+   */
+  uint32_t GetNNodes (void) const;
+
+  /**
+   * \return True if the loaded topology has node positions.
+   */
+  bool HasPositions (void) const;
+
+  /**
+   * \param [in] i The node index.
+   * \return The position of node i.
+   */
+  Vector GetPosition (uint32_t i) const;
+
+  /**
+   * \brief Gives the i-th node of a container the i-th position.
+   *
+   * Each coordinate is multiplied by the matching coordinate of
+   * scale.  Nodes that have no MobilityModel get a
+   * ConstantPositionMobilityModel.
+   *
+   * \param [in] nodes The nodes, at most GetNNodes () of them.
+   * \param [in] scale The scale factor of each coordinate.
+   */
+  void InstallPositions (NodeContainer nodes, Vector scale = Vector (1, 1, 1)) const;
+
+  /**
+   * \brief Writes a binary topology file.
+   *
+   * \param [in] fileName The file to write.
+   * \param [in] nNodes The number of nodes.
+   * \param [in] positions The node positions, empty or nNodes long.
+   * \param [in] links The links, as pairs of node indices.
+   * \param [in] weights The link weights, empty or as long as links.
+   * \param [in] sourceSize The size of the text file the file caches.
+   * \return True on success.
+   */
+  static bool WriteFile (const std::string &fileName, uint32_t nNodes,
+                         const std::vector<Vector> &positions,
+                         const std::vector<std::pair<uint32_t, uint32_t> > &links,
+                         const std::vector<double> &weights,
+                         uint64_t sourceSize = 0);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// \return True if the cache exists, is not older than the source and has its size.
+  bool IsCacheValid (void) const;
+  /// \return The size of the source file, zero if it cannot be read.
+  uint64_t GetSourceSize (void) const;
+  /// \return True if the location source file was converted.
+  bool ConvertLocations (void) const;
+  /// \return The nodes read from the graph source file, which is converted.
+  NodeContainer ConvertGraph (void);
+  /// \return True if the file was mapped and its header is valid.
+  bool Map (void);
+  /// Unmaps the file.
+  void Unmap (void);
+
+  std::string m_sourceFileName; //!< Text file the binary file caches, if any.
+  std::string m_sourceFileType; //!< Type of the text file.
+
+  uint8_t *m_map;               //!< Start of the mapping.
+  size_t m_mapSize;             //!< Size of the mapping.
+  dev_t m_mapDevice;            //!< Device of the mapped file.
+  ino_t m_mapInode;             //!< Inode of the mapped file.
+  uint32_t m_nNodes;            //!< Number of nodes.
+  uint32_t m_nLinks;            //!< Number of links.
+  const double *m_positions;    //!< Node positions, or 0.
+  const uint32_t *m_links;      //!< Link node indices.
+  const double *m_weights;      //!< Link weights, or 0.
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TOPOLOGY_READER_H */
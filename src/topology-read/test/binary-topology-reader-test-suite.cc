@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <fstream>
+
+#include "ns3/test.h"
+#include "ns3/binary-topology-reader.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Binary Topology Reader test of location files
+ */
+class BinaryTopologyReaderLocationTest : public TestCase
+{
+public:
+  BinaryTopologyReaderLocationTest ();
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTopologyReaderLocationTest::BinaryTopologyReaderLocationTest ()
+  : TestCase ("Check the conversion and mapping of a location file")
+{
+}
+
+void
+BinaryTopologyReaderLocationTest::DoRun (void)
+{
+  std::string input = CreateTempDirFilename ("location.txt");
+  {
+    // The scenario files have a fourth column, which must be ignored.
+    std::ofstream out (input.c_str ());
+    out << "10 20 1.5 7\n"
+        << "30 40 2.5 8\n"
+        << "\n"
+        << "50 60 3.5 9\n";
+  }
+
+  Ptr<BinaryTopologyReader> reader = CreateObject<BinaryTopologyReader> ();
+  reader->SetSourceFile (input, "Location");
+  NS_TEST_ASSERT_MSG_EQ (reader->GetFileName (), input + ".bin", "Wrong cache file name");
+  NS_TEST_ASSERT_MSG_EQ (reader->Load (), true, "The location file should have been loaded");
+  NS_TEST_ASSERT_MSG_EQ (std::ifstream (reader->GetFileName ().c_str ()).good (), true, "The cache was not written");
+  NS_TEST_ASSERT_MSG_EQ (reader->GetNNodes (), 3, "Wrong number of nodes");
+  NS_TEST_ASSERT_MSG_EQ (reader->HasPositions (), true, "The positions are missing");
+  NS_TEST_EXPECT_MSG_EQ_TOL (CalculateDistance (reader->GetPosition (1), Vector (30, 40, 2.5)), 0, 1e-9, "Wrong position of node 1");
+  NS_TEST_EXPECT_MSG_EQ_TOL (CalculateDistance (reader->GetPosition (2), Vector (50, 60, 3.5)), 0, 1e-9, "Wrong position of node 2");
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  reader->InstallPositions (nodes, Vector (0.5, 0.5, 1));
+  Ptr<MobilityModel> mobility = nodes.Get (1)->GetObject<MobilityModel> ();
+  NS_TEST_ASSERT_MSG_NE (mobility, 0, "No mobility model installed");
+  NS_TEST_EXPECT_MSG_EQ_TOL (CalculateDistance (mobility->GetPosition (), Vector (15, 20, 2.5)), 0, 1e-9, "Wrong scaled position");
+
+  // The same reader sees a text file rewritten right away, within the
+  // timestamp resolution of some file systems, with another size.
+  {
+    std::ofstream out (input.c_str ());
+    out << "11 21 1.5 7\n"
+        << "31 41 2.5 8\n";
+  }
+  NS_TEST_ASSERT_MSG_EQ (reader->Load (), true, "The location file should have been reloaded");
+  NS_TEST_ASSERT_MSG_EQ (reader->GetNNodes (), 2, "The stale cache was kept");
+  NS_TEST_EXPECT_MSG_EQ_TOL (CalculateDistance (reader->GetPosition (1), Vector (31, 41, 2.5)), 0, 1e-9, "Wrong reloaded position");
+
+  // A second reader uses the cache, even without the text file.
+  std::remove (input.c_str ());
+  Ptr<BinaryTopologyReader> cached = CreateObject<BinaryTopologyReader> ();
+  cached->SetSourceFile (input, "Location");
+  NS_TEST_ASSERT_MSG_EQ (cached->Load (), true, "The cache should have been loaded");
+  NS_TEST_EXPECT_MSG_EQ_TOL (CalculateDistance (cached->GetPosition (0), Vector (11, 21, 1.5)), 0, 1e-9, "Wrong cached position");
+  cached->Dispose ();
+  reader->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Binary Topology Reader test of graph files
+ */
+class BinaryTopologyReaderGraphTest : public TestCase
+{
+public:
+  BinaryTopologyReaderGraphTest ();
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTopologyReaderGraphTest::BinaryTopologyReaderGraphTest ()
+  : TestCase ("Check the conversion of an Inet file")
+{
+}
+
+void
+BinaryTopologyReaderGraphTest::DoRun (void)
+{
+  std::string input = CreateTempDirFilename ("inet.txt");
+  {
+    std::ofstream out (input.c_str ());
+    out << "3 2\n"
+        << "0 0 0\n"
+        << "1 10 0\n"
+        << "2 20 0\n"
+        << "0 1 5\n"
+        << "1 2 7\n";
+  }
+
+  Ptr<BinaryTopologyReader> reader = CreateObject<BinaryTopologyReader> ();
+  reader->SetSourceFile (input, "Inet");
+  NS_TEST_ASSERT_MSG_EQ (reader->Load (), false, "Graph files are converted by Read");
+  NodeContainer nodes = reader->Read ();
+  NS_TEST_ASSERT_MSG_EQ (nodes.GetN (), 3, "Wrong number of nodes from the text file");
+  NS_TEST_ASSERT_MSG_EQ (reader->LinksSize (), 2, "Wrong number of links from the text file");
+  NS_TEST_ASSERT_MSG_EQ (reader->GetNNodes (), 3, "The cache was not mapped");
+
+  Ptr<BinaryTopologyReader> cached = CreateObject<BinaryTopologyReader> ();
+  cached->SetSourceFile (input, "Inet");
+  nodes = cached->Read ();
+  NS_TEST_ASSERT_MSG_EQ (nodes.GetN (), 3, "Wrong number of nodes from the cache");
+  NS_TEST_ASSERT_MSG_EQ (cached->LinksSize (), 2, "Wrong number of links from the cache");
+  NS_TEST_EXPECT_MSG_EQ (cached->HasPositions (), false, "Inet files have no positions");
+  TopologyReader::ConstLinksIterator link = cached->LinksBegin ();
+  ++link;
+  NS_TEST_EXPECT_MSG_EQ (link->GetFromNode (), nodes.Get (1), "Wrong link source");
+  NS_TEST_EXPECT_MSG_EQ (link->GetToNode (), nodes.Get (2), "Wrong link destination");
+  NS_TEST_EXPECT_MSG_EQ (link->GetAttribute ("Weight"), "7", "Wrong link weight");
+  cached->Dispose ();
+  reader->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup topology-test
+ * \ingroup tests
+ *
+ * \brief Binary Topology Reader TestSuite
+ */
+class BinaryTopologyReaderTestSuite : public TestSuite
+{
+public:
+  BinaryTopologyReaderTestSuite ();
+};
+
+BinaryTopologyReaderTestSuite::BinaryTopologyReaderTestSuite ()
+  : TestSuite ("binary-topology-reader", UNIT)
+{
+  AddTestCase (new BinaryTopologyReaderLocationTest (), TestCase::QUICK);
+  AddTestCase (new BinaryTopologyReaderGraphTest (), TestCase::QUICK);
+}
+
+static BinaryTopologyReaderTestSuite g_binaryTopologyReaderTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/error-rate-model.h"
+#include "ns3/preamble-detection-model.h"
+#include "ns3/abstract-wifi-phy.h"
+#include "abstract-wifi-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AbstractWifiHelper");
+
+AbstractWifiChannelHelper::AbstractWifiChannelHelper ()
+{
+}
+
+AbstractWifiChannelHelper
+AbstractWifiChannelHelper::Default (void)
+{
+  AbstractWifiChannelHelper helper;
+  helper.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  helper.AddPropagationLoss ("ns3::LogDistancePropagationLossModel");
+  return helper;
+}
+
+void
+AbstractWifiChannelHelper::AddPropagationLoss (std::string type,
+                                           std::string n0, const AttributeValue &v0,
+                                           std::string n1, const AttributeValue &v1,
+                                           std::string n2, const AttributeValue &v2,
+                                           std::string n3, const AttributeValue &v3,
+                                           std::string n4, const AttributeValue &v4,
+                                           std::string n5, const AttributeValue &v5,
+                                           std::string n6, const AttributeValue &v6,
+                                           std::string n7, const AttributeValue &v7)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  factory.Set (n0, v0);
+  factory.Set (n1, v1);
+  factory.Set (n2, v2);
+  factory.Set (n3, v3);
+  factory.Set (n4, v4);
+  factory.Set (n5, v5);
+  factory.Set (n6, v6);
+  factory.Set (n7, v7);
+  m_propagationLoss.push_back (factory);
+}
+
+void
+AbstractWifiChannelHelper::SetPropagationDelay (std::string type,
+                                            std::string n0, const AttributeValue &v0,
+                                            std::string n1, const AttributeValue &v1,
+                                            std::string n2, const AttributeValue &v2,
+                                            std::string n3, const AttributeValue &v3,
+                                            std::string n4, const AttributeValue &v4,
+                                            std::string n5, const AttributeValue &v5,
+                                            std::string n6, const AttributeValue &v6,
+                                            std::string n7, const AttributeValue &v7)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  factory.Set (n0, v0);
+  factory.Set (n1, v1);
+  factory.Set (n2, v2);
+  factory.Set (n3, v3);
+  factory.Set (n4, v4);
+  factory.Set (n5, v5);
+  factory.Set (n6, v6);
+  factory.Set (n7, v7);
+  m_propagationDelay = factory;
+}
+
+Ptr<AbstractWifiChannel>
+AbstractWifiChannelHelper::Create (void) const
+{
+  Ptr<AbstractWifiChannel> channel = CreateObject<AbstractWifiChannel> ();
+  Ptr<PropagationLossModel> prev = 0;
+  for (std::vector<ObjectFactory>::const_iterator i = m_propagationLoss.begin (); i != m_propagationLoss.end (); ++i)
+    {
+      Ptr<PropagationLossModel> cur = (*i).Create<PropagationLossModel> ();
+      if (prev != 0)
+        {
+          prev->SetNext (cur);
+        }
+      if (m_propagationLoss.begin () == i)
+        {
+          channel->SetPropagationLossModel (cur);
+        }
+      prev = cur;
+    }
+  Ptr<PropagationDelayModel> delay = m_propagationDelay.Create<PropagationDelayModel> ();
+  channel->SetPropagationDelayModel (delay);
+  return channel;
+}
+
+int64_t
+AbstractWifiChannelHelper::AssignStreams (Ptr<AbstractWifiChannel> c, int64_t stream)
+{
+  return c->AssignStreams (stream);
+}
+
+AbstractWifiPhyHelper::AbstractWifiPhyHelper ()
+  : m_channel (0)
+{
+  m_phy.SetTypeId ("ns3::AbstractWifiPhy");
+}
+
+AbstractWifiPhyHelper
+AbstractWifiPhyHelper::Default (void)
+{
+  AbstractWifiPhyHelper helper;
+  helper.SetErrorRateModel ("ns3::NistErrorRateModel");
+  return helper;
+}
+
+void
+AbstractWifiPhyHelper::SetChannel (Ptr<AbstractWifiChannel> channel)
+{
+  m_channel = channel;
+}
+
+void
+AbstractWifiPhyHelper::SetChannel (std::string channelName)
+{
+  Ptr<AbstractWifiChannel> channel = Names::Find<AbstractWifiChannel> (channelName);
+  m_channel = channel;
+}
+
+Ptr<WifiPhy>
+AbstractWifiPhyHelper::Create (Ptr<Node> node, Ptr<NetDevice> device) const
+{
+  Ptr<AbstractWifiPhy> phy = m_phy.Create<AbstractWifiPhy> ();
+  Ptr<ErrorRateModel> error = m_errorRateModel.Create<ErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  if (m_preambleDetectionModel.IsTypeIdSet ())
+    {
+      Ptr<PreambleDetectionModel> capture = m_preambleDetectionModel.Create<PreambleDetectionModel> ();
+      phy->SetPreambleDetectionModel (capture);
+    }
+  phy->SetChannel (m_channel);
+  phy->SetDevice (device);
+  return phy;
+}
+
+} //namespace ns3
@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/mobility-model.h"
+#include "abstract-wifi-channel.h"
+#include "abstract-wifi-phy.h"
+#include "wifi-utils.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AbstractWifiChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (AbstractWifiChannel);
+
+TypeId
+AbstractWifiChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AbstractWifiChannel")
+    .SetParent<Channel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<AbstractWifiChannel> ()
+    .AddAttribute ("PropagationLossModel", "A pointer to the propagation loss model attached to this channel.",
+                   PointerValue (),
+                   MakePointerAccessor (&AbstractWifiChannel::m_loss),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("PropagationDelayModel", "A pointer to the propagation delay model attached to this channel.",
+                   PointerValue (),
+                   MakePointerAccessor (&AbstractWifiChannel::m_delay),
+                   MakePointerChecker<PropagationDelayModel> ())
+  ;
+  return tid;
+}
+
+AbstractWifiChannel::AbstractWifiChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AbstractWifiChannel::~AbstractWifiChannel ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::const_iterator i = m_tracked.begin (); i != m_tracked.end (); i++)
+    {
+      if (*i != 0)
+        {
+          (*i)->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&AbstractWifiChannel::InvalidateLinks, this));
+        }
+    }
+  m_tracked.clear ();
+  m_links.clear ();
+  m_phyList.clear ();
+}
+
+void
+AbstractWifiChannel::SetPropagationLossModel (const Ptr<PropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  m_loss = loss;
+  InvalidateLinks (0);
+}
+
+void
+AbstractWifiChannel::SetPropagationDelayModel (const Ptr<PropagationDelayModel> delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  m_delay = delay;
+  InvalidateLinks (0);
+}
+
+void
+AbstractWifiChannel::InvalidateLinks (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  std::fill (m_linksValid.begin (), m_linksValid.end (), false);
+}
+
+const AbstractWifiChannel::Links &
+AbstractWifiChannel::GetLinks (std::size_t sender)
+{
+  NS_LOG_FUNCTION (this << sender);
+  if (m_linksValid[sender])
+    {
+      return m_links[sender];
+    }
+  for (std::size_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ();
+      NS_ASSERT (mobility != 0);
+      if (mobility != m_tracked[i])
+        {
+          if (m_tracked[i] != 0)
+            {
+              m_tracked[i]->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&AbstractWifiChannel::InvalidateLinks, this));
+            }
+          mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&AbstractWifiChannel::InvalidateLinks, this));
+          m_tracked[i] = mobility;
+        }
+    }
+  //The receivers which would not sense the sender at its highest
+  //power are left out of the table
+  Ptr<AbstractWifiPhy> phy = m_phyList[sender];
+  Ptr<MobilityModel> senderMobility = m_tracked[sender];
+  double maxTxPowerDbm = std::max (phy->GetTxPowerStart (), phy->GetTxPowerEnd ()) + phy->GetTxGain ();
+  Links &links = m_links[sender];
+  links.clear ();
+  for (std::size_t i = 0; i < m_phyList.size (); i++)
+    {
+      if (i == sender)
+        {
+          continue;
+        }
+      Ptr<AbstractWifiPhy> receiver = m_phyList[i];
+      Link link;
+      link.receiver = i;
+      link.lossDb = -m_loss->CalcRxPower (0, senderMobility, m_tracked[i]);
+      if (maxTxPowerDbm - link.lossDb + receiver->GetRxGain () < receiver->GetRxSensitivity ())
+        {
+          continue;
+        }
+      link.delay = m_delay->GetDelay (senderMobility, m_tracked[i]);
+      Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
+      link.context = (dstNetDevice == 0) ? 0xffffffff : dstNetDevice->GetNode ()->GetId ();
+      links.push_back (link);
+    }
+  NS_LOG_DEBUG ("PHY " << sender << " has " << links.size () << " receivers in range");
+  m_linksValid[sender] = true;
+  return links;
+}
+
+void
+AbstractWifiChannel::Send (std::size_t sender, Ptr<const Packet> packet, WifiTxVector txVector,
+                           double txPowerDbm, Time duration, bool isFrameComplete)
+{
+  NS_LOG_FUNCTION (this << sender << packet << txVector << txPowerDbm << duration.GetSeconds () << isFrameComplete);
+  uint8_t channelNumber = m_phyList[sender]->GetChannelNumber ();
+  const Links &links = GetLinks (sender);
+  //The receivers only read the packet, they share a single copy
+  for (Links::const_iterator i = links.begin (); i != links.end (); i++)
+    {
+      Ptr<AbstractWifiPhy> receiver = m_phyList[i->receiver];
+      //For now don't account for inter channel interference nor channel bonding
+      if (receiver->GetChannelNumber () != channelNumber)
+        {
+          continue;
+        }
+      double rxPowerDbm = txPowerDbm - i->lossDb + receiver->GetRxGain ();
+      if (rxPowerDbm < receiver->GetRxSensitivity ())
+        {
+          continue;
+        }
+      Simulator::ScheduleWithContext (i->context, i->delay, &AbstractWifiPhy::StartReceive, receiver,
+                                      packet, txVector, DbmToW (rxPowerDbm), duration, isFrameComplete);
+    }
+}
+
+std::size_t
+AbstractWifiChannel::GetNDevices (void) const
+{
+  return m_phyList.size ();
+}
+
+Ptr<NetDevice>
+AbstractWifiChannel::GetDevice (std::size_t i) const
+{
+  return m_phyList[i]->GetDevice ()->GetObject<NetDevice> ();
+}
+
+std::size_t
+AbstractWifiChannel::Add (Ptr<AbstractWifiPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  m_phyList.push_back (phy);
+  m_links.push_back (Links ());
+  m_linksValid.push_back (false);
+  m_tracked.push_back (0);
+  InvalidateLinks (0);
+  return m_phyList.size () - 1;
+}
+
+int64_t
+AbstractWifiChannel::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  int64_t currentStream = stream;
+  currentStream += m_loss->AssignStreams (stream);
+  return (currentStream - stream);
+}
+
+} //namespace ns3
@@ -0,0 +1,438 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <limits>
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "abstract-wifi-phy.h"
+#include "abstract-wifi-channel.h"
+#include "wifi-phy-state-helper.h"
+#include "wifi-phy-tag.h"
+#include "wifi-phy-header.h"
+#include "wifi-utils.h"
+#include "error-rate-model.h"
+#include "mpdu-aggregator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AbstractWifiPhy");
+
+NS_OBJECT_ENSURE_REGISTERED (AbstractWifiPhy);
+
+/// Lowest SNR of the success rate tables, in dB
+static const double MIN_SNR_DB = -5;
+/// Step of the success rate tables, in dB
+static const double SNR_STEP_DB = 0.25;
+/// Number of entries of the success rate tables, up to 55 dB
+static const std::size_t N_SNR_STEPS = 241;
+/// Size of the chunk the success rate per bit is derived from, a typical MPDU
+static const uint32_t REFERENCE_BITS = 1500 * 8;
+
+TypeId
+AbstractWifiPhy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AbstractWifiPhy")
+    .SetParent<WifiPhy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<AbstractWifiPhy> ()
+  ;
+  return tid;
+}
+
+AbstractWifiPhy::AbstractWifiPhy ()
+  : m_channelIndex (0),
+    m_signalsPowerW (0),
+    m_rxPowerW (0),
+    m_rxInterferenceW (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AbstractWifiPhy::~AbstractWifiPhy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+AbstractWifiPhy::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_channel = 0;
+  m_rxPacket = 0;
+  m_signals.clear ();
+  m_rxInterferenceChanges.clear ();
+  m_logSuccessRates.clear ();
+  WifiPhy::DoDispose ();
+}
+
+Ptr<Channel>
+AbstractWifiPhy::GetChannel (void) const
+{
+  return m_channel;
+}
+
+void
+AbstractWifiPhy::SetChannel (const Ptr<AbstractWifiChannel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  m_channel = channel;
+  m_channelIndex = m_channel->Add (this);
+}
+
+void
+AbstractWifiPhy::StartTx (Ptr<Packet> packet, WifiTxVector txVector, Time txDuration)
+{
+  NS_LOG_DEBUG ("Start transmission: signal power before antenna gain=" << GetPowerDbm (txVector.GetTxPowerLevel ()) << "dBm");
+  //The receivers get the TXVECTOR from the channel: remove the PHY
+  //headers once here rather than parse them at every receiver
+  WifiPhyTag tag;
+  packet->RemovePacketTag (tag);
+  WifiModulationClass modulation = txVector.GetMode ().GetModulationClass ();
+  if ((modulation == WIFI_MOD_CLASS_DSSS) || (modulation == WIFI_MOD_CLASS_HR_DSSS))
+    {
+      DsssSigHeader dsssSigHdr;
+      packet->RemoveHeader (dsssSigHdr);
+    }
+  else if ((modulation != WIFI_MOD_CLASS_HT) || (txVector.GetPreambleType () != WIFI_PREAMBLE_HT_GF))
+    {
+      LSigHeader lSigHdr;
+      packet->RemoveHeader (lSigHdr);
+    }
+  if (modulation == WIFI_MOD_CLASS_HT)
+    {
+      HtSigHeader htSigHdr;
+      packet->RemoveHeader (htSigHdr);
+    }
+  else if (modulation == WIFI_MOD_CLASS_VHT)
+    {
+      VhtSigHeader vhtSigHdr;
+      vhtSigHdr.SetMuFlag (txVector.GetPreambleType () == WIFI_PREAMBLE_VHT_MU);
+      packet->RemoveHeader (vhtSigHdr);
+      if (IsAmpdu (packet))
+        {
+          txVector.SetAggregation (true);
+        }
+    }
+  else if (modulation == WIFI_MOD_CLASS_HE)
+    {
+      HeSigHeader heSigHdr;
+      heSigHdr.SetMuFlag (txVector.GetPreambleType () == WIFI_PREAMBLE_HE_MU);
+      packet->RemoveHeader (heSigHdr);
+      txVector.SetObssDst (tag.GetObssDst ());
+      txVector.SetObssSrc (tag.GetObssSrc ());
+      txVector.SetObssDuration (tag.GetObssDuration ());
+      txVector.SetObssTxPower (tag.GetObssTxPower ());
+      if (IsAmpdu (packet))
+        {
+          txVector.SetAggregation (true);
+        }
+    }
+  //The number of TX antennas is not signalled in the PHY headers: the
+  //receivers of a YansWifiPhy assume one, do the same
+  txVector.SetNTx (1);
+  //WifiPhy::SendPacket has cancelled the reception in progress, if any
+  m_rxPacket = 0;
+  m_channel->Send (m_channelIndex, packet, txVector, GetTxPowerForTransmission (txVector) + GetTxGain (),
+                   txDuration, tag.GetFrameComplete () != 0);
+}
+
+void
+AbstractWifiPhy::RemoveEndedSignals (void)
+{
+  Time now = Simulator::Now ();
+  while (!m_signals.empty () && m_signals.begin ()->first <= now)
+    {
+      m_signalsPowerW -= m_signals.begin ()->second;
+      m_signals.erase (m_signals.begin ());
+    }
+  if (m_signals.empty ())
+    {
+      //do not let rounding errors accumulate
+      m_signalsPowerW = 0;
+    }
+}
+
+void
+AbstractWifiPhy::AddSignal (double rxPowerW, Time end)
+{
+  NS_LOG_FUNCTION (this << rxPowerW << end);
+  RemoveEndedSignals ();
+  if (m_rxPacket != 0 && m_endRxEvent.IsRunning ())
+    {
+      m_rxInterferenceChanges.insert (std::make_pair (Simulator::Now (), rxPowerW));
+      if (end < m_rxEnd)
+        {
+          m_rxInterferenceChanges.insert (std::make_pair (end, -rxPowerW));
+        }
+    }
+  m_signals.insert (std::make_pair (end, rxPowerW));
+  m_signalsPowerW += rxPowerW;
+}
+
+Time
+AbstractWifiPhy::GetEnergyDuration (double thresholdW)
+{
+  RemoveEndedSignals ();
+  double powerW = m_signalsPowerW;
+  Time end = Simulator::Now ();
+  for (std::multimap<Time, double>::const_iterator i = m_signals.begin ();
+       i != m_signals.end () && powerW >= thresholdW; i++)
+    {
+      end = i->first;
+      powerW -= i->second;
+    }
+  return end - Simulator::Now ();
+}
+
+void
+AbstractWifiPhy::MaybeCcaBusy (void)
+{
+  Time delayUntilCcaEnd = GetEnergyDuration (DbmToW (GetCcaEdThreshold ()));
+  if (!delayUntilCcaEnd.IsZero ())
+    {
+      m_state->SwitchMaybeToCcaBusy (delayUntilCcaEnd);
+    }
+}
+
+void
+AbstractWifiPhy::StartReceive (Ptr<const Packet> packet, WifiTxVector txVector, double rxPowerW,
+                               Time rxDuration, bool isFrameComplete)
+{
+  NS_LOG_FUNCTION (this << packet << txVector << rxPowerW << rxDuration << isFrameComplete);
+  AddSignal (rxPowerW, Simulator::Now () + rxDuration);
+
+  if (m_state->GetState () == WifiPhyState::OFF)
+    {
+      NS_LOG_DEBUG ("Cannot start RX because device is OFF");
+      return;
+    }
+
+  if (!isFrameComplete)
+    {
+      NS_LOG_DEBUG ("Packet reception stopped because transmitter has been switched off");
+      return;
+    }
+
+  WifiMode txMode = txVector.GetMode ();
+  if (!IsModeSupported (txMode) && !IsMcsSupported (txMode))
+    {
+      NS_LOG_DEBUG ("drop packet because of unsupported RX mode");
+      NotifyRxDrop (packet, UNSUPPORTED_SETTINGS);
+      MaybeCcaBusy ();
+      return;
+    }
+
+  switch (m_state->GetState ())
+    {
+    case WifiPhyState::SWITCHING:
+    case WifiPhyState::RX:
+    case WifiPhyState::TX:
+      NS_LOG_DEBUG ("Drop packet because already in " << m_state->GetState () << " (power=" <<
+                    rxPowerW << "W)");
+      NotifyRxDrop (packet, NOT_ALLOWED);
+      MaybeCcaBusy ();
+      break;
+    case WifiPhyState::CCA_BUSY:
+    case WifiPhyState::IDLE:
+      StartRx (packet, txVector, rxPowerW, rxDuration);
+      break;
+    case WifiPhyState::SLEEP:
+      NS_LOG_DEBUG ("Drop packet because in sleep mode");
+      NotifyRxDrop (packet, NOT_ALLOWED);
+      break;
+    default:
+      NS_FATAL_ERROR ("Invalid WifiPhy state.");
+      break;
+    }
+}
+
+void
+AbstractWifiPhy::StartRx (Ptr<const Packet> packet, WifiTxVector txVector, double rxPowerW, Time rxDuration)
+{
+  NS_LOG_FUNCTION (this << packet << txVector << rxPowerW << rxDuration);
+  double noiseW = m_interference.GetNoiseFloorW (txVector.GetChannelWidth ());
+  double snr = rxPowerW / (noiseW + m_signalsPowerW - rxPowerW);
+  if (!IsPreambleDetected (rxPowerW, snr))
+    {
+      NS_LOG_DEBUG ("Drop packet because PHY preamble detection failed");
+      NotifyRxDrop (packet, PREAMBLE_DETECT_FAILURE);
+      MaybeCcaBusy ();
+      return;
+    }
+  if (txVector.GetNss () > GetMaxSupportedRxSpatialStreams ())
+    {
+      NS_LOG_DEBUG ("Packet reception could not be started because not enough RX antennas");
+      NotifyRxDrop (packet, UNSUPPORTED_SETTINGS);
+      MaybeCcaBusy ();
+      return;
+    }
+
+  m_state->SwitchToRx (rxDuration);
+  NotifyRxBegin (packet);
+  m_rxPacket = packet;
+  m_rxTxVector = txVector;
+  m_rxPowerW = rxPowerW;
+  m_rxStart = Simulator::Now ();
+  m_rxEnd = m_rxStart + rxDuration;
+  //the signals already on the medium, the frame itself being the last one
+  //added, and the ones of them which end before the frame
+  m_rxInterferenceW = m_signalsPowerW - rxPowerW;
+  m_rxInterferenceChanges.clear ();
+  for (std::multimap<Time, double>::const_iterator i = m_signals.begin ();
+       i != m_signals.end () && i->first < m_rxEnd; i++)
+    {
+      m_rxInterferenceChanges.insert (std::make_pair (i->first, -i->second));
+    }
+  m_endRxEvent = Simulator::Schedule (rxDuration, &AbstractWifiPhy::EndReceive, this);
+}
+
+void
+AbstractWifiPhy::EndReceive (void)
+{
+  NS_LOG_FUNCTION (this << m_rxPacket << m_rxTxVector);
+  NS_ASSERT (m_rxPacket != 0);
+  Ptr<const Packet> packet = m_rxPacket;
+  m_rxPacket = 0;
+
+  //combine the chunks of constant interference, weighted by their duration
+  double noiseW = m_interference.GetNoiseFloorW (m_rxTxVector.GetChannelWidth ());
+  double interferenceW = m_rxInterferenceW;
+  double interferenceJ = 0;
+  double logSuccessRatePerBit = 0;
+  Time chunkStart = m_rxStart;
+  m_rxInterferenceChanges.insert (std::make_pair (m_rxEnd, 0.0));
+  for (std::multimap<Time, double>::const_iterator i = m_rxInterferenceChanges.begin ();
+       i != m_rxInterferenceChanges.end (); i++)
+    {
+      double chunkDuration = (i->first - chunkStart).GetSeconds ();
+      if (chunkDuration > 0)
+        {
+          interferenceW = std::max (interferenceW, 0.0);
+          interferenceJ += interferenceW * chunkDuration;
+          logSuccessRatePerBit += chunkDuration * GetLogSuccessRatePerBit (m_rxTxVector, m_rxPowerW / (noiseW + interferenceW));
+          chunkStart = i->first;
+        }
+      interferenceW += i->second;
+    }
+  m_rxInterferenceChanges.clear ();
+  double rxDuration = (m_rxEnd - m_rxStart).GetSeconds ();
+  logSuccessRatePerBit /= rxDuration;
+  interferenceW = interferenceJ / rxDuration;
+  double snr = m_rxPowerW / (noiseW + interferenceW);
+  SignalNoiseDbm signalNoise;
+  signalNoise.signal = WToDbm (m_rxPowerW);
+  signalNoise.noise = WToDbm (noiseW + interferenceW);
+  NS_LOG_DEBUG ("snr(dB)=" << RatioToDb (snr) << ", interference(W)=" << interferenceW);
+
+  std::vector<bool> statusPerMpdu;
+  bool receptionOkAtLeastForOneMpdu = true;
+  if (m_rxTxVector.IsAggregation ())
+    {
+      std::list<Ptr<const Packet>> ampduSubframes = MpduAggregator::PeekAmpduSubframes (packet);
+      for (const auto & subframe : ampduSubframes)
+        {
+          bool ok = ReceiveMpdu (MpduAggregator::PeekMpduInAmpduSubframe (subframe), logSuccessRatePerBit);
+          statusPerMpdu.push_back (ok);
+          receptionOkAtLeastForOneMpdu |= ok;
+        }
+    }
+  else
+    {
+      receptionOkAtLeastForOneMpdu = ReceiveMpdu (packet, logSuccessRatePerBit);
+      statusPerMpdu.push_back (receptionOkAtLeastForOneMpdu);
+    }
+
+  if (receptionOkAtLeastForOneMpdu)
+    {
+      NotifyMonitorSniffRx (packet, GetFrequency (), m_rxTxVector, signalNoise, statusPerMpdu);
+      m_state->SwitchFromRxEndOk (packet->Copy (), snr, m_rxTxVector, statusPerMpdu);
+    }
+  else
+    {
+      m_state->SwitchFromRxEndError (packet->Copy (), snr);
+    }
+}
+
+bool
+AbstractWifiPhy::ReceiveMpdu (Ptr<const Packet> mpdu, double logSuccessRatePerBit)
+{
+  double per = 1 - std::exp (logSuccessRatePerBit * mpdu->GetSize () * 8);
+  if (m_random->GetValue () > per)
+    {
+      NS_LOG_DEBUG ("Reception succeeded: " << mpdu->ToString ());
+      NotifyRxEnd (mpdu);
+      return true;
+    }
+  NS_LOG_DEBUG ("Reception failed: " << mpdu->ToString ());
+  NotifyRxDrop (mpdu, ERRONEOUS_FRAME);
+  return false;
+}
+
+double
+AbstractWifiPhy::GetTableEntry (std::vector<double> &table, std::size_t index, WifiTxVector txVector)
+{
+  if (std::isnan (table[index]))
+    {
+      double snr = DbToRatio (MIN_SNR_DB + index * SNR_STEP_DB);
+      double csr = m_interference.GetErrorRateModel ()->GetChunkSuccessRate (txVector.GetMode (), txVector, snr, REFERENCE_BITS);
+      //a success rate of zero would make the interpolation undefined;
+      //e^-1 per bit is already zero for any MPDU
+      table[index] = std::max (std::log (csr) / REFERENCE_BITS, -1.0);
+    }
+  return table[index];
+}
+
+double
+AbstractWifiPhy::GetLogSuccessRatePerBit (WifiTxVector txVector, double snr)
+{
+  //as InterferenceHelper::CalculateChunkSuccessRate, account for the gain of
+  //MIMO, SIMO or MISO and spread the bits over the spatial streams
+  double bitsPerStream = 1.0;
+  WifiModulationClass modulation = txVector.GetMode ().GetModulationClass ();
+  if (modulation == WIFI_MOD_CLASS_HT || modulation == WIFI_MOD_CLASS_VHT || modulation == WIFI_MOD_CLASS_HE)
+    {
+      bitsPerStream = 1.0 / txVector.GetNss ();
+      snr *= txVector.GetNTx () * GetNumberOfAntennas ();
+    }
+  uint64_t key = (static_cast<uint64_t> (txVector.GetMode ().GetUid ()) << 32)
+    | (static_cast<uint64_t> (txVector.GetNss ()) << 16) | txVector.GetChannelWidth ();
+  std::vector<double> &table = m_logSuccessRates[key];
+  if (table.empty ())
+    {
+      table.assign (N_SNR_STEPS, std::numeric_limits<double>::quiet_NaN ());
+    }
+  double position = (RatioToDb (snr) - MIN_SNR_DB) / SNR_STEP_DB;
+  if (position <= 0)
+    {
+      return bitsPerStream * GetTableEntry (table, 0, txVector);
+    }
+  if (position >= N_SNR_STEPS - 1)
+    {
+      return bitsPerStream * GetTableEntry (table, N_SNR_STEPS - 1, txVector);
+    }
+  std::size_t index = static_cast<std::size_t> (position);
+  double fraction = position - index;
+  double lower = GetTableEntry (table, index, txVector);
+  if (fraction == 0)
+    {
+      return bitsPerStream * lower;
+    }
+  return bitsPerStream * (lower + fraction * (GetTableEntry (table, index + 1, txVector) - lower));
+}
+
+} //namespace ns3
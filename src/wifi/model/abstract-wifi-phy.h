@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ABSTRACT_WIFI_PHY_H
+#define ABSTRACT_WIFI_PHY_H
+
+#include <map>
+#include <vector>
+#include "wifi-phy.h"
+
+namespace ns3 {
+
+class AbstractWifiChannel;
+
+/**
+ * \brief abstracted 802.11 PHY layer model for large sweeps
+ * \ingroup wifi
+ *
+ * This PHY is a cheaper sibling of ns3::YansWifiPhy, meant for sweeps
+ * over large meshes where the PHY dominates the run time.  It does not
+ * follow a frame through its preamble, PHY headers and payload, nor track
+ * each chunk of interference: a frame is decided once, when it ends.
+ *
+ * - The received power of a frame comes from the per-link table of the
+ *   ns3::AbstractWifiChannel, which only delivers it to receivers in range.
+ * - The interference is the aggregate power of the other signals, which
+ *   changes when a signal starts or ends.  A frame is cut into chunks of
+ *   constant SINR, but their success rates are combined by bit rather than
+ *   by MPDU: the MPDUs of an A-MPDU share one success rate per bit.
+ * - The success rate of a frame is read from a table, built lazily for
+ *   each mode, of the logarithm of the success rate per bit of the error
+ *   rate model against the SNR (interpolated on a 0.25 dB grid).  The
+ *   table is exact for error rate models whose chunk success rate is a
+ *   power of a per-bit success rate, like ns3::NistErrorRateModel.
+ * - The preamble detection model is applied with the SINR at the start of
+ *   the frame.  The PHY headers always succeed.
+ *
+ * The frame capture model, the post-reception error model and the OBSS_PD
+ * spatial reuse (which needs the end of the HE preamble) are not supported.
+ */
+class AbstractWifiPhy : public WifiPhy
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  AbstractWifiPhy ();
+  virtual ~AbstractWifiPhy ();
+
+  /**
+   * Set the AbstractWifiChannel this AbstractWifiPhy is to be connected to.
+   *
+   * \param channel the AbstractWifiChannel this AbstractWifiPhy is to be connected to
+   */
+  void SetChannel (const Ptr<AbstractWifiChannel> channel);
+
+  /**
+   * \param packet the packet to send
+   * \param txVector the TXVECTOR that has tx parameters such as mode, the transmission mode to use to send
+   *        this packet, and txPowerLevel, a power level to use to send this packet. The real transmission
+   *        power is calculated as txPowerMin + txPowerLevel * (txPowerMax - txPowerMin) / nTxLevels
+   * \param txDuration duration of the transmission.
+   */
+  void StartTx (Ptr<Packet> packet, WifiTxVector txVector, Time txDuration);
+
+  /**
+   * Called by the AbstractWifiChannel when the first bit of a frame arrives.
+   *
+   * \param packet the packet, without its PHY headers
+   * \param txVector the TXVECTOR used to send the packet
+   * \param rxPowerW the received power in W, including the RX gain
+   * \param rxDuration the duration of the frame
+   * \param isFrameComplete false if the transmitter was switched off during the transmission
+   */
+  void StartReceive (Ptr<const Packet> packet, WifiTxVector txVector, double rxPowerW,
+                     Time rxDuration, bool isFrameComplete);
+
+  virtual Ptr<Channel> GetChannel (void) const;
+
+
+protected:
+  // Inherited
+  virtual void DoDispose (void);
+
+
+private:
+  /**
+   * Add a signal to the aggregate of the signals on the medium, and account
+   * for it in the interference of the frame being received, if any.
+   *
+   * \param rxPowerW the received power of the signal in W
+   * \param end the time at which the signal ends
+   */
+  void AddSignal (double rxPowerW, Time end);
+  /**
+   * Remove the signals which ended from the aggregate.
+   */
+  void RemoveEndedSignals (void);
+  /**
+   * \param thresholdW the energy threshold in W
+   *
+   * \return the time until the aggregate of the signals falls below the threshold
+   */
+  Time GetEnergyDuration (double thresholdW);
+  /**
+   * Switch to CCA busy if the signals on the medium are above the CCA-ED threshold.
+   */
+  void MaybeCcaBusy (void);
+  /**
+   * Lock on a frame, if its preamble can be detected.
+   *
+   * \param packet the packet
+   * \param txVector the TXVECTOR used to send the packet
+   * \param rxPowerW the received power in W
+   * \param rxDuration the duration of the frame
+   */
+  void StartRx (Ptr<const Packet> packet, WifiTxVector txVector, double rxPowerW, Time rxDuration);
+  /**
+   * Decide the reception of the frame which ends now.
+   */
+  void EndReceive (void);
+  /**
+   * Decide the reception of one MPDU of the frame which ends now.
+   *
+   * \param mpdu the MPDU
+   * \param logSuccessRatePerBit the logarithm of the success rate per bit
+   *
+   * \return true if the MPDU is received
+   */
+  bool ReceiveMpdu (Ptr<const Packet> mpdu, double logSuccessRatePerBit);
+  /**
+   * \param txVector the TXVECTOR of the frame
+   * \param snr the SINR (linear) of the frame
+   *
+   * \return the logarithm of the success rate per bit of the frame
+   */
+  double GetLogSuccessRatePerBit (WifiTxVector txVector, double snr);
+  /**
+   * \param table the table of the mode of the frame
+   * \param index the index of the entry in the table
+   * \param txVector the TXVECTOR of the frame
+   *
+   * \return the entry of the table, computed if it was not yet
+   */
+  double GetTableEntry (std::vector<double> &table, std::size_t index, WifiTxVector txVector);
+
+  Ptr<AbstractWifiChannel> m_channel; //!< AbstractWifiChannel that this AbstractWifiPhy is connected to
+  std::size_t m_channelIndex;         //!< Index of this PHY in the PHY list of the channel
+
+  std::multimap<Time, double> m_signals; //!< Powers (W) of the signals on the medium, by end time
+  double m_signalsPowerW;                //!< Aggregate power of the signals on the medium
+
+  Ptr<const Packet> m_rxPacket; //!< Frame being received, if any
+  WifiTxVector m_rxTxVector;    //!< TXVECTOR of the frame being received
+  double m_rxPowerW;            //!< Received power of the frame being received
+  Time m_rxStart;               //!< Time at which the reception started
+  Time m_rxEnd;                 //!< Time at which the reception ends
+  double m_rxInterferenceW;     //!< Interference power at the start of the frame being received
+  std::multimap<Time, double> m_rxInterferenceChanges; //!< Changes of the interference power over the frame being received
+
+  /// Logarithm of the success rate per bit against the SNR, by mode, NSS and width
+  std::map<uint64_t, std::vector<double> > m_logSuccessRates;
+};
+
+} //namespace ns3
+
+#endif /* ABSTRACT_WIFI_PHY_H */
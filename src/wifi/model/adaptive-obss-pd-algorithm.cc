@@ -0,0 +1,294 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "adaptive-obss-pd-algorithm.h"
+#include "obss-wifi-manager.h"
+#include "wifi-mac-header.h"
+#include "mpdu-aggregator.h"
+#include "wifi-utils.h"
+#include "wifi-phy.h"
+#include "wifi-net-device.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AdaptiveObssPdAlgorithm");
+NS_OBJECT_ENSURE_REGISTERED (AdaptiveObssPdAlgorithm);
+
+AdaptiveObssPdAlgorithm::AdaptiveObssPdAlgorithm ()
+  : MeshObssPdAlgorithm (),
+    m_ignored (NO_NODE_ID),
+    m_pending (NO_NODE_ID)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+AdaptiveObssPdAlgorithm::GetTypeId (void)
+{
+  static ns3::TypeId tid = ns3::TypeId ("ns3::AdaptiveObssPdAlgorithm")
+    .SetParent<MeshObssPdAlgorithm> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<AdaptiveObssPdAlgorithm> ()
+    .AddAttribute ("SinrTarget",
+                   "The SINR (dB) of the frames to the next hop for which the first "
+                   "OBSS PD level of a neighbor is predicted.",
+                   DoubleValue (20),
+                   MakeDoubleAccessor (&AdaptiveObssPdAlgorithm::m_sinrTarget),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("PerTarget",
+                   "The highest error rate of the frames sent while a neighbor is "
+                   "ignored for which its OBSS PD level is raised.",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&AdaptiveObssPdAlgorithm::m_perTarget),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("Window",
+                   "The number of frames sent while a neighbor is ignored between "
+                   "two changes of its OBSS PD level.",
+                   UintegerValue (20),
+                   MakeUintegerAccessor (&AdaptiveObssPdAlgorithm::m_window),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("InitialStep",
+                   "The first change (dB) of the OBSS PD level of a neighbor.",
+                   DoubleValue (4),
+                   MakeDoubleAccessor (&AdaptiveObssPdAlgorithm::m_initialStep),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("MinStep",
+                   "The smallest change (dB) of the OBSS PD level of a neighbor, "
+                   "under which the level has settled.",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&AdaptiveObssPdAlgorithm::m_minStep),
+                   MakeDoubleChecker<double> (0.01))
+    .AddTraceSource ("LevelChange", "The OBSS PD level of a neighbor changed.",
+                     MakeTraceSourceAccessor (&AdaptiveObssPdAlgorithm::m_levelChange),
+                     "ns3::AdaptiveObssPdAlgorithm::LevelTracedCallback")
+  ;
+  return tid;
+}
+
+void
+AdaptiveObssPdAlgorithm::ConnectWifiNetDevice (const Ptr<WifiNetDevice> device)
+{
+  Ptr<WifiPhy> phy = device->GetPhy ();
+  phy->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&AdaptiveObssPdAlgorithm::PhyTxBegin, this));
+  phy->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&AdaptiveObssPdAlgorithm::PhyRxEnd, this));
+  MeshObssPdAlgorithm::ConnectWifiNetDevice (device);
+}
+
+AdaptiveObssPdAlgorithm::Neighbor &
+AdaptiveObssPdAlgorithm::GetNeighbor (uint16_t neighbor, double level)
+{
+  if (neighbor >= m_neighbors.size ())
+    {
+      Neighbor unknown = {false, false, 0, 0, 0, 0};
+      m_neighbors.resize (neighbor + 1, unknown);
+    }
+  Neighbor &state = m_neighbors[neighbor];
+  if (!state.known)
+    {
+      state.known = true;
+      state.level = ClampObssPdLevel (level);
+      state.step = m_initialStep;
+      NS_LOG_DEBUG ("Neighbor " << neighbor << " starts at OBSS PD level " << state.level);
+    }
+  return state;
+}
+
+double
+AdaptiveObssPdAlgorithm::GetObssPdLevel (uint16_t neighbor) const
+{
+  if (neighbor < m_neighbors.size () && m_neighbors[neighbor].known)
+    {
+      return m_neighbors[neighbor].level;
+    }
+  return m_obssPdLevel;
+}
+
+bool
+AdaptiveObssPdAlgorithm::IsSettled (uint16_t neighbor) const
+{
+  return neighbor < m_neighbors.size () && m_neighbors[neighbor].known
+         && m_neighbors[neighbor].step < m_minStep;
+}
+
+double
+AdaptiveObssPdAlgorithm::ClampObssPdLevel (double level) const
+{
+  DoubleValue min;
+  DoubleValue max;
+  GetAttribute ("ObssPdLevelMin", min);
+  GetAttribute ("ObssPdLevelMax", max);
+  return std::max (min.Get (), std::min (max.Get (), level));
+}
+
+bool
+AdaptiveObssPdAlgorithm::PredictObssPdLevel (HePreambleParameters params, double &level)
+{
+  Mac48Address nextHop = GetNextHop ();
+  uint16_t nextHopId = nextHop.IsGroup () ? NO_NODE_ID : GetNodeIdOfAddress (nextHop);
+  if (nextHopId == NO_NODE_ID)
+    {
+      return false;
+    }
+  double signalLoss = ObssWifiManager::GetPathLoss (nextHopId, m_device->GetNode ()->GetId ());
+  double interferenceLoss = ObssWifiManager::GetPathLoss (nextHopId, params.src);
+  if (signalLoss == ObssWifiManager::UNKNOWN_PATH_LOSS || interferenceLoss == ObssWifiManager::UNKNOWN_PATH_LOSS)
+    {
+      NS_LOG_DEBUG ("No path loss between the next hop " << nextHopId << " and " << params.src);
+      return false;
+    }
+  //TX power for which the frames to the next hop arrive SinrTarget dB
+  //above the frames of the neighbor
+  double txPowerDbm = m_sinrTarget + params.txPowerDbm + interferenceLoss - signalLoss;
+  Ptr<WifiPhy> phy = m_device->GetPhy ();
+  DoubleValue min;
+  DoubleValue txPowerRef;
+  GetAttribute ("ObssPdLevelMin", min);
+  GetAttribute ("TxPowerRefSiso", txPowerRef);
+  if (txPowerDbm > phy->GetTxPowerEnd () + phy->GetTxGain ())
+    {
+      NS_LOG_DEBUG ("The next hop " << nextHopId << " cannot be reached during the frames of " << params.src);
+      level = min.Get ();
+    }
+  else
+    {
+      //The TX power restriction of a level is TxPowerRefSiso - (level - ObssPdLevelMin)
+      level = txPowerRef.Get () + min.Get () - txPowerDbm;
+    }
+  return true;
+}
+
+void
+AdaptiveObssPdAlgorithm::ReceiveHeSig (HePreambleParameters params)
+{
+  NS_LOG_FUNCTION (this << params.dst << params.src << WToDbm (params.rssiW) << Simulator::Now ());
+  if (params.src == NO_NODE_ID)
+    {
+      return;
+    }
+  uint16_t nodeId = m_device->GetNode ()->GetId ();
+  if (ObssWifiManager::GetPathLoss (nodeId, params.src) == ObssWifiManager::UNKNOWN_PATH_LOSS)
+    {
+      ObssWifiManager::SetPathLoss (nodeId, params.src, WToDbm (params.rssiW) - params.txPowerDbm);
+    }
+  if (!IsObss (params))
+    {
+      NS_LOG_DEBUG ("Not obss");
+      return;
+    }
+  Neighbor &neighbor = GetNeighbor (params.src, m_obssPdLevel);
+  //The level is predicted once the path losses are known, unless the
+  //error rate has already changed it
+  double level;
+  if (!neighbor.predicted && neighbor.step == m_initialStep && PredictObssPdLevel (params, level))
+    {
+      neighbor.level = ClampObssPdLevel (level);
+      neighbor.predicted = true;
+      NS_LOG_DEBUG ("Neighbor " << params.src << " predicted at OBSS PD level " << neighbor.level);
+    }
+  if (WToDbm (params.rssiW) < neighbor.level)
+    {
+      NS_LOG_DEBUG ("Frame is OBSS and RSSI " << WToDbm (params.rssiW) << " is below OBSS-PD level of "
+                    << neighbor.level << " of neighbor " << params.src << "; reset PHY to IDLE");
+      //The TX power restriction follows the level of the neighbor
+      level = m_obssPdLevel;
+      m_obssPdLevel = neighbor.level;
+      ResetPhy (params);
+      m_obssPdLevel = level;
+      m_ignored = params.src;
+      m_ignoredEnd = Simulator::Now () + params.duration;
+    }
+  else
+    {
+      NS_LOG_DEBUG ("Frame is OBSS and RSSI is above OBSS-PD level of neighbor " << params.src);
+    }
+}
+
+void
+AdaptiveObssPdAlgorithm::ReportTxOutcome (uint16_t neighbor, bool success)
+{
+  NS_LOG_FUNCTION (this << neighbor << success);
+  Neighbor &state = GetNeighbor (neighbor, m_obssPdLevel);
+  if (state.step < m_minStep)
+    {
+      return;
+    }
+  state.frames++;
+  if (!success)
+    {
+      state.failures++;
+    }
+  if (state.frames < m_window)
+    {
+      return;
+    }
+  double per = static_cast<double> (state.failures) / state.frames;
+  state.level = ClampObssPdLevel (per > m_perTarget ? state.level - state.step : state.level + state.step);
+  state.step /= 2;
+  state.frames = 0;
+  state.failures = 0;
+  NS_LOG_DEBUG ("Neighbor " << neighbor << " PER " << per << " new OBSS PD level " << state.level);
+  m_levelChange (neighbor, state.level, per);
+}
+
+void
+AdaptiveObssPdAlgorithm::PeekMacHeader (Ptr<const Packet> packet, WifiMacHeader &hdr)
+{
+  //The HE frames are S-MPDUs or A-MPDUs, whose MPDUs start with a
+  //subframe header
+  if (IsAmpdu (packet))
+    {
+      packet = MpduAggregator::PeekMpduInAmpduSubframe (packet);
+    }
+  packet->PeekHeader (hdr);
+}
+
+void
+AdaptiveObssPdAlgorithm::PhyTxBegin (Ptr<const Packet> packet, double txPowerW)
+{
+  WifiMacHeader hdr;
+  PeekMacHeader (packet, hdr);
+  //The MPDUs of an A-MPDU start together
+  if (!hdr.IsData () || hdr.GetAddr1 ().IsGroup () || Simulator::Now () == m_lastTx)
+    {
+      return;
+    }
+  if (m_pending != NO_NODE_ID)
+    {
+      ReportTxOutcome (m_pending, false);
+    }
+  m_lastTx = Simulator::Now ();
+  m_pending = (Simulator::Now () < m_ignoredEnd) ? m_ignored : NO_NODE_ID;
+}
+
+void
+AdaptiveObssPdAlgorithm::PhyRxEnd (Ptr<const Packet> packet)
+{
+  WifiMacHeader hdr;
+  PeekMacHeader (packet, hdr);
+  if (m_pending != NO_NODE_ID && (hdr.IsAck () || hdr.IsBlockAck ())
+      && hdr.GetAddr1 () == m_device->GetMac ()->GetAddress ())
+    {
+      ReportTxOutcome (m_pending, true);
+      m_pending = NO_NODE_ID;
+    }
+}
+
+} //namespace ns3
@@ -78,6 +78,14 @@ ApWifiMac::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&ApWifiMac::SetBeaconGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("AbstractBeacons",
+                   "If true, beacons are not transmitted by the PHY: their airtime is reserved "
+                   "on the channel and they are delivered to the stations that would decode them, "
+                   "according to the error rate of each link without interference. "
+                   "Requires a PHY which evaluates the RX power of a single link, as YansWifiPhy does.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ApWifiMac::m_abstractBeacons),
+                   MakeBooleanChecker ())
     .AddAttribute ("EnableNonErpProtection", "Whether or not protection mechanism should be used when non-ERP STAs are present within the BSS."
                    "This parameter is only used when ERP is supported by the AP.",
                    BooleanValue (true),
@@ -93,7 +101,8 @@ ApWifiMac::GetTypeId (void)
 }
 
 ApWifiMac::ApWifiMac ()
-  : m_enableBeaconGeneration (false)
+  : m_enableBeaconGeneration (false),
+    m_abstractBeacons (false)
 {
   NS_LOG_FUNCTION (this);
   m_beaconTxop = CreateObject<Txop> ();
@@ -223,8 +232,13 @@ int64_t
 ApWifiMac::AssignStreams (int64_t stream)
 {
   NS_LOG_FUNCTION (this << stream);
-  m_beaconJitter->SetStream (stream);
-  return 1;
+  int64_t currentStream = stream;
+  m_beaconJitter->SetStream (currentStream++);
+  if (m_abstractBeacons)
+    {
+      currentStream += AssignAbstractedStreams (currentStream);
+    }
+  return (currentStream - stream);
 }
 
 bool
@@ -915,8 +929,15 @@ ApWifiMac::SendOneBeacon (void)
     }
   packet->AddHeader (beacon);
 
-  //The beacon has it's own special queue, so we load it in there
-  m_beaconTxop->Queue (packet, hdr);
+  if (m_abstractBeacons)
+    {
+      SendAbstracted (packet, hdr);
+    }
+  else
+    {
+      //The beacon has it's own special queue, so we load it in there
+      m_beaconTxop->Queue (packet, hdr);
+    }
   m_beaconEvent = Simulator::Schedule (GetBeaconInterval (), &ApWifiMac::SendOneBeacon, this);
 
   //If a STA that does not support Short Slot Time associates,
@@ -20,13 +20,9 @@
 
 #include "ns3/log.h"
 #include "block-ack-cache.h"
-#include "qos-utils.h"
-#include "wifi-utils.h"
 #include "wifi-mac-header.h"
 #include "ctrl-headers.h"
 
-#define WINSIZE_ASSERT NS_ASSERT ((m_winEnd - m_winStart + 4096) % 4096 == m_winSize - 1)
-
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("BlockAckCache");
@@ -35,16 +31,13 @@ void
 BlockAckCache::Init (uint16_t winStart, uint16_t winSize)
 {
   NS_LOG_FUNCTION (this << winStart << winSize);
-  m_winStart = winStart;
-  m_winSize = winSize;
-  m_winEnd = (m_winStart + m_winSize - 1) % 4096;
-  memset (m_bitmap, 0, sizeof (m_bitmap));
+  m_window.Init (winStart, winSize);
 }
 
 uint16_t
 BlockAckCache::GetWinStart () const
 {
-  return m_winStart;
+  return m_window.GetWinStart ();
 }
 
 void
@@ -52,63 +45,33 @@ BlockAckCache::UpdateWithMpdu (const WifiMacHeader *hdr)
 {
   NS_LOG_FUNCTION (this << hdr);
   uint16_t seqNumber = hdr->GetSequenceNumber ();
-  if (!QosUtilsIsOldPacket (m_winStart, seqNumber))
-    {
-      if (!IsInWindow (seqNumber, m_winStart, m_winSize))
-        {
-          uint16_t delta = (seqNumber - m_winEnd + 4096) % 4096;
-          if (delta > 1)
-            {
-              ResetPortionOfBitmap ((m_winEnd + 1) % 4096, ((seqNumber - 1) + 4096) % 4096);
-            }
-          m_winStart = (m_winStart + delta) % 4096;
-          m_winEnd = seqNumber;
-
-          WINSIZE_ASSERT;
-        }
-      m_bitmap[seqNumber] |= (0x0001 << hdr->GetFragmentNumber ());
-    }
-}
-
-void
-BlockAckCache::UpdateWithBlockAckReq (uint16_t startingSeq)
-{
-  NS_LOG_FUNCTION (this << startingSeq);
-  if (!QosUtilsIsOldPacket (m_winStart, startingSeq))
+  uint16_t distance = m_window.GetDistance (seqNumber);
+  // MPDUs up to half the sequence number space before the window are old
+  if (distance < 2048)
     {
-      if (IsInWindow (startingSeq, m_winStart, m_winSize))
+      if (distance >= m_window.GetWinSize ())
         {
-          if (startingSeq != m_winStart)
-            {
-              m_winStart = startingSeq;
-              uint16_t newWinEnd = (m_winStart + m_winSize - 1) % 4096;
-              ResetPortionOfBitmap ((m_winEnd + 1) % 4096, newWinEnd);
-              m_winEnd = newWinEnd;
-
-              WINSIZE_ASSERT;
-            }
+          // move the window so that it ends with this MPDU
+          m_window.Advance (distance - m_window.GetWinSize () + 1);
         }
-      else
+      // compressed block acks acknowledge the first fragment only
+      if (hdr->GetFragmentNumber () == 0)
         {
-          m_winStart = startingSeq;
-          m_winEnd = (m_winStart + m_winSize - 1) % 4096;
-          ResetPortionOfBitmap (m_winStart, m_winEnd);
-
-          WINSIZE_ASSERT;
+          m_window.Set (seqNumber);
         }
     }
 }
 
 void
-BlockAckCache::ResetPortionOfBitmap (uint16_t start, uint16_t end)
+BlockAckCache::UpdateWithBlockAckReq (uint16_t startingSeq)
 {
-  NS_LOG_FUNCTION (this << start << end);
-  uint16_t i = start;
-  for (; i != end; i = (i + 1) % 4096)
+  NS_LOG_FUNCTION (this << startingSeq);
+  uint16_t distance = m_window.GetDistance (startingSeq);
+  if (distance < 2048)
     {
-      m_bitmap[i] = 0;
+      // if the starting sequence is beyond the window, the whole window is cleared
+      m_window.Advance (distance);
     }
-  m_bitmap[i] = 0;
 }
 
 void
@@ -121,19 +84,10 @@ BlockAckCache::FillBlockAckBitmap (CtrlBAckResponseHeader *blockAckHeader)
     }
   else if (blockAckHeader->IsCompressed () || blockAckHeader->IsExtendedCompressed ())
     {
-      uint16_t i = blockAckHeader->GetStartingSequence ();
-      uint16_t end = (i + m_winSize - 1) % 4096;
-      for (; i != end; i = (i + 1) % 4096)
-        {
-          if (m_bitmap[i] == 1)
-            {
-              blockAckHeader->SetReceivedPacket (i);
-            }
-        }
-      if (m_bitmap[i] == 1)
-        {
-          blockAckHeader->SetReceivedPacket (i);
-        }
+      uint64_t words[4];
+      std::size_t nWords = blockAckHeader->IsCompressed () ? 1 : 4;
+      m_window.GetBitmap (blockAckHeader->GetStartingSequence (), words, nWords);
+      blockAckHeader->SetCompressedBitmap (words, nWords);
     }
   else if (blockAckHeader->IsMultiTid ())
     {
@@ -21,7 +21,7 @@
 #ifndef BLOCK_ACK_CACHE_H
 #define BLOCK_ACK_CACHE_H
 
-//#include <stdint.h>
+#include "block-ack-window.h"
 
 namespace ns3 {
 
@@ -69,18 +69,7 @@ public:
 
 
 private:
-  /**
-   * Reset portion of bitmap functiion
-   * \param start the starting position
-   * \param end the ending position
-   */
-  void ResetPortionOfBitmap (uint16_t start, uint16_t end);
-
-  uint16_t m_winStart; ///< window start
-  uint16_t m_winSize; ///< window size
-  uint16_t m_winEnd; ///< window end
-
-  uint16_t m_bitmap[4096]; ///< bitmap
+  BlockAckWindow m_window; ///< the MPDUs received in the window
 };
 
 } //namespace ns3
@@ -46,6 +46,55 @@ Bar::Bar (Ptr<const Packet> bar, Mac48Address recipient, uint8_t tid, bool immed
   NS_LOG_FUNCTION (this << bar << recipient << +tid << immediate);
 }
 
+void
+BlockAckManager::Scoreboard::Init (uint16_t winStart, uint16_t winSize)
+{
+  // the originator may leave the buffer size of the ADDBA request to the recipient
+  window.Init (winStart, winSize == 0 ? 64 : winSize);
+  mpdus.assign (window.GetNBits (), 0);
+  nMpdus = 0;
+}
+
+Ptr<WifiMacQueueItem>
+BlockAckManager::Scoreboard::Get (uint16_t seq) const
+{
+  if (!window.IsInWindow (seq))
+    {
+      return 0;
+    }
+  return mpdus[seq & (mpdus.size () - 1)];
+}
+
+Ptr<WifiMacQueueItem>
+BlockAckManager::Scoreboard::Release (uint16_t seq)
+{
+  if (!window.IsInWindow (seq))
+    {
+      return 0;
+    }
+  Ptr<WifiMacQueueItem> &slot = mpdus[seq & (mpdus.size () - 1)];
+  Ptr<WifiMacQueueItem> mpdu = slot;
+  if (mpdu != 0)
+    {
+      slot = 0;
+      window.Reset (seq);
+      nMpdus--;
+    }
+  return mpdu;
+}
+
+void
+BlockAckManager::Scoreboard::Advance (uint16_t winStart)
+{
+  uint16_t count = window.GetDistance (winStart);
+  uint16_t start = window.GetWinStart ();
+  for (uint16_t d = 0; d < count && d < window.GetWinSize () && nMpdus > 0; d++)
+    {
+      Release ((start + d) % SEQNO_SPACE_SIZE);
+    }
+  window.Advance (count);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (BlockAckManager);
 
 TypeId
@@ -137,8 +186,9 @@ BlockAckManager::CreateAgreement (const MgtAddBaRequestHeader *reqHdr, Mac48Addr
   uint8_t tid = reqHdr->GetTid ();
   m_agreementState (Simulator::Now (), recipient, tid, OriginatorBlockAckAgreement::PENDING);
   agreement.SetState (OriginatorBlockAckAgreement::PENDING);
-  PacketQueue queue;
-  std::pair<OriginatorBlockAckAgreement, PacketQueue> value (agreement, queue);
+  Scoreboard scoreboard;
+  scoreboard.Init (agreement.GetStartingSequence (), agreement.GetBufferSize ());
+  std::pair<OriginatorBlockAckAgreement, Scoreboard> value (agreement, scoreboard);
   if (ExistsAgreement (recipient, tid))
     {
       // Delete agreement if it exists and in RESET state
@@ -198,6 +248,7 @@ BlockAckManager::UpdateAgreement (const MgtAddBaResponseHeader *respHdr, Mac48Ad
       // update the starting sequence number because some frames may have been sent
       // under Normal Ack policy after the transmission of the ADDBA Request frame
       agreement.SetStartingSequence (m_txMiddle->GetNextSeqNumberByTidAndAddress (tid, recipient));
+      it->second.second.Init (agreement.GetStartingSequence (), agreement.GetBufferSize ());
       if (respHdr->IsImmediateBlockAck ())
         {
           agreement.SetImmediateBlockAck ();
@@ -241,37 +292,28 @@ BlockAckManager::StorePacket (Ptr<WifiMacQueueItem> mpdu)
   AgreementsI agreementIt = m_agreements.find (std::make_pair (recipient, tid));
   NS_ASSERT (agreementIt != m_agreements.end ());
 
-  uint16_t startingSeq = agreementIt->second.first.GetStartingSequence ();
-  uint16_t mpduDist = (mpdu->GetHeader ().GetSequenceNumber () - startingSeq + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE;
+  Scoreboard &scoreboard = agreementIt->second.second;
+  uint16_t seq = mpdu->GetHeader ().GetSequenceNumber ();
+  uint16_t mpduDist = scoreboard.window.GetDistance (seq);
 
   if (mpduDist >= SEQNO_SPACE_HALF_SIZE)
     {
       NS_LOG_DEBUG ("Got an old packet. Do nothing");
       return;
     }
+  NS_ASSERT_MSG (mpduDist < scoreboard.window.GetWinSize (), "Packet beyond the transmit window");
 
-  // store the packet and keep the list sorted in increasing order of sequence number
-  // with respect to the starting sequence number
-  PacketQueueI it = agreementIt->second.second.begin ();
-  while (it != agreementIt->second.second.end ())
+  Ptr<WifiMacQueueItem> stored = scoreboard.Get (seq);
+  if (stored != 0)
     {
-      if (mpdu->GetHeader ().GetSequenceControl () == (*it)->GetHeader ().GetSequenceControl ())
-        {
-          NS_LOG_DEBUG ("Packet already in the queue of the BA agreement");
-          return;
-        }
-
-      uint16_t dist = ((*it)->GetHeader ().GetSequenceNumber () - startingSeq + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE;
-
-      if (mpduDist < dist ||
-          (mpduDist == dist && mpdu->GetHeader ().GetFragmentNumber () < (*it)->GetHeader ().GetFragmentNumber ()))
-        {
-          break;
-        }
-
-      it++;
+      NS_ASSERT_MSG (stored->GetHeader ().GetSequenceControl () == mpdu->GetHeader ().GetSequenceControl (),
+                     "Fragments are not sent under a block ack agreement");
+      NS_LOG_DEBUG ("Packet already in the queue of the BA agreement");
+      return;
     }
-  agreementIt->second.second.insert (it, mpdu);
+  scoreboard.mpdus[seq & (scoreboard.mpdus.size () - 1)] = mpdu;
+  scoreboard.window.Set (seq);
+  scoreboard.nMpdus++;
 }
 
 bool
@@ -305,19 +347,7 @@ BlockAckManager::GetNBufferedPackets (Mac48Address recipient, uint8_t tid) const
     {
       return 0;
     }
-  uint32_t nPackets = 0;
-  PacketQueueCI queueIt = (*it).second.second.begin ();
-  while (queueIt != (*it).second.second.end ())
-    {
-      uint16_t currentSeq = (*queueIt)->GetHeader ().GetSequenceNumber ();
-      nPackets++;
-      /* a fragmented packet must be counted as one packet */
-      while (queueIt != (*it).second.second.end () && (*queueIt)->GetHeader ().GetSequenceNumber () == currentSeq)
-        {
-          queueIt++;
-        }
-    }
-  return nPackets;
+  return it->second.second.nMpdus;
 }
 
 void
@@ -348,24 +378,14 @@ BlockAckManager::NotifyGotAck (Ptr<const WifiMacQueueItem> mpdu)
   NS_ASSERT (it != m_agreements.end ());
 
   // remove the acknowledged frame from the queue of outstanding packets
-  PacketQueueI queueIt = it->second.second.begin ();
-  while (queueIt != it->second.second.end ())
-    {
-      if ((*queueIt)->GetHeader ().GetSequenceNumber () == mpdu->GetHeader ().GetSequenceNumber ())
-        {
-          queueIt = it->second.second.erase (queueIt);
-        }
-      else
-      {
-        queueIt++;
-      }
-    }
+  it->second.second.Release (mpdu->GetHeader ().GetSequenceNumber ());
 
   uint16_t startingSeq = it->second.first.GetStartingSequence ();
   if (mpdu->GetHeader ().GetSequenceNumber () == startingSeq)
     {
       // make the transmit window advance
       it->second.first.SetStartingSequence ((startingSeq + 1) % SEQNO_SPACE_SIZE);
+      it->second.second.Advance (it->second.first.GetStartingSequence ());
     }
 }
 
@@ -384,21 +404,10 @@ BlockAckManager::NotifyMissedAck (Ptr<WifiMacQueueItem> mpdu)
 
   // remove the frame from the queue of outstanding packets (it will be re-inserted
   // if retransmitted)
-  PacketQueueI queueIt = it->second.second.begin ();
-  while (queueIt != it->second.second.end ())
-    {
-      if ((*queueIt)->GetHeader ().GetSequenceNumber () == mpdu->GetHeader ().GetSequenceNumber ())
-        {
-          queueIt = it->second.second.erase (queueIt);
-        }
-      else
-      {
-        queueIt++;
-      }
-    }
+  it->second.second.Release (mpdu->GetHeader ().GetSequenceNumber ());
 
   // insert in the retransmission queue
-  InsertInRetryQueue (mpdu);
+  InsertInRetryQueue (mpdu, WifiMacQueue::EMPTY);
 }
 
 void
@@ -410,11 +419,9 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
       uint8_t tid = blockAck->GetTidInfo ();
       if (ExistsAgreementInState (recipient, tid, OriginatorBlockAckAgreement::ESTABLISHED))
         {
-          bool foundFirstLost = false;
           uint8_t nSuccessfulMpdus = 0;
           uint8_t nFailedMpdus = 0;
           AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-          PacketQueueI queueEnd = it->second.second.end ();
 
           if (it->second.first.m_inactivityEvent.IsRunning ())
             {
@@ -429,74 +436,97 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
                                                                         recipient, tid);
             }
 
-          uint16_t currentStartingSeq = it->second.first.GetStartingSequence ();
+          Scoreboard &scoreboard = it->second.second;
+          uint16_t winStart = scoreboard.window.GetWinStart ();
           uint16_t currentSeq = SEQNO_SPACE_SIZE;   // invalid value
+          uint16_t firstLost = SEQNO_SPACE_SIZE;    // invalid value
+          Ptr<WifiMacQueueItem> mpdu;
+          // the lost MPDUs are inserted in order, each resuming where the previous stopped
+          WifiMacQueue::ConstIterator retryPos = WifiMacQueue::EMPTY;
 
           if (blockAck->IsBasic ())
             {
-              for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd; )
+              for (uint16_t d = 0; scoreboard.nMpdus > 0; d++)
                 {
-                  currentSeq = (*queueIt)->GetHeader ().GetSequenceNumber ();
+                  uint16_t seq = (winStart + d) % SEQNO_SPACE_SIZE;
+                  if ((mpdu = scoreboard.Release (seq)) == 0)
+                    {
+                      continue;
+                    }
+                  currentSeq = seq;
                   if (blockAck->IsFragmentReceived (currentSeq,
-                                                    (*queueIt)->GetHeader ().GetFragmentNumber ()))
+                                                    mpdu->GetHeader ().GetFragmentNumber ()))
                     {
                       nSuccessfulMpdus++;
                     }
-                  else if (!QosUtilsIsOldPacket (currentStartingSeq, currentSeq))
+                  else
                     {
-                      if (!foundFirstLost)
+                      if (firstLost == SEQNO_SPACE_SIZE)
                         {
-                          foundFirstLost = true;
-                          SetStartingSequence (recipient, tid, currentSeq);
+                          firstLost = currentSeq;
                         }
                       nFailedMpdus++;
-                      InsertInRetryQueue (*queueIt);
+                      retryPos = InsertInRetryQueue (mpdu, retryPos);
                     }
-                  // in any case, this packet is no longer outstanding
-                  queueIt = it->second.second.erase (queueIt);
-                }
-              // If all frames were acknowledged, move the transmit window past the last one
-              if (!foundFirstLost && currentSeq != SEQNO_SPACE_SIZE)
-                {
-                  SetStartingSequence (recipient, tid, (currentSeq + 1) % SEQNO_SPACE_SIZE);
                 }
             }
           else if (blockAck->IsCompressed () || blockAck->IsExtendedCompressed ())
             {
-              for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd; )
+              uint64_t compressed = blockAck->GetCompressedBitmap ();
+              // clear the bits of the MPDUs that the block ack does not acknowledge
+              if (blockAck->IsCompressed ())
+                {
+                  scoreboard.window.Intersect (blockAck->GetStartingSequence (), &compressed, 1);
+                }
+              else
                 {
-                  currentSeq = (*queueIt)->GetHeader ().GetSequenceNumber ();
-                  if (blockAck->IsPacketReceived (currentSeq))
+                  scoreboard.window.Intersect (blockAck->GetStartingSequence (),
+                                               blockAck->GetExtendedCompressedBitmap (), 4);
+                }
+              for (uint16_t d = 0; scoreboard.nMpdus > 0; d++)
+                {
+                  // the MPDUs before the next unset bit are acknowledged, and the
+                  // MPDU of the unset bit, if any, is retransmitted
+                  uint16_t next = scoreboard.window.GetNextUnset (d);
+                  for (; d < next; d++)
                     {
+                      currentSeq = (winStart + d) % SEQNO_SPACE_SIZE;
+                      mpdu = scoreboard.Release (currentSeq);
+                      NS_ASSERT (mpdu != 0);
                       nSuccessfulMpdus++;
                       if (!m_txOkCallback.IsNull ())
                         {
-                          m_txOkCallback ((*queueIt)->GetHeader ());
+                          m_txOkCallback (mpdu->GetHeader ());
                         }
                     }
-                  else if (!QosUtilsIsOldPacket (currentStartingSeq, currentSeq))
+                  uint16_t seq = (winStart + d) % SEQNO_SPACE_SIZE;
+                  if (d == scoreboard.window.GetWinSize () || (mpdu = scoreboard.Release (seq)) == 0)
                     {
-                      if (!foundFirstLost)
-                        {
-                          foundFirstLost = true;
-                          SetStartingSequence (recipient, tid, currentSeq);
-                        }
-                      nFailedMpdus++;
-                      if (!m_txFailedCallback.IsNull ())
-                        {
-                          m_txFailedCallback ((*queueIt)->GetHeader ());
-                        }
-                      InsertInRetryQueue (*queueIt);
+                      continue;
                     }
-                  // in any case, this packet is no longer outstanding
-                  queueIt = it->second.second.erase (queueIt);
-                }
-              // If all frames were acknowledged, move the transmit window past the last one
-              if (!foundFirstLost && currentSeq != SEQNO_SPACE_SIZE)
-                {
-                  SetStartingSequence (recipient, tid, (currentSeq + 1) % SEQNO_SPACE_SIZE);
+                  currentSeq = seq;
+                  if (firstLost == SEQNO_SPACE_SIZE)
+                    {
+                      firstLost = currentSeq;
+                    }
+                  nFailedMpdus++;
+                  if (!m_txFailedCallback.IsNull ())
+                    {
+                      m_txFailedCallback (mpdu->GetHeader ());
+                    }
+                  retryPos = InsertInRetryQueue (mpdu, retryPos);
                 }
             }
+          // Move the transmit window to the first lost frame or, if all frames
+          // were acknowledged, past the last one
+          if (firstLost != SEQNO_SPACE_SIZE)
+            {
+              SetStartingSequence (recipient, tid, firstLost);
+            }
+          else if (currentSeq != SEQNO_SPACE_SIZE)
+            {
+              SetStartingSequence (recipient, tid, (currentSeq + 1) % SEQNO_SPACE_SIZE);
+            }
           m_stationManager->ReportAmpduTxStatus (recipient, tid, nSuccessfulMpdus, nFailedMpdus, rxSnr, dataSnr);
         }
     }
@@ -514,14 +544,20 @@ BlockAckManager::NotifyMissedBlockAck (Mac48Address recipient, uint8_t tid)
   if (ExistsAgreementInState (recipient, tid, OriginatorBlockAckAgreement::ESTABLISHED))
     {
       AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-      for (auto& item : it->second.second)
-        {
-          // Queue previously transmitted packets that do not already exist in the retry queue.
-          InsertInRetryQueue (item);
-        }
+      Scoreboard &scoreboard = it->second.second;
+      uint16_t winStart = scoreboard.window.GetWinStart ();
+      WifiMacQueue::ConstIterator retryPos = WifiMacQueue::EMPTY;
       // remove all packets from the queue of outstanding packets (they will be
       // re-inserted if retransmitted)
-      it->second.second.clear ();
+      for (uint16_t d = 0; scoreboard.nMpdus > 0; d++)
+        {
+          Ptr<WifiMacQueueItem> mpdu = scoreboard.Release ((winStart + d) % SEQNO_SPACE_SIZE);
+          if (mpdu != 0)
+            {
+              // Queue previously transmitted packets that do not already exist in the retry queue.
+              retryPos = InsertInRetryQueue (mpdu, retryPos);
+            }
+        }
     }
 }
 
@@ -532,7 +568,8 @@ BlockAckManager::DiscardOutstandingMpdus (Mac48Address recipient, uint8_t tid)
   if (ExistsAgreementInState (recipient, tid, OriginatorBlockAckAgreement::ESTABLISHED))
     {
       AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-      it->second.second.clear ();
+      Scoreboard &scoreboard = it->second.second;
+      scoreboard.Init (scoreboard.window.GetWinStart (), scoreboard.window.GetWinSize ());
     }
 }
 
@@ -628,6 +665,15 @@ BlockAckManager::NotifyAgreementEstablished (Mac48Address recipient, uint8_t tid
   }
   it->second.first.SetState (OriginatorBlockAckAgreement::ESTABLISHED);
   it->second.first.SetStartingSequence (startingSeq);
+  Scoreboard &scoreboard = it->second.second;
+  if (scoreboard.window.GetDistance (startingSeq) < SEQNO_SPACE_HALF_SIZE)
+    {
+      scoreboard.Advance (startingSeq);
+    }
+  else
+    {
+      scoreboard.Init (startingSeq, it->second.first.GetBufferSize ());
+    }
 }
 
 void
@@ -796,22 +842,7 @@ BlockAckManager::SetStartingSequence (Mac48Address recipient, uint8_t tid, uint1
   RemoveFromRetryQueue (recipient, tid, currStartingSeq, lastRemovedSeq);
 
   // remove packets that will become old from the queue of outstanding packets
-  PacketQueueI it = agreementIt->second.second.begin ();
-  while (it != agreementIt->second.second.end ())
-    {
-      uint16_t itSeq = (*it)->GetHeader ().GetSequenceNumber ();
-
-      if ((itSeq - currStartingSeq + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE
-           <= (lastRemovedSeq - currStartingSeq + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE)
-        {
-          NS_LOG_DEBUG ("Removing frame with seqnum = " << itSeq);
-          it = agreementIt->second.second.erase (it);
-        }
-      else
-        {
-          it++;
-        }
-    }
+  agreementIt->second.second.Advance (startingSeq);
 
   // update the starting sequence number
   agreementIt->second.first.SetStartingSequence (startingSeq);
@@ -857,8 +888,8 @@ BlockAckManager::SetTxFailedCallback (TxFailed callback)
   m_txFailedCallback = callback;
 }
 
-void
-BlockAckManager::InsertInRetryQueue (Ptr<WifiMacQueueItem> mpdu)
+WifiMacQueue::ConstIterator
+BlockAckManager::InsertInRetryQueue (Ptr<WifiMacQueueItem> mpdu, WifiMacQueue::ConstIterator pos)
 {
   NS_LOG_INFO ("Adding to retry queue " << *mpdu);
   NS_ASSERT (mpdu->GetHeader ().IsQosData ());
@@ -875,17 +906,22 @@ BlockAckManager::InsertInRetryQueue (Ptr<WifiMacQueueItem> mpdu)
   if (mpduDist >= SEQNO_SPACE_HALF_SIZE)
     {
       NS_LOG_DEBUG ("Got an old packet. Do nothing");
-      return;
+      return pos;
     }
 
-  WifiMacQueue::ConstIterator it = m_retryPackets->PeekByTidAndAddress (tid, recipient);
+  // the packets preceding the given position have lower sequence numbers
+  WifiMacQueue::ConstIterator it = pos;
+  if (it != m_retryPackets->end ())
+    {
+      it = m_retryPackets->PeekByTidAndAddress (tid, recipient, pos);
+    }
 
   while (it != m_retryPackets->end ())
     {
       if (mpdu->GetHeader ().GetSequenceControl () == (*it)->GetHeader ().GetSequenceControl ())
         {
           NS_LOG_DEBUG ("Packet already in the retransmit queue");
-          return;
+          return it;
         }
 
       uint16_t dist = ((*it)->GetHeader ().GetSequenceNumber () - startingSeq + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE;
@@ -898,7 +934,10 @@ BlockAckManager::InsertInRetryQueue (Ptr<WifiMacQueueItem> mpdu)
 
       it = m_retryPackets->PeekByTidAndAddress (tid, recipient, ++it);
     }
+  uint32_t nPackets = m_retryPackets->GetNPackets ();
   m_retryPackets->Insert (it, mpdu);
+  // a full queue may have dropped packets, including the one at the insertion point
+  return (m_retryPackets->GetNPackets () == nPackets + 1 ? it : WifiMacQueue::EMPTY);
 }
 
 uint16_t
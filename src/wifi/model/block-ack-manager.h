@@ -22,12 +22,16 @@
 #define BLOCK_ACK_MANAGER_H
 
 #include <map>
+#include <list>
+#include <vector>
+#include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/traced-callback.h"
 #include "wifi-mac-header.h"
 #include "originator-block-ack-agreement.h"
 #include "block-ack-type.h"
 #include "wifi-mac-queue-item.h"
+#include "block-ack-window.h"
 
 namespace ns3 {
 
@@ -442,40 +446,75 @@ private:
   void SetStartingSequence (Mac48Address recipient, uint8_t tid, uint16_t startingSeq);
 
   /**
-   * typedef for a list of WifiMacQueueItem.
-   */
-  typedef std::list<Ptr<WifiMacQueueItem>> PacketQueue;
-  /**
-   * typedef for an iterator for PacketQueue.
-   */
-  typedef std::list<Ptr<WifiMacQueueItem>>::iterator PacketQueueI;
-  /**
-   * typedef for a const iterator for PacketQueue.
-   */
-  typedef std::list<Ptr<WifiMacQueueItem>>::const_iterator PacketQueueCI;
+   * \brief The MPDUs in flight under a Block Ack agreement
+   *
+   * The transmit window of the agreement has the bit of a sequence number
+   * set when its MPDU is sent, and a BlockAck clears the bits of the MPDUs
+   * it does not acknowledge. The MPDU of a sequence number is kept at the
+   * position of its bit in a circular array, hence the window slides with
+   * the starting sequence number without moving the MPDUs.
+   */
+  struct Scoreboard
+  {
+    /**
+     * Drop the MPDUs and reset the window.
+     *
+     * \param winStart the starting sequence number of the window
+     * \param winSize the size of the window
+     */
+    void Init (uint16_t winStart, uint16_t winSize);
+    /**
+     * \param seq a sequence number
+     * \return the MPDU in flight with the given sequence number, if any
+     */
+    Ptr<WifiMacQueueItem> Get (uint16_t seq) const;
+    /**
+     * Forget the MPDU in flight with the given sequence number, if any.
+     *
+     * \param seq the sequence number
+     * \return the MPDU, if any
+     */
+    Ptr<WifiMacQueueItem> Release (uint16_t seq);
+    /**
+     * Move the window forward, forgetting the MPDUs leaving it.
+     *
+     * \param winStart the new starting sequence number of the window
+     */
+    void Advance (uint16_t winStart);
+
+    BlockAckWindow window;                    ///< the MPDUs in flight
+    std::vector<Ptr<WifiMacQueueItem>> mpdus; ///< the MPDUs, at the position of their bit
+    uint16_t nMpdus;                          ///< the number of MPDUs in flight
+  };
+
   /**
    * typedef for a map between MAC address and block ACK agreement.
    */
   typedef std::map<std::pair<Mac48Address, uint8_t>,
-                   std::pair<OriginatorBlockAckAgreement, PacketQueue> > Agreements;
+                   std::pair<OriginatorBlockAckAgreement, Scoreboard> > Agreements;
   /**
    * typedef for an iterator for Agreements.
    */
   typedef std::map<std::pair<Mac48Address, uint8_t>,
-                   std::pair<OriginatorBlockAckAgreement, PacketQueue> >::iterator AgreementsI;
+                   std::pair<OriginatorBlockAckAgreement, Scoreboard> >::iterator AgreementsI;
   /**
    * typedef for a const iterator for Agreements.
    */
   typedef std::map<std::pair<Mac48Address, uint8_t>,
-                   std::pair<OriginatorBlockAckAgreement, PacketQueue> >::const_iterator AgreementsCI;
+                   std::pair<OriginatorBlockAckAgreement, Scoreboard> >::const_iterator AgreementsCI;
 
   /**
    * \param mpdu the packet to insert in the retransmission queue
+   * \param pos the position returned by the insertion of a packet with a lower
+   *        sequence number of the same agreement, to resume the search from
+   * \return the position to resume the search from when inserting a packet
+   *         with a higher sequence number of the same agreement
    *
    * Insert mpdu in retransmission queue.
    * This method ensures packets are retransmitted in the correct order.
    */
-  void InsertInRetryQueue (Ptr<WifiMacQueueItem> mpdu);
+  std::list<Ptr<WifiMacQueueItem> >::const_iterator
+  InsertInRetryQueue (Ptr<WifiMacQueueItem> mpdu, std::list<Ptr<WifiMacQueueItem> >::const_iterator pos);
 
   /**
    * Remove an item from retransmission queue.
@@ -499,9 +538,9 @@ private:
   void RemoveFromRetryQueue (Mac48Address address, uint8_t tid, uint16_t startSeq, uint16_t endSeq);
 
   /**
-   * This data structure contains, for each block ack agreement (recipient, tid), a set of packets
-   * for which an ack by block ack is requested.
-   * Every packet or fragment indicated as correctly received in block ack frame is
+   * This data structure contains, for each block ack agreement (recipient, tid), the
+   * scoreboard of the packets for which an ack by block ack is requested.
+   * Every packet indicated as correctly received in block ack frame is
    * erased from this data structure. Pushed back in retransmission queue otherwise.
    */
   Agreements m_agreements;
@@ -0,0 +1,270 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "block-ack-window.h"
+
+namespace ns3 {
+
+/// Size of the sequence number space
+static const uint16_t SEQNO_SPACE = 4096;
+/// Mask of the sequence number space
+static const uint16_t SEQNO_MASK = SEQNO_SPACE - 1;
+
+BlockAckWindow::BlockAckWindow ()
+  : m_mask (0),
+    m_winStart (0),
+    m_winSize (0)
+{
+}
+
+void
+BlockAckWindow::Init (uint16_t winStart, uint16_t winSize)
+{
+  NS_ASSERT (winSize > 0 && winSize <= SEQNO_SPACE);
+  // the bitmap size divides the sequence number space, hence the bit
+  // of a sequence number does not move when the sequence numbers wrap
+  uint16_t nBits = 64;
+  while (nBits < winSize)
+    {
+      nBits *= 2;
+    }
+  m_mask = nBits - 1;
+  m_words.assign (nBits / 64, 0);
+  m_winStart = winStart & SEQNO_MASK;
+  m_winSize = winSize;
+}
+
+uint16_t
+BlockAckWindow::GetWinStart (void) const
+{
+  return m_winStart;
+}
+
+uint16_t
+BlockAckWindow::GetWinEnd (void) const
+{
+  return (m_winStart + m_winSize - 1) & SEQNO_MASK;
+}
+
+uint16_t
+BlockAckWindow::GetWinSize (void) const
+{
+  return m_winSize;
+}
+
+uint16_t
+BlockAckWindow::GetDistance (uint16_t seq) const
+{
+  return (seq - m_winStart) & SEQNO_MASK;
+}
+
+bool
+BlockAckWindow::IsInWindow (uint16_t seq) const
+{
+  return GetDistance (seq) < m_winSize;
+}
+
+void
+BlockAckWindow::Clear (uint16_t pos, uint16_t count)
+{
+  if (count > m_mask)
+    {
+      m_words.assign (m_words.size (), 0);
+      return;
+    }
+  while (count > 0)
+    {
+      uint16_t bit = pos % 64;
+      uint16_t n = (count < 64 - bit) ? count : 64 - bit;
+      uint64_t mask = (n == 64) ? ~uint64_t (0) : ((uint64_t (1) << n) - 1) << bit;
+      m_words[pos / 64] &= ~mask;
+      pos = (pos + n) & m_mask;
+      count -= n;
+    }
+}
+
+void
+BlockAckWindow::Advance (uint16_t count)
+{
+  if (count == 0)
+    {
+      return;
+    }
+  // the bits past the end of the window are those entering it
+  uint16_t pos = (m_winStart + m_winSize) & m_mask;
+  if (count == 1)
+    {
+      // the window slides one MPDU at a time when receiving in order
+      m_words[pos / 64] &= ~(uint64_t (1) << (pos % 64));
+    }
+  else
+    {
+      Clear (pos, count);
+    }
+  m_winStart = (m_winStart + count) & SEQNO_MASK;
+}
+
+void
+BlockAckWindow::Set (uint16_t seq)
+{
+  NS_ASSERT (IsInWindow (seq));
+  uint16_t pos = seq & m_mask;
+  m_words[pos / 64] |= uint64_t (1) << (pos % 64);
+}
+
+void
+BlockAckWindow::Reset (uint16_t seq)
+{
+  NS_ASSERT (IsInWindow (seq));
+  uint16_t pos = seq & m_mask;
+  m_words[pos / 64] &= ~(uint64_t (1) << (pos % 64));
+}
+
+bool
+BlockAckWindow::IsSet (uint16_t seq) const
+{
+  if (!IsInWindow (seq))
+    {
+      return false;
+    }
+  uint16_t pos = seq & m_mask;
+  return (m_words[pos / 64] >> (pos % 64)) & 1;
+}
+
+uint16_t
+BlockAckWindow::GetNBits (void) const
+{
+  return m_mask + 1;
+}
+
+/**
+ * \param words consecutive bits
+ * \param nWords the number of words
+ * \param first the index of a bit, which can be negative or beyond the
+ *        last bit
+ * \return the 64 bits from the given one, zero for those out of the words
+ */
+static uint64_t
+GetBits (const uint64_t *words, std::size_t nWords, int32_t first)
+{
+  if (first < 0)
+    {
+      return first <= -64 ? 0 : GetBits (words, nWords, 0) << -first;
+    }
+  std::size_t w = first / 64;
+  uint16_t bit = first % 64;
+  if (w >= nWords)
+    {
+      return 0;
+    }
+  uint64_t bits = words[w] >> bit;
+  if (bit != 0 && w + 1 < nWords)
+    {
+      bits |= words[w + 1] << (64 - bit);
+    }
+  return bits;
+}
+
+void
+BlockAckWindow::Intersect (uint16_t from, const uint64_t *words, std::size_t nWords)
+{
+  // the index in the given bits of the start of the window
+  int32_t first = (m_winStart - from) & SEQNO_MASK;
+  if (first >= SEQNO_SPACE / 2)
+    {
+      first -= SEQNO_SPACE;
+    }
+  for (uint16_t distance = 0; distance < m_winSize; distance += 64)
+    {
+      uint64_t keep = GetBits (words, nWords, first + distance);
+      if (m_winSize - distance < 64)
+        {
+          // leave the bits past the end of the window alone
+          keep |= ~((uint64_t (1) << (m_winSize - distance)) - 1);
+        }
+      // the 64 bits may straddle two words of the circular bitmap
+      uint16_t pos = (m_winStart + distance) & m_mask;
+      uint16_t bit = pos % 64;
+      uint64_t below = (uint64_t (1) << bit) - 1;
+      m_words[pos / 64] &= (keep << bit) | below;
+      if (bit != 0)
+        {
+          m_words[(pos / 64 + 1) % m_words.size ()] &= (keep >> (64 - bit)) | ~below;
+        }
+    }
+}
+
+uint64_t
+BlockAckWindow::GetWord (int32_t distance) const
+{
+  if (distance <= -64 || distance >= m_winSize)
+    {
+      return 0;
+    }
+  // bits of the window from the given distance, or from the start of
+  // the window if the distance is negative
+  uint16_t first = distance < 0 ? 0 : distance;
+  uint16_t pos = (m_winStart + first) & m_mask;
+  uint16_t bit = pos % 64;
+  uint64_t word = m_words[pos / 64] >> bit;
+  if (bit != 0)
+    {
+      word |= m_words[(pos / 64 + 1) % m_words.size ()] << (64 - bit);
+    }
+  // drop the bits past the end of the window
+  if (m_winSize - first < 64)
+    {
+      word &= (uint64_t (1) << (m_winSize - first)) - 1;
+    }
+  return distance < 0 ? word << -distance : word;
+}
+
+void
+BlockAckWindow::GetBitmap (uint16_t from, uint64_t *words, std::size_t nWords) const
+{
+  int32_t distance = GetDistance (from);
+  if (distance >= SEQNO_SPACE / 2)
+    {
+      // the first sequence number is before the window
+      distance -= SEQNO_SPACE;
+    }
+  for (std::size_t w = 0; w < nWords; w++, distance += 64)
+    {
+      words[w] = GetWord (distance);
+    }
+}
+
+uint16_t
+BlockAckWindow::GetNextUnset (uint16_t distance) const
+{
+  while (distance < m_winSize)
+    {
+      uint64_t missing = ~GetWord (distance);
+      if (m_winSize - distance < 64)
+        {
+          missing &= (uint64_t (1) << (m_winSize - distance)) - 1;
+        }
+      if (missing != 0)
+        {
+          return distance + __builtin_ctzll (missing);
+        }
+      distance += 64;
+    }
+  return m_winSize;
+}
+
+} //namespace ns3
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BLOCK_ACK_WINDOW_H
+#define BLOCK_ACK_WINDOW_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Scoreboard of a Block Ack window
+ *
+ * One bit per sequence number of the window, kept in a circular bitmap
+ * of 64-bit words whose size is the smallest power of two, at least 64,
+ * holding the window. The bit of a sequence number is always at the
+ * same place, hence sliding the window only clears the bits entering
+ * it, and all the operations work a word at a time.
+ */
+class BlockAckWindow
+{
+public:
+  BlockAckWindow ();
+
+  /**
+   * Reset the window.
+   *
+   * \param winStart the starting sequence number of the window
+   * \param winSize the size of the window, from 1 to 4096
+   */
+  void Init (uint16_t winStart, uint16_t winSize);
+
+  /**
+   * \return the starting sequence number of the window
+   */
+  uint16_t GetWinStart (void) const;
+  /**
+   * \return the last sequence number of the window
+   */
+  uint16_t GetWinEnd (void) const;
+  /**
+   * \return the size of the window
+   */
+  uint16_t GetWinSize (void) const;
+  /**
+   * \param seq a sequence number
+   * \return the distance of the sequence number from the start of the
+   *         window, modulo the size of the sequence number space
+   */
+  uint16_t GetDistance (uint16_t seq) const;
+  /**
+   * \param seq a sequence number
+   * \return true if the given sequence number is in the window
+   */
+  bool IsInWindow (uint16_t seq) const;
+
+  /**
+   * Move the window forward, clearing the bits of the sequence numbers
+   * entering it.
+   *
+   * \param count the number of sequence numbers to move the window by
+   */
+  void Advance (uint16_t count);
+  /**
+   * Set the bit of a sequence number of the window.
+   *
+   * \param seq the sequence number
+   */
+  void Set (uint16_t seq);
+  /**
+   * Clear the bit of a sequence number of the window.
+   *
+   * \param seq the sequence number
+   */
+  void Reset (uint16_t seq);
+  /**
+   * \param seq a sequence number of the window
+   * \return true if the bit of the sequence number is set
+   */
+  bool IsSet (uint16_t seq) const;
+  /**
+   * Clear the bits of the window that are not set in the given bits of
+   * consecutive sequence numbers, laid out as by GetBitmap. The bits of
+   * the sequence numbers the given words do not cover are cleared.
+   *
+   * \param from the first sequence number of the given bits
+   * \param words the bits
+   * \param nWords the number of words
+   */
+  void Intersect (uint16_t from, const uint64_t *words, std::size_t nWords);
+  /**
+   * \return the number of bits of the circular bitmap: the bit of a
+   *         sequence number is at the sequence number modulo this size
+   */
+  uint16_t GetNBits (void) const;
+
+  /**
+   * Copy the bits of consecutive sequence numbers: bit i of word w is
+   * the bit of sequence number <i>from</i> + 64 * w + i, zero if that
+   * sequence number is out of the window.
+   *
+   * \param from the first sequence number
+   * \param words the words to fill
+   * \param nWords the number of words to fill
+   */
+  void GetBitmap (uint16_t from, uint64_t *words, std::size_t nWords) const;
+  /**
+   * \param distance a distance from the start of the window
+   * \return the distance from the start of the window of the first
+   *         sequence number, at or after the given distance, whose bit
+   *         is not set, or the size of the window if there is none
+   */
+  uint16_t GetNextUnset (uint16_t distance) const;
+
+private:
+  /**
+   * \param distance a distance from the start of the window, which can
+   *        be negative or beyond its end
+   * \return the bits of the 64 sequence numbers from the given distance,
+   *         zero for those out of the window
+   */
+  uint64_t GetWord (int32_t distance) const;
+  /**
+   * Clear bits of the circular bitmap.
+   *
+   * \param pos the position of the first bit
+   * \param count the number of bits
+   */
+  void Clear (uint16_t pos, uint16_t count);
+
+  std::vector<uint64_t> m_words; ///< the circular bitmap
+  uint16_t m_mask;               ///< the number of bits of the bitmap minus one
+  uint16_t m_winStart;           ///< window start
+  uint16_t m_winSize;            ///< window size
+};
+
+} //namespace ns3
+
+#endif /* BLOCK_ACK_WINDOW_H */
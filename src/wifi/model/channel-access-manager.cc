@@ -115,6 +115,9 @@ ChannelAccessManager::ChannelAccessManager ()
     m_lastSwitchingDuration (MicroSeconds (0)),
     m_sleeping (false),
     m_off (false),
+    m_accessTimeoutDue (Seconds (0.0)),
+    m_accessTimeoutWakeup (Seconds (0.0)),
+    m_pcfAccessTimeout (false),
     m_slot (Seconds (0.0)),
     m_sifs (Seconds (0.0)),
     m_phyListener (0)
@@ -270,11 +273,23 @@ ChannelAccessManager::RequestAccess (Ptr<Txop> state, bool isCfPeriod)
     {
       return;
     }
+  CatchUpAccessTimeout ();
   if (isCfPeriod)
     {
       state->NotifyAccessRequested ();
+      if (m_accessTimeout.IsRunning () && !m_pcfAccessTimeout
+          && m_accessTimeoutWakeup != m_accessTimeoutDue)
+        {
+          // the access timeout is no longer tracked: let it run when due
+          Simulator::Remove (m_accessTimeout);
+          Simulator::Schedule (m_accessTimeoutDue - Simulator::Now (),
+                               &ChannelAccessManager::AccessTimeout, this);
+        }
       Time delay = (MostRecent ({GetAccessGrantStart (true), Simulator::Now ()}) - Simulator::Now ());
       m_accessTimeout = Simulator::Schedule (delay, &ChannelAccessManager::DoGrantPcfAccess, this, state);
+      m_accessTimeoutDue = Simulator::Now () + delay;
+      m_accessTimeoutWakeup = m_accessTimeoutDue;
+      m_pcfAccessTimeout = true;
       return;
     }
   UpdateBackoff ();
@@ -381,6 +396,7 @@ void
 ChannelAccessManager::AccessTimeout (void)
 {
   NS_LOG_FUNCTION (this);
+  CatchUpAccessTimeout ();
   UpdateBackoff ();
   DoGrantDcfAccess ();
   DoRestartAccessTimeoutIfNeeded ();
@@ -390,8 +406,15 @@ Time
 ChannelAccessManager::GetAccessGrantStart (bool ignoreNav) const
 {
   NS_LOG_FUNCTION (this);
+  return GetAccessGrantStartAt (Simulator::Now (), ignoreNav);
+}
+
+Time
+ChannelAccessManager::GetAccessGrantStartAt (Time at, bool ignoreNav) const
+{
+  NS_LOG_FUNCTION (this << at << ignoreNav);
   Time rxAccessStart;
-  if (m_lastRxEnd <= Simulator::Now ())
+  if (m_lastRxEnd <= at)
     {
       rxAccessStart = m_lastRxEnd + m_sifs;
       if (!m_lastRxReceivedOk)
@@ -458,6 +481,34 @@ ChannelAccessManager::GetBackoffEndFor (Ptr<Txop> state)
   return GetBackoffStartFor (state) + (state->GetBackoffSlots () * m_slot);
 }
 
+Time
+ChannelAccessManager::GetBackoffEndAt (Ptr<Txop> state, Time at) const
+{
+  NS_LOG_FUNCTION (this << state << at);
+  Time backoffStart = MostRecent ({state->GetBackoffStart (),
+                                   GetAccessGrantStartAt (at) + (state->GetAifsn () * m_slot)});
+  return backoffStart + (state->GetBackoffSlots () * m_slot);
+}
+
+Time
+ChannelAccessManager::GetExpectedBackoffEnd (Time at) const
+{
+  NS_LOG_FUNCTION (this << at);
+  Time expectedBackoffEnd = Simulator::GetMaximumSimulationTime ();
+  for (States::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+    {
+      if ((*i)->IsAccessRequested ())
+        {
+          Time tmp = GetBackoffEndAt (*i, at);
+          if (tmp > at)
+            {
+              expectedBackoffEnd = std::min (expectedBackoffEnd, tmp);
+            }
+        }
+    }
+  return expectedBackoffEnd;
+}
+
 void
 ChannelAccessManager::UpdateBackoff (void)
 {
@@ -523,16 +574,78 @@ ChannelAccessManager::DoRestartAccessTimeoutIfNeeded (void)
       NS_LOG_DEBUG ("expected backoff end=" << expectedBackoffEnd);
       Time expectedBackoffDelay = expectedBackoffEnd - Simulator::Now ();
       if (m_accessTimeout.IsRunning ()
-          && Simulator::GetDelayLeft (m_accessTimeout) > expectedBackoffDelay)
+          && m_accessTimeoutDue - Simulator::Now () > expectedBackoffDelay)
         {
-          m_accessTimeout.Cancel ();
+          Simulator::Remove (m_accessTimeout);
         }
       if (m_accessTimeout.IsExpired ())
         {
-          m_accessTimeout = Simulator::Schedule (expectedBackoffDelay,
+          m_accessTimeoutDue = expectedBackoffEnd;
+          m_accessTimeoutWakeup = GetAccessTimeoutWakeup (expectedBackoffEnd);
+          m_pcfAccessTimeout = false;
+          m_accessTimeout = Simulator::Schedule (m_accessTimeoutWakeup - Simulator::Now (),
                                                  &ChannelAccessManager::AccessTimeout, this);
         }
     }
+  UpdateAccessTimeoutWakeup ();
+}
+
+Time
+ChannelAccessManager::GetAccessTimeoutWakeup (Time due) const
+{
+  NS_LOG_FUNCTION (this << due);
+  Time wakeup = due;
+  while (wakeup > Simulator::Now () && GetAccessGrantStartAt (wakeup) > wakeup)
+    {
+      Time next = GetExpectedBackoffEnd (wakeup);
+      if (next == Simulator::GetMaximumSimulationTime ())
+        {
+          // that run will stop the access timeout
+          break;
+        }
+      wakeup = next;
+    }
+  return wakeup;
+}
+
+void
+ChannelAccessManager::CatchUpAccessTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_accessTimeout.IsRunning () || m_pcfAccessTimeout)
+    {
+      return;
+    }
+  while (m_accessTimeoutDue < m_accessTimeoutWakeup && m_accessTimeoutDue <= Simulator::Now ())
+    {
+      // this run found the medium busy and only rescheduled the access timeout
+      Time next = GetExpectedBackoffEnd (m_accessTimeoutDue);
+      if (next == Simulator::GetMaximumSimulationTime ())
+        {
+          Simulator::Remove (m_accessTimeout);
+          return;
+        }
+      m_accessTimeoutDue = next;
+    }
+}
+
+void
+ChannelAccessManager::UpdateAccessTimeoutWakeup (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_accessTimeout.IsRunning () || m_pcfAccessTimeout)
+    {
+      return;
+    }
+  Time wakeup = GetAccessTimeoutWakeup (m_accessTimeoutDue);
+  if (wakeup != m_accessTimeoutWakeup)
+    {
+      NS_LOG_DEBUG ("access timeout due at " << m_accessTimeoutDue << " moved to " << wakeup);
+      Simulator::Remove (m_accessTimeout);
+      m_accessTimeoutWakeup = wakeup;
+      m_accessTimeout = Simulator::Schedule (wakeup - Simulator::Now (),
+                                             &ChannelAccessManager::AccessTimeout, this);
+    }
 }
 
 void
@@ -540,10 +653,12 @@ ChannelAccessManager::NotifyRxStartNow (Time duration)
 {
   NS_LOG_FUNCTION (this << duration);
   NS_LOG_DEBUG ("rx start for=" << duration);
+  CatchUpAccessTimeout ();
   UpdateBackoff ();
   m_lastRxStart = Simulator::Now ();
   m_lastRxDuration = duration;
   m_lastRxEnd = m_lastRxStart + m_lastRxDuration;
+  UpdateAccessTimeoutWakeup ();
 }
 
 void
@@ -551,9 +666,11 @@ ChannelAccessManager::NotifyRxEndOkNow (void)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_DEBUG ("rx end ok");
+  CatchUpAccessTimeout ();
   m_lastRxEnd = Simulator::Now ();
   m_lastRxDuration = m_lastRxEnd - m_lastRxStart;
   m_lastRxReceivedOk = true;
+  UpdateAccessTimeoutWakeup ();
 }
 
 void
@@ -561,15 +678,18 @@ ChannelAccessManager::NotifyRxEndErrorNow (void)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_DEBUG ("rx end error");
+  CatchUpAccessTimeout ();
   m_lastRxEnd = Simulator::Now ();
   m_lastRxDuration = m_lastRxEnd - m_lastRxStart;
   m_lastRxReceivedOk = false;
+  UpdateAccessTimeoutWakeup ();
 }
 
 void
 ChannelAccessManager::NotifyTxStartNow (Time duration)
 {
   NS_LOG_FUNCTION (this << duration);
+  CatchUpAccessTimeout ();
   if (m_lastRxEnd > Simulator::Now ())
     {
       //this may be caused only if PHY has started to receive a packet
@@ -583,6 +703,7 @@ ChannelAccessManager::NotifyTxStartNow (Time duration)
   UpdateBackoff ();
   m_lastTxStart = Simulator::Now ();
   m_lastTxDuration = duration;
+  UpdateAccessTimeoutWakeup ();
 }
 
 void
@@ -590,9 +711,11 @@ ChannelAccessManager::NotifyMaybeCcaBusyStartNow (Time duration)
 {
   NS_LOG_FUNCTION (this << duration);
   NS_LOG_DEBUG ("busy start for " << duration);
+  CatchUpAccessTimeout ();
   UpdateBackoff ();
   m_lastBusyStart = Simulator::Now ();
   m_lastBusyDuration = duration;
+  UpdateAccessTimeoutWakeup ();
 }
 
 void
@@ -737,6 +860,7 @@ ChannelAccessManager::NotifyNavResetNow (Time duration)
 {
   NS_LOG_FUNCTION (this << duration);
   NS_LOG_DEBUG ("nav reset for=" << duration);
+  CatchUpAccessTimeout ();
   UpdateBackoff ();
   m_lastNavStart = Simulator::Now ();
   m_lastNavDuration = duration;
@@ -755,6 +879,7 @@ ChannelAccessManager::NotifyNavStartNow (Time duration)
   NS_LOG_FUNCTION (this << duration);
   NS_ASSERT (m_lastNavStart <= Simulator::Now ());
   NS_LOG_DEBUG ("nav start for=" << duration);
+  CatchUpAccessTimeout ();
   UpdateBackoff ();
   Time newNavEnd = Simulator::Now () + duration;
   Time lastNavEnd = m_lastNavStart + m_lastNavDuration;
@@ -763,6 +888,7 @@ ChannelAccessManager::NotifyNavStartNow (Time duration)
       m_lastNavStart = Simulator::Now ();
       m_lastNavDuration = duration;
     }
+  UpdateAccessTimeoutWakeup ();
 }
 
 void
@@ -770,13 +896,16 @@ ChannelAccessManager::NotifyAckTimeoutStartNow (Time duration)
 {
   NS_LOG_FUNCTION (this << duration);
   NS_ASSERT (m_lastAckTimeoutEnd < Simulator::Now ());
+  CatchUpAccessTimeout ();
   m_lastAckTimeoutEnd = Simulator::Now () + duration;
+  UpdateAccessTimeoutWakeup ();
 }
 
 void
 ChannelAccessManager::NotifyAckTimeoutResetNow (void)
 {
   NS_LOG_FUNCTION (this);
+  CatchUpAccessTimeout ();
   m_lastAckTimeoutEnd = Simulator::Now ();
   DoRestartAccessTimeoutIfNeeded ();
 }
@@ -785,13 +914,16 @@ void
 ChannelAccessManager::NotifyCtsTimeoutStartNow (Time duration)
 {
   NS_LOG_FUNCTION (this << duration);
+  CatchUpAccessTimeout ();
   m_lastCtsTimeoutEnd = Simulator::Now () + duration;
+  UpdateAccessTimeoutWakeup ();
 }
 
 void
 ChannelAccessManager::NotifyCtsTimeoutResetNow (void)
 {
   NS_LOG_FUNCTION (this);
+  CatchUpAccessTimeout ();
   m_lastCtsTimeoutEnd = Simulator::Now ();
   DoRestartAccessTimeoutIfNeeded ();
 }
@@ -248,6 +248,16 @@ private:
    * \returns the absolute time at which access could start to be granted
    */
   Time GetAccessGrantStart (bool ignoreNav = false) const;
+  /**
+   * Same as GetAccessGrantStart, as evaluated at the given time if the
+   * state of the medium does not change until then.
+   *
+   * \param at the time of the evaluation, not in the past
+   * \param ignoreNav flag whether NAV should be ignored
+   *
+   * \returns the absolute time at which access could start to be granted
+   */
+  Time GetAccessGrantStartAt (Time at, bool ignoreNav = false) const;
   /**
    * Return the time when the backoff procedure
    * started for the given Txop.
@@ -266,9 +276,53 @@ private:
    * \return the time when the backoff procedure ended (or will ended)
    */
   Time GetBackoffEndFor (Ptr<Txop> state);
+  /**
+   * Same as GetBackoffEndFor, as evaluated at the given time if the
+   * state of the medium does not change until then.
+   *
+   * \param state
+   * \param at the time of the evaluation, not in the past
+   *
+   * \return the time when the backoff procedure ended (or will ended)
+   */
+  Time GetBackoffEndAt (Ptr<Txop> state, Time at) const;
+  /**
+   * \param at the time of the evaluation, not in the past
+   *
+   * \return the earliest backoff end after the given time among the
+   *         Txops which requested access, or the maximum simulation time
+   *         if there is none
+   */
+  Time GetExpectedBackoffEnd (Time at) const;
 
   void DoRestartAccessTimeoutIfNeeded (void);
 
+  /**
+   * A run of the access timeout while the medium is still busy, i.e.
+   * before the access grant start, neither updates the backoffs nor
+   * grants access: it only reschedules the access timeout at the
+   * earliest backoff end. The access timeout event is therefore
+   * scheduled at the first run which is not such a no-op, skipping the
+   * others, and moved whenever the state of the medium or of the Txops
+   * changes.
+   *
+   * \param due the time of the next run of the access timeout
+   *
+   * \return the time of the first run of the access timeout which is
+   *         not a no-op, if nothing changes in the meantime
+   */
+  Time GetAccessTimeoutWakeup (Time due) const;
+  /**
+   * Account for the runs of the access timeout skipped up to now.
+   * Called before the state changes.
+   */
+  void CatchUpAccessTimeout (void);
+  /**
+   * Move the access timeout event to the first run which is not a
+   * no-op. Called after the state changes.
+   */
+  void UpdateAccessTimeoutWakeup (void);
+
   /**
    * Called when access timeout should occur
    * (e.g. backoff procedure expired).
@@ -315,6 +369,9 @@ private:
   bool m_off;                   //!< flag whether it is in off state
   Time m_eifsNoDifs;            //!< EIFS no DIFS time
   EventId m_accessTimeout;      //!< the access timeout ID
+  Time m_accessTimeoutDue;      //!< the time of the next run of the access timeout, skipped or not
+  Time m_accessTimeoutWakeup;   //!< the time of the access timeout event
+  bool m_pcfAccessTimeout;      //!< flag whether the access timeout event grants PCF access
   Time m_slot;                  //!< the slot time
   Time m_sifs;                  //!< the SIFS time
   PhyListener* m_phyListener;   //!< the phy listener
@@ -776,6 +776,28 @@ CtrlBAckResponseHeader::GetExtendedCompressedBitmap (void) const
   return bitmap.m_extendedCompressedBitmap;
 }
 
+void
+CtrlBAckResponseHeader::SetCompressedBitmap (const uint64_t *words, std::size_t nWords)
+{
+  if (m_baType == COMPRESSED_BLOCK_ACK)
+    {
+      NS_ASSERT (nWords == 1);
+      bitmap.m_compressedBitmap = words[0];
+    }
+  else if (m_baType == EXTENDED_COMPRESSED_BLOCK_ACK)
+    {
+      NS_ASSERT (nWords == 4);
+      for (std::size_t i = 0; i < nWords; i++)
+        {
+          bitmap.m_extendedCompressedBitmap[i] = words[i];
+        }
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Only compressed block acks have a compressed bitmap");
+    }
+}
+
 void
 CtrlBAckResponseHeader::ResetBitmap (void)
 {
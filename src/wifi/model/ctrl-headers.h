@@ -355,6 +355,17 @@ public:
    */
   const uint64_t* GetExtendedCompressedBitmap (void) const;
 
+  /**
+   * Set the bitmap of a compressed or extended compressed block ACK:
+   * bit i of word w acknowledges the packet whose sequence number is the
+   * starting sequence number plus 64 * w + i.
+   *
+   * \param words the words of the bitmap
+   * \param nWords the number of words: 1 for a compressed block ACK,
+   *        4 for an extended compressed block ACK
+   */
+  void SetCompressedBitmap (const uint64_t *words, std::size_t nWords);
+
   /**
    * Reset the bitmap to 0.
    */
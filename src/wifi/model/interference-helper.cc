@@ -220,14 +220,20 @@ InterferenceHelper::AppendEvent (Ptr<Event> event)
 }
 
 double
-InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint16_t channelWidth) const
+InterferenceHelper::GetNoiseFloorW (uint16_t channelWidth) const
 {
   //thermal noise at 290K in J/s = W
   static const double BOLTZMANN = 1.3803e-23;
   //Nt is the power of thermal noise in W
   double Nt = BOLTZMANN * 290 * channelWidth * 1e6;
   //receiver noise Floor (W) which accounts for thermal noise and non-idealities of the receiver
-  double noiseFloor = m_noiseFigure * Nt;
+  return m_noiseFigure * Nt;
+}
+
+double
+InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint16_t channelWidth) const
+{
+  double noiseFloor = GetNoiseFloorW (channelWidth);
   double noise = noiseFloor + noiseInterference;
   double snr = signal / noise; //linear scale
   NS_LOG_DEBUG ("bandwidth(MHz)=" << channelWidth << ", signal(W)= " << signal << ", noise(W)=" << noiseFloor << ", interference(W)=" << noiseInterference << ", snr=" << RatioToDb(snr) << "dB");
@@ -235,7 +241,7 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint1
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event) const
 {
   double noiseInterferenceW = m_firstPower;
   auto it = m_niChanges.find (event->GetStartTime ());
@@ -243,14 +249,6 @@ InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni
     {
       noiseInterferenceW = it->second.GetPower () - event->GetRxPowerW ();
     }
-  it = m_niChanges.find (event->GetStartTime ());
-  for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
-  ni->emplace (event->GetStartTime (), NiChange (0, event));
-  while (++it != m_niChanges.end () && it->second.GetEvent () != event)
-    {
-      ni->insert (*it);
-    }
-  ni->emplace (event->GetEndTime (), NiChange (0, event));
   NS_ASSERT_MSG (noiseInterferenceW >= 0, "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
   return noiseInterferenceW;
 }
@@ -278,12 +276,11 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
 }
 
 double
-InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, NiChanges *ni, std::pair<Time, Time> window) const
+InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, std::pair<Time, Time> window) const
 {
   NS_LOG_FUNCTION (this << window.first << window.second);
   const WifiTxVector txVector = event->GetTxVector ();
-  double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
+  auto j = GetStartPosition (event);
   Time previous = j->first;
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = txVector.GetPreambleType ();
@@ -295,30 +292,37 @@ InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, NiChanges *ni,
   Time windowEnd = plcpPayloadStart + window.second;
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  //Skip the changes before the window, the interference at its start is
+  //the one after the last change before it
+  auto k = GetPreviousPosition (windowStart);
+  if (k != j)
+    {
+      noiseInterferenceW = k->second.GetPower () - powerW;
+      previous = k->first;
+      j = k;
+    }
+  //Gather the chunks of the window, then evaluate them all at once
+  m_chunkSeconds.clear ();
+  m_chunkInterferenceW.clear ();
+  //Walk the changes from the start of the event up to its end
+  bool end = false;
+  while (!end && ++j != m_niChanges.end ())
     {
+      end = (j->second.GetEvent () == event);
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
       //Case 1: Both previous and current point to the windowed payload
       if (previous >= windowStart)
         {
-          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                          noiseInterferenceW,
-                                                          txVector.GetChannelWidth ()),
-                                            current - previous,
-                                            payloadMode, txVector);
-          NS_LOG_DEBUG ("Both previous and current point to the windowed payload: mode=" << payloadMode << ", psr=" << psr);
+          m_chunkSeconds.push_back ((current - previous).GetSeconds ());
+          m_chunkInterferenceW.push_back (noiseInterferenceW);
         }
       //Case 2: previous is before windowed payload and current is in the windowed payload
       else if (current >= windowStart)
         {
-          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                          noiseInterferenceW,
-                                                          txVector.GetChannelWidth ()),
-                                            current - windowStart,
-                                            payloadMode, txVector);
-          NS_LOG_DEBUG ("previous is before windowed payload and current is in the windowed payload: mode=" << payloadMode << ", psr=" << psr);
+          m_chunkSeconds.push_back ((current - windowStart).GetSeconds ());
+          m_chunkInterferenceW.push_back (noiseInterferenceW);
         }
       noiseInterferenceW = j->second.GetPower () - powerW;
       previous = j->first;
@@ -329,17 +333,58 @@ InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, NiChanges *ni,
         }
 
     }
+  double psr = CalculateChunksSuccessRate (powerW, payloadMode, txVector); /* Packet Success Rate */
+  NS_LOG_DEBUG ("mode=" << payloadMode << ", chunks=" << m_chunkSeconds.size () << ", psr=" << psr);
   double per = 1 - psr;
   return per;
 }
 
 double
-InterferenceHelper::CalculateLegacyPhyHeaderPer (Ptr<const Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateChunksSuccessRate (double powerW, WifiMode mode, const WifiTxVector &txVector) const
+{
+  std::size_t nChunks = m_chunkSeconds.size ();
+  if (nChunks == 0)
+    {
+      return 1.0;
+    }
+  //as CalculateSnr and CalculateChunkSuccessRate, once for all the chunks
+  double noiseFloorW = GetNoiseFloorW (txVector.GetChannelWidth ());
+  uint64_t rate = mode.GetDataRate (txVector);
+  uint8_t nss = 1;
+  double gain = 1;
+  WifiModulationClass modulation = txVector.GetMode ().GetModulationClass ();
+  if (modulation == WIFI_MOD_CLASS_HT || modulation == WIFI_MOD_CLASS_VHT || modulation == WIFI_MOD_CLASS_HE)
+    {
+      nss = txVector.GetNss ();
+      gain = (txVector.GetNTx () * m_numRxAntennas);
+    }
+  m_chunkSnrs.resize (nChunks);
+  const double *interferenceW = m_chunkInterferenceW.data ();
+  double *snrs = m_chunkSnrs.data ();
+  for (std::size_t i = 0; i < nChunks; i++)
+    {
+      snrs[i] = powerW / (noiseFloorW + interferenceW[i]) * gain;
+    }
+  double psr = 1.0;
+  for (std::size_t i = 0; i < nChunks; i++)
+    {
+      if (m_chunkSeconds[i] == 0)
+        {
+          continue;
+        }
+      uint64_t nbits = static_cast<uint64_t> (rate * m_chunkSeconds[i]) / nss;
+      psr *= m_errorRateModel->GetChunkSuccessRate (mode, txVector, snrs[i], nbits);
+    }
+  return psr;
+}
+
+double
+InterferenceHelper::CalculateLegacyPhyHeaderPer (Ptr<const Event> event) const
 {
   NS_LOG_FUNCTION (this);
   const WifiTxVector txVector = event->GetTxVector ();
   double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
+  auto j = GetStartPosition (event);
   Time previous = j->first;
   WifiPreamble preamble = txVector.GetPreambleType ();
   WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (txVector);
@@ -349,8 +394,11 @@ InterferenceHelper::CalculateLegacyPhyHeaderPer (Ptr<const Event> event, NiChang
   Time plcpPayloadStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (txVector) + WifiPhy::GetPlcpSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A + Training + SIG-B
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  //Walk the changes from the start of the event up to its end
+  bool end = false;
+  while (!end && ++j != m_niChanges.end ())
     {
+      end = (j->second.GetEvent () == event);
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
@@ -478,12 +526,12 @@ InterferenceHelper::CalculateLegacyPhyHeaderPer (Ptr<const Event> event, NiChang
 }
 
 double
-InterferenceHelper::CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event) const
 {
   NS_LOG_FUNCTION (this);
   const WifiTxVector txVector = event->GetTxVector ();
   double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
+  auto j = GetStartPosition (event);
   Time previous = j->first;
   WifiPreamble preamble = txVector.GetPreambleType ();
   WifiMode mcsHeaderMode;
@@ -509,8 +557,11 @@ InterferenceHelper::CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, NiCh
   Time plcpPayloadStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (txVector) + WifiPhy::GetPlcpSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A + Training + SIG-B
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  //Walk the changes from the start of the event up to its end
+  bool end = false;
+  while (!end && ++j != m_niChanges.end ())
     {
+      end = (j->second.GetEvent () == event);
       Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
@@ -849,8 +900,7 @@ InterferenceHelper::CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, NiCh
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, std::pair<Time, Time> relativeMpduStartStop) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -858,7 +908,7 @@ InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, std::pair<Time, Ti
   /* calculate the SNIR at the start of the MPDU (located through windowing) and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePayloadPer (event, &ni, relativeMpduStartStop);
+  double per = CalculatePayloadPer (event, relativeMpduStartStop);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -866,11 +916,23 @@ InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, std::pair<Time, Ti
   return snrPer;
 }
 
+struct InterferenceHelper::SnrPer
+InterferenceHelper::CalculateNoInterferenceSnrPer (double rxPowerW, WifiTxVector txVector, uint32_t size) const
+{
+  NS_LOG_FUNCTION (this << rxPowerW << size);
+  double snr = CalculateSnr (rxPowerW, 0, txVector.GetChannelWidth ());
+  double psr = m_errorRateModel->GetChunkSuccessRate (txVector.GetMode (), txVector, snr, size * 8);
+
+  struct SnrPer snrPer;
+  snrPer.snr = snr;
+  snrPer.per = 1 - psr;
+  return snrPer;
+}
+
 double
 InterferenceHelper::CalculateSnr (Ptr<Event> event) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -880,8 +942,7 @@ InterferenceHelper::CalculateSnr (Ptr<Event> event) const
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculateLegacyPhyHeaderSnrPer (Ptr<Event> event) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -889,7 +950,7 @@ InterferenceHelper::CalculateLegacyPhyHeaderSnrPer (Ptr<Event> event) const
   /* calculate the SNIR at the start of the plcp header and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculateLegacyPhyHeaderPer (event, &ni);
+  double per = CalculateLegacyPhyHeaderPer (event);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -900,8 +961,7 @@ InterferenceHelper::CalculateLegacyPhyHeaderSnrPer (Ptr<Event> event) const
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculateNonLegacyPhyHeaderSnrPer (Ptr<Event> event) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -909,7 +969,7 @@ InterferenceHelper::CalculateNonLegacyPhyHeaderSnrPer (Ptr<Event> event) const
   /* calculate the SNIR at the start of the plcp header and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculateNonLegacyPhyHeaderPer (event, &ni);
+  double per = CalculateNonLegacyPhyHeaderPer (event);
   
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -943,6 +1003,14 @@ InterferenceHelper::GetPreviousPosition (Time moment) const
   return it;
 }
 
+InterferenceHelper::NiChanges::const_iterator
+InterferenceHelper::GetStartPosition (Ptr<const Event> event) const
+{
+  auto it = m_niChanges.find (event->GetStartTime ());
+  for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it);
+  return it;
+}
+
 InterferenceHelper::NiChanges::iterator
 InterferenceHelper::AddNiChangeEvent (Time moment, NiChange change)
 {
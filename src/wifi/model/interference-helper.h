@@ -24,6 +24,7 @@
 #include "ns3/nstime.h"
 #include "wifi-tx-vector.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -136,6 +137,15 @@ public:
    * \return Error rate model
    */
   Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+  /**
+   * Return the noise floor of the receiver, i.e. the thermal noise over
+   * the given width amplified by the noise figure.
+   *
+   * \param channelWidth signal width in MHz
+   *
+   * \return the noise floor in W
+   */
+  double GetNoiseFloorW (uint16_t channelWidth) const;
   /**
    * Set the number of RX antennas in the receiver corresponding to this
    * interference helper.
@@ -201,6 +211,18 @@ public:
    * \return struct of SNR and PER
    */
   struct InterferenceHelper::SnrPer CalculateLegacyPhyHeaderSnrPer (Ptr<Event> event) const;
+  /**
+   * Calculate the SNR and the PER of a frame received in the absence of
+   * any interference, i.e. against the noise floor alone.  The PER covers
+   * the whole frame, which is assumed to be sent in the payload mode.
+   *
+   * \param rxPowerW the received power in W
+   * \param txVector the TXVECTOR used to send the frame
+   * \param size the size of the frame in bytes
+   *
+   * \return struct of SNR and PER
+   */
+  struct InterferenceHelper::SnrPer CalculateNoInterferenceSnrPer (double rxPowerW, WifiTxVector txVector, uint32_t size) const;
   /**
    * Calculate the SNIR at the start of the non-legacy PHY header and accumulate
    * all SNIR changes in the snir vector.
@@ -279,11 +301,10 @@ private:
    * Calculate noise and interference power in W.
    *
    * \param event
-   * \param ni
    *
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    *
@@ -311,33 +332,47 @@ private:
    * window (thus enabling per MPDU PER information). The PLCP payload can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
+   * The changes over the event are read in place from m_niChanges.
+   *
    * \param event
-   * \param ni
    * \param window time window (pair of start and end times) of PLCP payload to focus on
    *
    * \return the error rate of the payload
    */
-  double CalculatePayloadPer (Ptr<const Event> event, NiChanges *ni, std::pair<Time, Time> window) const;
+  double CalculatePayloadPer (Ptr<const Event> event, std::pair<Time, Time> window) const;
+  /**
+   * Calculate the success rate of the chunks gathered in m_chunkSeconds and
+   * m_chunkInterferenceW.  The values which only depend on the frame (noise
+   * floor, rate, MIMO gain) are computed once, then the SINRs of all the
+   * chunks in one pass over the flat arrays, then their success rates.
+   * The result is the same as the product of CalculateChunkSuccessRate
+   * over the chunks.
+   *
+   * \param powerW the received power of the frame in W
+   * \param mode the mode of the payload
+   * \param txVector the TXVECTOR of the frame
+   *
+   * \return the success rate of the chunks
+   */
+  double CalculateChunksSuccessRate (double powerW, WifiMode mode, const WifiTxVector &txVector) const;
   /**
    * Calculate the error rate of the legacy PHY header. The legacy PHY header
    * can be divided into multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
    *
    * \return the error rate of the legacy PHY header
    */
-  double CalculateLegacyPhyHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculateLegacyPhyHeaderPer (Ptr<const Event> event) const;
   /**
    * Calculate the error rate of the non-legacy PHY header. The non-legacy PHY header
    * can be divided into multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
    *
    * \return the error rate of the non-legacy PHY header
    */
-  double CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculateNonLegacyPhyHeaderPer (Ptr<const Event> event) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel; ///< error rate model
@@ -347,6 +382,10 @@ private:
   double m_firstPower; ///< first power
   bool m_rxing; ///< flag whether it is in receiving state
 
+  mutable std::vector<double> m_chunkSeconds;       ///< durations (s) of the chunks of the payload window being evaluated
+  mutable std::vector<double> m_chunkInterferenceW; ///< interference powers (W) of the chunks of the payload window being evaluated
+  mutable std::vector<double> m_chunkSnrs;          ///< SINRs of the chunks of the payload window being evaluated
+
   /**
    * Returns an iterator to the first nichange that is later than moment
    *
@@ -368,6 +407,13 @@ private:
    * \returns an iterator to the list of NiChanges
    */
   NiChanges::const_iterator GetPreviousPosition (Time moment) const;
+  /**
+   * Returns an iterator to the nichange that records the start of the event
+   *
+   * \param event the event
+   * \returns an iterator to the nichange of the start of the event
+   */
+  NiChanges::const_iterator GetStartPosition (Ptr<const Event> event) const;
 
   /**
    * Add NiChange to the list at the appropriate position and
@@ -30,7 +30,6 @@
 #include "wifi-net-device.h"
 #include "he-configuration.h"
 #include "ns3/internet-module.h"
-// #include "ns3/aodv-module.h"
 
 namespace ns3 {
 
@@ -51,9 +50,10 @@ MeshObssPdAlgorithm::GetTypeId (void)
     .SetGroupName ("Wifi")
     .AddConstructor<MeshObssPdAlgorithm> ()
     .AddAttribute ("GatewayAddress",
-                  "The Ipv4 Address of gateway node.",
+                  "The Ipv4 Address of gateway node, used when the routing protocol "
+                  "does not give the next hop through SetNextHopCallback.",
                   Ipv4AddressValue("10.2.1.1"),
-                  MakeIpv4AddressAccessor (&MeshObssPdAlgorithm::gatewayAddr),
+                  MakeIpv4AddressAccessor (&MeshObssPdAlgorithm::m_gateway),
                   MakeIpv4AddressChecker())
   ;
   return tid;
@@ -68,17 +68,72 @@ MeshObssPdAlgorithm::ConnectWifiNetDevice (const Ptr<WifiNetDevice> device)
 }
 
 void
-MeshObssPdAlgorithm::ReceiveHeSig (HePreambleParameters params)
+MeshObssPdAlgorithm::SetNextHopCallback (NextHopCallback cb)
 {
-  NS_LOG_FUNCTION (this << +params.dst << +params.src<< WToDbm (params.rssiW) <<Simulator::Now());
+  NS_LOG_FUNCTION (this);
+  m_nextHop = cb;
+}
 
-  std::cout<< "Dst "<<(int)params.dst <<" Src "<< (int)params.src<< "  Power " << +params.txpower<< " Duration" << +params.time<< "  Mcs "<< +params.mcs <<std::endl;
+Mac48Address
+MeshObssPdAlgorithm::GetIpv4NextHop (Ptr<WifiNetDevice> device, Ipv4Address gateway)
+{
+  NS_LOG_FUNCTION (device << gateway);
+  Ptr<Ipv4L3Protocol> ipv4 = device->GetNode ()->GetObject<Ipv4L3Protocol> ();
+  int32_t interface = ipv4 ? ipv4->GetInterfaceForDevice (device) : -1;
+  if (interface < 0)
+    {
+      NS_LOG_DEBUG ("No IPv4 interface");
+      return Mac48Address::GetBroadcast ();
+    }
+  Ipv4Header ipHead;
+  ipHead.SetDestination (gateway);
+  ipHead.SetSource (ipv4->GetAddress (interface, 0).GetLocal ());
+  Socket::SocketErrno err;
+  Ptr<Ipv4Route> routeEntry = ipv4->GetRoutingProtocol ()->RouteOutput (Create<Packet> (), ipHead, device, err);
+  if (err != Socket::ERROR_NOTERROR || routeEntry == 0)
+    {
+      NS_LOG_DEBUG ("No route to " << gateway);
+      return Mac48Address::GetBroadcast ();
+    }
+  Ipv4Address nextHop = routeEntry->GetGateway ();
+  //AODV defers the route discoveries through the loopback
+  if (Ipv4Mask ("255.0.0.0").IsMatch (nextHop, Ipv4Address::GetLoopback ()))
+    {
+      NS_LOG_DEBUG ("Route to " << gateway << " is being discovered");
+      return Mac48Address::GetBroadcast ();
+    }
+  if (nextHop == Ipv4Address::GetAny ())
+    {
+      nextHop = gateway;
+    }
+  Ptr<ArpCache> arpCache = ipv4->GetInterface (interface)->GetArpCache ();
+  ArpCache::Entry *entry = arpCache ? arpCache->Lookup (nextHop) : 0;
+  if (entry == 0 || !(entry->IsAlive () || entry->IsPermanent ()))
+    {
+      NS_LOG_DEBUG ("Next hop " << nextHop << " is not resolved");
+      return Mac48Address::GetBroadcast ();
+    }
+  return Mac48Address::ConvertFrom (entry->GetMacAddress ());
+}
 
+Mac48Address
+MeshObssPdAlgorithm::GetNextHop (void) const
+{
+  if (!m_nextHop.IsNull ())
+    {
+      return m_nextHop (m_device->GetIfIndex ());
+    }
+  return GetIpv4NextHop (m_device, m_gateway);
+}
+
+bool
+MeshObssPdAlgorithm::IsObss (HePreambleParameters params)
+{
   Ptr<StaWifiMac> mac = m_device->GetMac ()->GetObject<StaWifiMac>();
   if (mac && !mac->IsAssociated ())
     {
       NS_LOG_DEBUG ("This is not an associated STA: skip OBSS PD algorithm");
-      return;
+      return false;
     }
 
   Ptr<HeConfiguration> heConfiguration = m_device->GetHeConfiguration ();
@@ -87,66 +142,40 @@ MeshObssPdAlgorithm::ReceiveHeSig (HePreambleParameters params)
   heConfiguration->GetAttribute ("BssColor", bssColorAttribute);
   uint8_t bssColor = bssColorAttribute.Get ();
 
-  //####
-  //set bsscolor as self mac address(last number)
-  uint8_t addrs[6]; // self mac
-  uint8_t addrs2[4]; // nexthop ip
-
-  m_device->GetMac()->GetAddress().CopyTo(addrs);
-  Ptr<Ipv4RoutingProtocol> aodvRouting;
-  aodvRouting = Ipv4RoutingHelper::GetRouting <Ipv4RoutingProtocol> (m_device->GetNode()->GetObject<Ipv4> ()->GetRoutingProtocol ());
-  // aodvRouting = m_device->GetNode()->GetObject<Ipv4> ()->GetRoutingProtocol ();
-  Ipv4Address sourceAddr = m_device->GetNode()->GetObject<Ipv4> ()->GetAddress(1,0).GetLocal();
-  Ipv4Header ipHead;
-  ipHead.SetDestination(gatewayAddr);
-  ipHead.SetSource(sourceAddr);
-  Socket::SocketErrno err;
-  Packet ptemp;
-  Ptr<Ipv4Route> routeEntry = aodvRouting->RouteOutput(&ptemp, ipHead, m_device, err);
-
-
-
   if (bssColor == 0)
     {
       NS_LOG_DEBUG ("BSS color is 0");
-      return;
+      return false;
     }
   NS_LOG_DEBUG("params.bsscolor= "<<+params.bssColor);
   if (params.bssColor == 0)
     {
       NS_LOG_DEBUG ("Received BSS color is 0");
-      std::cout<<"may be beacon"<<std::endl;
-      return;
+      return false;
     }
   //TODO: SRP_AND_NON-SRG_OBSS-PD_PROHIBITED=1 => OBSS_PD SR is not allowed
 
-  // bool isObss = (bssColor != params.bssColor);
-  bool isObss = false;
-  // std::cout<<err;
-
-  if(!err)
-  {
-      NS_LOG_DEBUG("gatewayAddr= "<<gatewayAddr<<"  myAddr= "<<sourceAddr<<"  nextHop= "<<routeEntry->GetGateway() );
-      routeEntry->GetGateway().Serialize(addrs2);
-
-      uint8_t dstMac, srcMac;
-      dstMac = params.dst;
-      srcMac = params.src;
-      if(dstMac!=addrs[5] && dstMac!=addrs2[3] && srcMac!=addrs2[3] && addrs2[0]!=127 )
-      {
-        NS_LOG_DEBUG("dst Mac= "<<(int)dstMac <<"  src Mac="<<(int)srcMac<< "  Is Obss!!");
-        isObss = true;
-      }
-  }
-  else
-  {
-    NS_LOG_DEBUG("gatewayAddr= "<<gatewayAddr<<"  myAddr= "<<sourceAddr<<"  error routing , no nexthop");  
-  }
-  
-
-  // isObss = false;
-
-  if (isObss)
+  Mac48Address nextHop = GetNextHop ();
+  uint16_t nextHopId = nextHop.IsGroup () ? NO_NODE_ID : GetNodeIdOfAddress (nextHop);
+  if (nextHopId == NO_NODE_ID)
+    {
+      NS_LOG_DEBUG ("No next hop towards the gateway, compare the BSS colors");
+      return (bssColor != params.bssColor);
+    }
+  //The preamble carries the node IDs of the receiver and transmitter
+  uint16_t nodeId = m_device->GetNode ()->GetId ();
+  NS_LOG_DEBUG ("myNode= " << nodeId << "  nextHop= " << nextHop << " (node " << nextHopId << ")");
+  return (params.dst != nodeId && params.dst != nextHopId && params.src != nextHopId);
+}
+
+void
+MeshObssPdAlgorithm::ReceiveHeSig (HePreambleParameters params)
+{
+  NS_LOG_FUNCTION (this << params.dst << params.src << WToDbm (params.rssiW) << Simulator::Now ());
+  NS_LOG_DEBUG ("Dst " << params.dst << " Src " << params.src << " Power " << params.txPowerDbm
+                << " Duration " << params.duration << " Mcs " << +params.mcs);
+
+  if (IsObss (params))
     {
       if (WToDbm (params.rssiW) < m_obssPdLevel)
         {
@@ -162,8 +191,6 @@ MeshObssPdAlgorithm::ReceiveHeSig (HePreambleParameters params)
     {
       NS_LOG_DEBUG("Not obss");
     }
-    
-    NS_LOG_DEBUG("");
 }
 
 } //namespace ns3
@@ -19,8 +19,11 @@
  */
 
 #include "ns3/log.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
 #include "obss-wifi-manager.h"
 #include "wifi-phy.h"
+#include "error-rate-model.h"
 
 namespace ns3 {
 /**
@@ -40,7 +43,13 @@ struct ObssWifiRemoteStation : public WifiRemoteStation
 /// To avoid using the cache before a valid value has been cached
 static const double CACHE_INITIAL_VALUE = -100;
 
-static ObssWifiManager::PathLossPairs globalLossPairs; // (dst+src, loss)
+const double ObssWifiManager::UNKNOWN_PATH_LOSS = 1; // loss must be negative
+
+static std::vector<ObssWifiManager::PathLosses> g_pathLosses; // path losses, indexed by the node ID of the receiver
+
+static const double GOODPUT_SINR_MIN = -10;      // lowest SINR (dB) of the goodput tables
+static const double GOODPUT_SINR_STEP = 0.5;     // SINR step (dB) of the goodput tables
+static const std::size_t GOODPUT_SINR_COUNT = 141; // SINRs of the goodput tables, up to 60 dB
 
 NS_OBJECT_ENSURE_REGISTERED (ObssWifiManager);
 
@@ -58,6 +67,26 @@ ObssWifiManager::GetTypeId (void)
                    DoubleValue (1e-5),
                    MakeDoubleAccessor (&ObssWifiManager::m_ber),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("GatewayAddress",
+                   "The Ipv4 Address of gateway node, used when the routing protocol "
+                   "does not give the next hop through SetNextHopCallback.",
+                   Ipv4AddressValue ("10.2.1.1"),
+                   MakeIpv4AddressAccessor (&ObssWifiManager::m_gateway),
+                   MakeIpv4AddressChecker ())
+    .AddAttribute ("ObssPolicy",
+                   "The selection of the TX power and MCS of the frames to the next hop: "
+                   "Ideal picks the MCS of the last SNR at the default TX power, Joint picks "
+                   "the TX power and HE MCS which maximize the expected goodput of these "
+                   "frames and of the active OBSS transmissions.",
+                   EnumValue (ObssWifiManager::OBSS_POLICY_IDEAL),
+                   MakeEnumAccessor (&ObssWifiManager::m_policy),
+                   MakeEnumChecker (ObssWifiManager::OBSS_POLICY_IDEAL, "Ideal",
+                                    ObssWifiManager::OBSS_POLICY_JOINT, "Joint"))
+    .AddAttribute ("FrameSize",
+                   "The frame size (bytes) of the expected goodput of the Joint policy.",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&ObssWifiManager::m_frameSize),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddTraceSource ("Rate",
                      "Traced value for rate changes (b/s)",
                      MakeTraceSourceAccessor (&ObssWifiManager::m_currentRate),
@@ -67,7 +96,11 @@ ObssWifiManager::GetTypeId (void)
 }
 
 ObssWifiManager::ObssWifiManager ()
-  : m_currentRate (0)
+  : m_currentRate (0),
+    m_obssRestricted (false),
+    m_obssPowerLimit (0),
+    m_obssMcsLimit (0),
+    m_goodputWidth (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -84,6 +117,13 @@ ObssWifiManager::SetupPhy (const Ptr<WifiPhy> phy)
   WifiRemoteStationManager::SetupPhy (phy);
 }
 
+void
+ObssWifiManager::SetNextHopCallback (MeshObssPdAlgorithm::NextHopCallback cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_nextHop = cb;
+}
+
 uint16_t
 ObssWifiManager::GetChannelWidthForMode (WifiMode mode) const
 {
@@ -178,14 +218,18 @@ ObssWifiManager::DoInitialize ()
         }
     }
   
+  if (GetHeSupported ())
+    {
+      BuildGoodputTables ();
+    }
+
   //######
   // connect end of preamble trace source
   GetPhy()->TraceConnectWithoutContext ("EndOfHePreamble", MakeCallback (&ObssWifiManager::ReceiveHeSig, this));
   m_device = DynamicCast<WifiNetDevice> (GetPhy()->GetDevice());
   m_obssRestricted = false;
-  uint8_t mymac[6];
-  m_device->GetMac()->GetAddress().CopyTo(mymac);
-  m_myMac = mymac[5];
+  m_nodeId = m_device->GetNode ()->GetId ();
+  m_nextHopId = NO_NODE_ID;
 
 }
 
@@ -266,7 +310,7 @@ ObssWifiManager::DoReportDataOk (WifiRemoteStation *st,
                                   double ackSnr, WifiMode ackMode, double dataSnr)
 {
   NS_LOG_FUNCTION (this << st << ackSnr << ackMode.GetUniqueName () << dataSnr);
-  std::cout<<"myMac: "<< +m_myMac <<" nexthop: "<< +m_nexthopMac<< " dataSnr:  "<< WToDbm(dataSnr) << std::endl;
+  NS_LOG_DEBUG ("myMac: " << m_nodeId << " nexthop: " << m_nextHopId << " dataSnr:  " << WToDbm(dataSnr));
 
   ObssWifiRemoteStation *station = (ObssWifiRemoteStation *)st;
   if (dataSnr == 0)
@@ -514,13 +558,25 @@ ObssWifiManager::DoGetDataTxVector (WifiRemoteStation *st)
     {
       guardInterval = 800;
     }
+  uint8_t txPowerLevel = GetDefaultTxPowerLevel ();
+  //The frames to the next hop use the TX power and MCS selected against
+  //the active OBSS transmissions, until they end
+  if (m_policy == OBSS_POLICY_JOINT && m_obssRestricted && Simulator::Now () < m_obssRestrictedUntil
+      && maxMode.GetModulationClass () == WIFI_MOD_CLASS_HE && channelWidth == m_goodputWidth
+      && GetNodeIdOfAddress (GetAddress (station)) == m_nextHopId)
+    {
+      NS_LOG_DEBUG ("OBSS restricted: TX power level " << +m_obssPowerLimit << " MCS " << +m_obssMcsLimit);
+      maxMode = m_heModes[m_obssMcsLimit];
+      selectedNss = 1;
+      txPowerLevel = m_obssPowerLimit;
+    }
   if (m_currentRate != maxMode.GetDataRate (channelWidth, guardInterval, selectedNss))
     {
       NS_LOG_DEBUG ("New datarate: " << maxMode.GetDataRate (channelWidth, guardInterval, selectedNss));
       m_currentRate = maxMode.GetDataRate (channelWidth, guardInterval, selectedNss);
     }
 
-  return WifiTxVector (maxMode, GetDefaultTxPowerLevel (), GetPreambleForTransmission (maxMode.GetModulationClass (), GetShortPreambleEnabled (), UseGreenfieldForDestination (GetAddress (station))), guardInterval, GetNumberOfAntennas (), selectedNss, 0, GetChannelWidthForTransmission (maxMode, channelWidth), GetAggregation (station), false);
+  return WifiTxVector (maxMode, txPowerLevel, GetPreambleForTransmission (maxMode.GetModulationClass (), GetShortPreambleEnabled (), UseGreenfieldForDestination (GetAddress (station))), guardInterval, GetNumberOfAntennas (), selectedNss, 0, GetChannelWidthForTransmission (maxMode, channelWidth), GetAggregation (station), false);
 }
 
 WifiTxVector
@@ -563,54 +619,70 @@ ObssWifiManager::IsLowLatency (void) const
 void
 ObssWifiManager::UpdatePathLoss(HePreambleParameters params)
 {
-  NS_LOG_FUNCTION (this<< +m_myMac);
+  NS_LOG_FUNCTION (this<< m_nodeId);
 
-  double loss = WToDbm(params.rssiW) - params.txpower/10.0 ; // negative value(dbm)
+  if (params.src == NO_NODE_ID)
+    {
+      return;
+    }
+  double loss = WToDbm(params.rssiW) - params.txPowerDbm ; // negative value(dbm)
 
   //TO DO: more complex updating method
-    for (PathLossPairs::const_iterator i = m_lossPairs.begin (); i != m_lossPairs.end (); i++)
+  if (params.src < m_pathLosses.size () && m_pathLosses[params.src] != UNKNOWN_PATH_LOSS)
     {
-      if(params.src == i->first)
-      {
-        if(i->second != loss)
+      if (m_pathLosses[params.src] != loss)
         {
-          std::cout<<"different loss, old: "<< i->second << " new: "<< loss<< std::endl; 
+          NS_LOG_DEBUG ("different loss, old: " << m_pathLosses[params.src] << " new: " << loss);
         }
-        return;
-      }
+      return;
     }
 
-    // no match
-    m_lossPairs.push_back(std::make_pair(params.src, loss));
-    std::cout<<"Node mac "<< +m_myMac << " pushed src="<< +params.src <<" loss= "<<loss<<std::endl;
+  // no match
+  if (params.src >= m_pathLosses.size ())
+    {
+      m_pathLosses.resize (params.src + 1, UNKNOWN_PATH_LOSS);
+    }
+  m_pathLosses[params.src] = loss;
+  NS_LOG_DEBUG ("Node " << m_nodeId << " pushed src=" << params.src << " loss= " << loss);
 
-    // update global loss pairs
+  // update global path losses
+  if (SetPathLoss (m_nodeId, params.src, loss))
+    {
+      NS_LOG_DEBUG ("Global pushed : dst= " << m_nodeId << "  src=" << params.src << " loss= " << loss);
+    }
+}
 
-    for (PathLossPairs::const_iterator i = globalLossPairs.begin (); i != globalLossPairs.end (); i++)
+bool
+ObssWifiManager::SetPathLoss (uint16_t dst, uint16_t src, double loss)
+{
+  if (dst >= g_pathLosses.size ())
     {
-      uint8_t i_dst = i->first / (1<<8);
-      uint8_t i_src = i->first % (1<<8);
-      if(params.src == i_src && m_myMac == i_dst )
-      {
-        if(i->second != loss)
+      g_pathLosses.resize (dst + 1);
+    }
+  PathLosses &losses = g_pathLosses[dst];
+  if (src >= losses.size ())
+    {
+      losses.resize (src + 1, UNKNOWN_PATH_LOSS);
+    }
+  if (losses[src] != UNKNOWN_PATH_LOSS)
+    {
+      if (losses[src] != loss)
         {
-          std::cout<<"global different loss, old: "<< i->second << " new: "<< loss<< std::endl; 
+          NS_LOG_DEBUG ("global different loss, old: " << losses[src] << " new: " << loss);
         }
-        return;
-      }
+      return false;
     }
-    globalLossPairs.push_back(std::make_pair(((uint16_t)m_myMac<<8) + params.src, loss));
-    std::cout<<"Global pushed : dst= "<< +m_myMac << "  src="<< +params.src <<" loss= "<<loss<<std::endl;
-
-    return;
+  losses[src] = loss;
+  return true;
 }
 
 void
 ObssWifiManager::ReceiveHeSig(HePreambleParameters params)
 {
-  NS_LOG_FUNCTION (this<< +m_myMac);
-  std::cout<< "Mymac "<<+m_myMac <<"\t Dst "<<(int)params.dst <<" Src "<< (int)params.src<< \
-   "  Power " << +params.txpower<<" Rssi: "<<WToDbm (params.rssiW) <<" Duration" << +params.time<< "  Mcs "<< +params.mcs <<std::endl;
+  NS_LOG_FUNCTION (this<< m_nodeId);
+  NS_LOG_DEBUG ("Node " << m_nodeId << " dst " << params.dst << " src " << params.src <<
+                " power " << params.txPowerDbm << " rssi " << WToDbm (params.rssiW) <<
+                " duration " << params.duration.GetNanoSeconds () << " mcs " << +params.mcs);
 
   UpdatePathLoss(params);
   UpdateObssTransStatus(params);
@@ -622,45 +694,40 @@ ObssWifiManager::ReceiveHeSig(HePreambleParameters params)
 void
 ObssWifiManager::UpdateObssTransStatus(HePreambleParameters params)
 {
-  NS_LOG_FUNCTION (this<< +m_myMac);
+  NS_LOG_FUNCTION (this<< m_nodeId);
 
-  ObssTran tran(params.dst, params.src, Simulator::Now().ToInteger(Time::Unit::NS),\
-   (uint64_t)params.time * 1e4, (double)params.txpower / 10.0, params.mcs);
-  // tran.dst = params.dst;
-  // tran.src = params.src;
-  // tran.startTime = Simulator::Now().ToInteger(Time::Unit::NS);
-  // tran.duration = (uint64_t)params.time * 1e4 ; // ns 
-  // tran.txPower = (double)params.txpower / 10.0;
+  ObssTran tran(params.dst, params.src, Simulator::Now (), params.duration, params.txPowerDbm, params.mcs);
   m_obssTrans.push_back(tran);
 }
 
 void
 ObssWifiManager::CheckObssStatus(HePreambleParameters params)
 {
-  NS_LOG_FUNCTION (this<< +m_myMac);
+  NS_LOG_FUNCTION (this<< m_nodeId);
 
-  std::cout<<"checkObssStatus"<<std::endl;
+  NS_LOG_DEBUG ("checkObssStatus");
   //check timer
-  for(int idx=0; idx<m_obssTrans.size(); idx++)
+  for(ObssTrans::iterator it = m_obssTrans.begin (); it != m_obssTrans.end (); )
   {
-    double startTime = std::get<2>(m_obssTrans[idx]);
-    double duration = std::get<3>(m_obssTrans[idx]);
-    std::cout<<"start "<<startTime<< " duration "<<duration<<"  Now "<< +Simulator::Now().ToInteger(Time::Unit::NS)<<std::endl;
-    if(startTime+duration < Simulator::Now().ToInteger(Time::Unit::NS))
+    Time startTime = std::get<2>(*it);
+    Time duration = std::get<3>(*it);
+    NS_LOG_DEBUG ("start " << startTime.GetNanoSeconds () << " duration " << duration.GetNanoSeconds () << "  Now " << Simulator::Now().GetNanoSeconds ());
+    if(startTime+duration < Simulator::Now())
     {
       // time past, delete it
-      m_obssTrans.erase(m_obssTrans.begin()+idx);
+      it = m_obssTrans.erase(it);
+    }
+    else
+    {
+      it++;
     }
-
   }
-  std::cout<<"m_obssTrans.size= "<<m_obssTrans.size()<<std::endl;
-  if(m_obssTrans.size()==0 || !CheckRouting(params))
+  NS_LOG_DEBUG ("m_obssTrans.size= " << m_obssTrans.size());
+  if(m_policy != OBSS_POLICY_JOINT || m_obssTrans.size()==0 || !CheckRouting(params))
   {
     m_obssRestricted = false;
     return;
   }
-  // #######
-  // TO DO: Update power and rate limit
 
   double interference = 0;
   ReceiverInfos recvinfos;
@@ -669,10 +736,10 @@ ObssWifiManager::CheckObssStatus(HePreambleParameters params)
   //for nexthop
   for(int idx=0; idx<m_obssTrans.size(); idx++)
   {
-    uint8_t temp_src = std::get<1>(m_obssTrans[idx]);
+    uint16_t temp_src = std::get<1>(m_obssTrans[idx]);
     double temp_txpower = std::get<4>(m_obssTrans[idx]);
-    double temp_loss = GetPathLoss(m_nexthopMac, temp_src);
-    std::cout<<"dst: "<<+m_nexthopMac<<" src: "<<+temp_src<<" loss: "<<temp_loss<<std::endl;
+    double temp_loss = GetPathLoss(m_nextHopId, temp_src);
+    NS_LOG_DEBUG ("dst: " << m_nextHopId << " src: " << temp_src << " loss: " << temp_loss);
     if(temp_loss>0) // no path loss yet
     {
       m_obssRestricted = false;
@@ -680,21 +747,21 @@ ObssWifiManager::CheckObssStatus(HePreambleParameters params)
     }
     interference += DbmToW(temp_txpower + temp_loss);
   }
-  ReceiverInfo recvInfo(m_nexthopMac, interference, 0, -1); // first one
+  ReceiverInfo recvInfo(m_nextHopId, interference, 0, -1); // first one
   recvinfos.push_back(recvInfo);
 
   // add other receivers
   double signal = 0;
   for(int idx=0; idx<m_obssTrans.size(); idx++)
   {
-    uint8_t temp_dst = std::get<0>(m_obssTrans[idx]);
+    uint16_t temp_dst = std::get<0>(m_obssTrans[idx]);
     uint8_t temp_mcs = std::get<5>(m_obssTrans[idx]);
     interference = 0;
     signal = 0;
     for(int idx2=0; idx2<m_obssTrans.size(); idx2++)
     {
-      uint8_t temp_src = std::get<1>(m_obssTrans[idx2]);
-      uint8_t temp_dst2 = std::get<0>(m_obssTrans[idx2]);
+      uint16_t temp_src = std::get<1>(m_obssTrans[idx2]);
+      uint16_t temp_dst2 = std::get<0>(m_obssTrans[idx2]);
       double temp_txpower = std::get<4>(m_obssTrans[idx2]);
       double temp_loss = GetPathLoss(temp_dst, temp_src);
       if(temp_loss>0) // no path loss yet
@@ -715,93 +782,155 @@ ObssWifiManager::CheckObssStatus(HePreambleParameters params)
     recvinfos.push_back(recvInfo);
   }
 
-  bool isOk;
-  double myTxpower;
-  int level;
-  std::cout<<"we have "<<recvinfos.size()<<" recv info"<<std::endl;
-  for(level=GetPhy()->GetNTxPower();level>=0;level--)
-  {
-    myTxpower = GetPhy()->GetPowerDbm(level); //dbm
-    isOk=true;
-
-    // must not disturb on-going transimission
-    for(int idx=1;idx<recvinfos.size();idx++)
+  NS_LOG_DEBUG ("we have " << recvinfos.size() << " recv info");
+  Time until = Simulator::Now ();
+  for (ObssTrans::const_iterator it = m_obssTrans.begin (); it != m_obssTrans.end (); it++)
     {
-      uint8_t temp_recv = std::get<0>(recvinfos[idx]);
-      double temp_inf = std::get<1>(recvinfos[idx]);
-      double temp_signal = std::get<2>(recvinfos[idx]);
-      int temp_mcs = std::get<3>(recvinfos[idx]);
-      double temp_loss = GetPathLoss(temp_recv, m_myMac);
-      if(temp_loss>0) // no path loss yet
-      {
-        m_obssRestricted = false;
-        return;
-      }
-      
-      WifiMode mode = GetPhy()->GetMcs(temp_mcs + 42); // Use HeMcs
-      std::cout<<"mcs: "<< temp_mcs << " name: "<< mode.GetUniqueName()<< std::endl;
-
-      double myI = DbmToW(myTxpower+ temp_loss); // the interference I will introduce (W)
-      uint16_t channelWidth = GetPhy ()->GetChannelWidth ();
-      std::cout<<"loss= "<<temp_loss<<" interference= "<<WToDbm(myI+temp_inf)<<" signal= "<<WToDbm(temp_signal)<<" ch= "<<channelWidth<<std::endl;
-      double dstSNR = WToDbm(CalculateSnr(temp_signal, myI+temp_inf, channelWidth));
+      until = std::max (until, std::get<2> (*it) + std::get<3> (*it));
+    }
+  SelectPowerAndMcs (recvinfos, until);
+}
 
+void
+ObssWifiManager::BuildGoodputTables (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_goodputWidth = GetPhy ()->GetChannelWidth ();
+  Ptr<ErrorRateModel> errorRateModel = GetPhy ()->GetErrorRateModel ();
+  m_heModes.clear ();
+  m_heRates.clear ();
+  m_successRates.clear ();
+  for (uint8_t i = 0; i < GetPhy ()->GetNMcs (); i++)
+    {
+      WifiMode mode = GetPhy ()->GetMcs (i);
+      if (mode.GetModulationClass () != WIFI_MOD_CLASS_HE || !mode.IsAllowed (m_goodputWidth, 1))
+        {
+          continue;
+        }
+      uint8_t mcs = mode.GetMcsValue ();
+      if (mcs >= m_heModes.size ())
+        {
+          m_heModes.resize (mcs + 1);
+          m_heRates.resize (mcs + 1, 0);
+          m_successRates.resize (mcs + 1, std::vector<double> (GOODPUT_SINR_COUNT, 0));
+        }
       WifiTxVector txVector;
-      txVector.SetChannelWidth (channelWidth);
-      txVector.SetNss (1);
       txVector.SetMode (mode);
-      double SNRlimit = WToDbm( GetPhy()->CalculateSnr(txVector, m_ber) );
-
-      std::cout<<"mypower= "<<myTxpower<<" SNRlimit= "<<SNRlimit<<" dstSNR= "<<dstSNR<<std::endl;
-
-      if(dstSNR<SNRlimit)
-      {
-        isOk=false;
-        break;
-      }
+      txVector.SetNss (1);
+      txVector.SetChannelWidth (m_goodputWidth);
+      txVector.SetGuardInterval (GetGuardInterval ());
+      m_heModes[mcs] = mode;
+      m_heRates[mcs] = mode.GetDataRate (txVector);
+      for (std::size_t k = 0; k < GOODPUT_SINR_COUNT; k++)
+        {
+          double sinr = DbToRatio (GOODPUT_SINR_MIN + k * GOODPUT_SINR_STEP);
+          m_successRates[mcs][k] = errorRateModel->GetChunkSuccessRate (mode, txVector, sinr, m_frameSize * 8);
+        }
     }
+  m_bestMcs.assign (GOODPUT_SINR_COUNT, 0);
+  m_bestGoodput.assign (GOODPUT_SINR_COUNT, 0);
+  for (std::size_t k = 0; k < GOODPUT_SINR_COUNT; k++)
+    {
+      for (uint8_t mcs = 0; mcs < m_heRates.size (); mcs++)
+        {
+          double goodput = m_heRates[mcs] * m_successRates[mcs][k];
+          if (goodput > m_bestGoodput[k])
+            {
+              m_bestGoodput[k] = goodput;
+              m_bestMcs[k] = mcs;
+            }
+        }
+    }
+}
 
-    if(isOk)
+std::size_t
+ObssWifiManager::GetSinrIndex (double sinrDb) const
+{
+  if (sinrDb <= GOODPUT_SINR_MIN)
     {
-      std::cout<<"Found right txpower!"<<myTxpower<<std::endl;
-      break;
+      return 0;
     }
+  return std::min<std::size_t> (static_cast<std::size_t> ((sinrDb - GOODPUT_SINR_MIN) / GOODPUT_SINR_STEP),
+                                GOODPUT_SINR_COUNT - 1);
+}
 
-  }
+void
+ObssWifiManager::SelectPowerAndMcs (const ReceiverInfos &recvinfos, Time until)
+{
+  NS_LOG_FUNCTION (this << recvinfos.size () << until);
+  if (m_heModes.empty ())
+    {
+      m_obssRestricted = false;
+      return;
+    }
+  //Path losses from this node to the next hop and to the receivers of
+  //the active transmissions
+  std::vector<double> losses;
+  for (ReceiverInfos::const_iterator it = recvinfos.begin (); it != recvinfos.end (); it++)
+    {
+      double loss = GetPathLoss (std::get<0> (*it), m_nodeId);
+      if (loss == UNKNOWN_PATH_LOSS) // no path loss yet
+        {
+          m_obssRestricted = false;
+          return;
+        }
+      losses.push_back (loss);
+    }
 
-  uint8_t temp_recv = std::get<0>(recvinfos[0]);
-  double temp_inf = std::get<1>(recvinfos[0]);
-  double temp_loss = GetPathLoss(temp_recv, m_myMac);
-  if(temp_loss>0) // no path loss yet
-  {
-    m_obssRestricted = false;
-    return;
-  }
-  uint16_t channelWidth = GetPhy ()->GetChannelWidth ();
-  std::cout<<"loss= "<<temp_loss<<" interference= "<<WToDbm(temp_inf)<<" signal= "<<(myTxpower+temp_loss)<<" ch= "<<channelWidth<<std::endl;
-  double SNR = WToDbm(CalculateSnr(DbmToW(myTxpower+temp_loss), temp_inf, channelWidth));
-  int mcs;
-  double SNRlimit;
-  for(mcs=9;mcs>=0;mcs--)
-  {
-    WifiMode mode = GetPhy()->GetMcs(mcs + 42);
-    WifiTxVector txVector;
-    txVector.SetChannelWidth (channelWidth);
-    txVector.SetNss (1);
-    txVector.SetMode (mode);
-    SNRlimit = WToDbm( GetPhy()->CalculateSnr(txVector, m_ber) );
-    if(SNRlimit<SNR)break;
-  }
-  std::cout<<"final mcs: "<<mcs<<" SNRlimit:"<<SNRlimit<<" SNR:"<<SNR<<std::endl;
-  m_obssPowerLimit = level;
-  m_obssMcsLimit = mcs;
-  m_obssRestricted = true; // ?? When to set true
+  double bestGoodput = -1;
+  uint8_t bestLevel = 0;
+  uint8_t bestMcs = 0;
+  std::size_t bestIndex = 0;
+  WifiTxVector txVector;
+  txVector.SetNss (1);
+  for (uint8_t level = 0; level < GetPhy ()->GetNTxPower (); level++)
+    {
+      //The levels above the TX power restriction of the OBSS PD
+      //algorithm are sent at the restricted power
+      txVector.SetTxPowerLevel (level);
+      double txPowerDbm = GetPhy ()->GetTxPowerForTransmission (txVector) + GetPhy ()->GetTxGain ();
+      //The frames to the next hop use the best MCS of their SINR
+      double sinr = RatioToDb (CalculateSnr (DbmToW (txPowerDbm + losses[0]), std::get<1> (recvinfos[0]), m_goodputWidth));
+      std::size_t index = GetSinrIndex (sinr);
+      double goodput = m_bestGoodput[index];
+      //The active transmissions keep their MCS, under the interference of these frames
+      for (std::size_t r = 1; r < recvinfos.size (); r++)
+        {
+          int mcs = std::get<3> (recvinfos[r]);
+          if (mcs < 0 || static_cast<std::size_t> (mcs) >= m_heRates.size ())
+            {
+              continue;
+            }
+          double interference = std::get<1> (recvinfos[r]) + DbmToW (txPowerDbm + losses[r]);
+          double sinrR = RatioToDb (CalculateSnr (std::get<2> (recvinfos[r]), interference, m_goodputWidth));
+          goodput += m_heRates[mcs] * m_successRates[mcs][GetSinrIndex (sinrR)];
+        }
+      NS_LOG_DEBUG ("TX power " << txPowerDbm << " dBm: MCS " << +m_bestMcs[index] << " expected goodput " << goodput);
+      if (goodput > bestGoodput)
+        {
+          bestGoodput = goodput;
+          bestLevel = level;
+          bestMcs = m_bestMcs[index];
+          bestIndex = index;
+        }
+    }
+  NS_LOG_DEBUG ("Selected TX power level " << +bestLevel << " MCS " << +bestMcs << " expected goodput " << bestGoodput);
+  if (m_bestGoodput[bestIndex] == 0)
+    {
+      NS_LOG_DEBUG ("The next hop cannot be reached during the active transmissions");
+      m_obssRestricted = false;
+      return;
+    }
+  m_obssPowerLimit = bestLevel;
+  m_obssMcsLimit = bestMcs;
+  m_obssRestricted = true;
+  m_obssRestrictedUntil = until;
 }
 
 double 
 ObssWifiManager::CalculateSnr (double signal, double noiseInterference, uint16_t channelWidth)
 {
-  double noiseFigure = 7; // default value of wifi-phy attribute
+  double noiseFigure = DbToRatio (7); // default value of wifi-phy attribute
 
   //thermal noise at 290K in J/s = W
   static const double BOLTZMANN = 1.3803e-23;
@@ -817,20 +946,15 @@ ObssWifiManager::CalculateSnr (double signal, double noiseInterference, uint16_t
 }
 
 double
-ObssWifiManager::GetPathLoss(uint8_t dst, uint8_t src)
+ObssWifiManager::GetPathLoss(uint16_t dst, uint16_t src)
 {
-
-  for (PathLossPairs::const_iterator i = globalLossPairs.begin (); i != globalLossPairs.end (); i++)
-  {
-    uint8_t i_dst = i->first / (1<<8);
-    uint8_t i_src = i->first % (1<<8);
-    if(src == i_src && dst == i_dst )
+  if (dst < g_pathLosses.size () && src < g_pathLosses[dst].size ()
+      && g_pathLosses[dst][src] != UNKNOWN_PATH_LOSS)
     {
-      return i->second;
+      return g_pathLosses[dst][src];
     }
-  }
-  std::cout<<"No loss for dst "<<+dst<<" src "<<+src<<std::endl;
-  return 1; // loss must be negative, so use 1 to indicate no match #####
+  NS_LOG_DEBUG ("No loss for dst " << dst << " src " << src);
+  return UNKNOWN_PATH_LOSS;
 }
 
 
@@ -839,47 +963,41 @@ ObssWifiManager::GetPathLoss(uint8_t dst, uint8_t src)
 bool
 ObssWifiManager::CheckRouting(HePreambleParameters params)
 {
-  uint8_t addrs2[4]; // nexthop ip
-
-  Ptr<Ipv4RoutingProtocol> aodvRouting;
-  aodvRouting = Ipv4RoutingHelper::GetRouting <Ipv4RoutingProtocol> (m_device->GetNode()->GetObject<Ipv4> ()->GetRoutingProtocol ());
-  // aodvRouting = m_device->GetNode()->GetObject<Ipv4> ()->GetRoutingProtocol ();
-  Ipv4Address sourceAddr = m_device->GetNode()->GetObject<Ipv4> ()->GetAddress(1,0).GetLocal();
-  Ipv4Header ipHead;
-  ipHead.SetDestination("10.2.1.1");
-  ipHead.SetSource(sourceAddr);
-  Socket::SocketErrno err;
-  Packet ptemp;
-  Ptr<Ipv4Route> routeEntry = aodvRouting->RouteOutput(&ptemp, ipHead, m_device, err);
+  Mac48Address nextHop;
+  if (!m_nextHop.IsNull ())
+    {
+      nextHop = m_nextHop (m_device->GetIfIndex ());
+    }
+  else
+    {
+      nextHop = MeshObssPdAlgorithm::GetIpv4NextHop (m_device, m_gateway);
+    }
+  if (nextHop.IsGroup ())
+    {
+      NS_LOG_DEBUG ("no nexthop");
+      return false;
+    }
+  m_nextHopId = GetNodeIdOfAddress (nextHop);
+  if (m_nextHopId == NO_NODE_ID)
+    {
+      NS_LOG_DEBUG ("nexthop not a wifi node");
+      return false;
+    }
 
-  if(!err)
+  // check all on-going transmission
+  for(int idx=0; idx<m_obssTrans.size(); idx++)
   {
-      // std::cout<<"  myAddr= "<<sourceAddr<<"  nextHop= "<<routeEntry->GetGateway() <<std::endl;
-      routeEntry->GetGateway().Serialize(addrs2);
-      m_nexthopMac = addrs2[3];
-
-      // check all on-going transmission
-      for(int idx=0; idx<m_obssTrans.size(); idx++)
-      {
-        uint8_t tran_dst = std::get<0>(m_obssTrans[idx]);
-        uint8_t tran_src = std::get<1>(m_obssTrans[idx]);
-
-        if(tran_src == m_nexthopMac || tran_dst == m_nexthopMac || tran_dst ==m_myMac || addrs2[0]==127)
-        {
-          NS_LOG_DEBUG("loopback addr or not a obss frame.");
-          // std::cout<<"loopback addr or not a obss frame."<<std::endl;
-          return false;
-        }
-      }
+    uint16_t tran_dst = std::get<0>(m_obssTrans[idx]);
+    uint16_t tran_src = std::get<1>(m_obssTrans[idx]);
 
-      return true;      
-  }
-  else
-  {
-    // std::cout<<"  myAddr= "<<sourceAddr<<"  error routing , no nexthop"<<std::endl;  
-    return false;
+    if(tran_src == m_nextHopId || tran_dst == m_nextHopId || tran_dst ==m_nodeId)
+    {
+      NS_LOG_DEBUG("not a obss frame.");
+      return false;
+    }
   }
-  
+
+  return true;
 }
 
 } //namespace ns3
@@ -26,9 +26,12 @@
 #include "ns3/wifi-net-device.h"
 #include "sta-wifi-mac.h"
 #include "wifi-remote-station-manager.h"
+#include "mesh-obss-pd-algorithm.h"
 #include "ns3/internet-module.h"
 #include "wifi-utils.h"
 
+class ObssWifiManagerTest;
+
 namespace ns3 {
 
 /**
@@ -49,6 +52,9 @@ namespace ns3 {
 class ObssWifiManager : public WifiRemoteStationManager
 {
 public:
+  /// Allow test cases to access private members
+  friend class ::ObssWifiManagerTest;
+
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -59,7 +65,48 @@ public:
 
   void SetupPhy (const Ptr<WifiPhy> phy);
 
-  typedef std::vector<std::pair<uint16_t, double> > PathLossPairs;
+  /**
+   * Set the callback which gives the next hop towards the gateway,
+   * instead of the IPv4 route to GatewayAddress.
+   *
+   * \param cb the callback
+   */
+  void SetNextHopCallback (MeshObssPdAlgorithm::NextHopCallback cb);
+
+  /// Selection of the TX power and MCS of the frames to the next hop
+  enum ObssPolicy
+  {
+    OBSS_POLICY_IDEAL, ///< the MCS of the last SNR, at the default TX power
+    OBSS_POLICY_JOINT  ///< the TX power and MCS of the best expected goodput of the active transmissions
+  };
+
+  /**
+   * Path losses (dB) towards a node, indexed by the node ID of the
+   * transmitter, UNKNOWN_PATH_LOSS if not heard yet
+   */
+  typedef std::vector<double> PathLosses;
+
+  static const double UNKNOWN_PATH_LOSS; ///< path loss of a pair of nodes not heard yet
+
+  /**
+   * Record the path loss between two nodes, learnt from the HE preamble
+   * of a frame, in the path losses shared by all the nodes, unless it is
+   * known already.
+   *
+   * \param dst the node ID of the receiver
+   * \param src the node ID of the transmitter
+   * \param loss the path loss (dB, negative)
+   * \return true if the path loss was recorded
+   */
+  static bool SetPathLoss (uint16_t dst, uint16_t src, double loss);
+
+  /**
+   * \param dst the node ID of the receiver
+   * \param src the node ID of the transmitter
+   * \return the path loss (dB, negative) between the two nodes,
+   * UNKNOWN_PATH_LOSS if the receiver has not heard the transmitter yet
+   */
+  static double GetPathLoss (uint16_t dst, uint16_t src);
 
 private:
   //overridden from base class
@@ -115,11 +162,22 @@ private:
 
   void CheckObssStatus(HePreambleParameters params);
 
-  double GetSINR(uint8_t dst, double myTxpower);
+  double GetSINR(uint16_t dst, double myTxpower);
 
   double CalculateSnr (double signal, double noiseInterference, uint16_t channelWidth);
 
-  double GetPathLoss(uint8_t dst, uint8_t src);
+  /**
+   * Build the tables of the success rate of each HE MCS and of the best
+   * HE MCS, against the SINR, for the channel width of the PHY.
+   */
+  void BuildGoodputTables (void);
+
+  /**
+   * \param sinrDb a SINR (dB)
+   * \return the index of the highest SINR of the goodput tables which
+   * does not exceed it
+   */
+  std::size_t GetSinrIndex (double sinrDb) const;
 
   bool CheckRouting(HePreambleParameters params);
 
@@ -129,20 +187,24 @@ private:
    */
   typedef std::vector<std::pair<double, WifiTxVector> > Thresholds;
 
-  // typedef struct ObssTran
-  // {
-  //   uint8_t dst;
-  //   uint8_t src;
-  //   uint64_t startTime;
-  //   uint64_t duration;
-  //   double txPower; //dbm
-  // };
-
-  typedef std::tuple<uint8_t, uint8_t, uint64_t, uint64_t, double, uint8_t> ObssTran; //dst, src, startTime, duration, txPower, mcs
+  typedef std::tuple<uint16_t, uint16_t, Time, Time, double, uint8_t> ObssTran; //dst, src (node IDs), startTime, duration, txPower (dBm), mcs
   typedef std::vector<ObssTran> ObssTrans;
-  typedef std::tuple<uint8_t, double, double, int> ReceiverInfo; // mac(dst), interference(W), signal(W), Mcs
+  typedef std::tuple<uint16_t, double, double, int> ReceiverInfo; // node ID (dst), interference(W), signal(W), Mcs
   typedef std::vector<ReceiverInfo> ReceiverInfos;
 
+  /**
+   * Select the TX power level and HE MCS of the frames to the next hop
+   * which maximize the expected goodput of these frames and of the
+   * active transmissions, with a lookup in the goodput tables for each
+   * TX power level.  The TX power of a level is capped at the current
+   * TX power restriction of the PHY.
+   *
+   * \param recvinfos the next hop, then the receivers of the active
+   * transmissions
+   * \param until the end of the active transmissions
+   */
+  void SelectPowerAndMcs (const ReceiverInfos &recvinfos, Time until);
+
   double m_ber;             //!< The maximum Bit Error Rate acceptable at any transmission mode
   Thresholds m_thresholds;  //!< List of WifiTxVector and the minimum SNR pair
 
@@ -150,16 +212,26 @@ private:
 
   // #####
   // obss pd
-  PathLossPairs m_lossPairs; // (src, loss)
+  PathLosses m_pathLosses; // path losses towards this node
   Ptr<WifiNetDevice> m_device;
   bool m_obssRestricted;
   ObssTrans m_obssTrans;
-  uint8_t m_myMac;
-  uint8_t m_nexthopMac;
-
-  uint8_t m_obssPowerLimit;
-  uint8_t m_obssMcsLimit;
-  uint8_t m_obssHeMcsLimit;
+  uint16_t m_nodeId;       ///< node ID of this node
+  uint16_t m_nextHopId;    ///< node ID of the next hop
+  Ipv4Address m_gateway;                          ///< IPv4 address of the gateway
+  MeshObssPdAlgorithm::NextHopCallback m_nextHop; ///< next hop given by the routing protocol
+
+  ObssPolicy m_policy;            ///< selection of the TX power and MCS
+  uint32_t m_frameSize;           ///< frame size (bytes) of the expected goodput
+  uint8_t m_obssPowerLimit;       ///< selected TX power level
+  uint8_t m_obssMcsLimit;         ///< selected HE MCS
+  Time m_obssRestrictedUntil;     ///< end of the transmissions of the selection
+  uint16_t m_goodputWidth;        ///< channel width (MHz) of the goodput tables
+  std::vector<WifiMode> m_heModes;   ///< HE modes, indexed by MCS
+  std::vector<uint64_t> m_heRates;   ///< data rates (b/s) of the HE modes, indexed by MCS
+  std::vector<std::vector<double> > m_successRates; ///< frame success rates, indexed by MCS and SINR
+  std::vector<uint8_t> m_bestMcs;    ///< MCS of the best expected goodput, indexed by SINR
+  std::vector<double> m_bestGoodput; ///< best expected goodput (b/s), indexed by SINR
 
 };
 
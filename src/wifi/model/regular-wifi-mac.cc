@@ -21,6 +21,10 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/abort.h"
+#include "ns3/channel.h"
 #include "regular-wifi-mac.h"
 #include "wifi-phy.h"
 #include "mac-rx-middle.h"
@@ -35,6 +39,9 @@
 #include "ht-configuration.h"
 #include "vht-configuration.h"
 #include "he-configuration.h"
+#include "channel-access-manager.h"
+#include "wifi-mac-trailer.h"
+#include "snr-tag.h"
 #include <algorithm>
 #include <cmath>
 
@@ -856,6 +863,97 @@ RegularWifiMac::ForwardUp (Ptr<Packet> packet, Mac48Address from, Mac48Address t
   m_forwardUp (packet, from, to);
 }
 
+void
+RegularWifiMac::SendAbstracted (Ptr<const Packet> packet, const WifiMacHeader &hdr)
+{
+  NS_LOG_FUNCTION (this << packet << hdr);
+  NS_ASSERT (hdr.GetAddr1 ().IsGroup ());
+  Ptr<WifiPhy> phy = m_phy;
+  Ptr<Channel> channel = phy->GetChannel ();
+  if (phy->IsStateSleep () || phy->IsStateOff ())
+    {
+      NS_LOG_DEBUG ("PHY is not active, frame not sent");
+      return;
+    }
+  if (m_abstractedRxRandom == 0)
+    {
+      //Only created once used, so as not to shift the streams of
+      //simulations which do not abstract any frame
+      m_abstractedRxRandom = CreateObject<UniformRandomVariable> ();
+    }
+
+  WifiMacHeader header = hdr;
+  header.SetSequenceNumber (m_txMiddle->GetNextSequenceNumberFor (&header));
+  WifiTxVector txVector = m_stationManager->GetDataTxVector (header.GetAddr1 (), &header, packet);
+  uint32_t size = packet->GetSize () + header.GetSize () + WIFI_MAC_FCS_LENGTH;
+  Time duration = phy->CalculateTxDuration (size, txVector, phy->GetFrequency ());
+  double txPowerDbm = phy->GetTxPowerForTransmission (txVector) + phy->GetTxGain ();
+  NS_LOG_DEBUG ("abstracted frame of " << size << " bytes, duration=" << duration);
+
+  //The medium is busy for everyone who senses the frame, be it decoded or not
+  m_channelAccessManager->NotifyNavStartNow (duration);
+  for (std::size_t i = 0; i < channel->GetNDevices (); i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (channel->GetDevice (i));
+      if (device == 0)
+        {
+          continue;
+        }
+      Ptr<WifiPhy> receiverPhy = device->GetPhy ();
+      Ptr<RegularWifiMac> receiverMac = DynamicCast<RegularWifiMac> (device->GetMac ());
+      if (receiverPhy == phy || receiverMac == 0
+          || receiverPhy->GetChannelNumber () != phy->GetChannelNumber ())
+        {
+          continue;
+        }
+      double rxPowerDbm = phy->GetRxPowerDbm (receiverPhy, txPowerDbm);
+      if (rxPowerDbm < receiverPhy->GetRxSensitivity ())
+        {
+          continue;
+        }
+      receiverMac->m_channelAccessManager->NotifyNavStartNow (duration);
+      if (!receiverPhy->IsStateIdle () && !receiverPhy->IsStateCcaBusy ())
+        {
+          continue;
+        }
+      InterferenceHelper::SnrPer snrPer = receiverPhy->CalculateNoInterferenceSnrPer (DbmToW (rxPowerDbm), txVector, size);
+      if (m_abstractedRxRandom->GetValue () < snrPer.per)
+        {
+          NS_LOG_DEBUG ("abstracted frame lost by " << receiverMac->GetAddress () << ", per=" << snrPer.per);
+          continue;
+        }
+      Simulator::ScheduleWithContext (device->GetNode ()->GetId (), duration,
+                                      &RegularWifiMac::ReceiveAbstracted, receiverMac,
+                                      packet->Copy (), header, snrPer.snr);
+    }
+}
+
+int64_t
+RegularWifiMac::AssignAbstractedStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  if (m_abstractedRxRandom == 0)
+    {
+      m_abstractedRxRandom = CreateObject<UniformRandomVariable> ();
+    }
+  m_abstractedRxRandom->SetStream (stream);
+  return 1;
+}
+
+void
+RegularWifiMac::ReceiveAbstracted (Ptr<Packet> packet, WifiMacHeader hdr, double snr)
+{
+  NS_LOG_FUNCTION (this << packet << hdr << snr);
+  if (m_phy == 0 || m_phy->IsStateSleep () || m_phy->IsStateOff ())
+    {
+      return;
+    }
+  SnrTag tag;
+  tag.Set (snr);
+  packet->AddPacketTag (tag);
+  Receive (packet, &hdr);
+}
+
 void
 RegularWifiMac::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
 {
@@ -32,6 +32,7 @@ class MacRxMiddle;
 class MacTxMiddle;
 class ChannelAccessManager;
 class ExtendedCapabilities;
+class UniformRandomVariable;
 
 /**
  * \brief base class for all MAC-level wifi objects.
@@ -417,6 +418,36 @@ protected:
    */
   void ForwardUp (Ptr<Packet> packet, Mac48Address from, Mac48Address to);
 
+  /**
+   * Account for the transmission of a group addressed management frame
+   * (e.g., a beacon) without handing it to the PHY.  The medium is
+   * reserved for the airtime of the frame at this station and at every
+   * station that senses it, and the frame is delivered at the end of its
+   * airtime to the stations that decode it, with a probability given by
+   * the error rate of each link in the absence of interference.  This
+   * trades the per-frame PHY events for a statistical model of the
+   * management traffic.  The PHY of this station does not enter the TX
+   * state, and every device of the channel is still visited to find the
+   * stations that sense the frame.  The PHY must be able to evaluate the
+   * RX power of a single link (WifiPhy::GetRxPowerDbm), as YansWifiPhy
+   * does.
+   *
+   * \param packet the frame body
+   * \param hdr the MAC header of the frame
+   */
+  void SendAbstracted (Ptr<const Packet> packet, const WifiMacHeader &hdr);
+
+  /**
+   * Assign a fixed random variable stream number to the random variable
+   * which decides the reception of the frames sent through SendAbstracted.
+   * Subclasses which abstract frames call it from their AssignStreams.
+   *
+   * \param stream first stream index to use
+   *
+   * \return the number of stream indices assigned (one)
+   */
+  int64_t AssignAbstractedStreams (int64_t stream);
+
   /**
    * This method can be called to de-aggregate an A-MSDU and forward
    * the constituent packets up the stack.
@@ -629,6 +660,18 @@ private:
 
   bool m_shortSlotTimeSupported; ///< flag whether short slot time is supported
   bool m_rifsSupported; ///< flag whether RIFS is supported (deprecated)
+
+  /**
+   * Deliver a frame sent through SendAbstracted, if the PHY of this
+   * station has been able to receive it.
+   *
+   * \param packet the frame body
+   * \param hdr the MAC header of the frame
+   * \param snr the SNR of the frame (linear)
+   */
+  void ReceiveAbstracted (Ptr<Packet> packet, WifiMacHeader hdr, double snr);
+
+  Ptr<UniformRandomVariable> m_abstractedRxRandom; ///< decides the reception of abstracted frames
 };
 
 } //namespace ns3
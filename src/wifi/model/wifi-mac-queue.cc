@@ -61,8 +61,7 @@ WifiMacQueue::GetTypeId (void)
 }
 
 WifiMacQueue::WifiMacQueue ()
-  : m_expiredPacketsPresent (false),
-    NS_LOG_TEMPLATE_DEFINE ("WifiMacQueue")
+  : NS_LOG_TEMPLATE_DEFINE ("WifiMacQueue")
 {
 }
 
@@ -116,6 +115,133 @@ WifiMacQueue::TtlExceeded (ConstIterator &it)
   return false;
 }
 
+uint32_t
+WifiMacQueue::RemoveExpired (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t nRemoved = 0;
+  while (!m_expiryIndex.empty ())
+    {
+      ConstIterator it = m_expiryIndex.begin ()->second;
+      if (!TtlExceeded (it))
+        {
+          break;
+        }
+      nRemoved++;
+    }
+  return nRemoved;
+}
+
+uint64_t
+WifiMacQueue::GetTidAddressKey (uint8_t tid, Mac48Address address)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return (key << 8) | tid;
+}
+
+bool
+WifiMacQueue::IsTidAddressIndexed (Ptr<const WifiMacQueueItem> item)
+{
+  return item->GetHeader ().IsQosData ();
+}
+
+void
+WifiMacQueue::AddToIndex (ConstIterator pos)
+{
+  NS_LOG_FUNCTION (this);
+  ItemIndex index;
+  index.expiryPos = m_expiryIndex.insert (std::make_pair ((*pos)->GetTimeStamp (), pos));
+
+  if (IsTidAddressIndexed (*pos))
+    {
+      uint8_t tid = (*pos)->GetHeader ().GetQosTid ();
+      Mac48Address dest = (*pos)->GetDestinationAddress ();
+      TidAddressList &list = m_tidAddressIndex[GetTidAddressKey (tid, dest)];
+      // find the next item of the same TID and receiver to keep the list
+      // in queue order; items are usually enqueued at the ends of the queue
+      TidAddressList::iterator next = list.end ();
+      if (pos == begin ())
+        {
+          next = list.begin ();
+        }
+      else
+        {
+          for (ConstIterator it = std::next (pos); it != end (); it++)
+            {
+              if (IsTidAddressIndexed (*it) && (*it)->GetHeader ().GetQosTid () == tid
+                  && (*it)->GetDestinationAddress () == dest)
+                {
+                  next = m_itemIndex[PeekPointer (*it)].tidAddressPos;
+                  break;
+                }
+            }
+        }
+      index.tidAddressPos = list.insert (next, pos);
+    }
+
+  bool inserted = m_itemIndex.insert (std::make_pair (PeekPointer (*pos), index)).second;
+  NS_ASSERT_MSG (inserted, "Item " << **pos << " is already in the queue");
+}
+
+void
+WifiMacQueue::RemoveFromIndex (ConstIterator pos)
+{
+  NS_LOG_FUNCTION (this);
+  auto index = m_itemIndex.find (PeekPointer (*pos));
+  NS_ASSERT (index != m_itemIndex.end ());
+
+  m_expiryIndex.erase (index->second.expiryPos);
+  if (IsTidAddressIndexed (*pos))
+    {
+      auto list = m_tidAddressIndex.find (GetTidAddressKey ((*pos)->GetHeader ().GetQosTid (),
+                                                            (*pos)->GetDestinationAddress ()));
+      NS_ASSERT (list != m_tidAddressIndex.end ());
+      list->second.erase (index->second.tidAddressPos);
+      if (list->second.empty ())
+        {
+          m_tidAddressIndex.erase (list);
+        }
+    }
+  m_itemIndex.erase (index);
+}
+
+bool
+WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
+{
+  if (!Queue<WifiMacQueueItem>::DoEnqueue (pos, item))
+    {
+      return false;
+    }
+  AddToIndex (std::prev (pos));
+  return true;
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoDequeue (ConstIterator pos)
+{
+  if (QueueBase::GetNPackets () > 0)
+    {
+      RemoveFromIndex (pos);
+    }
+  return Queue<WifiMacQueueItem>::DoDequeue (pos);
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueue::DoRemove (ConstIterator pos)
+{
+  if (QueueBase::GetNPackets () > 0)
+    {
+      RemoveFromIndex (pos);
+    }
+  return Queue<WifiMacQueueItem>::DoRemove (pos);
+}
+
 bool
 WifiMacQueue::Enqueue (Ptr<WifiMacQueueItem> item)
 {
@@ -147,26 +273,26 @@ WifiMacQueue::Insert (ConstIterator pos, Ptr<WifiMacQueueItem> item)
       return DoEnqueue (pos, item);
     }
 
-  // the queue is full; scan the list in the attempt to remove stale packets
-  ConstIterator it = begin ();
-  while (it != end ())
+  // the queue is full; remove stale packets, moving the insertion point
+  // past them if they are right at it
+  while (pos != end () && TtlExceeded (pos))
     {
-      if (it == pos && TtlExceeded (it))
-        {
-          return DoEnqueue (it, item);
-        }
-      if (TtlExceeded (it))
-        {
-          return DoEnqueue (pos, item);
-        }
-      it++;
+    }
+  if (RemoveExpired () > 0 || QueueBase::GetNPackets () < GetMaxSize ().GetValue ())
+    {
+      return DoEnqueue (pos, item);
     }
 
   // the queue is still full, remove the oldest item if the policy is drop oldest
   if (m_dropPolicy == DROP_OLDEST)
     {
       NS_LOG_DEBUG ("Remove the oldest item in the queue");
-      DoRemove (begin ());
+      ConstIterator oldest = begin ();
+      if (pos == oldest)
+        {
+          pos++;
+        }
+      DoRemove (oldest);
     }
 
   return DoEnqueue (pos, item);
@@ -244,38 +370,15 @@ WifiMacQueue::Dequeue (ConstIterator pos)
 {
   NS_LOG_FUNCTION (this);
 
-  if (!m_expiredPacketsPresent)
-    {
-      if (TtlExceeded (pos))
-        {
-          NS_LOG_DEBUG ("Packet lifetime expired");
-          return 0;
-        }
-      return DoDequeue (pos);
-    }
-
-  // remove stale items queued before the given position
-  ConstIterator it = begin ();
-  while (it != end ())
+  if (TtlExceeded (pos))
     {
-      if (it == pos)
-        {
-          // reset the flag signaling the presence of expired packets before returning
-          m_expiredPacketsPresent = false;
-
-          if (TtlExceeded (it))
-            {
-              return 0;
-            }
-          return DoDequeue (it);
-        }
-      else if (!TtlExceeded (it))
-        {
-          it++;
-        }
+      NS_LOG_DEBUG ("Packet lifetime expired");
+      RemoveExpired ();
+      return 0;
     }
-  NS_LOG_DEBUG ("Invalid iterator");
-  return 0;
+  // the item at the given position is not expired, hence it is not removed
+  RemoveExpired ();
+  return DoDequeue (pos);
 }
 
 Ptr<const WifiMacQueueItem>
@@ -290,8 +393,6 @@ WifiMacQueue::Peek (void) const
         {
           return DoPeek (it);
         }
-      // signal the presence of expired packets
-      m_expiredPacketsPresent = true;
     }
   NS_LOG_DEBUG ("The queue is empty");
   return 0;
@@ -314,11 +415,6 @@ WifiMacQueue::PeekByAddress (Mac48Address dest, ConstIterator pos) const
               return it;
             }
         }
-      else
-        {
-          // signal the presence of expired packets
-          m_expiredPacketsPresent = true;
-        }
       it++;
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -341,11 +437,6 @@ WifiMacQueue::PeekByTid (uint8_t tid, ConstIterator pos) const
               return it;
             }
         }
-      else
-        {
-          // signal the presence of expired packets
-          m_expiredPacketsPresent = true;
-        }
       it++;
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -356,25 +447,57 @@ WifiMacQueue::ConstIterator
 WifiMacQueue::PeekByTidAndAddress (uint8_t tid, Mac48Address dest, ConstIterator pos) const
 {
   NS_LOG_FUNCTION (this << +tid << dest);
-  ConstIterator it = (pos != EMPTY ? pos : begin ());
-  while (it != end ())
+  auto list = m_tidAddressIndex.find (GetTidAddressKey (tid, dest));
+  if (list == m_tidAddressIndex.end () || pos == end ())
     {
-      // skip packets that stayed in the queue for too long. They will be
-      // actually removed from the queue by the next call to a non-const method
-      if (Simulator::Now () <= (*it)->GetTimeStamp () + m_maxDelay)
+      NS_LOG_DEBUG ("The queue is empty");
+      return end ();
+    }
+
+  auto matches = [tid, dest] (Ptr<const WifiMacQueueItem> item)
+    {
+      return IsTidAddressIndexed (item) && item->GetDestinationAddress () == dest
+             && item->GetHeader ().GetQosTid () == tid;
+    };
+
+  // find where to start in the list of the given TID and receiver: at the
+  // given position if it holds a matching item, or after the matching item
+  // preceding it, which are the usual cases
+  TidAddressList::const_iterator listIt = list->second.begin ();
+  if (pos != EMPTY)
+    {
+      if (matches (*pos))
+        {
+          listIt = m_itemIndex.find (PeekPointer (*pos))->second.tidAddressPos;
+        }
+      else if (pos != begin () && matches (*std::prev (pos)))
+        {
+          listIt = std::next (m_itemIndex.find (PeekPointer (*std::prev (pos)))->second.tidAddressPos);
+        }
+      else
         {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
+          ConstIterator it = pos;
+          while (it != end () && !matches (*it))
             {
-              return it;
+              it++;
             }
+          if (it == end ())
+            {
+              NS_LOG_DEBUG ("The queue is empty");
+              return end ();
+            }
+          listIt = m_itemIndex.find (PeekPointer (*it))->second.tidAddressPos;
         }
-      else
+    }
+
+  for (; listIt != list->second.end (); listIt++)
+    {
+      // skip packets that stayed in the queue for too long. They will be
+      // actually removed from the queue by the next call to a non-const method
+      if (Simulator::Now () <= (**listIt)->GetTimeStamp () + m_maxDelay)
         {
-          // signal the presence of expired packets
-          m_expiredPacketsPresent = true;
+          return *listIt;
         }
-      it++;
     }
   NS_LOG_DEBUG ("The queue is empty");
   return end ();
@@ -397,11 +520,6 @@ WifiMacQueue::PeekFirstAvailable (const Ptr<QosBlockedDestinations> blockedPacke
               return it;
             }
         }
-      else
-        {
-          // signal the presence of expired packets
-          m_expiredPacketsPresent = true;
-        }
       it++;
     }
   NS_LOG_DEBUG ("The queue is empty");
@@ -457,26 +575,15 @@ WifiMacQueue::Remove (ConstIterator pos, bool removeExpired)
       return pos;
     }
 
-  // remove stale items queued before the given position
-  ConstIterator it = begin ();
-  while (it != end ())
+  // remove the item, then the stale items, taking care not to remove the
+  // item following the given position
+  ConstIterator curr = pos++;
+  DoRemove (curr);
+  while (pos != end () && TtlExceeded (pos))
     {
-      if (it == pos)
-        {
-          // reset the flag signaling the presence of expired packets before returning
-          m_expiredPacketsPresent = false;
-
-          ConstIterator curr = pos++;
-          DoRemove (curr);
-          return pos;
-        }
-      else if (!TtlExceeded (it))
-        {
-          it++;
-        }
     }
-  NS_LOG_DEBUG ("Invalid iterator");
-  return end ();
+  RemoveExpired ();
+  return pos;
 }
 
 uint32_t
@@ -486,16 +593,12 @@ WifiMacQueue::GetNPacketsByAddress (Mac48Address dest)
 
   uint32_t nPackets = 0;
 
-  for (ConstIterator it = begin (); it != end (); )
+  RemoveExpired ();
+  for (ConstIterator it = begin (); it != end (); it++)
     {
-      if (!TtlExceeded (it))
+      if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
         {
-          if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
-            {
-              nPackets++;
-            }
-
-          it++;
+          nPackets++;
         }
     }
   NS_LOG_DEBUG ("returns " << nPackets);
@@ -507,18 +610,11 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
   uint32_t nPackets = 0;
-  for (ConstIterator it = begin (); it != end (); )
+  RemoveExpired ();
+  auto list = m_tidAddressIndex.find (GetTidAddressKey (tid, dest));
+  if (list != m_tidAddressIndex.end ())
     {
-      if (!TtlExceeded (it))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              nPackets++;
-            }
-
-          it++;
-        }
+      nPackets = list->second.size ();
     }
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
@@ -545,13 +641,7 @@ WifiMacQueue::GetNPackets (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (ConstIterator it = begin (); it != end (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  RemoveExpired ();
   return QueueBase::GetNPackets ();
 }
 
@@ -560,13 +650,7 @@ WifiMacQueue::GetNBytes (void)
 {
   NS_LOG_FUNCTION (this);
   // remove packets that stayed in the queue for too long
-  for (ConstIterator it = begin (); it != end (); )
-    {
-      if (!TtlExceeded (it))
-        {
-          it++;
-        }
-    }
+  RemoveExpired ();
   return QueueBase::GetNBytes ();
 }
 
@@ -24,6 +24,8 @@
 #ifndef WIFI_MAC_QUEUE_H
 #define WIFI_MAC_QUEUE_H
 
+#include <map>
+#include <unordered_map>
 #include "wifi-mac-queue-item.h"
 #include "ns3/queue.h"
 
@@ -53,6 +55,12 @@ extern template class Queue<WifiMacQueueItem>;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * The QoS Data frames are also linked, in queue order, in one list per
+ * (TID, receiver address) pair, so that peeking, dequeuing and counting
+ * the frames for a given TID and receiver do not walk the whole queue.
+ * All the items are also indexed by timestamp, so that the items whose
+ * lifetime expired are found without walking the queue either.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -281,7 +289,9 @@ public:
   uint32_t GetNPacketsByAddress (Mac48Address dest);
   /**
    * Return the number of QoS packets having tid equal to <i>tid</i> and
-   * destination address equal to <i>dest</i>.
+   * destination address equal to <i>dest</i>. The count is kept by the
+   * queue, hence this method takes constant time, once the expired
+   * packets are removed.
    *
    * \param tid the given TID
    * \param dest the given destination
@@ -323,11 +333,78 @@ private:
    * \return true if the item is removed, false otherwise
    */
   bool TtlExceeded (ConstIterator &it);
+  /**
+   * Remove all the items which have been in the queue for too long, oldest
+   * first.
+   *
+   * \return the number of items removed
+   */
+  uint32_t RemoveExpired (void);
+
+  /**
+   * Insert an item in the queue and in the indices.
+   *
+   * \param pos the position before which the item is to be inserted
+   * \param item the item to insert
+   * \return true if success, false if the packet has been dropped
+   */
+  bool DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item);
+  /**
+   * Remove an item from the indices and dequeue it.
+   *
+   * \param pos the position of the item to dequeue
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoDequeue (ConstIterator pos);
+  /**
+   * Remove an item from the indices, then from the queue, and drop it.
+   *
+   * \param pos the position of the item to remove
+   * \return the item
+   */
+  Ptr<WifiMacQueueItem> DoRemove (ConstIterator pos);
+
+  /**
+   * \param tid the TID
+   * \param address the receiver address
+   * \return the key of the (TID, receiver) index
+   */
+  static uint64_t GetTidAddressKey (uint8_t tid, Mac48Address address);
+  /**
+   * \param item the item
+   * \return true if the item is linked in a (TID, receiver) list
+   */
+  static bool IsTidAddressIndexed (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Link the item at the given position in the indices.
+   *
+   * \param pos the position of the item just inserted in the queue
+   */
+  void AddToIndex (ConstIterator pos);
+  /**
+   * Unlink the item at the given position from the indices.
+   *
+   * \param pos the position of the item about to leave the queue
+   */
+  void RemoveFromIndex (ConstIterator pos);
+
+  /// Items of a (TID, receiver address) pair, in queue order
+  typedef std::list<ConstIterator> TidAddressList;
+  /// Items in order of timestamp
+  typedef std::multimap<Time, ConstIterator> ExpiryIndex;
+  /// Positions of an item in the indices
+  struct ItemIndex
+  {
+    TidAddressList::iterator tidAddressPos; //!< position in its (TID, receiver) list, if a QoS Data frame
+    ExpiryIndex::iterator expiryPos;        //!< position in the timestamp index
+  };
 
   QueueSize m_maxSize;                      //!< max queue size
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
-  mutable bool m_expiredPacketsPresent;     //!> True if expired packets are in the queue
+  std::unordered_map<uint64_t, TidAddressList> m_tidAddressIndex; //!< QoS Data frames by (TID, receiver)
+  ExpiryIndex m_expiryIndex;                //!< All the items by timestamp
+  std::unordered_map<const WifiMacQueueItem *, ItemIndex> m_itemIndex; //!< Positions of the items in the indices
 
   /// Traced callback: fired when a packet is dropped due to lifetime expiration
   TracedCallback<Ptr<const WifiMacQueueItem> > m_traceExpired;
@@ -19,6 +19,7 @@
  */
 
 #include "wifi-phy-tag.h"
+#include "wifi-utils.h"
 
 namespace ns3 {
 
@@ -40,7 +41,7 @@ WifiPhyTag::GetInstanceTypeId (void) const
 uint32_t
 WifiPhyTag::GetSerializedSize (void) const
 {
-  return 3;
+  return 23;
 }
 
 void
@@ -49,6 +50,10 @@ WifiPhyTag::Serialize (TagBuffer i) const
   i.WriteU8 (static_cast<uint8_t> (m_preamble));
   i.WriteU8 (static_cast<uint8_t> (m_modulation));
   i.WriteU8 (m_frameComplete);
+  i.WriteU16 (m_obssDst);
+  i.WriteU16 (m_obssSrc);
+  i.WriteU64 (m_obssDuration);
+  i.WriteDouble (m_obssTxPower);
 }
 
 void
@@ -57,6 +62,10 @@ WifiPhyTag::Deserialize (TagBuffer i)
   m_preamble = static_cast<WifiPreamble> (i.ReadU8 ());
   m_modulation = static_cast<WifiModulationClass> (i.ReadU8 ());
   m_frameComplete = i.ReadU8 ();
+  m_obssDst = i.ReadU16 ();
+  m_obssSrc = i.ReadU16 ();
+  m_obssDuration = i.ReadU64 ();
+  m_obssTxPower = i.ReadDouble ();
 }
 
 void
@@ -66,13 +75,21 @@ WifiPhyTag::Print (std::ostream &os) const
 }
 
 WifiPhyTag::WifiPhyTag ()
+  : m_obssDst (NO_NODE_ID),
+    m_obssSrc (NO_NODE_ID),
+    m_obssDuration (0),
+    m_obssTxPower (0)
 {
 }
 
 WifiPhyTag::WifiPhyTag (WifiPreamble preamble, WifiModulationClass modulation, uint8_t frameComplete)
   : m_preamble (preamble),
     m_modulation (modulation),
-    m_frameComplete (frameComplete)
+    m_frameComplete (frameComplete),
+    m_obssDst (NO_NODE_ID),
+    m_obssSrc (NO_NODE_ID),
+    m_obssDuration (0),
+    m_obssTxPower (0)
 {
 }
 
@@ -94,4 +111,37 @@ WifiPhyTag::GetFrameComplete (void) const
   return m_frameComplete;
 }
 
+void
+WifiPhyTag::SetObssInfo (uint16_t dst, uint16_t src, Time duration, double txPowerDbm)
+{
+  m_obssDst = dst;
+  m_obssSrc = src;
+  m_obssDuration = duration.GetNanoSeconds ();
+  m_obssTxPower = txPowerDbm;
+}
+
+uint16_t
+WifiPhyTag::GetObssDst (void) const
+{
+  return m_obssDst;
+}
+
+uint16_t
+WifiPhyTag::GetObssSrc (void) const
+{
+  return m_obssSrc;
+}
+
+Time
+WifiPhyTag::GetObssDuration (void) const
+{
+  return NanoSeconds (m_obssDuration);
+}
+
+double
+WifiPhyTag::GetObssTxPower (void) const
+{
+  return m_obssTxPower;
+}
+
 } // namespace ns3
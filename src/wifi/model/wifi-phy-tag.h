@@ -24,6 +24,7 @@
 #include "ns3/tag.h"
 #include "wifi-preamble.h"
 #include "wifi-mode.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
@@ -69,6 +70,32 @@ public:
    * \return the frameComplete parameter, i.e. 0 if the frame is not complete, 1 otherwise.
    */
   uint8_t GetFrameComplete (void) const;
+  /**
+   * Set the OBSS information of a HE PPDU, which the OBSS PD algorithms
+   * learn from.
+   *
+   * \param dst the node id of the receiver, NO_NODE_ID if none
+   * \param src the node id of the transmitter
+   * \param duration the duration of the PPDU
+   * \param txPowerDbm the TX power (dBm), antenna gain included
+   */
+  void SetObssInfo (uint16_t dst, uint16_t src, Time duration, double txPowerDbm);
+  /**
+   * \return the node id of the receiver of the PPDU
+   */
+  uint16_t GetObssDst (void) const;
+  /**
+   * \return the node id of the transmitter of the PPDU
+   */
+  uint16_t GetObssSrc (void) const;
+  /**
+   * \return the duration of the PPDU
+   */
+  Time GetObssDuration (void) const;
+  /**
+   * \return the TX power (dBm) of the PPDU
+   */
+  double GetObssTxPower (void) const;
 
   // From class Tag
   uint32_t GetSerializedSize (void) const;
@@ -81,6 +108,10 @@ private:
   WifiPreamble m_preamble;          ///< preamble type
   WifiModulationClass m_modulation; ///< modulation used for transmission
   uint8_t m_frameComplete;          ///< Used to indicate that TX stopped sending before the end of the frame
+  uint16_t m_obssDst;               ///< node id of the receiver
+  uint16_t m_obssSrc;               ///< node id of the transmitter
+  int64_t m_obssDuration;           ///< duration of the PPDU, in ns
+  double m_obssTxPower;             ///< TX power (dBm)
 };
 
 } // namespace ns3
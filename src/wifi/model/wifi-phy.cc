@@ -325,6 +325,13 @@ WifiPhy::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&WifiPhy::m_postReceptionErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("TxDurationCacheSize",
+                   "The maximum number of TX durations, by size, TXVECTOR, band "
+                   "and MPDU type, remembered by this PHY. The cache is flushed "
+                   "when it is full. 0 disables the cache.",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&WifiPhy::m_txDurationCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddTraceSource ("PhyTxBegin",
                      "Trace source indicating a packet "
                      "has begun transmitting over the channel medium",
@@ -397,6 +404,7 @@ WifiPhy::WifiPhy ()
     m_initialChannelNumber (0),
     m_totalAmpduSize (0),
     m_totalAmpduNumSymbols (0),
+    m_txDurationCacheSize (0),
     m_currentEvent (0),
     m_wifiRadioEnergyModel (0),
     m_timeLastPreambleDetected (Seconds (0))
@@ -766,6 +774,12 @@ WifiPhy::SetErrorRateModel (const Ptr<ErrorRateModel> rate)
   m_interference.SetNumberOfReceiveAntennas (GetNumberOfAntennas ());
 }
 
+Ptr<ErrorRateModel>
+WifiPhy::GetErrorRateModel (void) const
+{
+  return m_interference.GetErrorRateModel ();
+}
+
 void
 WifiPhy::SetPostReceptionErrorModel (const Ptr<ErrorModel> em)
 {
@@ -2048,9 +2062,87 @@ WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t freq
   return GetPayloadDuration (size, txVector, frequency, NORMAL_MPDU, 0);
 }
 
+bool
+WifiPhy::TxDurationKey::operator== (const TxDurationKey &o) const
+{
+  return size == o.size && txVector == o.txVector;
+}
+
+std::size_t
+WifiPhy::TxDurationKeyHash::operator() (const TxDurationKey &key) const
+{
+  // 64-bit mix of both words (splitmix64 finalizer)
+  uint64_t h = key.size * 0x9e3779b97f4a7c15ULL ^ key.txVector;
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  return static_cast<std::size_t> (h ^ (h >> 31));
+}
+
+WifiPhy::TxDurationKey
+WifiPhy::GetTxDurationKey (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype)
+{
+  TxDurationKey key;
+  key.size = (static_cast<uint64_t> (size) << 32)
+    | (static_cast<uint64_t> (mpdutype) << 1)
+    | (Is2_4Ghz (frequency) ? 1 : 0);
+  // Only the fields the durations depend on: 16 bits of mode UID,
+  // channel width and guard interval, then the preamble, NSS, NESS
+  // and STBC in the last 12 bits.
+  key.txVector = (static_cast<uint64_t> (txVector.GetMode ().GetUid () & 0xffff) << 44)
+    | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 28)
+    | (static_cast<uint64_t> (txVector.GetGuardInterval ()) << 12)
+    | (static_cast<uint64_t> (txVector.GetPreambleType () & 0xf) << 8)
+    | (static_cast<uint64_t> (txVector.GetNss () & 0xf) << 4)
+    | (static_cast<uint64_t> (txVector.GetNess () & 0x7) << 1)
+    | (txVector.IsStbc () ? 1 : 0);
+  return key;
+}
+
+const WifiPhy::TxDuration &
+WifiPhy::LookupTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype)
+{
+  TxDurationKey key = GetTxDurationKey (size, txVector, frequency, mpdutype);
+  TxDurationCache::const_iterator it = m_txDurationCache.find (key);
+  if (it != m_txDurationCache.end ())
+    {
+      return it->second;
+    }
+  if (m_txDurationCache.size () >= m_txDurationCacheSize)
+    {
+      // Sizes of aggregates vary a lot; start over rather than grow.
+      NS_LOG_DEBUG ("TX duration cache full, flushing " << m_txDurationCache.size () << " entries");
+      m_txDurationCache.clear ();
+    }
+  TxDuration duration;
+  duration.payload = ComputePayloadDuration (size, txVector, frequency, mpdutype, 0);
+  duration.total = CalculatePlcpPreambleAndHeaderDuration (txVector) + duration.payload;
+  return m_txDurationCache.insert (std::make_pair (key, duration)).first->second;
+}
+
+bool
+WifiPhy::IsTxDurationCacheable (MpduType mpdutype, uint8_t incFlag) const
+{
+  // The last MPDU of an A-MPDU depends on the previous ones, and the
+  // other MPDUs of an A-MPDU update that state when incFlag is set.
+  return m_txDurationCacheSize > 0
+         && (mpdutype == NORMAL_MPDU || mpdutype == SINGLE_MPDU
+             || ((mpdutype == FIRST_MPDU_IN_AGGREGATE || mpdutype == MIDDLE_MPDU_IN_AGGREGATE) && incFlag == 0));
+}
+
 Time
 WifiPhy::GetPayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency,
                              MpduType mpdutype, uint8_t incFlag)
+{
+  if (IsTxDurationCacheable (mpdutype, incFlag))
+    {
+      return LookupTxDuration (size, txVector, frequency, mpdutype).payload;
+    }
+  return ComputePayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+}
+
+Time
+WifiPhy::ComputePayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency,
+                                 MpduType mpdutype, uint8_t incFlag)
 {
   WifiMode payloadMode = txVector.GetMode ();
   NS_LOG_FUNCTION (size << payloadMode);
@@ -2336,6 +2428,10 @@ Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency,
                               MpduType mpdutype, uint8_t incFlag)
 {
+  if (IsTxDurationCacheable (mpdutype, incFlag))
+    {
+      return LookupTxDuration (size, txVector, frequency, mpdutype).total;
+    }
   Time duration = CalculatePlcpPreambleAndHeaderDuration (txVector)
     + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
   return duration;
@@ -2347,6 +2443,30 @@ WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t fre
   return CalculateTxDuration (size, txVector, frequency, NORMAL_MPDU, 0);
 }
 
+double
+WifiPhy::GetRxPowerDbm (Ptr<const WifiPhy> receiver, double txPowerDbm) const
+{
+  NS_FATAL_ERROR ("The channel of this PHY cannot evaluate the RX power of a single link");
+  return 0;
+}
+
+InterferenceHelper::SnrPer
+WifiPhy::CalculateNoInterferenceSnrPer (double rxPowerW, WifiTxVector txVector, uint32_t size) const
+{
+  InterferenceHelper::SnrPer snrPer = m_interference.CalculateNoInterferenceSnrPer (rxPowerW, txVector, size);
+  if (!IsPreambleDetected (rxPowerW, snrPer.snr))
+    {
+      snrPer.per = 1;
+    }
+  return snrPer;
+}
+
+bool
+WifiPhy::IsPreambleDetected (double rxPowerW, double snr) const
+{
+  return !m_preambleDetectionModel || m_preambleDetectionModel->IsPreambleDetected (rxPowerW, snr, m_channelWidth);
+}
+
 void
 WifiPhy::NotifyTxBegin (Ptr<const Packet> packet, double txPowerW)
 {
@@ -2566,59 +2686,6 @@ WifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector)
       NS_LOG_DEBUG ("Transmitting without power restriction");
     }
 
-  // #############
-  // // set BSS color
-  // if(txVector.GetBssColor())
-  // {
-  //   Ptr<Packet> obssPacket = packet->Copy (); // obtain non-const Packet
-  //   WifiMacHeader head;
-  //   AmpduSubframeHeader head2;
-  //   uint8_t addrs[6]; 
-  //   uint8_t addrs2[6];
-  //   // uint32_t testFlag=0;
-  //   // obssPacket->PeekHeader(head2);
-  //   obssPacket->PeekHeader(head); // may be mac header or AmpduSubframeHeader
-  //   head.GetAddr1().CopyTo(addrs); // dst address
-  //   head.GetAddr2().CopyTo(addrs2); // src address
-  //   if(addrs[0]+addrs[1]+addrs[2]+addrs[3]+addrs[4]!=0 || !addrs[5]) // should be the wrong mac address
-  //   {
-  //     obssPacket->RemoveHeader(head2);
-  //     obssPacket->PeekHeader(head); // may be mac header or AmpduSubframeHeader
-  //     head.GetAddr1().CopyTo(addrs);
-  //     head.GetAddr2().CopyTo(addrs2);
-  //   }
-  //   // std::cout<<"packet : ";
-  //   // obssPacket->Print(std::cout);
-  //   // std::cout<<std::endl;
-  //   // std::cout<<"sending to mac: "<<head.GetAddr1()<<std::endl;
-
-  //   txVector.SetBssColor(addrs[5]*8 + addrs2[5]); // set BSS color as dst mac addr + src mac addr
-
-  // }
-
-  Ptr<Packet> obssPacket = packet->Copy (); // obtain non-const Packet
-  // std::cout<<"packet : ";
-  // obssPacket->Print(std::cout);
-  // std::cout<<std::endl;
-
-  WifiMacHeader head;
-  AmpduSubframeHeader head2;
-  uint8_t addrs[6]; 
-  uint8_t addrs2[6];
-  // uint32_t testFlag=0;
-  // obssPacket->PeekHeader(head2);
-  obssPacket->PeekHeader(head); // may be mac header or AmpduSubframeHeader
-  head.GetAddr1().CopyTo(addrs); // dst address
-  head.GetAddr2().CopyTo(addrs2); // src address
-  if(addrs[0]+addrs[1]+addrs[2]+addrs[3]+addrs[4]!=0 || !addrs[5]) // should be the wrong mac address
-  {
-    obssPacket->RemoveHeader(head2);
-    obssPacket->PeekHeader(head); // may be mac header or AmpduSubframeHeader
-    head.GetAddr1().CopyTo(addrs);
-    head.GetAddr2().CopyTo(addrs2);
-  }
-  // std::cout<<"sending to mac: "<<head.GetAddr1()<<std::endl;
-
   NotifyTxBegin (packet, DbmToW (GetTxPowerForTransmission (txVector) + GetTxGain ()));
   NotifyMonitorSniffTx (packet, GetFrequency (), txVector);
   m_state->SwitchToTx (txDuration, packet, GetPowerDbm (txVector.GetTxPowerLevel ()), txVector);
@@ -2665,13 +2732,6 @@ WifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector)
       heSig.SetChannelWidth (txVector.GetChannelWidth ());
       heSig.SetGuardIntervalAndLtfSize (txVector.GetGuardInterval (), 2/*NLTF currently unused*/);
       heSig.SetNStreams (txVector.GetNss ());
-      // heSig.SetSrc(123);
-      heSig.SetDst(addrs[5]);
-      heSig.SetSrc(addrs2[5]);
-      heSig.SetTxPower((uint8_t)(10*(GetTxPowerForTransmission (txVector) + GetTxGain ())));
-      // std::cout<< "Time in : "<<txDuration<<"  "<< +(uint8_t)(txDuration.ToInteger(Time::Unit::US)/10)<<std::endl;
-      heSig.SetTime((uint8_t)(txDuration.ToInteger(Time::Unit::US)/10));
-
       newPacket->AddHeader (heSig);
     }
   if ((txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_DSSS) || (txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HR_DSSS))
@@ -2719,6 +2779,28 @@ WifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector)
       isFrameComplete = 0;
     }
   WifiPhyTag tag (txVector.GetPreambleType (), txVector.GetMode ().GetModulationClass (), isFrameComplete);
+  if (txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HE)
+    {
+      //The OBSS PD algorithms learn who transmits to whom, for how long
+      //and at which power
+      Ptr<Packet> mpdu = packet->Copy ();
+      if (IsAmpdu (mpdu))
+        {
+          AmpduSubframeHeader subframeHdr;
+          mpdu->RemoveHeader (subframeHdr);
+        }
+      WifiMacHeader hdr;
+      mpdu->PeekHeader (hdr);
+      uint16_t src = NO_NODE_ID;
+      if (GetDevice ())
+        {
+          uint32_t nodeId = GetDevice ()->GetNode ()->GetId ();
+          NS_ABORT_MSG_IF (nodeId >= NO_NODE_ID, "Node id " << nodeId << " does not fit the OBSS information");
+          src = nodeId;
+        }
+      tag.SetObssInfo (GetNodeIdOfAddress (hdr.GetAddr1 ()), src, txDuration,
+                       GetTxPowerForTransmission (txVector) + GetTxGain ());
+    }
   newPacket->AddPacketTag (tag);
 
   StartTx (newPacket, txVector, txDuration);
@@ -2921,7 +3003,6 @@ WifiPhy::StartReceivePreamble (Ptr<Packet> packet, double rxPowerW, Time rxDurat
           NS_FATAL_ERROR ("Received 802.11ax signal with no HE-SIG field");
           return;
         }
-      // std::cout << "packet header: "<< (int)heSigHdr.GetSrc()<< std::endl;
 
       txVector.SetChannelWidth (heSigHdr.GetChannelWidth ());
       txVector.SetNss (heSigHdr.GetNStreams ());
@@ -2936,12 +3017,10 @@ WifiPhy::StartReceivePreamble (Ptr<Packet> packet, double rxPowerW, Time rxDurat
         }
       txVector.SetGuardInterval (heSigHdr.GetGuardInterval ());
       txVector.SetBssColor (heSigHdr.GetBssColor ());
-      // ####
-      // add obss info to txvector
-      txVector.SetObssDst(heSigHdr.GetDst());
-      txVector.SetObssSrc(heSigHdr.GetSrc());
-      txVector.SetObssTime(heSigHdr.GetTime());
-      txVector.SetObssPower(heSigHdr.GetTxPower());
+      txVector.SetObssDst (tag.GetObssDst ());
+      txVector.SetObssSrc (tag.GetObssSrc ());
+      txVector.SetObssDuration (tag.GetObssDuration ());
+      txVector.SetObssTxPower (tag.GetObssTxPower ());
 
       if (IsAmpdu (packet))
         {
@@ -3092,11 +3171,11 @@ WifiPhy::StartReceivePayload (Ptr<Event> event)
               HePreambleParameters params;
               params.rssiW = event->GetRxPowerW ();
               params.bssColor = event->GetTxVector ().GetBssColor ();
-              params.dst = event->GetTxVector().GetObssDst();
-              params.src = event->GetTxVector().GetObssSrc();
-              params.mcs = event->GetTxVector().GetMode().GetMcsValue();
-              params.time = event->GetTxVector().GetObssTime();
-              params.txpower = event->GetTxVector().GetObssPower();
+              params.dst = event->GetTxVector ().GetObssDst ();
+              params.src = event->GetTxVector ().GetObssSrc ();
+              params.mcs = event->GetTxVector ().GetMode ().GetMcsValue ();
+              params.duration = event->GetTxVector ().GetObssDuration ();
+              params.txPowerDbm = event->GetTxVector ().GetObssTxPower ();
               NotifyEndOfHePreamble (params);
             }
         }
@@ -22,6 +22,7 @@
 #ifndef WIFI_PHY_H
 #define WIFI_PHY_H
 
+#include <unordered_map>
 #include "ns3/event-id.h"
 #include "ns3/deprecated.h"
 #include "ns3/error-model.h"
@@ -30,6 +31,8 @@
 #include "interference-helper.h"
 #include "wifi-phy-state-helper.h"
 
+class ObssWifiManagerTest;
+
 namespace ns3 {
 
 #define HE_PHY 125
@@ -79,11 +82,11 @@ struct HePreambleParameters
 {
   double rssiW; ///< RSSI in W
   uint8_t bssColor; ///< BSS color
-  uint8_t dst;
-  uint8_t src;
-  uint8_t mcs;
-  uint8_t time;
-  uint8_t txpower;
+  uint16_t dst; ///< node id of the receiver, NO_NODE_ID if none
+  uint16_t src; ///< node id of the transmitter
+  uint8_t mcs; ///< HE MCS
+  Time duration; ///< duration of the PPDU
+  double txPowerDbm; ///< TX power (dBm)
 };
 
 /**
@@ -94,6 +97,9 @@ struct HePreambleParameters
 class WifiPhy : public Object
 {
 public:
+  /// Allow test cases to access private members
+  friend class ::ObssWifiManagerTest;
+
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -282,6 +288,22 @@ public:
    */
   Time CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency,
                             MpduType mpdutype, uint8_t incFlag);
+  /**
+   * \param rxPowerW the received power in W, including the RX gain
+   * \param txVector the TXVECTOR used to send the frame
+   * \param size the number of bytes in the frame
+   *
+   * \return the SNR and the PER this PHY would see for the frame in the absence of interference
+   * (the PER is 1 if the preamble detection model, if any, would not detect the frame)
+   */
+  InterferenceHelper::SnrPer CalculateNoInterferenceSnrPer (double rxPowerW, WifiTxVector txVector, uint32_t size) const;
+  /**
+   * \param rxPowerW the received power in W, including the RX gain
+   * \param snr the SNR (linear) at the start of the frame
+   *
+   * \return true if the preamble detection model, if any, detects the frame
+   */
+  bool IsPreambleDetected (double rxPowerW, double snr) const;
 
   /**
    * \param txVector the transmission parameters used for this packet
@@ -562,6 +584,18 @@ public:
    */
   virtual Ptr<Channel> GetChannel (void) const = 0;
 
+  /**
+   * Return the power at which another PHY attached to the same channel
+   * would receive a transmission of this PHY.  PHY models whose channel
+   * cannot evaluate a single link abort.
+   *
+   * \param receiver the receiving PHY
+   * \param txPowerDbm the TX power in dBm, including the TX gain
+   *
+   * \return the RX power in dBm, including the RX gain of the receiver
+   */
+  virtual double GetRxPowerDbm (Ptr<const WifiPhy> receiver, double txPowerDbm) const;
+
   /**
    * Return a WifiMode for DSSS at 1Mbps.
    *
@@ -1495,6 +1529,10 @@ public:
    * \param rate the error rate model
    */
   void SetErrorRateModel (const Ptr<ErrorRateModel> rate);
+  /**
+   * \return the error rate model
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
   /**
    * Attach a receive ErrorModel to the WifiPhy.
    *
@@ -1918,6 +1956,70 @@ private:
   uint32_t m_totalAmpduSize;     //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   double m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
 
+  /// Key of the TX duration cache
+  struct TxDurationKey
+  {
+    uint64_t size;      //!< size in the upper 32 bits, then MPDU type and 2.4 GHz flag
+    uint64_t txVector;  //!< the TXVECTOR fields the duration depends on
+    /**
+     * \param o the other key
+     * \return true if both keys are equal
+     */
+    bool operator== (const TxDurationKey &o) const;
+  };
+  /// Hash of TxDurationKey
+  struct TxDurationKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    std::size_t operator() (const TxDurationKey &key) const;
+  };
+  /// Cached durations
+  struct TxDuration
+  {
+    Time payload;  //!< duration of the payload
+    Time total;    //!< duration of the PLCP preamble, header and payload
+  };
+  /// TX duration cache
+  typedef std::unordered_map<TxDurationKey, TxDuration, TxDurationKeyHash> TxDurationCache;
+  TxDurationCache m_txDurationCache; //!< Durations of the stateless transmissions
+  uint32_t m_txDurationCacheSize;    //!< Maximum number of entries of m_txDurationCache
+
+  /**
+   * \param mpdutype the type of the MPDU
+   * \param incFlag whether the A-MPDU state is updated
+   * \return true if the TX duration can be taken from the cache
+   */
+  bool IsTxDurationCacheable (MpduType mpdutype, uint8_t incFlag) const;
+  /**
+   * \param size the number of bytes in the packet to send
+   * \param txVector the TXVECTOR used for the transmission of this packet
+   * \param frequency the channel center frequency (MHz)
+   * \param mpdutype the type of the MPDU
+   * \return the key of the TX duration cache
+   */
+  static TxDurationKey GetTxDurationKey (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype);
+  /**
+   * \param size the number of bytes in the packet to send
+   * \param txVector the TXVECTOR used for the transmission of this packet
+   * \param frequency the channel center frequency (MHz)
+   * \param mpdutype the type of the MPDU
+   * \return the durations, computed and cached if not cached yet
+   */
+  const TxDuration & LookupTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype);
+  /**
+   * \param size the number of bytes in the packet to send
+   * \param txVector the TXVECTOR used for the transmission of this packet
+   * \param frequency the channel center frequency (MHz)
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::MpduType.
+   * \param incFlag whether the A-MPDU state is updated
+   *
+   * \return the duration of the payload, computed without the cache
+   */
+  Time ComputePayloadDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag);
+
   Ptr<NetDevice>     m_device;   //!< Pointer to the device
   Ptr<MobilityModel> m_mobility; //!< Pointer to the mobility model
 
@@ -122,6 +122,15 @@ WifiRemoteStationManager::GetTypeId (void)
                      "The transmission of a data packet has exceeded the maximum number of attempts",
                      MakeTraceSourceAccessor (&WifiRemoteStationManager::m_macTxFinalDataFailed),
                      "ns3::Mac48Address::TracedCallback")
+    .AddTraceSource ("DataModeChange",
+                     "The data mode selected for a remote station, or its data rate "
+                     "(e.g. after a change of NSS, channel width or guard interval), has changed",
+                     MakeTraceSourceAccessor (&WifiRemoteStationManager::m_dataModeChange),
+                     "ns3::WifiRemoteStationManager::DataModeChangeTracedCallback")
+    .AddTraceSource ("FrameErrorRate",
+                     "The frame error rate average of a remote station was updated",
+                     MakeTraceSourceAccessor (&WifiRemoteStationManager::m_frameErrorRate),
+                     "ns3::WifiRemoteStationManager::FrameErrorRateTracedCallback")
   ;
   return tid;
 }
@@ -524,6 +533,10 @@ WifiRemoteStationManager::PrepareForQueue (Mac48Address address, const WifiMacHe
   WifiRemoteStation *station = Lookup (address, header);
   WifiTxVector rts = DoGetRtsTxVector (station);
   WifiTxVector data = DoGetDataTxVector (station);
+  if (!header->IsMgt ())
+    {
+      NotifyDataMode (station, data);
+    }
   WifiTxVector ctstoself = DoGetCtsToSelfTxVector ();
   HighLatencyDataTxVectorTag datatag;
   HighLatencyRtsTxVectorTag rtstag;
@@ -567,8 +580,13 @@ WifiRemoteStationManager::GetDataTxVector (Mac48Address address, const WifiMacHe
       NS_ASSERT (found);
       return datatag.GetDataTxVector ();
     }
-  WifiTxVector txVector = DoGetDataTxVector (Lookup (address, header));
-  if (header->IsMgt ())
+  WifiRemoteStation *station = Lookup (address, header);
+  WifiTxVector txVector = DoGetDataTxVector (station);
+  if (!header->IsMgt ())
+    {
+      NotifyDataMode (station, txVector);
+    }
+  else
     {
       //Use the lowest basic rate for management frames
       WifiMode mgtMode;
@@ -714,6 +732,7 @@ WifiRemoteStationManager::ReportRtsOk (Mac48Address address, const WifiMacHeader
   NS_ASSERT (!address.IsGroup ());
   WifiRemoteStation *station = Lookup (address, header);
   station->m_state->m_info.NotifyTxSuccess (station->m_ssrc);
+  NotifyFrameErrorRate (station);
   station->m_ssrc = 0;
   DoReportRtsOk (station, ctsSnr, ctsMode, rtsSnr);
 }
@@ -737,6 +756,7 @@ WifiRemoteStationManager::ReportDataOk (Mac48Address address, const WifiMacHeade
       station->m_state->m_info.NotifyTxSuccess (station->m_ssrc);
       station->m_ssrc = 0;
     }
+  NotifyFrameErrorRate (station);
   DoReportDataOk (station, ackSnr, ackMode, dataSnr);
 }
 
@@ -747,6 +767,7 @@ WifiRemoteStationManager::ReportFinalRtsFailed (Mac48Address address, const Wifi
   NS_ASSERT (!address.IsGroup ());
   WifiRemoteStation *station = Lookup (address, header);
   station->m_state->m_info.NotifyTxFailed ();
+  NotifyFrameErrorRate (station);
   station->m_ssrc = 0;
   m_macTxFinalRtsFailed (address);
   DoReportFinalRtsFailed (station);
@@ -760,6 +781,7 @@ WifiRemoteStationManager::ReportFinalDataFailed (Mac48Address address, const Wif
   NS_ASSERT (!address.IsGroup ());
   WifiRemoteStation *station = Lookup (address, header);
   station->m_state->m_info.NotifyTxFailed ();
+  NotifyFrameErrorRate (station);
   bool longMpdu = (packetSize + header->GetSize () + WIFI_MAC_FCS_LENGTH) > m_rtsCtsThreshold;
   if (longMpdu)
     {
@@ -1087,17 +1109,29 @@ WifiRemoteStationManager::GetInfo (Mac48Address address)
   return state->m_info;
 }
 
+uint64_t
+WifiRemoteStationManager::GetStationKey (Mac48Address address, uint8_t tid)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return (key << 8) | tid;
+}
+
 WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  uint64_t key = GetStationKey (address, 0);
+  StationStateIndex::const_iterator it = m_stateIndex.find (key);
+  if (it != m_stateIndex.end ())
     {
-      if ((*i)->m_address == address)
-        {
-          NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
-        }
+      NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+      return it->second;
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
   state->m_state = WifiRemoteStationState::BRAND_NEW;
@@ -1113,6 +1147,7 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_aggregation = false;
   state->m_qosSupported = false;
   const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  const_cast<WifiRemoteStationManager *> (this)->m_stateIndex[key] = state;
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
   return state;
 }
@@ -1136,13 +1171,11 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << +tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  uint64_t key = GetStationKey (address, tid);
+  StationIndex::const_iterator it = m_stationIndex.find (key);
+  if (it != m_stationIndex.end ())
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
-        {
-          return (*i);
-        }
+      return it->second;
     }
   WifiRemoteStationState *state = LookupState (address);
 
@@ -1151,7 +1184,9 @@ WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
   station->m_tid = tid;
   station->m_ssrc = 0;
   station->m_slrc = 0;
+  station->m_dataRate = 0;
   const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  const_cast<WifiRemoteStationManager *> (this)->m_stationIndex[key] = station;
   return station;
 }
 
@@ -1336,11 +1371,13 @@ WifiRemoteStationManager::Reset (void)
       delete (*i);
     }
   m_states.clear ();
+  m_stateIndex.clear ();
   for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
     {
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.clear ();
   m_bssBasicRateSet.clear ();
   m_bssBasicMcsSet.clear ();
 }
@@ -1610,6 +1647,31 @@ WifiRemoteStationManager::GetMac (void) const
   return m_wifiMac;
 }
 
+void
+WifiRemoteStationManager::NotifyDataMode (WifiRemoteStation *station, WifiTxVector txVector)
+{
+  WifiMode mode = txVector.GetMode ();
+  //The NSS, the channel width and the guard interval change the data rate
+  //of a mode
+  uint64_t dataRate = mode.GetDataRate (txVector);
+  if (!(mode == station->m_dataMode) || dataRate != station->m_dataRate)
+    {
+      NS_LOG_DEBUG ("Data mode of " << station->m_state->m_address << " changed from "
+                    << station->m_dataMode << " (" << station->m_dataRate << " b/s) to "
+                    << mode << " (" << dataRate << " b/s)");
+      WifiMode oldMode = station->m_dataMode;
+      station->m_dataMode = mode;
+      station->m_dataRate = dataRate;
+      m_dataModeChange (oldMode, mode, station->m_state->m_address);
+    }
+}
+
+void
+WifiRemoteStationManager::NotifyFrameErrorRate (WifiRemoteStation *station)
+{
+  m_frameErrorRate (station->m_state->m_info.GetFrameErrorRate (), station->m_state->m_address);
+}
+
 uint8_t
 WifiRemoteStationManager::GetNSupported (const WifiRemoteStation *station) const
 {
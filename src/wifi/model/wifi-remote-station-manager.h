@@ -21,6 +21,7 @@
 #ifndef WIFI_REMOTE_STATION_MANAGER_H
 #define WIFI_REMOTE_STATION_MANAGER_H
 
+#include <unordered_map>
 #include "ns3/traced-callback.h"
 #include "ns3/object.h"
 #include "ns3/data-rate.h"
@@ -60,6 +61,8 @@ struct WifiRemoteStation
   uint32_t m_ssrc;                  //!< STA short retry count
   uint32_t m_slrc;                  //!< STA long retry count
   uint8_t m_tid;                    //!< traffic ID
+  WifiMode m_dataMode;              //!< mode of the last data TX vector
+  uint64_t m_dataRate;              //!< data rate (bps) of the last data TX vector
 };
 
 /**
@@ -137,6 +140,14 @@ public:
    * A vector of WifiRemoteStationStates
    */
   typedef std::vector <WifiRemoteStationState *> StationStates;
+  /**
+   * An index of WifiRemoteStations, by address and TID
+   */
+  typedef std::unordered_map <uint64_t, WifiRemoteStation *> StationIndex;
+  /**
+   * An index of WifiRemoteStationStates, by address
+   */
+  typedef std::unordered_map <uint64_t, WifiRemoteStationState *> StationStateIndex;
 
   /**
    * Set up PHY associated with this device since it is the object that
@@ -915,6 +926,23 @@ public:
    */
   typedef void (*RateChangeTracedCallback)(DataRate oldRate, DataRate newRate, Mac48Address remoteAddress);
 
+  /**
+   * TracedCallback signature for data mode change events.
+   *
+   * \param [in] oldMode The previous data mode.
+   * \param [in] newMode The new data mode.
+   * \param [in] address The remote station MAC address.
+   */
+  typedef void (*DataModeChangeTracedCallback)(WifiMode oldMode, WifiMode newMode, Mac48Address remoteAddress);
+
+  /**
+   * TracedCallback signature for frame error rate update events.
+   *
+   * \param [in] frameErrorRate The new frame error rate average.
+   * \param [in] address The remote station MAC address.
+   */
+  typedef void (*FrameErrorRateTracedCallback)(double frameErrorRate, Mac48Address remoteAddress);
+
 
 protected:
   virtual void DoDispose (void);
@@ -1088,8 +1116,29 @@ protected:
    */
   Ptr<WifiMac> GetMac (void) const;
 
+  /**
+   * Notify a data TX vector selected for the given station, and fire the
+   * DataModeChange trace source if its mode or its data rate differs
+   * from the previous one.  This is called for every data TX vector; rate
+   * control algorithms whose selection changes between transmissions
+   * may call it as well, so that the users of the data mode (e.g. link
+   * metrics) do not wait for the next transmission to see the change.
+   *
+   * \param station the station being notified
+   * \param txVector the data TX vector selected for the station
+   */
+  void NotifyDataMode (WifiRemoteStation *station, WifiTxVector txVector);
+
 
 private:
+  /**
+   * Fire the FrameErrorRate trace source after the frame error rate
+   * average of the given station was updated.
+   *
+   * \param station the station whose frame error rate was updated
+   */
+  void NotifyFrameErrorRate (WifiRemoteStation *station);
+
   /**
    * \param station the station that we need to communicate
    * \param packet the packet to send
@@ -1234,6 +1283,14 @@ private:
    */
   virtual void DoReportAmpduTxStatus (WifiRemoteStation *station, uint8_t nSuccessfulMpdus, uint8_t nFailedMpdus, double rxSnr, double dataSnr);
 
+  /**
+   * Return the key of a station in the station indexes.
+   *
+   * \param address the address of the station
+   * \param tid the TID of the station
+   * \return the address in the upper 48 bits and the TID in the lower 8 bits
+   */
+  static uint64_t GetStationKey (Mac48Address address, uint8_t tid);
   /**
    * Return the state of the station associated with the given address.
    *
@@ -1316,6 +1373,8 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  StationStateIndex m_stateIndex;  //!< Index of m_states by address
+  StationIndex m_stationIndex;     //!< Index of m_stations by address and TID
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -1355,6 +1414,16 @@ private:
    * exceeded the maximum number of attempts
    */
   TracedCallback<Mac48Address> m_macTxFinalDataFailed;
+  /**
+   * The trace source fired when the data mode selected for a remote
+   * station, or its data rate, changes
+   */
+  TracedCallback<WifiMode, WifiMode, Mac48Address> m_dataModeChange;
+  /**
+   * The trace source fired when the frame error rate average of a
+   * remote station is updated
+   */
+  TracedCallback<double, Mac48Address> m_frameErrorRate;
 };
 
 } //namespace ns3
@@ -20,6 +20,7 @@
  */
 
 #include "wifi-tx-vector.h"
+#include "wifi-utils.h"
 
 namespace ns3 {
 
@@ -33,6 +34,9 @@ WifiTxVector::WifiTxVector ()
     m_aggregation (false),
     m_stbc (false),
     m_bssColor (0),
+    m_obssDst (NO_NODE_ID),
+    m_obssSrc (NO_NODE_ID),
+    m_obssTxPower (0),
     m_modeInitialized (false)
 {
 }
@@ -59,6 +63,9 @@ WifiTxVector::WifiTxVector (WifiMode mode,
     m_aggregation (aggregation),
     m_stbc (stbc),
     m_bssColor (bssColor),
+    m_obssDst (NO_NODE_ID),
+    m_obssSrc (NO_NODE_ID),
+    m_obssTxPower (0),
     m_modeInitialized (true)
 {
 }
@@ -238,44 +245,52 @@ WifiTxVector::IsValid (void) const
   return true;
 }
 
-void WifiTxVector::SetObssDst(uint8_t dst)
+void
+WifiTxVector::SetObssDst (uint16_t dst)
 {
-  m_obss_dst = dst;
+  m_obssDst = dst;
 }
 
-uint8_t WifiTxVector::GetObssDst() const
+uint16_t
+WifiTxVector::GetObssDst (void) const
 {
-  return m_obss_dst;
+  return m_obssDst;
 }
 
-void WifiTxVector::SetObssSrc(uint8_t src)
+void
+WifiTxVector::SetObssSrc (uint16_t src)
 {
-  m_obss_src = src;
+  m_obssSrc = src;
 }
 
-uint8_t WifiTxVector::GetObssSrc() const
+uint16_t
+WifiTxVector::GetObssSrc (void) const
 {
-  return m_obss_src;
+  return m_obssSrc;
 }
 
-void WifiTxVector::SetObssTime(uint8_t time)
+void
+WifiTxVector::SetObssDuration (Time duration)
 {
-  m_obss_time = time;
+  m_obssDuration = duration;
 }
 
-uint8_t WifiTxVector::GetObssTime() const
+Time
+WifiTxVector::GetObssDuration (void) const
 {
-  return m_obss_time;
+  return m_obssDuration;
 }
 
-void WifiTxVector::SetObssPower(uint8_t power)
+void
+WifiTxVector::SetObssTxPower (double txPowerDbm)
 {
-  m_obss_txpower = power;
+  m_obssTxPower = txPowerDbm;
 }
 
-uint8_t WifiTxVector::GetObssPower() const
+double
+WifiTxVector::GetObssTxPower (void) const
 {
-  return m_obss_txpower;
+  return m_obssTxPower;
 }
 
 std::ostream & operator << ( std::ostream &os, const WifiTxVector &v)
@@ -24,6 +24,7 @@
 
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
@@ -216,16 +217,46 @@ public:
    */
   bool IsValid (void) const;
 
-  // ######
-  // store obss info
-  void SetObssDst(uint8_t dst);
-  uint8_t GetObssDst(void) const;
-  void SetObssSrc(uint8_t src);
-  uint8_t GetObssSrc(void) const;
-  void SetObssTime(uint8_t time);
-  uint8_t GetObssTime(void) const;
-  void SetObssPower(uint8_t power);
-  uint8_t GetObssPower(void) const;
+  /**
+   * Set the node id of the receiver of the PPDU, for the OBSS PD algorithms
+   *
+   * \param dst the node id, NO_NODE_ID if none
+   */
+  void SetObssDst (uint16_t dst);
+  /**
+   * \return the node id of the receiver of the PPDU
+   */
+  uint16_t GetObssDst (void) const;
+  /**
+   * Set the node id of the transmitter of the PPDU, for the OBSS PD algorithms
+   *
+   * \param src the node id
+   */
+  void SetObssSrc (uint16_t src);
+  /**
+   * \return the node id of the transmitter of the PPDU
+   */
+  uint16_t GetObssSrc (void) const;
+  /**
+   * Set the duration of the PPDU, for the OBSS PD algorithms
+   *
+   * \param duration the duration
+   */
+  void SetObssDuration (Time duration);
+  /**
+   * \return the duration of the PPDU
+   */
+  Time GetObssDuration (void) const;
+  /**
+   * Set the TX power of the PPDU, for the OBSS PD algorithms
+   *
+   * \param txPowerDbm the TX power (dBm), antenna gain included
+   */
+  void SetObssTxPower (double txPowerDbm);
+  /**
+   * \return the TX power (dBm) of the PPDU
+   */
+  double GetObssTxPower (void) const;
 
 private:
   WifiMode m_mode;               /**< The DATARATE parameter in Table 15-4.
@@ -244,10 +275,10 @@ private:
   bool     m_stbc;               /**< STBC used or not */
   uint8_t  m_bssColor;           /**< BSS color */
 
-  uint8_t m_obss_dst;
-  uint8_t m_obss_src;
-  uint8_t m_obss_time;
-  uint8_t m_obss_txpower;
+  uint16_t m_obssDst;            /**< node id of the receiver */
+  uint16_t m_obssSrc;            /**< node id of the transmitter */
+  Time     m_obssDuration;       /**< duration of the PPDU */
+  double   m_obssTxPower;        /**< TX power (dBm) */
 
   bool     m_modeInitialized;         /**< Internal initialization flag */
 };
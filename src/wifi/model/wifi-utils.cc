@@ -18,12 +18,17 @@
  * Author: Sébastien Deronne <sebastien.deronne@gmail.com>
  */
 
+#include <map>
 #include "ns3/nstime.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/abort.h"
 #include "wifi-utils.h"
 #include "ctrl-headers.h"
 #include "wifi-mac-header.h"
 #include "wifi-mac-trailer.h"
 #include "wifi-net-device.h"
+#include "wifi-mac.h"
 #include "ht-configuration.h"
 #include "he-configuration.h"
 #include "wifi-mode.h"
@@ -303,4 +308,43 @@ IsAmpdu (Ptr<const Packet> packet)
     }
 }
 
+uint16_t
+GetNodeIdOfAddress (Mac48Address address)
+{
+  if (address.IsGroup ())
+    {
+      return NO_NODE_ID;
+    }
+  static std::map<Mac48Address, uint32_t> nodeIds;
+  std::map<Mac48Address, uint32_t>::const_iterator it = nodeIds.find (address);
+  //The cached node is checked, since the nodes are rebuilt by each
+  //simulation of a program
+  if (it != nodeIds.end () && it->second < NodeList::GetNNodes ())
+    {
+      Ptr<Node> node = NodeList::GetNode (it->second);
+      for (uint32_t i = 0; i < node->GetNDevices (); i++)
+        {
+          Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (node->GetDevice (i));
+          if (device && device->GetMac () && device->GetMac ()->GetAddress () == address)
+            {
+              return it->second;
+            }
+        }
+    }
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End (); node++)
+    {
+      for (uint32_t i = 0; i < (*node)->GetNDevices (); i++)
+        {
+          Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> ((*node)->GetDevice (i));
+          if (device && device->GetMac () && device->GetMac ()->GetAddress () == address)
+            {
+              NS_ABORT_MSG_IF ((*node)->GetId () >= NO_NODE_ID, "Node id " << (*node)->GetId () << " does not fit the OBSS information");
+              nodeIds[address] = (*node)->GetId ();
+              return (*node)->GetId ();
+            }
+        }
+    }
+  return NO_NODE_ID;
+}
+
 } //namespace ns3
@@ -24,6 +24,7 @@
 #include "block-ack-type.h"
 #include "wifi-preamble.h"
 #include "wifi-mode.h"
+#include "ns3/mac48-address.h"
 
 namespace ns3 {
 
@@ -183,6 +184,18 @@ uint32_t GetSize (Ptr<const Packet> packet, const WifiMacHeader *hdr, bool isAmp
  */
 bool IsAmpdu (Ptr<const Packet> packet);
 
+/// Node id which designates no node, or a group of nodes, in the OBSS information of the HE PPDUs
+static const uint16_t NO_NODE_ID = 0xffff;
+/**
+ * \param address the MAC address of a wifi device
+ * \return the id of the node of the device, as carried by the OBSS
+ * information of the HE PPDUs, NO_NODE_ID if the address is a group
+ * address or no wifi device has it
+ *
+ * The node of an address is looked up among the nodes once, then cached.
+ */
+uint16_t GetNodeIdOfAddress (Mac48Address address);
+
   /**
    * Get the maximum PPDU duration (see Section 10.14 of 802.11-2016) for
    * the PHY layers defining the aPPDUMaxTime characteristic (HT, VHT and HE).
@@ -121,6 +121,16 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
     }
 }
 
+double
+YansWifiChannel::GetRxPowerDbm (Ptr<const WifiPhy> sender, Ptr<const WifiPhy> receiver, double txPowerDbm) const
+{
+  NS_LOG_FUNCTION (this << sender << receiver << txPowerDbm);
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ();
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
+  NS_ASSERT (senderMobility != 0 && receiverMobility != 0);
+  return m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) + receiver->GetRxGain ();
+}
+
 void
 YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<Packet> packet, double rxPowerDbm, Time duration)
 {
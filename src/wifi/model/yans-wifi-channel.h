@@ -28,6 +28,7 @@ namespace ns3 {
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
+class WifiPhy;
 class YansWifiPhy;
 class Packet;
 class Time;
@@ -86,6 +87,16 @@ public:
    */
   void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm, Time duration) const;
 
+  /**
+   * \param sender the PHY which transmits
+   * \param receiver the PHY which receives
+   * \param txPowerDbm the tx power associated to the transmission, including the TX gain
+   *
+   * \return the power, in dBm and including the RX gain, at which \p receiver
+   * would receive a transmission of \p sender
+   */
+  double GetRxPowerDbm (Ptr<const WifiPhy> sender, Ptr<const WifiPhy> receiver, double txPowerDbm) const;
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -66,6 +66,12 @@ YansWifiPhy::GetChannel (void) const
   return m_channel;
 }
 
+double
+YansWifiPhy::GetRxPowerDbm (Ptr<const WifiPhy> receiver, double txPowerDbm) const
+{
+  return m_channel->GetRxPowerDbm (this, receiver, txPowerDbm);
+}
+
 void
 YansWifiPhy::SetChannel (const Ptr<YansWifiChannel> channel)
 {
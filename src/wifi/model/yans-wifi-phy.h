@@ -73,6 +73,7 @@ public:
   void StartTx (Ptr<Packet> packet, WifiTxVector txVector, Time txDuration);
 
   virtual Ptr<Channel> GetChannel (void) const;
+  virtual double GetRxPowerDbm (Ptr<const WifiPhy> receiver, double txPowerDbm) const;
 
 
 protected:
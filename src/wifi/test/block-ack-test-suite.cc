@@ -22,6 +22,14 @@
 #include "ns3/string.h"
 #include "ns3/qos-utils.h"
 #include "ns3/ctrl-headers.h"
+#include "ns3/block-ack-cache.h"
+#include "ns3/block-ack-window.h"
+#include "ns3/block-ack-manager.h"
+#include "ns3/mgt-headers.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/yans-wifi-phy.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/ht-configuration.h"
 #include "ns3/packet.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/ap-wifi-mac.h"
@@ -319,6 +327,430 @@ CtrlBAckResponseHeaderTest::DoRun (void)
 }
 
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test for the Block Ack window scoreboard
+ *
+ * Set and clear random bits of a BlockAckWindow, intersect it with
+ * random bitmaps and move it forward by random amounts, across the end
+ * of the sequence number space, and check it against a bitmap indexed
+ * by sequence number.
+ */
+class BlockAckWindowTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param winSize the size of the window
+   */
+  BlockAckWindowTest (uint16_t winSize);
+private:
+  virtual void DoRun ();
+  /**
+   * Check the window against the reference.
+   * \param window the window
+   * \param reference the bits of the sequence numbers of the window
+   */
+  void Check (const BlockAckWindow &window, const std::vector<bool> &reference);
+  uint16_t m_winSize; ///< the size of the window
+};
+
+BlockAckWindowTest::BlockAckWindowTest (uint16_t winSize)
+  : TestCase ("Check the Block Ack window scoreboard of size " + std::to_string (winSize)),
+    m_winSize (winSize)
+{
+}
+
+void
+BlockAckWindowTest::Check (const BlockAckWindow &window, const std::vector<bool> &reference)
+{
+  uint16_t start = window.GetWinStart ();
+  NS_TEST_EXPECT_MSG_EQ (window.GetWinEnd (), (start + m_winSize - 1) % 4096, "Wrong window end");
+  uint16_t nextUnset = m_winSize;
+  for (uint16_t d = m_winSize; d-- > 0; )
+    {
+      uint16_t seq = (start + d) % 4096;
+      NS_TEST_EXPECT_MSG_EQ (window.IsSet (seq), reference[seq], "Wrong bit of " << seq);
+      if (!reference[seq])
+        {
+          nextUnset = d;
+        }
+      if (d % 7 == 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (window.GetNextUnset (d), nextUnset, "Wrong unset MPDU after distance " << d);
+        }
+    }
+  const int16_t offsets[] = {0, 7, -5, -70, 63, 200};
+  for (uint8_t i = 0; i < sizeof (offsets) / sizeof (offsets[0]); i++)
+    {
+      uint16_t from = (start + offsets[i] + 4096) % 4096;
+      uint64_t words[4];
+      window.GetBitmap (from, words, 4);
+      for (uint16_t b = 0; b < 256; b++)
+        {
+          uint16_t seq = (from + b) % 4096;
+          bool expected = window.IsInWindow (seq) && reference[seq];
+          NS_TEST_EXPECT_MSG_EQ (((words[b / 64] >> (b % 64)) & 1), uint64_t (expected),
+                                 "Wrong bit " << b << " of the bitmap from " << from);
+        }
+    }
+}
+
+void
+BlockAckWindowTest::DoRun (void)
+{
+  BlockAckWindow window;
+  window.Init (4000, m_winSize);
+  std::vector<bool> reference (4096, false);
+  uint32_t random = 12345;
+  for (uint16_t round = 0; round < 200; round++)
+    {
+      for (uint16_t i = 0; i < m_winSize / 2; i++)
+        {
+          random = random * 1103515245 + 12345;
+          uint16_t seq = (window.GetWinStart () + (random >> 16) % m_winSize) % 4096;
+          window.Set (seq);
+          reference[seq] = true;
+        }
+      Check (window, reference);
+      for (uint16_t i = 0; i < m_winSize / 8; i++)
+        {
+          random = random * 1103515245 + 12345;
+          uint16_t seq = (window.GetWinStart () + (random >> 16) % m_winSize) % 4096;
+          window.Reset (seq);
+          reference[seq] = false;
+        }
+      Check (window, reference);
+      if (round % 4 == 1)
+        {
+          // a block ack bitmap, usually dense, starting near the window
+          random = random * 1103515245 + 12345;
+          uint16_t from = (window.GetWinStart () + (random >> 16) % 100 - 50 + 4096) % 4096;
+          std::size_t nWords = (round % 8 == 1) ? 1 : 4;
+          uint64_t words[4];
+          for (std::size_t w = 0; w < nWords; w++)
+            {
+              uint64_t bits[2] = {0, 0};
+              for (uint8_t j = 0; j < 8; j++)
+                {
+                  random = random * 1103515245 + 12345;
+                  bits[j % 2] = (bits[j % 2] << 16) | (random >> 16);
+                }
+              // one hole out of four MPDUs
+              words[w] = ~(bits[0] & bits[1]);
+            }
+          for (uint16_t d = 0; d < m_winSize; d++)
+            {
+              uint16_t seq = (window.GetWinStart () + d) % 4096;
+              uint16_t b = (seq - from + 4096) % 4096;
+              if (b >= 64 * nWords || ((words[b / 64] >> (b % 64)) & 1) == 0)
+                {
+                  reference[seq] = false;
+                }
+            }
+          window.Intersect (from, words, nWords);
+          Check (window, reference);
+        }
+      random = random * 1103515245 + 12345;
+      // mostly small moves, sometimes past the whole window
+      uint16_t count = (round % 10 == 9) ? m_winSize + (random >> 16) % 300 : (random >> 16) % (m_winSize / 2);
+      for (uint16_t i = 0; i < count && i < 4096; i++)
+        {
+          reference[(window.GetWinStart () + m_winSize + i) % 4096] = false;
+        }
+      window.Advance (count);
+      Check (window, reference);
+    }
+}
+
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test for the bitmap of the block acks filled by BlockAckCache
+ */
+class BlockAckCacheTest : public TestCase
+{
+public:
+  BlockAckCacheTest ();
+private:
+  virtual void DoRun ();
+};
+
+BlockAckCacheTest::BlockAckCacheTest ()
+  : TestCase ("Check the block ack bitmap filled by the block ack cache")
+{
+}
+
+void
+BlockAckCacheTest::DoRun (void)
+{
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetFragmentNumber (0);
+
+  const uint16_t winSizes[] = {64, 256};
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      uint16_t winSize = winSizes[i];
+      BlockAckCache cache;
+      cache.Init (4000, winSize);
+      CtrlBAckResponseHeader blockAck;
+      blockAck.SetType (winSize == 64 ? COMPRESSED_BLOCK_ACK : EXTENDED_COMPRESSED_BLOCK_ACK);
+
+      // receive all the MPDUs of two windows, across the end of the sequence
+      // number space, but one out of five; the window ends with the last MPDU
+      for (uint16_t n = 0; n < 2 * winSize; n++)
+        {
+          if (n % 5 != 3)
+            {
+              hdr.SetSequenceNumber ((4000 + n) % 4096);
+              cache.UpdateWithMpdu (&hdr);
+            }
+        }
+      uint16_t winStart = (4000 + winSize) % 4096;
+      NS_TEST_EXPECT_MSG_EQ (cache.GetWinStart (), winStart, "Wrong window start");
+      blockAck.ResetBitmap ();
+      blockAck.SetStartingSequence (cache.GetWinStart ());
+      cache.FillBlockAckBitmap (&blockAck);
+      for (uint16_t n = winSize; n < 2 * winSize; n++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (blockAck.IsPacketReceived ((4000 + n) % 4096), (n % 5 != 3),
+                                 "Wrong bit for MPDU " << n << " of window " << winSize);
+        }
+
+      // a Block Ack Request moves the window forward; the MPDUs entering it
+      // are not received
+      cache.UpdateWithBlockAckReq ((winStart + 10) % 4096);
+      blockAck.ResetBitmap ();
+      blockAck.SetStartingSequence (cache.GetWinStart ());
+      cache.FillBlockAckBitmap (&blockAck);
+      for (uint16_t n = winSize + 10; n < 2 * winSize + 10; n++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (blockAck.IsPacketReceived ((4000 + n) % 4096), (n < 2 * winSize && n % 5 != 3),
+                                 "Wrong bit for MPDU " << n << " of window " << winSize << " after BAR");
+        }
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test for the scoreboard of the MPDUs in flight of BlockAckManager
+ *
+ * Send a window of MPDUs, across the end of the sequence number space,
+ * and acknowledge all of them but one out of five with a block ack.
+ * Then retransmit the missing MPDUs with new ones, acknowledge all of
+ * them but one, and finally miss the block ack of a third window.
+ */
+class BlockAckManagerScoreboardTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param winSize the size of the window
+   */
+  BlockAckManagerScoreboardTest (uint16_t winSize);
+private:
+  virtual void DoRun ();
+  /**
+   * Send MPDUs: the MPDUs of the retransmission queue, then new MPDUs up
+   * to the end of the transmit window.
+   * \param manager the block ack manager
+   */
+  void SendWindow (Ptr<BlockAckManager> manager);
+  /**
+   * Check the retransmission queue.
+   * \param manager the block ack manager
+   * \param expected the sequence numbers expected in the queue, in order
+   */
+  void CheckRetransmissions (Ptr<BlockAckManager> manager, const std::vector<uint16_t> &expected);
+  /**
+   * Count the MPDUs acknowledged by a block ack.
+   * \param hdr the header of the MPDU
+   */
+  void TxOk (const WifiMacHeader &hdr);
+  /**
+   * Count the MPDUs not acknowledged by a block ack.
+   * \param hdr the header of the MPDU
+   */
+  void TxFailed (const WifiMacHeader &hdr);
+  /**
+   * Callback of the block ack manager to block the recipient.
+   * \param recipient the recipient
+   * \param tid the TID
+   */
+  void Block (Mac48Address recipient, uint8_t tid);
+
+  uint16_t m_winSize;       ///< the size of the window
+  Mac48Address m_recipient; ///< the recipient
+  uint16_t m_nextSeq;       ///< the sequence number of the next new MPDU
+  uint16_t m_nTxOk;         ///< the number of MPDUs acknowledged
+  uint16_t m_nTxFailed;     ///< the number of MPDUs not acknowledged
+};
+
+BlockAckManagerScoreboardTest::BlockAckManagerScoreboardTest (uint16_t winSize)
+  : TestCase ("Check the block ack manager scoreboard of size " + std::to_string (winSize)),
+    m_winSize (winSize),
+    m_recipient (Mac48Address ("00:00:00:00:00:02")),
+    m_nextSeq (4000),
+    m_nTxOk (0),
+    m_nTxFailed (0)
+{
+}
+
+void
+BlockAckManagerScoreboardTest::TxOk (const WifiMacHeader &hdr)
+{
+  m_nTxOk++;
+}
+
+void
+BlockAckManagerScoreboardTest::TxFailed (const WifiMacHeader &hdr)
+{
+  m_nTxFailed++;
+}
+
+void
+BlockAckManagerScoreboardTest::Block (Mac48Address recipient, uint8_t tid)
+{
+}
+
+void
+BlockAckManagerScoreboardTest::SendWindow (Ptr<BlockAckManager> manager)
+{
+  Ptr<WifiMacQueue> retransmissions = manager->GetRetransmitQueue ();
+  while (!retransmissions->IsEmpty ())
+    {
+      Ptr<WifiMacQueueItem> mpdu = retransmissions->Dequeue ();
+      mpdu->GetHeader ().SetRetry ();
+      manager->StorePacket (mpdu);
+    }
+  uint16_t winEnd = (manager->GetOriginatorStartingSequence (m_recipient, 0) + m_winSize) % 4096;
+  for (; m_nextSeq != winEnd; m_nextSeq = (m_nextSeq + 1) % 4096)
+    {
+      WifiMacHeader hdr;
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetAddr1 (m_recipient);
+      hdr.SetQosTid (0);
+      hdr.SetQosAckPolicy (WifiMacHeader::BLOCK_ACK);
+      hdr.SetSequenceNumber (m_nextSeq);
+      hdr.SetFragmentNumber (0);
+      manager->StorePacket (Create<WifiMacQueueItem> (Create<Packet> (100), hdr));
+    }
+}
+
+void
+BlockAckManagerScoreboardTest::CheckRetransmissions (Ptr<BlockAckManager> manager,
+                                                     const std::vector<uint16_t> &expected)
+{
+  Ptr<WifiMacQueue> retransmissions = manager->GetRetransmitQueue ();
+  NS_TEST_ASSERT_MSG_EQ (retransmissions->GetNPackets (), expected.size (), "Wrong number of retransmissions");
+  std::size_t i = 0;
+  for (WifiMacQueue::ConstIterator it = retransmissions->begin (); it != retransmissions->end (); it++, i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((*it)->GetHeader ().GetSequenceNumber (), expected[i], "Wrong retransmission " << i);
+    }
+}
+
+void
+BlockAckManagerScoreboardTest::DoRun (void)
+{
+  Ptr<WifiNetDevice> device = CreateObject<WifiNetDevice> ();
+  device->SetHtConfiguration (CreateObject<HtConfiguration> ());
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetDevice (device);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  Ptr<WifiRemoteStationManager> stationManager = CreateObject<ConstantRateWifiManager> ();
+  stationManager->SetupPhy (phy);
+
+  Ptr<BlockAckManager> manager = CreateObject<BlockAckManager> ();
+  manager->SetWifiRemoteStationManager (stationManager);
+  manager->SetBlockDestinationCallback (MakeCallback (&BlockAckManagerScoreboardTest::Block, this));
+  manager->SetTxOkCallback (MakeCallback (&BlockAckManagerScoreboardTest::TxOk, this));
+  manager->SetTxFailedCallback (MakeCallback (&BlockAckManagerScoreboardTest::TxFailed, this));
+
+  MgtAddBaRequestHeader reqHdr;
+  reqHdr.SetImmediateBlockAck ();
+  reqHdr.SetTid (0);
+  reqHdr.SetBufferSize (m_winSize);
+  reqHdr.SetTimeout (0);
+  reqHdr.SetStartingSequence (m_nextSeq);
+  manager->CreateAgreement (&reqHdr, m_recipient);
+  manager->NotifyAgreementEstablished (m_recipient, 0, m_nextSeq);
+
+  CtrlBAckResponseHeader blockAck;
+  blockAck.SetType (m_winSize == 64 ? COMPRESSED_BLOCK_ACK : EXTENDED_COMPRESSED_BLOCK_ACK);
+  blockAck.SetTidInfo (0);
+
+  // the recipient misses one MPDU out of five
+  SendWindow (manager);
+  NS_TEST_EXPECT_MSG_EQ (manager->GetNBufferedPackets (m_recipient, 0), m_winSize, "Wrong number of MPDUs in flight");
+  blockAck.ResetBitmap ();
+  blockAck.SetStartingSequence (4000);
+  std::vector<uint16_t> missing;
+  for (uint16_t n = 0; n < m_winSize; n++)
+    {
+      if (n % 5 == 3)
+        {
+          missing.push_back ((4000 + n) % 4096);
+        }
+      else
+        {
+          blockAck.SetReceivedPacket ((4000 + n) % 4096);
+        }
+    }
+  manager->NotifyGotBlockAck (&blockAck, m_recipient, 0, WifiMode (), 0);
+  NS_TEST_EXPECT_MSG_EQ (manager->GetNBufferedPackets (m_recipient, 0), 0, "Wrong number of MPDUs in flight");
+  NS_TEST_EXPECT_MSG_EQ (m_nTxOk, m_winSize - missing.size (), "Wrong number of acknowledged MPDUs");
+  NS_TEST_EXPECT_MSG_EQ (m_nTxFailed, missing.size (), "Wrong number of missing MPDUs");
+  NS_TEST_EXPECT_MSG_EQ (manager->GetOriginatorStartingSequence (m_recipient, 0), 4003,
+                         "The window must start at the first missing MPDU");
+  CheckRetransmissions (manager, missing);
+
+  // the retransmissions are received, with all the new MPDUs but the last one
+  SendWindow (manager);
+  uint16_t last = (4003 + m_winSize - 1) % 4096;
+  NS_TEST_EXPECT_MSG_EQ (manager->GetNBufferedPackets (m_recipient, 0), missing.size () + 3,
+                         "Wrong number of MPDUs in flight");
+  blockAck.ResetBitmap ();
+  blockAck.SetStartingSequence (4003);
+  for (uint16_t n = 0; n < m_winSize - 1; n++)
+    {
+      blockAck.SetReceivedPacket ((4003 + n) % 4096);
+    }
+  m_nTxOk = 0;
+  m_nTxFailed = 0;
+  manager->NotifyGotBlockAck (&blockAck, m_recipient, 0, WifiMode (), 0);
+  NS_TEST_EXPECT_MSG_EQ (m_nTxOk, missing.size () + 2, "Wrong number of acknowledged MPDUs");
+  NS_TEST_EXPECT_MSG_EQ (m_nTxFailed, 1, "Wrong number of missing MPDUs");
+  NS_TEST_EXPECT_MSG_EQ (manager->GetOriginatorStartingSequence (m_recipient, 0), last,
+                         "The window must start at the missing MPDU");
+  CheckRetransmissions (manager, std::vector<uint16_t> (1, last));
+
+  // all the MPDUs in flight are retransmitted when the block ack is missed
+  SendWindow (manager);
+  NS_TEST_EXPECT_MSG_EQ (manager->GetNBufferedPackets (m_recipient, 0), m_winSize, "Wrong number of MPDUs in flight");
+  manager->NotifyMissedBlockAck (m_recipient, 0);
+  NS_TEST_EXPECT_MSG_EQ (manager->GetNBufferedPackets (m_recipient, 0), 0, "Wrong number of MPDUs in flight");
+  NS_TEST_EXPECT_MSG_EQ (manager->GetOriginatorStartingSequence (m_recipient, 0), last,
+                         "The window must not move without a block ack");
+  std::vector<uint16_t> all;
+  for (uint16_t n = 0; n < m_winSize; n++)
+    {
+      all.push_back ((last + n) % 4096);
+    }
+  CheckRetransmissions (manager, all);
+  manager->Dispose ();
+  stationManager->Dispose ();
+  phy->Dispose ();
+  device->Dispose ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -555,6 +987,11 @@ BlockAckTestSuite::BlockAckTestSuite ()
   AddTestCase (new PacketBufferingCaseA, TestCase::QUICK);
   AddTestCase (new PacketBufferingCaseB, TestCase::QUICK);
   AddTestCase (new CtrlBAckResponseHeaderTest, TestCase::QUICK);
+  AddTestCase (new BlockAckWindowTest (64), TestCase::QUICK);
+  AddTestCase (new BlockAckWindowTest (256), TestCase::QUICK);
+  AddTestCase (new BlockAckCacheTest, TestCase::QUICK);
+  AddTestCase (new BlockAckManagerScoreboardTest (64), TestCase::QUICK);
+  AddTestCase (new BlockAckManagerScoreboardTest (256), TestCase::QUICK);
   AddTestCase (new BlockAckAggregationDisabledTest, TestCase::QUICK);
 }
 
@@ -724,6 +724,23 @@ ChannelAccessManagerTest::DoRun (void)
   AddRxOkEvt (69, 6);
   EndTest ();
 
+  // Test a backoff interrupted by several busy periods in a row, the
+  // access timeout expiring in each of them.
+  //
+  //  20          60     66      70       74       78  80     100     120    126    135     141             157     161      165      169   171
+  //   |    rx     | sifs | aifsn | bslot0 | bslot1 |   |  rx  |  nav  |      |  rx  | sifs | <---eifs---> | aifsn | bslot2 | bslot3 | tx |
+  //        |                                                                          error
+  //       30 request access. backoff slots: 4
+  StartTest (4, 6, 10);
+  AddDcfState (1);
+  AddRxOkEvt (20, 40);
+  AddAccessRequest (30, 2, 169, 0);
+  ExpectCollision (30, 4, 0); //backoff: 4 slots
+  AddRxOkEvt (80, 20);
+  AddNavStart (100, 20);
+  AddRxErrorEvt (125, 10);
+  EndTest ();
+
   // Test two DCFs which suffer an internal collision. the first DCF has a higher
   // priority than the second DCF.
   //
@@ -26,6 +26,11 @@
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/ht-configuration.h"
+#include "ns3/vht-configuration.h"
+#include "ns3/he-configuration.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/obss-wifi-manager.h"
 
 using namespace ns3;
 
@@ -1014,6 +1019,135 @@ PowerRateAdaptationTest::DoRun (void)
   TestRrpaa ();
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test the goodput tables of the OBSS wifi manager, and its choice
+ * of the TX power level and HE MCS of the frames to the next hop against
+ * known active transmissions, with and without a TX power restriction of
+ * the PHY.
+ */
+class ObssWifiManagerTest : public TestCase
+{
+public:
+  ObssWifiManagerTest ();
+
+  virtual void DoRun (void);
+private:
+  /**
+   * \param txPowerDbm the TX power of the frames to the next hop
+   * \return the best MCS of these frames, from the goodput tables
+   */
+  uint8_t GetBestMcs (double txPowerDbm) const;
+
+  Ptr<ObssWifiManager> m_manager; ///< manager
+};
+
+/// Node ID of the manager, not used by the other tests as the path losses are global
+static const uint16_t OBSS_TEST_NODE = 2000;
+/// Node ID of the next hop
+static const uint16_t OBSS_TEST_NEXT_HOP = 2001;
+/// Node ID of the receiver of the active transmission
+static const uint16_t OBSS_TEST_RECEIVER = 2002;
+/// Path loss (dB) to the next hop
+static const double OBSS_TEST_NEXT_HOP_LOSS = -90;
+
+ObssWifiManagerTest::ObssWifiManagerTest ()
+  : TestCase ("OBSS wifi manager TX power and MCS selection")
+{
+}
+
+uint8_t
+ObssWifiManagerTest::GetBestMcs (double txPowerDbm) const
+{
+  double snr = m_manager->CalculateSnr (DbmToW (txPowerDbm + OBSS_TEST_NEXT_HOP_LOSS), 0, 20);
+  return m_manager->m_bestMcs[m_manager->GetSinrIndex (RatioToDb (snr))];
+}
+
+void
+ObssWifiManagerTest::DoRun (void)
+{
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+  dev->SetHtConfiguration (CreateObject<HtConfiguration> ());
+  dev->SetVhtConfiguration (CreateObject<VhtConfiguration> ());
+  dev->SetHeConfiguration (CreateObject<HeConfiguration> ());
+  Ptr<AdhocWifiMac> mac = CreateObject<AdhocWifiMac> ();
+  mac->SetDevice (dev);
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (mobility);
+  phy->SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  phy->SetChannelWidth (20);
+  phy->SetNTxPower (18);
+  phy->SetTxPowerStart (0);
+  phy->SetTxPowerEnd (17);
+  phy->SetTxGain (0);
+  m_manager = CreateObject<ObssWifiManager> ();
+  Ptr<Node> node = CreateObject<Node> ();
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (m_manager);
+  node->AddDevice (dev);
+  m_manager->Initialize ();
+
+  //Goodput tables of the HE MCSs of 20 MHz, every 0.5 dB from -10 dB
+  NS_TEST_ASSERT_MSG_EQ (m_manager->m_heModes.size (), 12, "HE MCSs of the goodput tables");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->GetSinrIndex (-20), 0, "Index of a SINR below the tables");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->GetSinrIndex (10.7), 41, "Index of a SINR within the tables");
+  NS_TEST_EXPECT_MSG_EQ (m_manager->GetSinrIndex (100), m_manager->m_bestMcs.size () - 1, "Index of a SINR above the tables");
+  for (std::size_t k = 1; k < m_manager->m_bestGoodput.size (); k++)
+    {
+      NS_TEST_EXPECT_MSG_GT_OR_EQ (m_manager->m_bestGoodput[k], m_manager->m_bestGoodput[k - 1], "Best goodput against the SINR");
+      uint8_t mcs = m_manager->m_bestMcs[k];
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_manager->m_bestGoodput[k], m_manager->m_heRates[mcs] * m_manager->m_successRates[mcs][k], 1e-6,
+                                 "Goodput of the best MCS");
+    }
+  NS_TEST_EXPECT_MSG_EQ (+m_manager->m_bestMcs.back (), 11, "Best MCS of the highest SINR");
+
+  m_manager->m_nodeId = OBSS_TEST_NODE;
+  ObssWifiManager::SetPathLoss (OBSS_TEST_NEXT_HOP, OBSS_TEST_NODE, OBSS_TEST_NEXT_HOP_LOSS);
+  ObssWifiManager::SetPathLoss (OBSS_TEST_RECEIVER, OBSS_TEST_NODE, -85);
+  ObssWifiManager::ReceiverInfos nextHop;
+  nextHop.push_back (ObssWifiManager::ReceiverInfo (OBSS_TEST_NEXT_HOP, 0, 0, -1));
+
+  //Alone, the frames to the next hop use the highest TX power
+  m_manager->SelectPowerAndMcs (nextHop, Seconds (1));
+  NS_TEST_EXPECT_MSG_EQ (m_manager->m_obssRestricted, true, "Selection without active transmissions");
+  NS_TEST_EXPECT_MSG_EQ (+m_manager->m_obssPowerLimit, 17, "TX power level without active transmissions");
+  NS_TEST_EXPECT_MSG_EQ (+m_manager->m_obssMcsLimit, +GetBestMcs (17), "MCS without active transmissions");
+
+  //An active transmission at MCS 5, received at -60 dBm 85 dB away, is
+  //lost at the highest TX power: a lower one gives a better total goodput
+  ObssWifiManager::ReceiverInfos active = nextHop;
+  active.push_back (ObssWifiManager::ReceiverInfo (OBSS_TEST_RECEIVER, 0, DbmToW (-60), 5));
+  m_manager->SelectPowerAndMcs (active, Seconds (1));
+  NS_TEST_EXPECT_MSG_EQ (m_manager->m_obssRestricted, true, "Selection with an active transmission");
+  uint8_t level = m_manager->m_obssPowerLimit;
+  NS_TEST_EXPECT_MSG_LT (+level, 17, "TX power level with an active transmission");
+  NS_TEST_EXPECT_MSG_GT (+level, 0, "TX power level with an active transmission");
+  NS_TEST_EXPECT_MSG_EQ (+m_manager->m_obssMcsLimit, +GetBestMcs (level), "MCS with an active transmission");
+
+  //The OBSS PD algorithm restricts the next transmission to 10 dBm: the
+  //levels above it are sent at 10 dBm, and the MCS is selected for it
+  phy->m_powerRestricted = true;
+  phy->m_txPowerMaxSiso = 10;
+  m_manager->SelectPowerAndMcs (nextHop, Seconds (1));
+  NS_TEST_EXPECT_MSG_EQ (+m_manager->m_obssPowerLimit, 10, "TX power level under the restriction");
+  NS_TEST_EXPECT_MSG_EQ (+m_manager->m_obssMcsLimit, +GetBestMcs (10), "MCS under the restriction");
+  NS_TEST_EXPECT_MSG_LT (+m_manager->m_obssMcsLimit, +GetBestMcs (17), "MCS under the restriction");
+  phy->m_powerRestricted = false;
+
+  m_manager = 0;
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1030,6 +1164,7 @@ PowerRateAdaptationTestSuite::PowerRateAdaptationTestSuite ()
   : TestSuite ("power-rate-adaptation-wifi", UNIT)
 {
   AddTestCase (new PowerRateAdaptationTest, TestCase::QUICK);
+  AddTestCase (new ObssWifiManagerTest, TestCase::QUICK);
 }
 
 static PowerRateAdaptationTestSuite g_powerRateAdaptationTestSuite; ///< the test suite
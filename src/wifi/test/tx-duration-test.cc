@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/yans-wifi-phy.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -426,6 +427,139 @@ TxDurationTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (retval, true, "an 802.11ax duration failed");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Tx Duration Cache Test
+ *
+ * Check that the durations returned by a PHY with a TX duration cache,
+ * including a cache small enough to be flushed, are those computed by a
+ * PHY without one, for every mode of 802.11ax in both bands, and across
+ * the MPDUs of an A-MPDU.
+ */
+class TxDurationCacheTest : public TestCase
+{
+public:
+  TxDurationCacheTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Compare the durations of a PHY to those of the reference PHY.
+   *
+   * \param phy the PHY under test
+   * \param reference the PHY without cache
+   * \param frequency the channel center frequency (MHz)
+   */
+  void CheckDurations (Ptr<WifiPhy> phy, Ptr<WifiPhy> reference, uint16_t frequency);
+  /**
+   * \param standard the standard to configure
+   * \param cacheSize the value of the TxDurationCacheSize attribute
+   * \return a new PHY
+   */
+  static Ptr<WifiPhy> CreatePhy (WifiPhyStandard standard, uint32_t cacheSize);
+};
+
+TxDurationCacheTest::TxDurationCacheTest ()
+  : TestCase ("Wifi TX duration cache")
+{
+}
+
+Ptr<WifiPhy>
+TxDurationCacheTest::CreatePhy (WifiPhyStandard standard, uint32_t cacheSize)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetAttribute ("TxDurationCacheSize", UintegerValue (cacheSize));
+  phy->ConfigureStandard (standard);
+  return phy;
+}
+
+void
+TxDurationCacheTest::CheckDurations (Ptr<WifiPhy> phy, Ptr<WifiPhy> reference, uint16_t frequency)
+{
+  std::vector<WifiMode> modes;
+  for (uint8_t i = 0; i < phy->GetNModes (); i++)
+    {
+      modes.push_back (phy->GetMode (i));
+    }
+  for (uint8_t i = 0; i < phy->GetNMcs (); i++)
+    {
+      modes.push_back (phy->GetMcs (i));
+    }
+  const uint32_t sizes[] = {14, 32, 1536, 1537, 65535};
+  const MpduType types[] = {NORMAL_MPDU, SINGLE_MPDU,
+                            FIRST_MPDU_IN_AGGREGATE, MIDDLE_MPDU_IN_AGGREGATE};
+  // The second pass reads the durations cached by the first one
+  for (uint8_t pass = 0; pass < 2; pass++)
+    {
+      for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); mode++)
+        {
+          WifiTxVector txVector;
+          txVector.SetMode (*mode);
+          txVector.SetNss (1);
+          txVector.SetChannelWidth (20);
+          switch (mode->GetModulationClass ())
+            {
+            case WIFI_MOD_CLASS_HE:
+              txVector.SetPreambleType (WIFI_PREAMBLE_HE_SU);
+              txVector.SetGuardInterval (800);
+              break;
+            case WIFI_MOD_CLASS_HT:
+              txVector.SetPreambleType (WIFI_PREAMBLE_HT_MF);
+              txVector.SetGuardInterval (400);
+              break;
+            case WIFI_MOD_CLASS_VHT:
+              // VHT MCS 9 is not allowed at 20 MHz with one stream
+              txVector.SetPreambleType (WIFI_PREAMBLE_VHT_SU);
+              txVector.SetChannelWidth (40);
+              txVector.SetGuardInterval (400);
+              break;
+            default:
+              txVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+              txVector.SetGuardInterval (800);
+              break;
+            }
+          for (uint8_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+            {
+              for (uint8_t t = 0; t < sizeof (types) / sizeof (types[0]); t++)
+                {
+                  NS_TEST_EXPECT_MSG_EQ (phy->CalculateTxDuration (sizes[s], txVector, frequency, types[t], 0),
+                                         reference->CalculateTxDuration (sizes[s], txVector, frequency, types[t], 0),
+                                         "TX duration differs for mode " << *mode << " size " << sizes[s]);
+                  NS_TEST_EXPECT_MSG_EQ (phy->GetPayloadDuration (sizes[s], txVector, frequency, types[t], 0),
+                                         reference->GetPayloadDuration (sizes[s], txVector, frequency, types[t], 0),
+                                         "payload duration differs for mode " << *mode << " size " << sizes[s]);
+                }
+            }
+          if (mode->GetModulationClass () < WIFI_MOD_CLASS_HT)
+            {
+              continue;
+            }
+          // An A-MPDU of three MPDUs: the last duration depends on the first two
+          MpduType ampdu[] = {FIRST_MPDU_IN_AGGREGATE, MIDDLE_MPDU_IN_AGGREGATE,
+                              LAST_MPDU_IN_AGGREGATE};
+          for (uint8_t t = 0; t < 3; t++)
+            {
+              NS_TEST_EXPECT_MSG_EQ (phy->CalculateTxDuration (1537, txVector, frequency, ampdu[t], 1),
+                                     reference->CalculateTxDuration (1537, txVector, frequency, ampdu[t], 1),
+                                     "A-MPDU duration differs for mode " << *mode);
+            }
+        }
+    }
+}
+
+void
+TxDurationCacheTest::DoRun (void)
+{
+  Ptr<WifiPhy> reference = CreatePhy (WIFI_PHY_STANDARD_80211ax_5GHZ, 0);
+  CheckDurations (CreatePhy (WIFI_PHY_STANDARD_80211ax_5GHZ, 4096), reference, CHANNEL_36_MHZ);
+  CheckDurations (CreatePhy (WIFI_PHY_STANDARD_80211ax_5GHZ, 8), reference, CHANNEL_36_MHZ);
+  reference = CreatePhy (WIFI_PHY_STANDARD_80211ax_2_4GHZ, 0);
+  CheckDurations (CreatePhy (WIFI_PHY_STANDARD_80211ax_2_4GHZ, 4096), reference, CHANNEL_1_MHZ);
+  CheckDurations (CreatePhy (WIFI_PHY_STANDARD_80211ax_2_4GHZ, 8), reference, CHANNEL_1_MHZ);
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -442,6 +576,7 @@ TxDurationTestSuite::TxDurationTestSuite ()
   : TestSuite ("devices-wifi-tx-duration", UNIT)
 {
   AddTestCase (new TxDurationTest, TestCase::QUICK);
+  AddTestCase (new TxDurationCacheTest, TestCase::QUICK);
 }
 
 static TxDurationTestSuite g_txDurationTestSuite; ///< the test suite
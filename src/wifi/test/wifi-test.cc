@@ -23,6 +23,7 @@
 
 #include "ns3/string.h"
 #include "ns3/yans-wifi-helper.h"
+#include "ns3/abstract-wifi-helper.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/adhoc-wifi-mac.h"
@@ -46,6 +47,7 @@
 #include "ns3/mgt-headers.h"
 #include "ns3/ht-configuration.h"
 #include "ns3/wifi-phy-header.h"
+#include "ns3/wifi-mac-queue.h"
 
 using namespace ns3;
 
@@ -241,6 +243,176 @@ public:
 };
 
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief WifiMacQueue (TID, receiver) index and lifetime expiry
+ *
+ * Interleave the QoS Data frames of several receivers and TIDs with
+ * non-QoS frames, inserting at the head, the tail and in the middle of
+ * the queue, and check that peeking, counting and dequeuing by TID and
+ * receiver give the same result as a walk of the whole queue, before
+ * and after the lifetime of the oldest frames expires.
+ */
+class WifiMacQueueIndexTest : public TestCase
+{
+public:
+  WifiMacQueueIndexTest ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Enqueue a frame.
+   * \param dest the receiver address
+   * \param tid the TID, or 8 for a non-QoS Data frame
+   * \param where 0 to enqueue at the tail, 1 at the head, 2 in the middle
+   */
+  void Enqueue (Mac48Address dest, uint8_t tid, uint8_t where);
+  /**
+   * Check the queue against a walk of the whole queue.
+   * \param when a string describing the check
+   */
+  void Check (std::string when);
+  /// Dequeue and remove frames by TID and receiver
+  void Dequeue (void);
+  /**
+   * Check the frames still queued and the frames expired.
+   * \param nFrames the number of frames not dequeued
+   */
+  void CheckSize (uint32_t nFrames);
+  /**
+   * Count the expired frames.
+   * \param item the expired frame
+   */
+  void Expired (Ptr<const WifiMacQueueItem> item);
+
+  Ptr<WifiMacQueue> m_queue;            ///< the queue
+  std::vector<Mac48Address> m_receivers; ///< the receivers
+  uint32_t m_nExpired;                  ///< number of expired frames
+};
+
+WifiMacQueueIndexTest::WifiMacQueueIndexTest ()
+  : TestCase ("Index of WifiMacQueue by TID and receiver"),
+    m_nExpired (0)
+{
+}
+
+void
+WifiMacQueueIndexTest::Enqueue (Mac48Address dest, uint8_t tid, uint8_t where)
+{
+  WifiMacHeader hdr;
+  if (tid < 8)
+    {
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetQosTid (tid);
+    }
+  else
+    {
+      hdr.SetType (WIFI_MAC_DATA);
+    }
+  hdr.SetAddr1 (dest);
+  Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> (Create<Packet> (100), hdr);
+  if (where == 0)
+    {
+      m_queue->Enqueue (item);
+    }
+  else if (where == 1)
+    {
+      m_queue->PushFront (item);
+    }
+  else
+    {
+      WifiMacQueue::ConstIterator pos = m_queue->begin ();
+      std::advance (pos, m_queue->QueueBase::GetNPackets () / 2);
+      m_queue->Insert (pos, item);
+    }
+}
+
+void
+WifiMacQueueIndexTest::Check (std::string when)
+{
+  for (std::vector<Mac48Address>::const_iterator dest = m_receivers.begin (); dest != m_receivers.end (); dest++)
+    {
+      for (uint8_t tid = 0; tid < 3; tid++)
+        {
+          std::vector<Ptr<const WifiMacQueueItem> > expected;
+          for (WifiMacQueue::ConstIterator it = m_queue->begin (); it != m_queue->end (); it++)
+            {
+              if ((*it)->GetHeader ().IsQosData () && (*it)->GetHeader ().GetQosTid () == tid
+                  && (*it)->GetDestinationAddress () == *dest
+                  && Simulator::Now () <= (*it)->GetTimeStamp () + m_queue->GetMaxDelay ())
+                {
+                  expected.push_back (*it);
+                }
+            }
+          std::vector<Ptr<const WifiMacQueueItem> > peeked;
+          WifiMacQueue::ConstIterator it = m_queue->PeekByTidAndAddress (tid, *dest);
+          while (it != m_queue->end ())
+            {
+              peeked.push_back (*it);
+              it = m_queue->PeekByTidAndAddress (tid, *dest, ++it);
+            }
+          NS_TEST_EXPECT_MSG_EQ ((peeked == expected), true, "Unexpected frames peeked " << when);
+          NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (tid, *dest), expected.size (),
+                                 "Unexpected number of frames " << when);
+        }
+    }
+}
+
+void
+WifiMacQueueIndexTest::Dequeue (void)
+{
+  Ptr<WifiMacQueueItem> item = m_queue->DequeueByTidAndAddress (1, m_receivers[1]);
+  NS_TEST_ASSERT_MSG_NE (item, 0, "No frame dequeued");
+  NS_TEST_EXPECT_MSG_EQ (+item->GetHeader ().GetQosTid (), 1, "Unexpected TID");
+  NS_TEST_EXPECT_MSG_EQ (item->GetDestinationAddress (), m_receivers[1], "Unexpected receiver");
+  m_queue->Remove (m_queue->PeekByTidAndAddress (0, m_receivers[2]));
+  Check ("after dequeue");
+}
+
+void
+WifiMacQueueIndexTest::CheckSize (uint32_t nFrames)
+{
+  uint32_t nPackets = m_queue->GetNPackets ();
+  NS_TEST_EXPECT_MSG_GT (m_nExpired, 0, "No frame expired");
+  NS_TEST_EXPECT_MSG_EQ (m_nExpired + nPackets, nFrames, "Frames lost");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->IsEmpty (), (nPackets == 0), "Unexpected emptiness");
+}
+
+void
+WifiMacQueueIndexTest::Expired (Ptr<const WifiMacQueueItem> item)
+{
+  m_nExpired++;
+}
+
+void
+WifiMacQueueIndexTest::DoRun (void)
+{
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxDelay (MilliSeconds (100));
+  m_queue->TraceConnectWithoutContext ("Expired", MakeCallback (&WifiMacQueueIndexTest::Expired, this));
+  for (uint8_t i = 0; i < 4; i++)
+    {
+      m_receivers.push_back (Mac48Address::Allocate ());
+    }
+
+  // frames of the first batch expire at 100 ms, those of the second one at 150 ms
+  for (uint32_t i = 0; i < 60; i++)
+    {
+      Simulator::Schedule (MilliSeconds (i < 30 ? 0 : 50), &WifiMacQueueIndexTest::Enqueue, this,
+                           m_receivers[(i * 7) % 4], (i % 5 == 4) ? 8 : i % 3, (i % 4 == 3) ? 1 + i % 2 : 0);
+    }
+  Simulator::Schedule (MilliSeconds (60), &WifiMacQueueIndexTest::Check, this, "before expiry");
+  Simulator::Schedule (MilliSeconds (70), &WifiMacQueueIndexTest::Dequeue, this);
+  Simulator::Schedule (MilliSeconds (120), &WifiMacQueueIndexTest::Check, this, "after expiry of the first frames");
+  Simulator::Schedule (MilliSeconds (120), &WifiMacQueueIndexTest::CheckSize, this, 58);
+  Simulator::Schedule (MilliSeconds (200), &WifiMacQueueIndexTest::Check, this, "after expiry of all frames");
+  Simulator::Schedule (MilliSeconds (200), &WifiMacQueueIndexTest::CheckSize, this, 58);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
 /**
  * See \bugid{991}
  */
@@ -1883,6 +2055,257 @@ StaWifiMacScanningTestCase::DoRun (void)
   }
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that a STA associates to an AP whose beacons are abstracted.
+ *
+ * The AP sets the AbstractBeacons attribute, so that its beacons never
+ * reach the PHY, and a STA scans passively.  When the STA is close to the
+ * AP, it is expected to associate to the AP, and the AP PHY is expected
+ * not to transmit any beacon.  When the STA is out of range, it is not
+ * expected to associate.
+ */
+class AbstractBeaconsTestCase : public TestCase
+{
+public:
+  AbstractBeaconsTestCase ();
+  virtual ~AbstractBeaconsTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Callback function on STA assoc event
+   * \param context context string
+   * \param bssid the associated AP's bssid
+   */
+  void AssocCallback (std::string context, Mac48Address bssid);
+  /**
+   * Callback function on AP PHY TX begin event
+   * \param context context string
+   * \param p the packet
+   * \param txPowerW the TX power in W
+   */
+  void ApTxCallback (std::string context, Ptr<const Packet> p, double txPowerW);
+  /**
+   * Run the scenario
+   * \param distance the distance between the AP and the STA in meters
+   * \return the address of the AP
+   */
+  Mac48Address RunOne (double distance);
+
+  Mac48Address m_associatedApBssid; ///< Associated AP's bssid
+  uint32_t m_beaconsTransmitted; ///< number of beacons transmitted by the AP PHY
+};
+
+AbstractBeaconsTestCase::AbstractBeaconsTestCase ()
+  : TestCase ("Test case for the association to an AP with abstracted beacons"),
+    m_beaconsTransmitted (0)
+{
+}
+
+AbstractBeaconsTestCase::~AbstractBeaconsTestCase ()
+{
+}
+
+void
+AbstractBeaconsTestCase::AssocCallback (std::string context, Mac48Address bssid)
+{
+  m_associatedApBssid = bssid;
+}
+
+void
+AbstractBeaconsTestCase::ApTxCallback (std::string context, Ptr<const Packet> p, double txPowerW)
+{
+  WifiMacHeader hdr;
+  p->PeekHeader (hdr);
+  if (hdr.IsBeacon ())
+    {
+      m_beaconsTransmitted++;
+    }
+}
+
+Mac48Address
+AbstractBeaconsTestCase::RunOne (double distance)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  m_associatedApBssid = Mac48Address ();
+  m_beaconsTransmitted = 0;
+
+  Ptr<Node> apNode = CreateObject<Node> ();
+  Ptr<Node> staNode = CreateObject<Node> ();
+
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager");
+
+  WifiMacHelper mac;
+  mac.SetType ("ns3::ApWifiMac",
+               "AbstractBeacons", BooleanValue (true));
+  NetDeviceContainer apDevice = wifi.Install (phy, mac, apNode);
+  Mac48Address apAddr = Mac48Address::ConvertFrom (apDevice.Get (0)->GetAddress ());
+  mac.SetType ("ns3::StaWifiMac",
+               "ActiveProbing", BooleanValue (false));
+  wifi.Install (phy, mac, staNode);
+  //The beacon jitter and the reception of the abstracted beacons
+  Ptr<ApWifiMac> apMac = DynamicCast<ApWifiMac> (DynamicCast<WifiNetDevice> (apDevice.Get (0))->GetMac ());
+  NS_TEST_EXPECT_MSG_EQ (apMac->AssignStreams (100), 2, "Wrong number of streams of the AP MAC");
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (distance, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNode);
+  mobility.Install (staNode);
+
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/$ns3::StaWifiMac/Assoc", MakeCallback (&AbstractBeaconsTestCase::AssocCallback, this));
+  Config::Connect ("/NodeList/" + std::to_string (apNode->GetId ()) + "/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxBegin", MakeCallback (&AbstractBeaconsTestCase::ApTxCallback, this));
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  return apAddr;
+}
+
+void
+AbstractBeaconsTestCase::DoRun (void)
+{
+  Mac48Address apAddr = RunOne (5);
+  NS_TEST_ASSERT_MSG_EQ (m_associatedApBssid, apAddr, "STA is not associated to the AP");
+  NS_TEST_ASSERT_MSG_EQ (m_beaconsTransmitted, 0, "Abstracted beacons should not be transmitted by the PHY");
+
+  RunOne (1000);
+  NS_TEST_ASSERT_MSG_EQ (m_associatedApBssid, Mac48Address (), "STA out of range should not be associated");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the abstracted PHY delivers frames to the receivers in range.
+ *
+ * Three stations use an AbstractWifiPhy on the same AbstractWifiChannel: the
+ * first one sends 10 packets to the second one, 10 m away, and the third one
+ * is 1000 m away.  The second station is expected to receive all packets, and
+ * the channel is expected not to deliver any frame to the third station PHY.
+ */
+class AbstractWifiPhyTestCase : public TestCase
+{
+public:
+  AbstractWifiPhyTestCase ();
+  virtual ~AbstractWifiPhyTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Callback function on packet reception by the server
+   * \param context context string
+   * \param p the packet
+   * \param adr the address of the sender
+   */
+  void Receive (std::string context, Ptr<const Packet> p, const Address &adr);
+  /**
+   * Callback function on RX begin event of the PHY out of range
+   * \param context context string
+   * \param p the packet
+   */
+  void FarRxCallback (std::string context, Ptr<const Packet> p);
+
+  uint32_t m_received;   ///< number of packets received by the server
+  uint32_t m_farRxBegin; ///< number of frames seen by the PHY out of range
+};
+
+AbstractWifiPhyTestCase::AbstractWifiPhyTestCase ()
+  : TestCase ("Test case for the reception range of the abstracted PHY"),
+    m_received (0),
+    m_farRxBegin (0)
+{
+}
+
+AbstractWifiPhyTestCase::~AbstractWifiPhyTestCase ()
+{
+}
+
+void
+AbstractWifiPhyTestCase::Receive (std::string context, Ptr<const Packet> p, const Address &adr)
+{
+  m_received++;
+}
+
+void
+AbstractWifiPhyTestCase::FarRxCallback (std::string context, Ptr<const Packet> p)
+{
+  m_farRxBegin++;
+}
+
+void
+AbstractWifiPhyTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  AbstractWifiChannelHelper channel = AbstractWifiChannelHelper::Default ();
+  AbstractWifiPhyHelper phy = AbstractWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("HtMcs7"),
+                                "ControlMode", StringValue ("HtMcs0"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac",
+               "QosSupported", BooleanValue (true));
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (10.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (1000.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (nodes);
+
+  PacketSocketAddress socket;
+  socket.SetSingleDevice (devices.Get (0)->GetIfIndex ());
+  socket.SetPhysicalAddress (devices.Get (1)->GetAddress ());
+  socket.SetProtocol (1);
+
+  Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+  client->SetAttribute ("PacketSize", UintegerValue (1000));
+  client->SetAttribute ("MaxPackets", UintegerValue (10));
+  client->SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+  client->SetRemote (socket);
+  nodes.Get (0)->AddApplication (client);
+  client->SetStartTime (Seconds (0.5));
+  client->SetStopTime (Seconds (1.0));
+
+  Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+  server->SetLocal (socket);
+  nodes.Get (1)->AddApplication (server);
+  server->SetStartTime (Seconds (0.0));
+  server->SetStopTime (Seconds (1.0));
+
+  Config::Connect ("/NodeList/1/ApplicationList/*/$ns3::PacketSocketServer/Rx", MakeCallback (&AbstractWifiPhyTestCase::Receive, this));
+  Config::Connect ("/NodeList/2/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxBegin", MakeCallback (&AbstractWifiPhyTestCase::FarRxCallback, this));
+
+  Simulator::Stop (Seconds (1.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, 10, "The station in range did not receive all packets");
+  NS_TEST_ASSERT_MSG_EQ (m_farRxBegin, 0, "The station out of range should not see any frame");
+}
+
 //-----------------------------------------------------------------------------
 /**
  * Make sure that the ADDBA handshake process is protected.
@@ -2191,6 +2614,7 @@ WifiTestSuite::WifiTestSuite ()
 {
   AddTestCase (new WifiTest, TestCase::QUICK);
   AddTestCase (new QosUtilsIsOldPacketTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueIndexTest, TestCase::QUICK);
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new DcfImmediateAccessBroadcastTestCase, TestCase::QUICK);
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
@@ -2200,6 +2624,8 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug2843TestCase, TestCase::QUICK); //Bug 2843
   AddTestCase (new Bug2831TestCase, TestCase::QUICK); //Bug 2831
   AddTestCase (new StaWifiMacScanningTestCase, TestCase::QUICK); //Bug 2399
+  AddTestCase (new AbstractBeaconsTestCase, TestCase::QUICK);
+  AddTestCase (new AbstractWifiPhyTestCase, TestCase::QUICK);
   AddTestCase (new Bug2470TestCase, TestCase::QUICK); //Bug 2470
 }
 
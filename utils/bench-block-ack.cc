@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of either side of a Block Ack agreement.
+//
+// The recipient side is done by MacLow: for each A-MPDU filling the
+// window, the BlockAckCache is updated with every MPDU received, then
+// the bitmap of the BlockAck is filled.  A new agreement is set up every
+// agreementPeriod A-MPDUs.
+//
+// The originator side is done by QosTxop and the BlockAckManager: each
+// A-MPDU retransmits the MPDUs of the retransmission queue and fills the
+// rest of the transmit window with new MPDUs, which are stored in the
+// BlockAckManager, then the BlockAck of the recipient is notified to it.
+//
+// On both sides, one MPDU out of lossPeriod is lost, and retransmitted in
+// the next A-MPDU.
+// Sample usage:  ./waf --run 'bench-block-ack --winSize=256 --ampdus=100000 --originator=1'
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/block-ack-cache.h"
+#include "ns3/block-ack-manager.h"
+#include "ns3/wifi-mac-queue.h"
+
+using namespace ns3;
+
+/**
+ * Callback of the BlockAckManager to block or unblock a recipient.
+ *
+ * \param recipient the recipient
+ * \param tid the TID
+ */
+static void
+BlockDestination (Mac48Address recipient, uint8_t tid)
+{
+}
+
+/**
+ * Run the originator side.
+ *
+ * \param ampdus the number of A-MPDUs
+ * \param winSize the size of the window
+ * \param lossPeriod one MPDU out of lossPeriod is lost
+ * \return the checksum of the starting sequence numbers of the transmit window
+ */
+static uint64_t
+RunOriginator (uint32_t ampdus, uint16_t winSize, uint32_t lossPeriod)
+{
+  Ptr<WifiNetDevice> device = CreateObject<WifiNetDevice> ();
+  device->SetHtConfiguration (CreateObject<HtConfiguration> ());
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetDevice (device);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  Ptr<WifiRemoteStationManager> stationManager = CreateObject<ConstantRateWifiManager> ();
+  stationManager->SetupPhy (phy);
+  Ptr<BlockAckManager> manager = CreateObject<BlockAckManager> ();
+  manager->SetWifiRemoteStationManager (stationManager);
+  manager->SetBlockDestinationCallback (MakeCallback (&BlockDestination));
+  Ptr<WifiMacQueue> retransmissions = manager->GetRetransmitQueue ();
+
+  Mac48Address recipient ("00:00:00:00:00:02");
+  MgtAddBaRequestHeader reqHdr;
+  reqHdr.SetImmediateBlockAck ();
+  reqHdr.SetTid (0);
+  reqHdr.SetBufferSize (winSize);
+  reqHdr.SetTimeout (0);
+  reqHdr.SetStartingSequence (0);
+  manager->CreateAgreement (&reqHdr, recipient);
+  manager->NotifyAgreementEstablished (recipient, 0, 0);
+
+  // the MPDUs are built once, and stored again when they are retransmitted
+  std::vector<Ptr<WifiMacQueueItem>> mpdus;
+  Ptr<Packet> packet = Create<Packet> (1000);
+  for (uint16_t seq = 0; seq < 4096; seq++)
+    {
+      WifiMacHeader hdr;
+      hdr.SetType (WIFI_MAC_QOSDATA);
+      hdr.SetAddr1 (recipient);
+      hdr.SetQosTid (0);
+      hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
+      hdr.SetSequenceNumber (seq);
+      hdr.SetFragmentNumber (0);
+      mpdus.push_back (Create<WifiMacQueueItem> (packet, hdr));
+    }
+
+  CtrlBAckResponseHeader blockAck;
+  blockAck.SetType (winSize == 64 ? COMPRESSED_BLOCK_ACK : EXTENDED_COMPRESSED_BLOCK_ACK);
+  blockAck.SetTidInfo (0);
+  uint64_t words[4];
+  std::size_t nWords = winSize / 64;
+
+  uint64_t checksum = 0;
+  uint16_t nextSeq = 0;
+  uint32_t mpdu = 0;
+  for (uint32_t i = 0; i < ampdus; ++i)
+    {
+      uint16_t winStart = manager->GetOriginatorStartingSequence (recipient, 0);
+      for (std::size_t w = 0; w < nWords; w++)
+        {
+          words[w] = 0;
+        }
+      // the retransmissions are received
+      while (!retransmissions->IsEmpty ())
+        {
+          Ptr<WifiMacQueueItem> item = retransmissions->Dequeue ();
+          uint16_t b = (item->GetHeader ().GetSequenceNumber () - winStart + 4096) % 4096;
+          words[b / 64] |= uint64_t (1) << (b % 64);
+          manager->StorePacket (item);
+        }
+      for (; nextSeq != (winStart + winSize) % 4096; nextSeq = (nextSeq + 1) % 4096)
+        {
+          if (++mpdu % lossPeriod != 0)
+            {
+              uint16_t b = (nextSeq - winStart + 4096) % 4096;
+              words[b / 64] |= uint64_t (1) << (b % 64);
+            }
+          manager->StorePacket (mpdus[nextSeq]);
+        }
+      blockAck.SetStartingSequence (winStart);
+      blockAck.SetCompressedBitmap (words, nWords);
+      manager->NotifyGotBlockAck (&blockAck, recipient, 0, WifiMode (), 0);
+      checksum += manager->GetOriginatorStartingSequence (recipient, 0);
+    }
+  manager->Dispose ();
+  stationManager->Dispose ();
+  phy->Dispose ();
+  device->Dispose ();
+  return checksum;
+}
+
+/**
+ * Run the recipient side.
+ *
+ * \param ampdus the number of A-MPDUs
+ * \param winSize the size of the window
+ * \param lossPeriod one MPDU out of lossPeriod is lost
+ * \param agreementPeriod the number of A-MPDUs per agreement
+ * \return the checksum of the BlockAck bitmaps
+ */
+static uint64_t
+RunRecipient (uint32_t ampdus, uint16_t winSize, uint32_t lossPeriod, uint32_t agreementPeriod)
+{
+  CtrlBAckResponseHeader blockAck;
+  blockAck.SetType (winSize == 64 ? COMPRESSED_BLOCK_ACK : EXTENDED_COMPRESSED_BLOCK_ACK);
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetFragmentNumber (0);
+  BlockAckCache cache;
+
+  uint64_t checksum = 0;
+  uint16_t nextSeq = 0;
+  uint16_t lost = 4096;  // sequence number of the MPDU to retransmit, if any
+  uint32_t mpdu = 0;
+  for (uint32_t i = 0; i < ampdus; ++i)
+    {
+      if (i % agreementPeriod == 0)
+        {
+          cache.Init (nextSeq, winSize);
+          lost = 4096;
+        }
+      uint16_t n = 0;
+      if (lost != 4096)
+        {
+          hdr.SetSequenceNumber (lost);
+          cache.UpdateWithMpdu (&hdr);
+          lost = 4096;
+          n++;
+        }
+      for (; n < winSize; n++, nextSeq = (nextSeq + 1) % 4096)
+        {
+          if (++mpdu % lossPeriod == 0 && lost == 4096)
+            {
+              lost = nextSeq;
+              continue;
+            }
+          hdr.SetSequenceNumber (nextSeq);
+          cache.UpdateWithMpdu (&hdr);
+        }
+      blockAck.ResetBitmap ();
+      blockAck.SetStartingSequence (cache.GetWinStart ());
+      cache.FillBlockAckBitmap (&blockAck);
+      if (winSize == 64)
+        {
+          checksum += blockAck.GetCompressedBitmap () % 65521;
+        }
+      else
+        {
+          for (uint8_t w = 0; w < 4; w++)
+            {
+              checksum += blockAck.GetExtendedCompressedBitmap ()[w] % 65521;
+            }
+        }
+    }
+  return checksum;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t ampdus = 100000;
+  uint16_t winSize = 64;
+  uint32_t lossPeriod = 10;
+  uint32_t agreementPeriod = 1000;
+  bool originator = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the BlockAck scoreboard of the recipient or of the originator");
+  cmd.AddValue ("ampdus", "number of A-MPDUs", ampdus);
+  cmd.AddValue ("winSize", "size of the Block Ack window: 64 or 256", winSize);
+  cmd.AddValue ("lossPeriod", "one MPDU out of lossPeriod is lost", lossPeriod);
+  cmd.AddValue ("agreementPeriod", "number of A-MPDUs per agreement of the recipient", agreementPeriod);
+  cmd.AddValue ("originator", "measure the originator instead of the recipient", originator);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (winSize != 64 && winSize != 256, "The window size must be 64 or 256");
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint64_t checksum = originator ? RunOriginator (ampdus, winSize, lossPeriod)
+                                 : RunRecipient (ampdus, winSize, lossPeriod, agreementPeriod);
+  int64_t elapsed = clock.End ();
+
+  std::cout << (originator ? "originator" : "recipient") << " window " << winSize << ": " << ampdus << " A-MPDUs in "
+            << elapsed << " ms (" << elapsed * 1e6 / ampdus << " ns/A-MPDU, checksum "
+            << checksum << ")" << std::endl;
+  return 0;
+}
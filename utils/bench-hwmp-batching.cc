@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program compares the HWMP path discoveries of a grid of mesh
+// points with the path selection elements sent at once, and batched
+// during the PathSelectionBatchWindow of HWMP.  Once the peer links are
+// up, each mesh point requests paths to several other mesh points
+// within a short time.  For both settings, the program prints the
+// number of path selection frames transmitted, the number of simulated
+// events, the number of paths found and the mean path discovery time.
+// The frames whose path is found are handed back to the program rather
+// than transmitted, so that only the path selection frames are counted.
+// Sample usage:  ./waf --run 'bench-hwmp-batching --size=5 --destinations=4 --window=5ms'
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+
+using namespace ns3;
+
+static uint32_t g_frames = 0;      //!< Number of path selection frames transmitted
+static uint64_t g_bytes = 0;       //!< Size of the path selection frames transmitted
+static uint32_t g_found = 0;       //!< Number of paths found
+static uint32_t g_discoveries = 0; //!< Number of path discoveries
+static Time g_discoveryTime;       //!< Total path discovery time
+
+/**
+ * Count the path selection frames transmitted by a PHY.
+ *
+ * \param packet the frame
+ * \param txPowerW the TX power
+ */
+static void
+PhyTxBegin (Ptr<const Packet> packet, double txPowerW)
+{
+  Ptr<Packet> copy = packet->Copy ();
+  WifiMacHeader hdr;
+  copy->RemoveHeader (hdr);
+  if (!hdr.IsAction ())
+    {
+      return;
+    }
+  WifiActionHeader actionHdr;
+  copy->RemoveHeader (actionHdr);
+  if (actionHdr.GetCategory () == WifiActionHeader::MESH
+      && actionHdr.GetAction ().meshAction == WifiActionHeader::PATH_SELECTION)
+    {
+      g_frames++;
+      g_bytes += packet->GetSize ();
+    }
+}
+
+/**
+ * Record the duration of a path discovery.
+ *
+ * \param time the duration of the path discovery
+ */
+static void
+RouteDiscoveryTime (Time time)
+{
+  g_discoveries++;
+  g_discoveryTime += time;
+}
+
+/**
+ * Count a frame handed back by HWMP.
+ *
+ * \param success whether a path was found
+ * \param packet the frame
+ * \param src the source address
+ * \param dst the destination address
+ * \param protocol the protocol number
+ * \param index the interface index
+ */
+static void
+Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t index)
+{
+  g_found += success;
+}
+
+/**
+ * Request the paths from a mesh point to the next ones.
+ *
+ * \param devices the mesh points
+ * \param i the index of the mesh point
+ * \param destinations the number of destinations of the mesh point
+ */
+static void
+RequestRoutes (NetDeviceContainer devices, uint32_t i, uint32_t destinations)
+{
+  Ptr<Packet> packet = Create<Packet> (100);
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (i));
+  Mac48Address src = Mac48Address::ConvertFrom (mp->GetAddress ());
+  for (uint32_t j = 1; j <= destinations; ++j)
+    {
+      Ptr<NetDevice> dst = devices.Get ((i + j * 7) % devices.GetN ());
+      mp->GetRoutingProtocol ()->RequestRoute (mp->GetIfIndex (), src, Mac48Address::ConvertFrom (dst->GetAddress ()),
+                                               packet, 0x0800, MakeCallback (&Reply));
+    }
+}
+
+/**
+ * Run the path discoveries.
+ *
+ * \param size the number of mesh points on each side of the grid
+ * \param step the distance between the mesh points
+ * \param destinations the number of destinations of each mesh point
+ * \param spread the duration over which the mesh points request their paths
+ * \param window the batch window of HWMP
+ */
+static void
+Run (uint32_t size, double step, uint32_t destinations, Time spread, Time window)
+{
+  g_frames = 0;
+  g_bytes = 0;
+  g_found = 0;
+  g_discoveries = 0;
+  g_discoveryTime = Seconds (0);
+  Config::SetDefault ("ns3::dot11s::HwmpProtocol::PathSelectionBatchWindow", TimeValue (window));
+  RngSeedManager::SetRun (1);
+
+  NodeContainer nodes;
+  nodes.Create (size * size);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetStandard (WIFI_PHY_STANDARD_80211a);
+  mesh.SetMacType ("QosSupported", BooleanValue (true));
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  mesh.AssignStreams (devices, 0);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (step),
+                                 "DeltaY", DoubleValue (step),
+                                 "GridWidth", UintegerValue (size));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxBegin",
+                                 MakeCallback (&PhyTxBegin));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/RouteDiscoveryTime",
+                                 MakeCallback (&RouteDiscoveryTime));
+
+  //Peer links are up after a few beacons, then the mesh points request
+  //their paths within the spread
+  Ptr<UniformRandomVariable> start = CreateObject<UniformRandomVariable> ();
+  start->SetStream (devices.GetN () * 100);
+  for (uint32_t i = 0; i < devices.GetN (); ++i)
+    {
+      Simulator::Schedule (Seconds (5) + MicroSeconds (start->GetInteger (0, spread.GetMicroSeconds ())),
+                           &RequestRoutes, devices, i, destinations);
+    }
+  Simulator::Stop (Seconds (10));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  std::cout << "window " << window.As (Time::MS) << ": "
+            << g_frames << " path selection frames (" << g_bytes << " bytes), "
+            << Simulator::GetEventCount () << " events, "
+            << g_found << "/" << devices.GetN () * destinations << " paths found, "
+            << "mean discovery time " << (g_discoveries ? g_discoveryTime / g_discoveries : Seconds (0)).As (Time::MS) << ", "
+            << elapsed << " ms" << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t size = 5;
+  double step = 50;
+  uint32_t destinations = 4;
+  Time spread = MilliSeconds (100);
+  Time window = MilliSeconds (5);
+
+  CommandLine cmd;
+  cmd.Usage ("Compare the HWMP path discoveries with and without batching of the path selection elements");
+  cmd.AddValue ("size", "number of mesh points on each side of the grid", size);
+  cmd.AddValue ("step", "distance (m) between the mesh points", step);
+  cmd.AddValue ("destinations", "number of paths requested by each mesh point", destinations);
+  cmd.AddValue ("spread", "duration over which the mesh points request their paths", spread);
+  cmd.AddValue ("window", "batch window of the path selection elements", window);
+  cmd.Parse (argc, argv);
+
+  Run (size, step, destinations, spread, Seconds (0));
+  Run (size, step, destinations, spread, window);
+  return 0;
+}
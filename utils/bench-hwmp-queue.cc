@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of the HWMP queue of the frames which
+// wait for a path: two mesh points peer, then the first one is handed
+// many frames at once for the second one, interleaved with frames for
+// destinations which do not exist.  They are all queued during the
+// path discovery, and the frames for the second mesh point are flushed
+// when its PREP is received.  The frames are handed back to the
+// program rather than transmitted, so that only the queue is measured.
+// Sample usage:  ./waf --run 'bench-hwmp-queue --frames=10000 --unreachable=4'
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+
+using namespace ns3;
+
+static uint32_t g_flushed = 0;     //!< Number of frames flushed to the reachable mesh point
+static uint32_t g_dropped = 0;     //!< Number of frames dropped
+static uint32_t g_frames = 0;      //!< Number of frames for the reachable mesh point
+static SystemWallClockMs g_clock;  //!< Clock of the flush
+static bool g_started = false;     //!< Whether the first path was resolved
+static int64_t g_elapsed = 0;      //!< Duration of the flush, in ms
+
+/**
+ * Start the clock when the path discovery of the reachable mesh point
+ * ends, right before its frames are flushed.
+ *
+ * \param time the duration of the path discovery
+ */
+static void
+RouteDiscoveryTime (Time time)
+{
+  if (!g_started)
+    {
+      g_started = true;
+      g_clock.Start ();
+    }
+}
+
+/**
+ * Count a frame handed back by HWMP, and stop the clock when all the
+ * frames for the reachable mesh point were flushed.
+ *
+ * \param success whether a path was found
+ * \param packet the frame
+ * \param src the source address
+ * \param dst the destination address
+ * \param protocol the protocol number
+ * \param index the interface index
+ */
+static void
+Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t index)
+{
+  if (!success)
+    {
+      g_dropped++;
+    }
+  else if (++g_flushed == g_frames)
+    {
+      g_elapsed = g_clock.End ();
+    }
+}
+
+/**
+ * Hand the frames to HWMP.
+ *
+ * \param mp the mesh point which sends the frames
+ * \param dst the address of the reachable mesh point
+ * \param frames the number of frames for the reachable mesh point
+ * \param unreachable the number of destinations which do not exist
+ */
+static void
+Enqueue (Ptr<MeshPointDevice> mp, Mac48Address dst, uint32_t frames, uint32_t unreachable)
+{
+  Ptr<MeshL2RoutingProtocol> hwmp = mp->GetRoutingProtocol ();
+  Mac48Address src = Mac48Address::ConvertFrom (mp->GetAddress ());
+  Ptr<Packet> packet = Create<Packet> (100);
+  for (uint32_t i = 0; i < frames; ++i)
+    {
+      hwmp->RequestRoute (mp->GetIfIndex (), src, dst, packet, 0x0800, MakeCallback (&Reply));
+      for (uint32_t j = 0; j < unreachable; ++j)
+        {
+          uint8_t buffer[6] = {0x02, 0, 0, 0, static_cast<uint8_t> (j >> 8), static_cast<uint8_t> (j)};
+          Mac48Address other;
+          other.CopyFrom (buffer);
+          hwmp->RequestRoute (mp->GetIfIndex (), src, other, packet, 0x0800, MakeCallback (&Reply));
+        }
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t frames = 10000;
+  uint32_t unreachable = 0;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the flush of the HWMP queue on path resolution");
+  cmd.AddValue ("frames", "number of frames queued for the reachable mesh point", frames);
+  cmd.AddValue ("unreachable", "number of unreachable destinations, with as many frames each", unreachable);
+  cmd.Parse (argc, argv);
+  g_frames = frames;
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetStandard (WIFI_PHY_STANDARD_80211a);
+  mesh.SetRemoteStationManager ("ns3::ConstantRateWifiManager");
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/MaxQueueSize",
+               UintegerValue (std::min<uint32_t> (frames * (unreachable + 1), 65535)));
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (50),
+                                 "GridWidth", UintegerValue (2));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  Config::ConnectWithoutContext ("/NodeList/0/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/RouteDiscoveryTime",
+                                 MakeCallback (&RouteDiscoveryTime));
+
+  //Peer links are up after a few beacons
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  Mac48Address dst = Mac48Address::ConvertFrom (devices.Get (1)->GetAddress ());
+  Simulator::Schedule (Seconds (5), &Enqueue, mp, dst, frames, unreachable);
+  Simulator::Stop (Seconds (6));
+  Simulator::Run ();
+
+  std::cout << frames << " frames, " << unreachable << " unreachable destinations: "
+            << g_flushed << " flushed in " << g_elapsed << " ms, "
+            << g_dropped << " dropped" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
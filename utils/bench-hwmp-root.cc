@@ -0,0 +1,288 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program compares the HWMP path discoveries of gateway-centric
+// traffic with on-demand HWMP and with the gateways as roots of the
+// proactive tree, announced by proactive PREQs or by RANNs.  The mesh
+// points are laid on a grid, or read from a location file as the ones
+// of mesh-loc-jw.  Once the peer links are up, each mesh point which is
+// not a gateway hands a frame for its gateway to HWMP every interval.
+// For each mode, the program prints the number of path selection frames
+// transmitted, the number of frames whose path was known at once,
+// queued or dropped, the number and mean duration of the path
+// discoveries, and the number of simulated events.  The frames whose
+// path is found are handed back to the program rather than
+// transmitted, so that only the path selection frames are counted.
+// Sample usage:  ./waf --run 'bench-hwmp-root --locationFile=my-simulations/2_throughput/input/location_400_0_25_1.txt --scale=80 --gateways=0+12'
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+
+using namespace ns3;
+
+static uint32_t g_frames = 0;      //!< Number of path selection frames transmitted
+static uint64_t g_bytes = 0;       //!< Size of the path selection frames transmitted
+static uint32_t g_immediate = 0;   //!< Number of frames whose path was known at once
+static uint32_t g_queued = 0;      //!< Number of frames whose path was found later
+static uint32_t g_dropped = 0;     //!< Number of frames dropped
+static uint32_t g_discoveries = 0; //!< Number of path discoveries
+static Time g_discoveryTime;       //!< Total path discovery time
+static bool g_requesting = false;  //!< Whether a frame is being handed to HWMP
+
+/**
+ * Count the path selection frames transmitted by a PHY.
+ *
+ * \param packet the frame
+ * \param txPowerW the TX power
+ */
+static void
+PhyTxBegin (Ptr<const Packet> packet, double txPowerW)
+{
+  Ptr<Packet> copy = packet->Copy ();
+  WifiMacHeader hdr;
+  copy->RemoveHeader (hdr);
+  if (!hdr.IsAction ())
+    {
+      return;
+    }
+  WifiActionHeader actionHdr;
+  copy->RemoveHeader (actionHdr);
+  if (actionHdr.GetCategory () == WifiActionHeader::MESH
+      && actionHdr.GetAction ().meshAction == WifiActionHeader::PATH_SELECTION)
+    {
+      g_frames++;
+      g_bytes += packet->GetSize ();
+    }
+}
+
+/**
+ * Record the duration of a path discovery.
+ *
+ * \param time the duration of the path discovery
+ */
+static void
+RouteDiscoveryTime (Time time)
+{
+  g_discoveries++;
+  g_discoveryTime += time;
+}
+
+/**
+ * Count a frame handed back by HWMP.
+ *
+ * \param success whether a path was found
+ * \param packet the frame
+ * \param src the source address
+ * \param dst the destination address
+ * \param protocol the protocol number
+ * \param index the interface index
+ */
+static void
+Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t index)
+{
+  if (!success)
+    {
+      g_dropped++;
+    }
+  else if (g_requesting)
+    {
+      g_immediate++;
+    }
+  else
+    {
+      g_queued++;
+    }
+}
+
+/**
+ * Hand a frame for its gateway to HWMP, and schedule the next one.
+ *
+ * \param mp the mesh point which sends the frame
+ * \param gateway the address of the gateway
+ * \param interval the interval between two frames
+ */
+static void
+Send (Ptr<MeshPointDevice> mp, Mac48Address gateway, Time interval)
+{
+  g_requesting = true;
+  mp->GetRoutingProtocol ()->RequestRoute (mp->GetIfIndex (), Mac48Address::ConvertFrom (mp->GetAddress ()), gateway,
+                                           Create<Packet> (100), 0x0800, MakeCallback (&Reply));
+  g_requesting = false;
+  Simulator::Schedule (interval, &Send, mp, gateway, interval);
+}
+
+/**
+ * Run the traffic to the gateways.
+ *
+ * \param mode the mode of HWMP: OnDemand, ProactivePreq or Rann
+ * \param positions the positions of the mesh points
+ * \param gateways the indices of the gateways
+ * \param interval the interval between two frames of a mesh point
+ * \param duration the duration of the traffic
+ */
+static void
+Run (std::string mode, Ptr<ListPositionAllocator> positions, std::vector<uint32_t> gateways, Time interval, Time duration)
+{
+  g_frames = 0;
+  g_bytes = 0;
+  g_immediate = 0;
+  g_queued = 0;
+  g_dropped = 0;
+  g_discoveries = 0;
+  g_discoveryTime = Seconds (0);
+  RngSeedManager::SetRun (1);
+
+  NodeContainer nodes;
+  nodes.Create (positions->GetSize ());
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetStandard (WIFI_PHY_STANDARD_80211a);
+  mesh.SetMacType ("QosSupported", BooleanValue (true));
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  mesh.AssignStreams (devices, 0);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  if (mode != "OnDemand")
+    {
+      Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/RootMode",
+                   StringValue (mode));
+      Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/Dot11MeshHWMPrannInterval",
+                   TimeValue (MicroSeconds (1024*2000)));
+      Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/RootPathRepair",
+                   BooleanValue (true));
+      for (std::vector<uint32_t>::const_iterator i = gateways.begin (); i != gateways.end (); ++i)
+        {
+          devices.Get (*i)->GetObject<dot11s::HwmpProtocol> ()->SetRoot ();
+        }
+    }
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxBegin",
+                                 MakeCallback (&PhyTxBegin));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/RouteDiscoveryTime",
+                                 MakeCallback (&RouteDiscoveryTime));
+
+  //Peer links are up after a few beacons, then the mesh points send to
+  //their gateway, each with its own phase
+  Ptr<UniformRandomVariable> start = CreateObject<UniformRandomVariable> ();
+  start->SetStream (devices.GetN () * 100);
+  for (uint32_t i = 0; i < devices.GetN (); ++i)
+    {
+      if (std::find (gateways.begin (), gateways.end (), i) != gateways.end ())
+        {
+          continue;
+        }
+      Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (i));
+      Mac48Address gateway = Mac48Address::ConvertFrom (devices.Get (gateways[i % gateways.size ()])->GetAddress ());
+      Simulator::Schedule (Seconds (5) + MicroSeconds (start->GetInteger (0, interval.GetMicroSeconds ())),
+                           &Send, mp, gateway, interval);
+    }
+  Simulator::Stop (Seconds (5) + duration);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  std::cout << mode << ": "
+            << g_frames << " path selection frames (" << g_bytes << " bytes), "
+            << g_immediate << " frames sent at once, " << g_queued << " queued, " << g_dropped << " dropped, "
+            << g_discoveries << " discoveries of mean time "
+            << (g_discoveries ? g_discoveryTime / g_discoveries : Seconds (0)).As (Time::MS) << ", "
+            << Simulator::GetEventCount () << " events, "
+            << elapsed << " ms" << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t size = 5;
+  double step = 50;
+  std::string locationFile;
+  double scale = 80;
+  std::string gateways = "0";
+  Time interval = Seconds (1);
+  Time duration = Seconds (60);
+
+  CommandLine cmd;
+  cmd.Usage ("Compare on-demand HWMP with the proactive tree of the gateways");
+  cmd.AddValue ("size", "number of mesh points on each side of the grid", size);
+  cmd.AddValue ("step", "distance (m) between the mesh points of the grid", step);
+  cmd.AddValue ("locationFile", "file of the positions of the mesh points, instead of the grid", locationFile);
+  cmd.AddValue ("scale", "ratio (%) between the positions of the location file and the simulation", scale);
+  cmd.AddValue ("gateways", "'+'-separated indices of the gateways", gateways);
+  cmd.AddValue ("interval", "interval between two frames of a mesh point", interval);
+  cmd.AddValue ("duration", "duration of the traffic", duration);
+  cmd.Parse (argc, argv);
+
+  //The peer links of mesh-loc-jw, which survive the frames lost in
+  //crowded layouts
+  Config::SetDefault ("ns3::dot11s::PeerLink::MaxBeaconLoss", UintegerValue (20));
+  Config::SetDefault ("ns3::dot11s::PeerLink::MaxRetries", UintegerValue (4));
+  Config::SetDefault ("ns3::dot11s::PeerLink::MaxPacketFailure", UintegerValue (5));
+
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  if (locationFile.empty ())
+    {
+      for (uint32_t i = 0; i < size * size; ++i)
+        {
+          positions->Add (Vector (step * (i % size), step * (i / size), 0));
+        }
+    }
+  else
+    {
+      std::ifstream file (locationFile.c_str ());
+      NS_ABORT_MSG_IF (!file.is_open (), "Cannot open " << locationFile);
+      std::string line;
+      while (std::getline (file, line))
+        {
+          std::istringstream fields (line);
+          double x, y, z;
+          if (fields >> x >> y >> z)
+            {
+              positions->Add (Vector (x * scale / 100, y * scale / 100, z * scale / 100));
+            }
+        }
+    }
+
+  std::replace (gateways.begin (), gateways.end (), '+', ' ');
+  std::istringstream gatewayStream (gateways);
+  std::vector<uint32_t> indices;
+  uint32_t index;
+  while (gatewayStream >> index)
+    {
+      NS_ABORT_MSG_IF (index >= positions->GetSize (), "Invalid gateway " << index);
+      indices.push_back (index);
+    }
+  NS_ABORT_MSG_IF (indices.empty (), "No gateway");
+
+  Run ("OnDemand", positions, indices, interval, duration);
+  Run ("ProactivePreq", positions, indices, interval, duration);
+  Run ("Rann", positions, indices, interval, duration);
+  return 0;
+}
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of the management plane of an idle
+// 802.11s mesh: mesh points on a grid, without any data traffic, so
+// that the simulator only runs beacons and peer link management.  It
+// reports the number of events executed by the simulator and the
+// number of peer links opened and closed, with beacons either
+// transmitted or abstracted (see the AbstractBeacons attribute of
+// MeshWifiInterfaceMac).
+// Sample usage:  ./waf --run 'bench-mesh-beacons --side=10 --simTime=60 --abstract=1'
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+
+using namespace ns3;
+
+static uint32_t g_linksOpened = 0; //!< Number of peer links opened
+static uint32_t g_linksClosed = 0; //!< Number of peer links closed
+
+/**
+ * Count a peer link opened.
+ * \param src the address of the local interface
+ * \param dst the address of the peer interface
+ */
+static void
+LinkOpen (Mac48Address src, Mac48Address dst)
+{
+  g_linksOpened++;
+}
+
+/**
+ * Count a peer link closed.
+ * \param src the address of the local interface
+ * \param dst the address of the peer interface
+ */
+static void
+LinkClose (Mac48Address src, Mac48Address dst)
+{
+  g_linksClosed++;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t side = 10;
+  double step = 100;
+  double simTime = 60;
+  bool abstract = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the management plane of an idle 802.11s mesh");
+  cmd.AddValue ("side", "number of mesh points on each side of the grid", side);
+  cmd.AddValue ("step", "distance between neighbour mesh points, in meters", step);
+  cmd.AddValue ("simTime", "simulated time, in seconds", simTime);
+  cmd.AddValue ("abstract", "abstract the beacons rather than transmit them", abstract);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (side * side);
+
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  mesh.SetRemoteStationManager ("ns3::IdealWifiManager");
+  mesh.SetMacType ("RandomStart", TimeValue (Seconds (0.1)),
+                   "AbstractBeacons", BooleanValue (abstract));
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "MinX", DoubleValue (0.0),
+                                 "MinY", DoubleValue (0.0),
+                                 "DeltaX", DoubleValue (step),
+                                 "DeltaY", DoubleValue (step),
+                                 "GridWidth", UintegerValue (side),
+                                 "LayoutType", StringValue ("RowFirst"));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::dot11s::PeerManagementProtocol/LinkOpen",
+                                 MakeCallback (&LinkOpen));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::dot11s::PeerManagementProtocol/LinkClose",
+                                 MakeCallback (&LinkClose));
+
+  Simulator::Stop (Seconds (simTime));
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  std::cout << side * side << " mesh points, " << simTime << " s, "
+            << (abstract ? "abstracted" : "transmitted") << " beacons: "
+            << g_linksOpened << " links opened, " << g_linksClosed << " closed, "
+            << Simulator::GetEventCount () << " events in " << elapsed << " ms" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the throughput of a mesh backhaul with one to
+// several radios per mesh point, on non-overlapping channels, with and
+// without multi-channel forwarding.  The mesh points are laid on a
+// line, and once the peer links are up, the first one sends frames to
+// the last one faster than the backhaul can carry them.  For each
+// number of radios and mode, the program prints the throughput received
+// by the last mesh point and the data frames transmitted by each radio
+// of the first one.
+// Sample usage:  ./waf --run 'bench-mesh-channels --nodes=3 --radios=3'
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mesh-module.h"
+
+using namespace ns3;
+
+static uint64_t g_rxBytes = 0;           //!< Bytes received by the last mesh point
+static std::vector<uint32_t> g_txFrames; //!< Data frames transmitted by each radio of the first mesh point
+
+/**
+ * Count the bytes received by the last mesh point.
+ *
+ * \param device the mesh point
+ * \param packet the frame
+ * \param protocol the protocol number
+ * \param from the source address
+ * \return true
+ */
+static bool
+Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  g_rxBytes += packet->GetSize ();
+  return true;
+}
+
+/**
+ * Count the data frames transmitted by a radio of the first mesh point.
+ *
+ * \param context the index of the radio
+ * \param packet the frame
+ * \param txPowerW the TX power
+ */
+static void
+PhyTxBegin (std::string context, Ptr<const Packet> packet, double txPowerW)
+{
+  WifiMacHeader hdr;
+  packet->PeekHeader (hdr);
+  if (hdr.IsData () && !hdr.GetAddr1 ().IsGroup ())
+    {
+      g_txFrames[std::atoi (context.c_str ())]++;
+    }
+}
+
+/**
+ * Send a frame to the last mesh point, and schedule the next one.
+ *
+ * \param mp the first mesh point
+ * \param dst the address of the last mesh point
+ * \param size the size of the frames
+ * \param interval the interval between two frames
+ */
+static void
+Send (Ptr<MeshPointDevice> mp, Mac48Address dst, uint32_t size, Time interval)
+{
+  mp->Send (Create<Packet> (size), dst, 0x0800);
+  Simulator::Schedule (interval, &Send, mp, dst, size, interval);
+}
+
+/**
+ * Run the backhaul.
+ *
+ * \param nodes the number of mesh points
+ * \param step the distance between two mesh points
+ * \param radios the number of radios of each mesh point
+ * \param multiChannel whether multi-channel forwarding is enabled
+ * \param size the size of the frames
+ * \param interval the interval between two frames
+ * \param duration the duration of the traffic
+ */
+static void
+Run (uint32_t nodes, double step, uint32_t radios, bool multiChannel, uint32_t size, Time interval, Time duration)
+{
+  g_rxBytes = 0;
+  g_txFrames.assign (radios, 0);
+  RngSeedManager::SetRun (1);
+
+  NodeContainer meshNodes;
+  meshNodes.Create (nodes);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetStandard (WIFI_PHY_STANDARD_80211a);
+  mesh.SetMacType ("QosSupported", BooleanValue (true));
+  mesh.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate24Mbps"));
+  mesh.SetNumberOfInterfaces (radios);
+  NetDeviceContainer devices = mesh.Install (phy, meshNodes);
+  mesh.AssignStreams (devices, 0);
+  Config::Set ("/NodeList/*/DeviceList/*/RoutingProtocol/$ns3::dot11s::HwmpProtocol/MultiChannelForwarding",
+               BooleanValue (multiChannel));
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (step),
+                                 "GridWidth", UintegerValue (nodes));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (meshNodes);
+
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  std::vector<Ptr<NetDevice> > interfaces = mp->GetInterfaces ();
+  for (uint32_t i = 0; i < interfaces.size (); ++i)
+    {
+      std::ostringstream context;
+      context << i;
+      DynamicCast<WifiNetDevice> (interfaces[i])->GetPhy ()->TraceConnect ("PhyTxBegin", context.str (),
+                                                                            MakeCallback (&PhyTxBegin));
+    }
+  devices.Get (nodes - 1)->SetReceiveCallback (MakeCallback (&Receive));
+
+  //Peer links are up after a few beacons
+  Mac48Address dst = Mac48Address::ConvertFrom (devices.Get (nodes - 1)->GetAddress ());
+  Simulator::Schedule (Seconds (5), &Send, mp, dst, size, interval);
+  Simulator::Stop (Seconds (5) + duration);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  std::cout << radios << " radios, multi-channel " << (multiChannel ? "on " : "off") << ": "
+            << g_rxBytes * 8 / duration.GetSeconds () / 1e6 << " Mbps, data frames of each radio";
+  for (uint32_t i = 0; i < radios; ++i)
+    {
+      std::cout << " " << g_txFrames[i];
+    }
+  std::cout << ", " << elapsed << " ms" << std::endl;
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nodes = 3;
+  double step = 30;
+  uint32_t radios = 3;
+  uint32_t size = 1000;
+  Time interval = MicroSeconds (100);
+  Time duration = Seconds (10);
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the throughput of a mesh backhaul against its number of radios");
+  cmd.AddValue ("nodes", "number of mesh points of the line", nodes);
+  cmd.AddValue ("step", "distance (m) between two mesh points", step);
+  cmd.AddValue ("radios", "largest number of radios of each mesh point", radios);
+  cmd.AddValue ("size", "size of the frames", size);
+  cmd.AddValue ("interval", "interval between two frames", interval);
+  cmd.AddValue ("duration", "duration of the traffic", duration);
+  cmd.Parse (argc, argv);
+
+  //The peer links of mesh-loc-jw, which survive the frames lost by a
+  //saturated backhaul
+  Config::SetDefault ("ns3::dot11s::PeerLink::MaxBeaconLoss", UintegerValue (20));
+  Config::SetDefault ("ns3::dot11s::PeerLink::MaxRetries", UintegerValue (4));
+  Config::SetDefault ("ns3::dot11s::PeerLink::MaxPacketFailure", UintegerValue (5));
+
+  for (uint32_t r = 1; r <= radios; ++r)
+    {
+      Run (nodes, step, r, false, size, interval, duration);
+      if (r > 1)
+        {
+          Run (nodes, step, r, true, size, interval, duration);
+        }
+    }
+  return 0;
+}
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of the payload PER of a long HE A-MPDU
+// received under heavy interference, which InterferenceHelper cuts into
+// many chunks of constant SINR.  The PER of each MPDU is computed with
+// InterferenceHelper::CalculatePayloadSnrPer, then with a scalar
+// reference which evaluates one chunk at a time, as InterferenceHelper
+// used to, and the largest difference between the two is printed.
+// Sample usage:  ./waf --run 'bench-payload-per --interferers=200 --mpdus=64'
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+
+using namespace ns3;
+
+/// An interfering signal, which starts with the frame
+struct Interferer
+{
+  Time end;      ///< end of the signal
+  double powerW; ///< received power of the signal
+};
+
+int main (int argc, char *argv[])
+{
+  uint32_t interferers = 200;
+  uint32_t mpdus = 64;
+  uint32_t iterations = 200;
+  uint32_t mcs = 7;
+  uint16_t width = 80;
+  double rxPowerDbm = -60;
+  double interferenceDbm = -100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the payload PER of InterferenceHelper against a scalar reference");
+  cmd.AddValue ("interferers", "number of interfering signals over the frame", interferers);
+  cmd.AddValue ("mpdus", "number of MPDUs in the A-MPDU", mpdus);
+  cmd.AddValue ("iterations", "number of times the PER of the A-MPDU is computed", iterations);
+  cmd.AddValue ("mcs", "HE MCS of the frame", mcs);
+  cmd.AddValue ("width", "channel width (MHz) of the frame", width);
+  cmd.AddValue ("rxPower", "received power (dBm) of the frame", rxPowerDbm);
+  cmd.AddValue ("interference", "mean received power (dBm) of an interfering signal", interferenceDbm);
+  cmd.Parse (argc, argv);
+
+  std::vector<WifiMode> heMcs = {WifiPhy::GetHeMcs0 (), WifiPhy::GetHeMcs1 (), WifiPhy::GetHeMcs2 (), WifiPhy::GetHeMcs3 (),
+                                 WifiPhy::GetHeMcs4 (), WifiPhy::GetHeMcs5 (), WifiPhy::GetHeMcs6 (), WifiPhy::GetHeMcs7 (),
+                                 WifiPhy::GetHeMcs8 (), WifiPhy::GetHeMcs9 (), WifiPhy::GetHeMcs10 (), WifiPhy::GetHeMcs11 ()};
+  NS_ABORT_MSG_IF (mcs >= heMcs.size (), "Invalid HE MCS " << mcs);
+  WifiTxVector txVector;
+  txVector.SetMode (heMcs[mcs]);
+  txVector.SetPreambleType (WIFI_PREAMBLE_HE_SU);
+  txVector.SetChannelWidth (width);
+  txVector.SetGuardInterval (800);
+  txVector.SetNss (1);
+  txVector.SetNTx (1);
+  txVector.SetAggregation (true);
+  Time payloadStart = WifiPhy::CalculatePlcpPreambleAndHeaderDuration (txVector);
+  Time mpduDuration = MicroSeconds (100);
+  Time duration = payloadStart + mpduDuration * mpdus;
+
+  double noiseFigure = DbToRatio (7);
+  Ptr<ErrorRateModel> errorRateModel = CreateObject<NistErrorRateModel> ();
+  InterferenceHelper interference;
+  interference.SetNoiseFigure (noiseFigure);
+  interference.SetErrorRateModel (errorRateModel);
+  interference.SetNumberOfReceiveAntennas (1);
+
+  //The frame, then the interfering signals, which end at random times
+  //over the payload
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  double rxPowerW = DbmToW (rxPowerDbm);
+  Ptr<Packet> packet = Create<Packet> (1500 * mpdus);
+  Ptr<Event> event = interference.Add (packet, txVector, duration, rxPowerW);
+  interference.NotifyRxStart ();
+  std::vector<Interferer> signals;
+  for (uint32_t i = 0; i < interferers; ++i)
+    {
+      Interferer signal;
+      signal.end = payloadStart + NanoSeconds (random->GetInteger (1, (mpduDuration * mpdus).GetNanoSeconds ()));
+      signal.powerW = DbmToW (interferenceDbm + random->GetValue (-6, 6));
+      interference.Add (packet, txVector, signal.end, signal.powerW);
+      signals.push_back (signal);
+    }
+  std::sort (signals.begin (), signals.end (),
+             [] (const Interferer &a, const Interferer &b) { return a.end < b.end; });
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  std::vector<double> pers;
+  for (uint32_t n = 0; n < iterations; ++n)
+    {
+      pers.clear ();
+      for (uint32_t i = 0; i < mpdus; ++i)
+        {
+          std::pair<Time, Time> window (mpduDuration * i, mpduDuration * (i + 1));
+          pers.push_back (interference.CalculatePayloadSnrPer (event, window).per);
+        }
+    }
+  int64_t batched = clock.End ();
+
+  //Scalar reference: one chunk at a time, with the SNR, the rate and the
+  //number of bits of each chunk computed from Time.  As InterferenceHelper,
+  //the chunk which crosses the end of the window is counted in full.
+  clock.Start ();
+  std::vector<double> reference;
+  double noiseFloorW = interference.GetNoiseFloorW (width);
+  std::vector<Time> changes;
+  for (std::vector<Interferer>::const_iterator j = signals.begin (); j != signals.end (); ++j)
+    {
+      changes.push_back (j->end);
+    }
+  changes.push_back (duration);
+  for (uint32_t n = 0; n < iterations; ++n)
+    {
+      reference.clear ();
+      for (uint32_t i = 0; i < mpdus; ++i)
+        {
+          Time windowStart = payloadStart + mpduDuration * i;
+          Time windowEnd = payloadStart + mpduDuration * (i + 1);
+          double interferenceW = 0;
+          for (std::vector<Interferer>::const_iterator j = signals.begin (); j != signals.end (); ++j)
+            {
+              interferenceW += j->powerW;
+            }
+          Time previous = Seconds (0);
+          double psr = 1.0;
+          for (uint32_t j = 0; j < changes.size () && previous <= windowEnd; ++j)
+            {
+              Time chunk = Seconds (0);
+              if (previous >= windowStart)
+                {
+                  chunk = changes[j] - previous;
+                }
+              else if (changes[j] >= windowStart)
+                {
+                  chunk = changes[j] - windowStart;
+                }
+              if (!chunk.IsZero ())
+                {
+                  double snr = rxPowerW / (noiseFloorW + interferenceW);
+                  uint64_t rate = txVector.GetMode ().GetDataRate (txVector);
+                  uint64_t nbits = static_cast<uint64_t> (rate * chunk.GetSeconds ());
+                  psr *= errorRateModel->GetChunkSuccessRate (txVector.GetMode (), txVector, snr, nbits);
+                }
+              if (j < signals.size ())
+                {
+                  interferenceW -= signals[j].powerW;
+                }
+              previous = changes[j];
+            }
+          reference.push_back (1 - psr);
+        }
+    }
+  int64_t scalar = clock.End ();
+
+  double maxDifference = 0;
+  double checksum = 0;
+  for (uint32_t i = 0; i < mpdus; ++i)
+    {
+      maxDifference = std::max (maxDifference, std::abs (pers[i] - reference[i]));
+      checksum += pers[i];
+    }
+  std::cout << "chunks per MPDU " << static_cast<double> (interferers) / mpdus << std::endl
+            << "batched " << batched << " ms" << std::endl
+            << "scalar " << scalar << " ms" << std::endl
+            << "max PER difference " << maxDifference << std::endl
+            << "checksum " << checksum << std::endl;
+  return 0;
+}
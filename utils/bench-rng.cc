@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the throughput of the random numbers of
+// RngStream, one at a time and by blocks, and of the random variables
+// built on them.  It first checks that RngStream gives the same
+// sequences as a scalar reference, which generates one random at a
+// time, as RngStream used to.
+// Sample usage:  ./waf --run 'bench-rng --randoms=100000000'
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/rng-stream.h"
+
+using namespace ns3;
+
+/**
+ * Scalar MRG32k3a, which generates one random at a time.
+ */
+class ReferenceRng
+{
+public:
+  /**
+   * Construct the generator of the first stream and substream of a seed,
+   * whose state is the seed itself.
+   *
+   * \param seed the seed
+   */
+  ReferenceRng (uint32_t seed)
+  {
+    for (int i = 0; i < 6; ++i)
+      {
+        m_state[i] = seed;
+      }
+  }
+  /**
+   * \return the next random
+   */
+  double RandU01 (void)
+  {
+    const double m1 = 4294967087.0;
+    const double m2 = 4294944443.0;
+    const double norm = 1.0 / (m1 + 1.0);
+    int32_t k;
+    double p1 = 1403580.0 * m_state[1] - 810728.0 * m_state[0];
+    k = static_cast<int32_t> (p1 / m1);
+    p1 -= k * m1;
+    if (p1 < 0.0)
+      {
+        p1 += m1;
+      }
+    m_state[0] = m_state[1]; m_state[1] = m_state[2]; m_state[2] = p1;
+    double p2 = 527612.0 * m_state[5] - 1370589.0 * m_state[3];
+    k = static_cast<int32_t> (p2 / m2);
+    p2 -= k * m2;
+    if (p2 < 0.0)
+      {
+        p2 += m2;
+      }
+    m_state[3] = m_state[4]; m_state[4] = m_state[5]; m_state[5] = p2;
+    return ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
+  }
+
+private:
+  double m_state[6]; ///< the state of the two components
+};
+
+/**
+ * Print the throughput of a generator.
+ *
+ * \param name the name of the generator
+ * \param randoms the number of randoms generated
+ * \param elapsed the time it took, in ms
+ * \param checksum the sum of the randoms
+ */
+static void
+Print (std::string name, uint64_t randoms, int64_t elapsed, double checksum)
+{
+  std::cout << std::left << std::setw (32) << name << std::right << std::setw (8)
+            << elapsed * 1e6 / randoms << " ns/random (checksum " << checksum << ")" << std::endl;
+}
+
+/**
+ * Time the generation of randoms one at a time.
+ *
+ * \param name the name of the generator
+ * \param randoms the number of randoms to generate
+ * \param generate the generator
+ */
+template <typename Generate>
+static void
+Run (std::string name, uint64_t randoms, Generate generate)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  double checksum = 0;
+  for (uint64_t i = 0; i < randoms; ++i)
+    {
+      checksum += generate ();
+    }
+  Print (name, randoms, clock.End (), checksum);
+}
+
+int main (int argc, char *argv[])
+{
+  uint64_t randoms = 100000000;
+  uint32_t block = 1024;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the random numbers of RngStream against a scalar reference");
+  cmd.AddValue ("randoms", "number of randoms generated by each generator", randoms);
+  cmd.AddValue ("block", "number of randoms requested at once from RngStream", block);
+  cmd.Parse (argc, argv);
+
+  //The sequences must match the reference, one at a time and by blocks
+  //of sizes which are not multiples of RngStream::BLOCK_SIZE
+  uint64_t mismatches = 0;
+  for (uint32_t seed = 1; seed <= 4; ++seed)
+    {
+      ReferenceRng reference (seed);
+      RngStream single (seed, 0, 0);
+      RngStream blocks (seed, 0, 0);
+      std::vector<double> values;
+      for (uint32_t n = 1; n <= 100; ++n)
+        {
+          values.resize (n * 7 % 45);
+          blocks.RandU01 (values.data (), values.size ());
+          for (std::size_t i = 0; i < values.size (); ++i)
+            {
+              double u = reference.RandU01 ();
+              mismatches += (single.RandU01 () != u) + (values[i] != u);
+            }
+        }
+    }
+  std::cout << "mismatches " << mismatches << std::endl;
+
+  ReferenceRng reference (1);
+  Run ("reference", randoms, [&] () { return reference.RandU01 (); });
+
+  RngStream single (1, 0, 0);
+  Run ("RngStream::RandU01", randoms, [&] () { return single.RandU01 (); });
+
+  RngStream blocks (1, 0, 0);
+  std::vector<double> values (block);
+  SystemWallClockMs clock;
+  clock.Start ();
+  double checksum = 0;
+  for (uint64_t i = 0; i < randoms; i += block)
+    {
+      blocks.RandU01 (values.data (), block);
+      for (uint32_t j = 0; j < block; ++j)
+        {
+          checksum += values[j];
+        }
+    }
+  Print ("RngStream::RandU01 (block)", randoms, clock.End (), checksum);
+
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  Run ("UniformRandomVariable", randoms, [&] () { return uniform->GetValue (); });
+
+  Ptr<ExponentialRandomVariable> exponential = CreateObject<ExponentialRandomVariable> ();
+  Run ("ExponentialRandomVariable", randoms, [&] () { return exponential->GetValue (); });
+
+  Ptr<NormalRandomVariable> normal = CreateObject<NormalRandomVariable> ();
+  Run ("NormalRandomVariable", randoms, [&] () { return normal->GetValue (); });
+
+  return 0;
+}
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the per-frame cost of the remote station
+// lookups of a WifiRemoteStationManager which knows many peers, as in
+// a dense mesh.  For each frame, it makes the calls the MAC makes for
+// a unicast data frame: NeedRts, GetDataTxVector, ReportDataOk and
+// ReportRxOk, for QoS and non-QoS frames.
+// Sample usage:  ./waf --run 'bench-station-lookup --peers=500 --manager=ns3::MinstrelHtWifiManager'
+
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t peers = 500;
+  uint32_t frames = 1000000;
+  std::string manager = "ns3::MinstrelHtWifiManager";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the station lookups of WifiRemoteStationManager");
+  cmd.AddValue ("peers", "number of peers known by the station manager", peers);
+  cmd.AddValue ("frames", "number of frames", frames);
+  cmd.AddValue ("manager", "TypeId of the station manager", manager);
+  cmd.Parse (argc, argv);
+
+  NodeContainer node;
+  node.Create (1);
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  wifi.SetRemoteStationManager (manager);
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac", "QosSupported", BooleanValue (true));
+  NetDeviceContainer devices = wifi.Install (phy, mac, node);
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (devices.Get (0));
+  Ptr<WifiRemoteStationManager> stations = device->GetRemoteStationManager ();
+
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < peers; ++i)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+      stations->AddAllSupportedModes (addresses.back ());
+      stations->AddAllSupportedMcs (addresses.back ());
+      stations->SetQosSupport (addresses.back (), true);
+    }
+
+  WifiMacHeader qosData;
+  qosData.SetType (WIFI_MAC_QOSDATA);
+  qosData.SetQosTid (5);
+  WifiMacHeader data;
+  data.SetType (WIFI_MAC_DATA);
+  Ptr<Packet> packet = Create<Packet> (1000);
+  WifiMode ackMode = stations->GetDefaultMode ();
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint64_t checksum = 0;
+  for (uint32_t i = 0; i < frames; ++i)
+    {
+      Mac48Address address = addresses[(i * 7919) % peers];
+      const WifiMacHeader *header = (i % 4 == 0) ? &data : &qosData;
+      WifiTxVector txVector = stations->GetDataTxVector (address, header, packet);
+      stations->NeedRts (address, header, packet, txVector);
+      stations->ReportDataOk (address, header, 30, ackMode, 30, packet->GetSize ());
+      stations->ReportRxOk (address, header, 30, ackMode);
+      checksum += txVector.GetMode ().GetUid ();
+    }
+  int64_t elapsed = clock.End ();
+
+  std::cout << manager << ", " << peers << " peers: " << frames << " frames in "
+            << elapsed << " ms (" << elapsed * 1e6 / frames << " ns/frame, checksum "
+            << checksum << ")" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program compares the cost of collecting per-sink throughput
+// time series by polling the counters from a periodic event with the
+// cost of binning them with a TimeBinAggregator as samples arrive.
+// Both variants produce the same rows; the overhead reported for each
+// is relative to a run without any monitoring.
+// Sample usage:  ./waf --run 'bench-time-bin-aggregator --sinks=100 --interval=0.01'
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/time-bin-aggregator.h"
+
+using namespace ns3;
+
+/// Per-sink byte counters, as kept by PacketSink
+std::vector<uint64_t> g_totalRx;
+/// Counter values at the previous poll
+std::vector<uint64_t> g_lastTotalRx;
+
+/**
+ * Poll every counter and print one row.
+ * \param os the output stream
+ * \param interval the polling interval
+ */
+void
+Poll (std::ostream *os, Time interval)
+{
+  *os << Simulator::Now ().GetSeconds ();
+  for (uint32_t i = 0; i < g_totalRx.size (); ++i)
+    {
+      *os << '\t' << (g_totalRx[i] - g_lastTotalRx[i]) * 8e-6 / interval.GetSeconds ();
+      g_lastTotalRx[i] = g_totalRx[i];
+    }
+  *os << '\n';
+  Simulator::Schedule (interval, &Poll, os, interval);
+}
+
+/**
+ * Simulate the reception of one packet by a sink.
+ * \param sink the sink index
+ * \param gap the time between two packets
+ * \param aggregator the aggregator, or 0 when polling
+ */
+void
+Receive (uint32_t sink, Time gap, Ptr<TimeBinAggregator> aggregator)
+{
+  g_totalRx[sink] += 1472;
+  if (aggregator)
+    {
+      aggregator->Add (sink, 1472);
+    }
+  Simulator::Schedule (gap, &Receive, sink, gap, aggregator);
+}
+
+/// Benchmark variants
+enum Variant
+{
+  NONE,
+  POLLING,
+  AGGREGATOR
+};
+
+/**
+ * Run one variant of the benchmark.
+ * \param variant the variant
+ * \param sinks the number of sinks
+ * \param interval the monitoring interval
+ * \param gap the time between two packets of a sink
+ * \param stop the simulation duration
+ * \return the wall-clock time, in ms
+ */
+int64_t
+Run (enum Variant variant, uint32_t sinks, Time interval, Time gap, Time stop)
+{
+  std::ostringstream os;
+  g_totalRx.assign (sinks, 0);
+  g_lastTotalRx.assign (sinks, 0);
+
+  Ptr<TimeBinAggregator> aggregator;
+  if (variant == AGGREGATOR)
+    {
+      aggregator = CreateObject<TimeBinAggregator> (&os);
+      aggregator->SetAttribute ("Interval", TimeValue (interval));
+      aggregator->SetAttribute ("Scale", DoubleValue (8e-6 / interval.GetSeconds ()));
+      for (uint32_t i = 0; i < sinks; ++i)
+        {
+          std::ostringstream name;
+          name << "cl-" << i;
+          aggregator->AddColumn (name.str ());
+        }
+    }
+  else if (variant == POLLING)
+    {
+      Simulator::Schedule (interval, &Poll, &os, interval);
+    }
+  for (uint32_t i = 0; i < sinks; ++i)
+    {
+      Simulator::Schedule (NanoSeconds (i + 1), &Receive, i, gap, aggregator);
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  if (aggregator)
+    {
+      aggregator->Flush ();
+    }
+  int64_t elapsed = clock.End ();
+  Simulator::Destroy ();
+  return elapsed;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t sinks = 100;
+  double interval = 0.01;
+  double gap = 0.001;
+  double stop = 10;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark TimeBinAggregator against periodic polling");
+  cmd.AddValue ("sinks", "number of sinks", sinks);
+  cmd.AddValue ("interval", "monitoring interval, s", interval);
+  cmd.AddValue ("gap", "time between two packets of a sink, s", gap);
+  cmd.AddValue ("stop", "simulation duration, s", stop);
+  cmd.Parse (argc, argv);
+
+  int64_t none = Run (NONE, sinks, Seconds (interval), Seconds (gap), Seconds (stop));
+  int64_t polling = Run (POLLING, sinks, Seconds (interval), Seconds (gap), Seconds (stop));
+  int64_t binning = Run (AGGREGATOR, sinks, Seconds (interval), Seconds (gap), Seconds (stop));
+
+  std::cout << "No monitoring: " << none << " ms" << std::endl;
+  std::cout << "Polling:       " << polling << " ms (+" << polling - none << " ms)" << std::endl;
+  std::cout << "Aggregator:    " << binning << " ms (+" << binning - none << " ms)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of the Time operations found in the
+// PHY, MAC and queue code: the conversions from and to integers and
+// doubles, the arithmetic between Times and with int64x64_t, and the
+// TX duration computations of WifiPhy (without its TX duration cache),
+// which are mostly made of them.
+// Sample usage:  ./waf --run 'bench-time --operations=10000000'
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+
+using namespace ns3;
+
+/**
+ * Time an operation and print its cost.
+ *
+ * \param name the name of the operation
+ * \param operations the number of times to run the operation
+ * \param operation the operation, which gets the iteration number and
+ *        returns a value to add to the checksum
+ */
+template <typename Operation>
+static void
+Run (std::string name, uint32_t operations, Operation operation)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  int64_t checksum = 0;
+  for (uint32_t i = 0; i < operations; ++i)
+    {
+      checksum += operation (i);
+    }
+  int64_t elapsed = clock.End ();
+  std::cout << std::left << std::setw (24) << name << std::right << std::setw (8)
+            << elapsed * 1e6 / operations << " ns/op (checksum " << checksum << ")" << std::endl;
+}
+
+/**
+ * Run the benchmarks.
+ *
+ * \param operations the number of times each operation is run
+ */
+static void
+RunAll (uint32_t operations)
+{
+  //Operands which the compiler cannot fold
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  const uint32_t nOperands = 1024;
+  std::vector<uint64_t> integers;
+  std::vector<double> doubles;
+  std::vector<Time> times;
+  for (uint32_t i = 0; i < nOperands; ++i)
+    {
+      integers.push_back (random->GetInteger (1, 100000));
+      doubles.push_back (random->GetValue (0, 10));
+      times.push_back (NanoSeconds (static_cast<uint64_t> (random->GetValue (1, 1e10))));
+    }
+  const uint32_t mask = nOperands - 1;
+
+  Run ("NanoSeconds (uint64_t)", operations,
+       [&] (uint32_t i) { return NanoSeconds (integers[i & mask]).GetTimeStep (); });
+  Run ("MicroSeconds (uint64_t)", operations,
+       [&] (uint32_t i) { return MicroSeconds (integers[i & mask]).GetTimeStep (); });
+  Run ("Seconds (double)", operations,
+       [&] (uint32_t i) { return Seconds (doubles[i & mask]).GetTimeStep (); });
+  Run ("NanoSeconds (double)", operations,
+       [&] (uint32_t i) { return NanoSeconds (doubles[i & mask] * 1e6).GetTimeStep (); });
+  Run ("GetNanoSeconds", operations,
+       [&] (uint32_t i) { return times[i & mask].GetNanoSeconds (); });
+  Run ("GetMicroSeconds", operations,
+       [&] (uint32_t i) { return times[i & mask].GetMicroSeconds (); });
+  Run ("GetSeconds", operations,
+       [&] (uint32_t i) { return static_cast<int64_t> (times[i & mask].GetSeconds () * 1e9); });
+  Run ("Time + Time", operations,
+       [&] (uint32_t i) { return (times[i & mask] + times[(i + 1) & mask]).GetTimeStep (); });
+  Run ("Time * int64_t", operations,
+       [&] (uint32_t i) { return (times[i & mask] * static_cast<int64_t> (integers[i & mask])).GetTimeStep (); });
+  Run ("Time * double", operations,
+       [&] (uint32_t i) { return (times[i & mask] * int64x64_t (doubles[i & mask])).GetTimeStep (); });
+  Run ("Time / Time", operations,
+       [&] (uint32_t i) { return (times[i & mask] / times[(i + 1) & mask]).GetHigh (); });
+  Run ("Time / int64_t", operations,
+       [&] (uint32_t i) { return (times[i & mask] / static_cast<int64_t> (integers[i & mask])).GetTimeStep (); });
+
+  //The TX durations of data frames over the HE MCSs and of their ACK
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetAttribute ("TxDurationCacheSize", UintegerValue (0));
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  uint16_t frequency = phy->GetFrequency ();
+  std::vector<WifiTxVector> txVectors;
+  for (uint8_t i = 0; i < phy->GetNMcs (); i++)
+    {
+      if (phy->GetMcs (i).GetModulationClass () != WIFI_MOD_CLASS_HE)
+        {
+          continue;
+        }
+      WifiTxVector txVector;
+      txVector.SetMode (phy->GetMcs (i));
+      txVector.SetPreambleType (WIFI_PREAMBLE_HE_SU);
+      txVector.SetChannelWidth (20);
+      txVector.SetGuardInterval (800);
+      txVector.SetNss (1);
+      txVectors.push_back (txVector);
+    }
+  WifiTxVector ackTxVector;
+  ackTxVector.SetMode (WifiPhy::GetOfdmRate24Mbps ());
+  ackTxVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  ackTxVector.SetChannelWidth (20);
+  ackTxVector.SetGuardInterval (800);
+  ackTxVector.SetNss (1);
+  Run ("CalculateTxDuration", operations / 10,
+       [&] (uint32_t i) {
+         uint32_t size = 64 + integers[i & mask] % 1500;
+         return phy->CalculateTxDuration (size, txVectors[i % txVectors.size ()], frequency).GetNanoSeconds ()
+                + phy->CalculateTxDuration (14, ackTxVector, frequency).GetNanoSeconds ();
+       });
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t operations = 10000000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the Time operations");
+  cmd.AddValue ("operations", "number of times each operation is run", operations);
+  cmd.Parse (argc, argv);
+
+  //Times are only cheap once the simulation runs: until then, each of
+  //them is recorded in case the resolution changes
+  Simulator::ScheduleNow (&RunAll, operations);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return 0;
+}
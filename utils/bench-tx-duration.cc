@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of WifiPhy::CalculateTxDuration and
+// WifiPhy::GetPayloadDuration with and without the TX duration cache of
+// the PHY.  Each iteration makes the calls the MAC makes for a data
+// frame: the duration of the frame, of its MPDU in an aggregate, and
+// of the ACK, over the HE MCSs and a few frame sizes.
+// Sample usage:  ./waf --run 'bench-tx-duration --calls=1000000 --cacheSize=0'
+
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/wifi-module.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t calls = 1000000;
+  uint32_t cacheSize = 4096;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the TX duration computations of WifiPhy");
+  cmd.AddValue ("calls", "number of iterations", calls);
+  cmd.AddValue ("cacheSize", "TxDurationCacheSize attribute of the PHY, 0 to disable the cache", cacheSize);
+  cmd.Parse (argc, argv);
+
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->SetAttribute ("TxDurationCacheSize", UintegerValue (cacheSize));
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211ax_5GHZ);
+  uint16_t frequency = phy->GetFrequency ();
+
+  std::vector<WifiTxVector> txVectors;
+  for (uint8_t i = 0; i < phy->GetNMcs (); i++)
+    {
+      if (phy->GetMcs (i).GetModulationClass () != WIFI_MOD_CLASS_HE)
+        {
+          continue;
+        }
+      WifiTxVector txVector;
+      txVector.SetMode (phy->GetMcs (i));
+      txVector.SetPreambleType (WIFI_PREAMBLE_HE_SU);
+      txVector.SetChannelWidth (20);
+      txVector.SetGuardInterval (800);
+      txVector.SetNss (1);
+      txVectors.push_back (txVector);
+    }
+  WifiTxVector ackTxVector;
+  ackTxVector.SetMode (WifiPhy::GetOfdmRate24Mbps ());
+  ackTxVector.SetPreambleType (WIFI_PREAMBLE_LONG);
+  ackTxVector.SetChannelWidth (20);
+  ackTxVector.SetGuardInterval (800);
+  ackTxVector.SetNss (1);
+  const uint32_t sizes[] = {64, 576, 1500, 1536};
+  const uint32_t nSizes = sizeof (sizes) / sizeof (sizes[0]);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  int64_t checksum = 0;
+  for (uint32_t i = 0; i < calls; ++i)
+    {
+      const WifiTxVector &txVector = txVectors[i % txVectors.size ()];
+      uint32_t size = sizes[(i / txVectors.size ()) % nSizes];
+      checksum += phy->CalculateTxDuration (size, txVector, frequency).GetNanoSeconds ();
+      checksum += phy->GetPayloadDuration (size, txVector, frequency, MIDDLE_MPDU_IN_AGGREGATE, 0).GetNanoSeconds ();
+      checksum += phy->CalculateTxDuration (14, ackTxVector, frequency).GetNanoSeconds ();
+    }
+  int64_t elapsed = clock.End ();
+
+  std::cout << "cache size " << cacheSize << ": " << calls << " iterations in "
+            << elapsed << " ms (" << elapsed * 1e6 / calls << " ns/iteration, checksum "
+            << checksum << ")" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}